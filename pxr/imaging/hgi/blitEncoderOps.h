@@ -54,6 +54,10 @@ PXR_NAMESPACE_OPEN_SCOPE
 ///   The gpu texture to copy pixels from.</li>
 /// <li>sourceTexelOffset:
 ///   The texel offset (width, height, depth) of where to start copying.</li>
+/// <li>sourceTexelExtent:
+///   The number of texels (width, height, depth) to copy. Components that
+///   are zero copy to the end of the mip level. The destination receives
+///   the region tightly packed.</li>
 /// <li>mipLevel:
 ///   Mip level to copy from.</li>
 /// <li>startLayer:
@@ -72,6 +76,7 @@ struct HgiTextureGpuToCpuOp {
     HgiTextureGpuToCpuOp()
     : gpuSourceTexture(nullptr)
     , sourceTexelOffset(GfVec3i(0))
+    , sourceTexelExtent(GfVec3i(0))
     , mipLevel(0)
     , startLayer(0)
     , numLayers(1)
@@ -82,6 +87,7 @@ struct HgiTextureGpuToCpuOp {
 
     HgiTextureHandle gpuSourceTexture;
     GfVec3i sourceTexelOffset;
+    GfVec3i sourceTexelExtent;
     uint32_t mipLevel;
     uint32_t startLayer;
     uint32_t numLayers;
@@ -12,6 +12,7 @@ HgiBuffer::~HgiBuffer()
 
 HgiBufferDesc::HgiBufferDesc()
     : usage(HgiBufferUsageStorage)
+    , stageUsage(0)
     , byteSize(0)
     , data(nullptr)
 {
@@ -23,6 +24,7 @@ bool operator==(
 {
     return lhs.debugName == rhs.debugName &&
            lhs.usage == rhs.usage &&
+           lhs.stageUsage == rhs.stageUsage &&
            lhs.byteSize == rhs.byteSize
            // Omitted because data ptr is set to nullptr after CreateBuffer
            // lhs.data == rhs.data &&
@@ -63,6 +63,11 @@ typedef std::vector<HgiBufferHandle> HgiBufferHandleVector;
 /// <ul>
 /// <li>usage:
 ///   Bits describing the intended usage and properties of the buffer.</li>
+/// <li>stageUsage:
+///   The shader stages that read (or write) the buffer when it is a uniform or
+///   storage buffer. Zero means the buffer may be used in any stage.
+///   Backends use this to synchronize uploads with the first stage that
+///   actually consumes the buffer.</li>
 /// <li>byteSize:
 ///   Byte size (length) of buffer</li>
 /// <li>data:
@@ -78,6 +83,7 @@ struct HgiBufferDesc {
 
     std::string debugName;
     HgiBufferUsage usage;
+    HgiShaderStage stageUsage;
     size_t byteSize;
     void const* data;
 };
@@ -24,6 +24,7 @@
 #ifndef PXR_IMAGING_HGI_ENCODER_OPS_H
 #define PXR_IMAGING_HGI_ENCODER_OPS_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -46,6 +47,22 @@ struct HgiTimeQuery {
 typedef std::vector<HgiTimeQuery> HgiTimeQueryVector;
 
 
+/// \struct HgiDrawIndexedIndirectCommand
+///
+/// Arguments of one indexed draw in an indirect (argument) buffer.
+/// See HgiGraphicsEncoder::DrawIndexedIndirect.
+/// The layout matches VkDrawIndexedIndirectCommand, MTLDrawIndexedPrimitives-
+/// IndirectArguments and the OpenGL DrawElementsIndirectCommand.
+///
+struct HgiDrawIndexedIndirectCommand {
+    uint32_t indexCount = 0;
+    uint32_t instanceCount = 0;
+    uint32_t firstIndex = 0;
+    int32_t vertexOffset = 0;
+    uint32_t firstInstance = 0;
+};
+
+
 PXR_NAMESPACE_CLOSE_SCOPE
 
 #endif
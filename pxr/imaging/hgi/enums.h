@@ -78,6 +78,12 @@ typedef HgiBits HgiDeviceCapabilities;
 ///   This bit is present if the texture uses reversed channel ordering.
 ///   Both HdFormat and HgiFormat do not support such a format, but it may be
 ///   needed on some platforms that only support BGRA window swapchains.</li>
+/// <li>HgiTextureUsageBitsTransient:
+///   The texture is a render pass attachment whose contents are not needed
+///   outside of the pass, such as a multisample attachment that is resolved
+///   (HgiAttachmentDesc::resolveTexture) and not stored. The texture may
+///   live in lazily allocated memory. Only combine with ColorTarget or
+///   DepthTarget.</li>
 /// </ul>
 ///
 enum HgiTextureUsageBits : HgiBits {
@@ -90,6 +96,7 @@ enum HgiTextureUsageBits : HgiBits {
     HgiTextureUsageBitsTransferSrc = 1 << 5,
     HgiTextureUsageBitsSwapchain   = 1 << 6,
     HgiTextureUsageBitsBGRA        = 1 << 7,
+    HgiTextureUsageBitsTransient   = 1 << 8,
 };
 
 typedef HgiBits HgiTextureUsage;
@@ -106,6 +113,72 @@ enum HgiSampleCount {
 };
 
 
+/// \enum HgiSamplerFilter
+///
+/// Filter of a sampler within one mip level.
+///
+/// <ul>
+/// <li>HgiSamplerFilterNearest:
+///   Uses the texel nearest to the texture coordinate.</li>
+/// <li>HgiSamplerFilterLinear:
+///   Interpolates the texels around the texture coordinate.</li>
+/// </ul>
+///
+enum HgiSamplerFilter {
+    HgiSamplerFilterNearest = 0,
+    HgiSamplerFilterLinear,
+
+    HgiSamplerFilterCount
+};
+
+
+/// \enum HgiMipFilter
+///
+/// Filter of a sampler between mip levels.
+///
+/// <ul>
+/// <li>HgiMipFilterNearest:
+///   Samples the nearest mip level.</li>
+/// <li>HgiMipFilterLinear:
+///   Interpolates between the two nearest mip levels.</li>
+/// </ul>
+///
+enum HgiMipFilter {
+    HgiMipFilterNearest = 0,
+    HgiMipFilterLinear,
+
+    HgiMipFilterCount
+};
+
+
+/// \enum HgiSamplerAddressMode
+///
+/// Describes how a sampler addresses texture coordinates outside of [0, 1].
+///
+/// <ul>
+/// <li>HgiSamplerAddressModeClampToEdge:
+///   Uses the texels at the edge of the texture.</li>
+/// <li>HgiSamplerAddressModeMirrorClampToEdge:
+///   Mirrors the texture once, then clamps to the edge.</li>
+/// <li>HgiSamplerAddressModeRepeat:
+///   Repeats the texture.</li>
+/// <li>HgiSamplerAddressModeMirrorRepeat:
+///   Repeats the texture, mirroring every other repetition.</li>
+/// <li>HgiSamplerAddressModeClampToBorderColor:
+///   Returns the border color (opaque white).</li>
+/// </ul>
+///
+enum HgiSamplerAddressMode {
+    HgiSamplerAddressModeClampToEdge = 0,
+    HgiSamplerAddressModeMirrorClampToEdge,
+    HgiSamplerAddressModeRepeat,
+    HgiSamplerAddressModeMirrorRepeat,
+    HgiSamplerAddressModeClampToBorderColor,
+
+    HgiSamplerAddressModeCount
+};
+
+
 /// \enum HgiAttachmentLoadOp
 ///
 /// Describes what will happen to the attachment pixel data prior to rendering.
@@ -255,6 +328,9 @@ typedef HgiBits HgiShaderStage;
 ///   Buffer contain data written by GPU that you want to read back on CPU,
 ///   e.g. results of a computation.
 ///   Cannot be combined with HgiBufferUsageCpuToGpu.</li>
+/// <li>HgiBufferUsageIndirect:
+///   Buffer holds the arguments of indirect draws
+///   (HgiDrawIndexedIndirectCommand) or their draw count.</li>
 /// </ul>
 ///
 enum HgiBufferUsageBits : HgiBits {
@@ -267,6 +343,7 @@ enum HgiBufferUsageBits : HgiBits {
     HgiBufferUsageTransferDst = 1 << 6,
     HgiBufferUsageCpuToGpu    = 1 << 7,
     HgiBufferUsageGpuToCpu    = 1 << 8,
+    HgiBufferUsageIndirect    = 1 << 9,
 };
 typedef HgiBits HgiBufferUsage;
 
@@ -126,6 +126,44 @@ public:
         uint32_t instanceCount,
         uint32_t firstInstance) = 0;
 
+    /// Records `drawCount` indexed draws whose arguments are read by the gpu
+    /// from `drawParameterBuffer`, so the arguments can be generated on the
+    /// gpu (e.g. by a culling compute shader).
+    /// `drawParameterBuffer` holds HgiDrawIndexedIndirectCommand structs and
+    ///                       must have HgiBufferUsageIndirect.
+    /// `drawBufferByteOffset`: Byte offset of the first command (multiple
+    ///                         of 4).
+    /// `drawCount`: Number of commands (draws) to execute.
+    /// `stride`: Byte distance between commands. Zero means the commands are
+    ///           tightly packed.
+    /// A command with a firstInstance other than zero needs backend support
+    /// (e.g. the Vulkan drawIndirectFirstInstance feature).
+    HGI_API
+    virtual void DrawIndexedIndirect(
+        HgiBufferHandle const& indexBuffer,
+        HgiBufferHandle const& drawParameterBuffer,
+        uint32_t drawBufferByteOffset,
+        uint32_t drawCount,
+        uint32_t stride) = 0;
+
+    /// Same as DrawIndexedIndirect, but the number of draws is read by the
+    /// gpu from `countBuffer` (one uint32_t at `countBufferByteOffset`).
+    /// At most `maxDrawCount` draws are executed.
+    /// `countBuffer` must have HgiBufferUsageIndirect.
+    /// Backends that can not read the count on the gpu execute
+    /// `maxDrawCount` draws, so commands past the count should have an
+    /// instanceCount of zero.
+    /// firstInstance has the same requirement as in DrawIndexedIndirect.
+    HGI_API
+    virtual void DrawIndexedIndirectCount(
+        HgiBufferHandle const& indexBuffer,
+        HgiBufferHandle const& drawParameterBuffer,
+        uint32_t drawBufferByteOffset,
+        HgiBufferHandle const& countBuffer,
+        uint32_t countBufferByteOffset,
+        uint32_t maxDrawCount,
+        uint32_t stride) = 0;
+
     /// Push a debug marker onto the encoder.
     HGI_API
     virtual void PushDebugGroup(const char* label) = 0;
@@ -32,7 +32,8 @@ bool operator==(
     return  lhs.clearValue == rhs.clearValue &&
             lhs.loadOp == rhs.loadOp &&
             lhs.storeOp == rhs.storeOp &&
-            lhs.texture == rhs.texture;
+            lhs.texture == rhs.texture &&
+            lhs.resolveTexture == rhs.resolveTexture;
 }
 
 bool operator!=(
@@ -50,7 +51,8 @@ std::ostream& operator<<(
         << "has_texture: " << (attachment.texture!=nullptr) << ", "
         << "clearValue: " << attachment.clearValue << ", "
         << "loadOp: " << attachment.loadOp << ", "
-        << "storeOp: " << attachment.storeOp <<
+        << "storeOp: " << attachment.storeOp << ", "
+        << "has_resolveTexture: " << (attachment.resolveTexture!=nullptr) <<
     "}";
     return out;
 }
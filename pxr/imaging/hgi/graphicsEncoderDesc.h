@@ -49,6 +49,12 @@ PXR_NAMESPACE_OPEN_SCOPE
 ///   The operation to perform on the attachment pixel data after rendering.</li>
 /// <li>clearValue:
 ///   The value to clear the attachment with (r,g,b,a) or (depth,stencil,x,x)</li>
+/// <li>resolveTexture:
+///   Optional single sample texture the multisample `texture` is resolved
+///   into at the end of the render pass (color attachments only). When the
+///   multisample contents are not needed afterwards, use
+///   HgiAttachmentStoreOpDontCare and create `texture` with
+///   HgiTextureUsageBitsTransient, so it is never written to memory.</li>
 ///
 struct HgiAttachmentDesc {
     HgiAttachmentDesc()
@@ -56,12 +62,14 @@ struct HgiAttachmentDesc {
     , loadOp(HgiAttachmentLoadOpLoad)
     , storeOp(HgiAttachmentStoreOpStore)
     , clearValue(0)
+    , resolveTexture(nullptr)
     {}
 
     HgiTextureHandle texture;
     HgiAttachmentLoadOp loadOp;
     HgiAttachmentStoreOp storeOp;
     GfVec4f clearValue;
+    HgiTextureHandle resolveTexture;
 };
 
 typedef std::vector<HgiAttachmentDesc> HgiAttachmentDescVector;
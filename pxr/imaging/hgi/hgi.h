@@ -27,11 +27,13 @@
 #include "pxr/pxr.h"
 #include "pxr/imaging/hgi/api.h"
 #include "pxr/imaging/hgi/blitEncoder.h"
+#include "pxr/imaging/hgi/computeEncoder.h"
 #include "pxr/imaging/hgi/graphicsEncoder.h"
 #include "pxr/imaging/hgi/graphicsEncoderDesc.h"
 #include "pxr/imaging/hgi/parallelGraphicsEncoder.h"
 #include "pxr/imaging/hgi/pipeline.h"
 #include "pxr/imaging/hgi/resourceBindings.h"
+#include "pxr/imaging/hgi/sampler.h"
 #include "pxr/imaging/hgi/shaderFunction.h"
 #include "pxr/imaging/hgi/shaderProgram.h"
 #include "pxr/imaging/hgi/texture.h"
@@ -105,6 +107,16 @@ public:
     HGI_API
     virtual HgiBlitEncoderUniquePtr CreateBlitEncoder() = 0;
 
+    /// Returns a compute encoder for temporary use that is ready to execute
+    /// compute commands. ComputeEncoder is a lightweight object that
+    /// should be re-acquired each frame (don't hold onto it after EndEncoding).
+    /// Compute work may run asynchronously to graphics work, but is guaranteed
+    /// to have finished before the draw commands of the same frame consume
+    /// its results.
+    /// This compute encoder can only be used in a single thread.
+    HGI_API
+    virtual HgiComputeEncoderUniquePtr CreateComputeEncoder() = 0;
+
     //
     // Resource API
     //
@@ -117,6 +129,15 @@ public:
     HGI_API
     virtual void DestroyTexture(HgiTextureHandle* texHandle) = 0;
 
+    /// Create a sampler in rendering backend.
+    /// Samplers with the same description may share one backend object.
+    HGI_API
+    virtual HgiSamplerHandle CreateSampler(HgiSamplerDesc const & desc) = 0;
+
+    /// Destroy a sampler in rendering backend.
+    HGI_API
+    virtual void DestroySampler(HgiSamplerHandle* samplerHandle) = 0;
+
     /// Create a new buffer object
     HGI_API
     virtual HgiBufferHandle CreateBuffer(HgiBufferDesc const& desc) = 0;
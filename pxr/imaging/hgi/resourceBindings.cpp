@@ -90,6 +90,7 @@ bool operator==(
     const HgiTextureBindDesc& rhs)
 {
     return lhs.textures == rhs.textures &&
+           lhs.samplers == rhs.samplers &&
            lhs.resourceType == rhs.resourceType &&
            lhs.bindingIndex == rhs.bindingIndex &&
            lhs.stageUsage == rhs.stageUsage;
@@ -127,6 +128,7 @@ bool operator!=(
 
 HgiResourceBindingsDesc::HgiResourceBindingsDesc()
     : pipelineType(HgiPipelineTypeGraphics)
+    , transient(false)
 {
 }
 
@@ -139,7 +141,8 @@ bool operator==(
            lhs.buffers == rhs.buffers &&
            lhs.textures == rhs.textures &&
            lhs.pushConstants == rhs.pushConstants &&
-           lhs.vertexBuffers == rhs.vertexBuffers;
+           lhs.vertexBuffers == rhs.vertexBuffers &&
+           lhs.transient == rhs.transient;
 }
 
 bool operator!=(
@@ -8,6 +8,7 @@
 #include "pxr/imaging/hgi/api.h"
 #include "pxr/imaging/hgi/buffer.h"
 #include "pxr/imaging/hgi/enums.h"
+#include "pxr/imaging/hgi/sampler.h"
 #include "pxr/imaging/hgi/texture.h"
 #include "pxr/imaging/hgi/types.h"
 
@@ -168,6 +169,10 @@ inline bool operator!=(
 ///   If there are more than one texture, the textures will be put in an
 ///   array-of-textures (not texture-array). Please note that different
 ///   platforms have varying limits to max textures in an array.</li>
+/// <li>samplers:
+///   (optional) The sampler of each texture in `textures`.
+///   When empty, each texture is sampled with its default sampler
+///   (linear filtering, clamp to edge, max anisotropy).</li>
 /// <li>resourceType:
 ///    The type of the texture(s) that is to be bound.
 ///    All textures in the array must have the same type.</li>
@@ -182,6 +187,7 @@ struct HgiTextureBindDesc {
     HgiTextureBindDesc();
 
     HgiTextureHandleVector textures;
+    HgiSamplerHandleVector samplers;
     HgiBindResourceType resourceType;
     uint32_t bindingIndex;
     HgiShaderStage stageUsage;
@@ -250,6 +256,11 @@ bool operator!=(
 /// <li>vertexBuffers:
 ///   Description of the vertex buffers (per-vertex attributes).
 ///   The actual VBOs are bound via GraphicsEncoder.</li>
+/// <li>transient:
+///   The resource bindings are used for few draws (E.g. per-prim uniforms).
+///   Backends may record the resources directly into the command buffer
+///   instead of creating a descriptor set up front. Pipelines must be
+///   created with resource bindings of the same transient setting.</li>
 /// </ul>
 ///
 struct HgiResourceBindingsDesc {
@@ -262,6 +273,7 @@ struct HgiResourceBindingsDesc {
     HgiTextureBindDescVector textures;
     HgiPushConstantDescVector pushConstants;
     HgiVertexBufferDescVector vertexBuffers;
+    bool transient;
 };
 
 HGI_API
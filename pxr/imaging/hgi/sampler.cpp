@@ -0,0 +1,57 @@
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+#include "pxr/imaging/hgi/sampler.h"
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+HgiSampler::HgiSampler(HgiSamplerDesc const&)
+{
+}
+
+HgiSampler::~HgiSampler()
+{
+}
+
+bool operator==(const HgiSamplerDesc& lhs,
+    const HgiSamplerDesc& rhs)
+{
+    return  lhs.debugName == rhs.debugName &&
+            lhs.magFilter == rhs.magFilter &&
+            lhs.minFilter == rhs.minFilter &&
+            lhs.mipFilter == rhs.mipFilter &&
+            lhs.addressModeU == rhs.addressModeU &&
+            lhs.addressModeV == rhs.addressModeV &&
+            lhs.addressModeW == rhs.addressModeW &&
+            lhs.maxAnisotropy == rhs.maxAnisotropy
+    ;
+}
+
+bool operator!=(const HgiSamplerDesc& lhs,
+    const HgiSamplerDesc& rhs)
+{
+    return !(lhs == rhs);
+}
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
@@ -0,0 +1,126 @@
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+#ifndef PXR_IMAGING_HGI_SAMPLER_H
+#define PXR_IMAGING_HGI_SAMPLER_H
+
+#include <string>
+#include <vector>
+
+#include "pxr/pxr.h"
+#include "pxr/imaging/hgi/api.h"
+#include "pxr/imaging/hgi/enums.h"
+#include "pxr/imaging/hgi/types.h"
+
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+struct HgiSamplerDesc;
+
+
+///
+/// \class HgiSampler
+///
+/// Represents a graphics platform independent GPU sampler resource that
+/// describes how textures are filtered and addressed when they are sampled.
+///
+/// Base class for Hgi samplers.
+/// Samplers are bound together with textures (see HgiTextureBindDesc), so
+/// one texture can be sampled with different settings.
+///
+class HgiSampler {
+public:
+    HGI_API
+    HgiSampler(HgiSamplerDesc const& desc);
+
+    HGI_API
+    virtual ~HgiSampler();
+
+private:
+    HgiSampler() = delete;
+    HgiSampler & operator=(const HgiSampler&) = delete;
+    HgiSampler(const HgiSampler&) = delete;
+};
+
+typedef HgiSampler* HgiSamplerHandle;
+typedef std::vector<HgiSamplerHandle> HgiSamplerHandleVector;
+
+
+
+/// \struct HgiSamplerDesc
+///
+/// Describes the properties needed to create a GPU sampler.
+///
+/// <ul>
+/// <li>magFilter:
+///   The filter used when the texture is magnified.</li>
+/// <li>minFilter:
+///   The filter used when the texture is minified.</li>
+/// <li>mipFilter:
+///   The filter used between mip levels.</li>
+/// <li>addressModeU:
+///   Addressing of texture coordinates outside of [0, 1] in U.</li>
+/// <li>addressModeV:
+///   Addressing of texture coordinates outside of [0, 1] in V.</li>
+/// <li>addressModeW:
+///   Addressing of texture coordinates outside of [0, 1] in W.</li>
+/// <li>maxAnisotropy:
+///   Max anisotropic filtering ratio. 1 disables anisotropic filtering.
+///   Clamped to the limit of the device.</li>
+/// </ul>
+///
+struct HgiSamplerDesc {
+    HgiSamplerDesc()
+    : magFilter(HgiSamplerFilterLinear)
+    , minFilter(HgiSamplerFilterLinear)
+    , mipFilter(HgiMipFilterLinear)
+    , addressModeU(HgiSamplerAddressModeClampToEdge)
+    , addressModeV(HgiSamplerAddressModeClampToEdge)
+    , addressModeW(HgiSamplerAddressModeClampToEdge)
+    , maxAnisotropy(16.0f)
+    {}
+
+    std::string debugName;
+    HgiSamplerFilter magFilter;
+    HgiSamplerFilter minFilter;
+    HgiMipFilter mipFilter;
+    HgiSamplerAddressMode addressModeU;
+    HgiSamplerAddressMode addressModeV;
+    HgiSamplerAddressMode addressModeW;
+    float maxAnisotropy;
+};
+
+HGI_API
+bool operator==(
+    const HgiSamplerDesc& lhs,
+    const HgiSamplerDesc& rhs);
+
+HGI_API
+bool operator!=(
+    const HgiSamplerDesc& lhs,
+    const HgiSamplerDesc& rhs);
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+#endif
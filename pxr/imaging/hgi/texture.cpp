@@ -40,6 +40,7 @@ bool operator==(const HgiTextureDesc& lhs,
             lhs.usage == rhs.usage &&
             lhs.format == rhs.format &&
             lhs.dimensions == rhs.dimensions &&
+            lhs.generateMips == rhs.generateMips &&
             lhs.sampleCount == rhs.sampleCount &&
             lhs.pixelsByteSize == rhs.pixelsByteSize
             // Omitted because data ptr is set to nullptr after CreateTexture
@@ -80,6 +80,9 @@ typedef HgiTexture* HgiTextureHandle;
 ///   The number of layers (texture-arrays).</li>
 /// <li>mipLevels:
 ///   The number of mips in texture.</li>
+/// <li>generateMips:
+///   When true, pixelData only holds the pixels of mip 0 and the remaining
+///   mipLevels are generated on the gpu after the upload.</li>
 /// <li>sampleCount:
 ///   samples per texel (multi-sampling)</li>
 /// <li>pixelsByteSize:
@@ -99,6 +102,7 @@ struct HgiTextureDesc {
     , dimensions(0)
     , layerCount(1)
     , mipLevels(1)
+    , generateMips(false)
     , sampleCount(HgiSampleCount1)
     , pixelsByteSize(0)
     , pixelData(nullptr)
@@ -110,6 +114,7 @@ struct HgiTextureDesc {
     GfVec3i dimensions;
     uint16_t layerCount;
     uint16_t mipLevels;
+    bool generateMips;
     HgiSampleCount sampleCount;
     size_t pixelsByteSize;
     void const* pixelData;
@@ -0,0 +1,193 @@
+#include "pxr/base/tf/diagnostic.h"
+
+#include "pxr/imaging/hgiVk/bindlessTextures.h"
+#include "pxr/imaging/hgiVk/device.h"
+#include "pxr/imaging/hgiVk/diagnostic.h"
+
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+HgiVkBindlessTextures::HgiVkBindlessTextures(
+    HgiVkDevice* device,
+    uint32_t maxTextures)
+    : _device(device)
+    , _maxTextures(maxTextures)
+    , _vkDescriptorSetLayout(nullptr)
+    , _vkDescriptorPool(nullptr)
+    , _vkDescriptorSet(nullptr)
+    , _nextIndex(0)
+{
+    //
+    // Layout
+    //
+
+    // Textures are written while frames that use the set are in flight,
+    // and most slots are empty.
+    VkDescriptorBindingFlagsEXT bindingFlags =
+        VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT |
+        VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT |
+        VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT;
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo =
+        {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT};
+    bindingFlagsInfo.bindingCount = 1;
+    bindingFlagsInfo.pBindingFlags = &bindingFlags;
+
+    VkDescriptorSetLayoutBinding binding = {};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    binding.descriptorCount = _maxTextures;
+    binding.stageFlags = VK_SHADER_STAGE_ALL;
+
+    VkDescriptorSetLayoutCreateInfo setCreateInfo =
+        {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+    setCreateInfo.pNext = &bindingFlagsInfo;
+    setCreateInfo.flags =
+        VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+    setCreateInfo.bindingCount = 1;
+    setCreateInfo.pBindings = &binding;
+
+    TF_VERIFY(
+        vkCreateDescriptorSetLayout(
+            _device->GetVulkanDevice(),
+            &setCreateInfo,
+            HgiVkAllocator(),
+            &_vkDescriptorSetLayout) == VK_SUCCESS
+    );
+
+    //
+    // Pool and set
+    //
+
+    VkDescriptorPoolSize poolSize;
+    poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSize.descriptorCount = _maxTextures;
+
+    VkDescriptorPoolCreateInfo poolInfo =
+        {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+
+    TF_VERIFY(
+        vkCreateDescriptorPool(
+            _device->GetVulkanDevice(),
+            &poolInfo,
+            HgiVkAllocator(),
+            &_vkDescriptorPool) == VK_SUCCESS
+    );
+
+    VkDescriptorSetAllocateInfo allocateInfo =
+        {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+    allocateInfo.descriptorPool = _vkDescriptorPool;
+    allocateInfo.descriptorSetCount = 1;
+    allocateInfo.pSetLayouts = &_vkDescriptorSetLayout;
+
+    TF_VERIFY(
+        vkAllocateDescriptorSets(
+            _device->GetVulkanDevice(),
+            &allocateInfo,
+            &_vkDescriptorSet) == VK_SUCCESS
+    );
+
+    // Debug label
+    HgiVkSetDebugName(
+        _device,
+        (uint64_t)_vkDescriptorSet,
+        VK_DEBUG_REPORT_OBJECT_TYPE_DESCRIPTOR_SET_EXT,
+        "Descriptor Set Bindless Textures");
+}
+
+HgiVkBindlessTextures::~HgiVkBindlessTextures()
+{
+    // Destroying the pool frees the set.
+    vkDestroyDescriptorPool(
+        _device->GetVulkanDevice(),
+        _vkDescriptorPool,
+        HgiVkAllocator());
+
+    vkDestroyDescriptorSetLayout(
+        _device->GetVulkanDevice(),
+        _vkDescriptorSetLayout,
+        HgiVkAllocator());
+}
+
+uint32_t
+HgiVkBindlessTextures::RegisterTexture(
+    VkImageView imageView,
+    VkSampler sampler,
+    VkImageLayout imageLayout)
+{
+    /* MULTI-THREAD CALL*/
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    uint32_t index = InvalidIndex;
+    if (!_freeIndices.empty()) {
+        index = _freeIndices.back();
+        _freeIndices.pop_back();
+    } else if (_nextIndex < _maxTextures) {
+        index = _nextIndex++;
+    } else {
+        TF_WARN("Bindless texture array is full (%u textures)", _maxTextures);
+        return InvalidIndex;
+    }
+
+    VkDescriptorImageInfo imageInfo;
+    imageInfo.sampler = sampler;
+    imageInfo.imageView = imageView;
+    imageInfo.imageLayout = imageLayout;
+
+    VkWriteDescriptorSet writeSet = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+    writeSet.dstSet = _vkDescriptorSet;
+    writeSet.dstBinding = 0;
+    writeSet.dstArrayElement = index;
+    writeSet.descriptorCount = 1;
+    writeSet.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    writeSet.pImageInfo = &imageInfo;
+
+    vkUpdateDescriptorSets(
+        _device->GetVulkanDevice(),
+        1,
+        &writeSet,
+        0,
+        nullptr);
+
+    return index;
+}
+
+void
+HgiVkBindlessTextures::UnregisterTexture(uint32_t index)
+{
+    /* MULTI-THREAD CALL*/
+
+    if (index == InvalidIndex) return;
+
+    // The slot keeps the destroyed texture's descriptor until it is re-used.
+    // That is valid, since the binding is partially bound and the slot is
+    // not accessed.
+    std::lock_guard<std::mutex> lock(_lock);
+    _freeIndices.push_back(index);
+}
+
+VkDescriptorSetLayout
+HgiVkBindlessTextures::GetDescriptorSetLayout() const
+{
+    return _vkDescriptorSetLayout;
+}
+
+VkDescriptorSet
+HgiVkBindlessTextures::GetDescriptorSet() const
+{
+    return _vkDescriptorSet;
+}
+
+uint32_t
+HgiVkBindlessTextures::GetMaxTextures() const
+{
+    return _maxTextures;
+}
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
@@ -0,0 +1,100 @@
+#ifndef PXR_IMAGING_HGIVK_BINDLESS_TEXTURES_H
+#define PXR_IMAGING_HGIVK_BINDLESS_TEXTURES_H
+
+#include <mutex>
+#include <vector>
+
+#include "pxr/pxr.h"
+#include "pxr/imaging/hgiVk/api.h"
+#include "pxr/imaging/hgiVk/vulkan.h"
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+class HgiVkDevice;
+
+
+/// \class HgiVkBindlessTextures
+///
+/// Global array of all sampled textures of the device (bindless mode,
+/// see HGIVK_BINDLESS_TEXTURES). Requires VK_EXT_descriptor_indexing.
+///
+/// Each sampled texture registers itself when it is created and receives an
+/// index into the array that stays the same for its whole lifetime.
+/// The array is one update-after-bind descriptor set. Every pipeline layout
+/// of resource bindings has it at set HgiVkBindlessTextures::SetIndex, so
+/// shaders can sample any texture by index (E.g. a material id):
+///
+///   layout(set=1, binding=0) uniform sampler2D hgiTextures[];
+///   texture(hgiTextures[nonuniformEXT(materialId)], uv);
+///
+/// Textures of other dimensions alias the same binding with their own
+/// sampler type. Slots that were never written or whose texture was
+/// destroyed must not be accessed.
+///
+class HgiVkBindlessTextures final
+{
+public:
+    /// The descriptor set number of the array in pipeline layouts.
+    static const uint32_t SetIndex = 1;
+
+    /// The index of textures that are not in the array.
+    static const uint32_t InvalidIndex = 0xFFFFFFFF;
+
+    HGIVK_API
+    HgiVkBindlessTextures(HgiVkDevice* device, uint32_t maxTextures);
+
+    HGIVK_API
+    ~HgiVkBindlessTextures();
+
+    /// Writes a texture into a free slot of the array and returns its index.
+    /// Returns InvalidIndex if the array is full.
+    /// Thread safety: May be called from any thread.
+    HGIVK_API
+    uint32_t RegisterTexture(
+        VkImageView imageView,
+        VkSampler sampler,
+        VkImageLayout imageLayout);
+
+    /// Returns the slot of a texture to the free list.
+    /// Called when the texture is garbage collected, so the gpu no longer
+    /// uses the slot. The slot may be re-used by the next texture.
+    /// Thread safety: May be called from any thread.
+    HGIVK_API
+    void UnregisterTexture(uint32_t index);
+
+    /// Returns the layout of the array's descriptor set.
+    HGIVK_API
+    VkDescriptorSetLayout GetDescriptorSetLayout() const;
+
+    /// Returns the array's descriptor set.
+    HGIVK_API
+    VkDescriptorSet GetDescriptorSet() const;
+
+    /// Returns the number of slots in the array.
+    HGIVK_API
+    uint32_t GetMaxTextures() const;
+
+private:
+    HgiVkBindlessTextures() = delete;
+    HgiVkBindlessTextures & operator=(const HgiVkBindlessTextures&) = delete;
+    HgiVkBindlessTextures(const HgiVkBindlessTextures&) = delete;
+
+private:
+    HgiVkDevice* _device;
+    uint32_t _maxTextures;
+
+    VkDescriptorSetLayout _vkDescriptorSetLayout;
+    VkDescriptorPool _vkDescriptorPool;
+    VkDescriptorSet _vkDescriptorSet;
+
+    // Guards the slots and the descriptor writes, since updates of one set
+    // must be externally synchronized.
+    std::mutex _lock;
+    uint32_t _nextIndex;
+    std::vector<uint32_t> _freeIndices;
+};
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+#endif
@@ -1,9 +1,11 @@
+#include <algorithm>
+
 #include "pxr/imaging/hgiVk/blitEncoder.h"
 #include "pxr/imaging/hgiVk/commandBuffer.h"
 #include "pxr/imaging/hgiVk/conversions.h"
 #include "pxr/imaging/hgiVk/device.h"
 #include "pxr/imaging/hgiVk/diagnostic.h"
-#include "pxr/imaging/hgiVk/renderPass.h"
+#include "pxr/imaging/hgiVk/fullscreenPass.h"
 #include "pxr/imaging/hgiVk/texture.h"
 #include "pxr/imaging/hgiVk/vulkan.h"
 
@@ -66,7 +68,6 @@ HgiVkBlitEncoder::CopyTextureGpuToCpu(
     // CPU can read the pixels data.
     HgiVkCommandPool cp(_device);
     HgiVkCommandBuffer cb(_device, &cp, HgiVkCommandBufferUsagePrimary);
-    VkCommandBuffer vkCmdBuf = cb.GetCommandBufferForRecoding();
 
     // Create the GPU buffer that will receive a copy of the GPU texels that
     // we can then memcpy to CPU buffer.
@@ -77,61 +78,44 @@ HgiVkBlitEncoder::CopyTextureGpuToCpu(
 
     HgiVkBuffer dstBuffer(_device, dstDesc);
 
-    // Setup info to copy data form gpu texture to gpu buffer
-    HgiTextureDesc const& texDesc = srcTexture->GetDescriptor();
+    VkBufferImageCopy region = _GetBufferImageCopy(
+        copyOp, (VkDeviceSize) copyOp.destinationByteOffset);
 
-    VkOffset3D imageOffset;
-    imageOffset.x = copyOp.sourceTexelOffset[0];
-    imageOffset.y = copyOp.sourceTexelOffset[1];
-    imageOffset.z = copyOp.sourceTexelOffset[2];
-
-    VkExtent3D imageExtent;
-    imageExtent.width = texDesc.dimensions[0];
-    imageExtent.height = texDesc.dimensions[1];
-    imageExtent.depth = texDesc.dimensions[2];
-
-    VkImageSubresourceLayers imageSub;
-    imageSub.aspectMask = HgiVkConversions::GetImageAspectFlag(texDesc.usage);
-    imageSub.baseArrayLayer = copyOp.startLayer;
-    imageSub.layerCount = copyOp.numLayers;
-    imageSub.mipLevel = copyOp.mipLevel;
-
-    // See vulkan docs: Copying Data Between Buffers and Images
-    VkBufferImageCopy region;
-    region.bufferImageHeight = 0; // Buffer is tightly packed, like image
-    region.bufferRowLength = 0;   // Buffer is tightly packed, like image
-    region.bufferOffset = (VkDeviceSize) copyOp.destinationByteOffset;
-    region.imageExtent = imageExtent;
-    region.imageOffset = imageOffset;
-    region.imageSubresource = imageSub;
+    // This command buffer is submitted on its own, before the command
+    // buffers of the frame. The queue sees the texture in its default layout
+    // (the state it has between command buffers) and the next command buffer
+    // expects it in that layout again. So the tracked state of the texture,
+    // which belongs to the frame's command buffers, is not used here.
+    VkImageLayout defaultLayout = srcTexture->GetImageLayout();
 
     // Transition image to TRANSFER_READ
-    VkImageLayout oldLayout = srcTexture->GetImageLayout();
-    srcTexture->TransitionImageBarrier(
+    srcTexture->RecordImageBarrier(
         &cb,
-        srcTexture,
+        defaultLayout,                        // transition tex from this layout
         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, // transition tex to this layout
+        0,                                    // producer access
         VK_ACCESS_TRANSFER_READ_BIT,          // type of access
         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,    // producer stage
         VK_PIPELINE_STAGE_TRANSFER_BIT);      // consumer stage
 
     // Copy gpu texture to gpu buffer
     vkCmdCopyImageToBuffer(
-        vkCmdBuf,
+        cb.GetCommandBufferForRecoding(),
         srcTexture->GetImage(),
-        srcTexture->GetImageLayout(),
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
         dstBuffer.GetBuffer(),
         1,
         &region);
 
-    // Transition image back to what it was.
-    srcTexture->TransitionImageBarrier(
+    // Return image to its default layout.
+    srcTexture->RecordImageBarrier(
         &cb,
-        srcTexture,
-        oldLayout, // transition tex to this layout
-        HgiVkRenderPass::GetDefaultDstAccessMask(), // type of access
-        VK_PIPELINE_STAGE_TRANSFER_BIT,             // producer stage
-        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT);       // consumer stage
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, // transition tex from this layout
+        defaultLayout,                        // transition tex to this layout
+        0,                                    // producer access (read only)
+        0,                                    // type of access
+        VK_PIPELINE_STAGE_TRANSFER_BIT,       // producer stage
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);// consumer stage
 
     cb.EndRecording();
 
@@ -151,6 +135,7 @@ HgiVkBlitEncoder::CopyTextureGpuToCpu(
     std::vector<VkSubmitInfo> submitInfos;
     VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
     submitInfo.commandBufferCount = 1;
+    VkCommandBuffer vkCmdBuf = cb.GetVulkanCommandBuffer();
     submitInfo.pCommandBuffers = &vkCmdBuf;
     submitInfos.emplace_back(std::move(submitInfo));
     _device->SubmitToQueue(submitInfos, vkFence);
@@ -172,6 +157,166 @@ HgiVkBlitEncoder::CopyTextureGpuToCpu(
     dstBuffer.CopyBufferTo(copyOp.cpuDestinationBuffer);
 }
 
+HgiVkReadbackTicket
+HgiVkBlitEncoder::CopyTextureGpuToCpuAsync(
+    HgiTextureGpuToCpuOp const& copyOp,
+    HgiVkReadbackCallback const& callback)
+{
+    HgiVkTexture* srcTexture =
+        static_cast<HgiVkTexture*>(copyOp.gpuSourceTexture);
+
+    if (!TF_VERIFY(srcTexture && srcTexture->GetImage(),
+        "Invalid texture handle")) {
+        return 0;
+    }
+
+    if (copyOp.destinationBufferByteSize <= copyOp.destinationByteOffset) {
+        TF_WARN("The size of the data to copy was zero (aborted)");
+        return 0;
+    }
+
+    HgiTextureDesc const& desc = srcTexture->GetDescriptor();
+
+    uint32_t layerCnt = copyOp.startLayer + copyOp.numLayers;
+    if (!TF_VERIFY(desc.layerCount >= layerCnt,
+        "Texture has less layers than attempted to be copied")) {
+        return 0;
+    }
+
+    // The readback buffer only holds the data after the destination offset.
+    HgiVkReadbackManager* readbacks = _device->GetReadbackManager();
+    HgiVkReadbackRegion readback = readbacks->AddReadback(
+        copyOp.destinationBufferByteSize - copyOp.destinationByteOffset,
+        (char*) copyOp.cpuDestinationBuffer + copyOp.destinationByteOffset,
+        callback);
+
+    if (!readback.buffer) {
+        return 0;
+    }
+
+    // Record after the draws of the frame, which usually render the texture.
+    HgiVkCommandBufferManager* cbm = _device->GetCommandBufferManager();
+    HgiVkCommandBuffer* cb = cbm->GetDrawCommandBuffer();
+
+    // The command buffer returns the texture to its default state.
+    srcTexture->TransitionImageBarrier(
+        cb,
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, // transition tex to this layout
+        VK_ACCESS_TRANSFER_READ_BIT,          // type of access
+        VK_PIPELINE_STAGE_TRANSFER_BIT,       // consumer stage
+        copyOp.mipLevel, 1,
+        copyOp.startLayer, copyOp.numLayers);
+
+    VkBufferImageCopy region = _GetBufferImageCopy(copyOp, readback.offset);
+
+    vkCmdCopyImageToBuffer(
+        cb->GetCommandBufferForRecoding(),
+        srcTexture->GetImage(),
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        readback.buffer,
+        1,
+        &region);
+
+    // Make the copy visible to the host once the frame has completed.
+    VkBufferMemoryBarrier barrier = {VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = readback.buffer;
+    barrier.offset = readback.offset;
+    barrier.size = readback.size;
+
+    cb->AddBarrier(
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_HOST_BIT,
+        barrier);
+
+    return readback.ticket;
+}
+
+void
+HgiVkBlitEncoder::PickTextureGpuToCpu(HgiTextureGpuToCpuOp const& copyOp)
+{
+    // Picks read a few texels. Keeping a full frame sized immediate buffer
+    // around would waste memory, so large copies take the regular path.
+    static const size_t maxPickByteSize = 64 * 1024;
+
+    HgiVkTexture* srcTexture =
+        static_cast<HgiVkTexture*>(copyOp.gpuSourceTexture);
+
+    if (!TF_VERIFY(srcTexture && srcTexture->GetImage(),
+        "Invalid texture handle")) {
+        return;
+    }
+
+    if (copyOp.destinationBufferByteSize <= copyOp.destinationByteOffset) {
+        TF_WARN("The size of the data to copy was zero (aborted)");
+        return;
+    }
+
+    const size_t byteSize =
+        copyOp.destinationBufferByteSize - copyOp.destinationByteOffset;
+
+    if (byteSize > maxPickByteSize) {
+        CopyTextureGpuToCpu(copyOp);
+        return;
+    }
+
+    HgiTextureDesc const& desc = srcTexture->GetDescriptor();
+
+    uint32_t layerCnt = copyOp.startLayer + copyOp.numLayers;
+    if (!TF_VERIFY(desc.layerCount >= layerCnt,
+        "Texture has less layers than attempted to be copied")) {
+        return;
+    }
+
+    auto recordFn = [&copyOp, srcTexture](
+        HgiVkCommandBuffer* cb,
+        HgiVkReadbackRegion const& region)
+    {
+        // Like CopyTextureGpuToCpu the command buffer is submitted on its
+        // own, so the texture is in its default layout. The copy must wait
+        // for the earlier submissions that render into the texture.
+        VkImageLayout defaultLayout = srcTexture->GetImageLayout();
+
+        srcTexture->RecordImageBarrier(
+            cb,
+            defaultLayout,
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            0,
+            VK_ACCESS_TRANSFER_READ_BIT,
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+        VkBufferImageCopy imageCopy =
+            _GetBufferImageCopy(copyOp, region.offset);
+
+        vkCmdCopyImageToBuffer(
+            cb->GetCommandBufferForRecoding(),
+            srcTexture->GetImage(),
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            region.buffer,
+            1,
+            &imageCopy);
+
+        srcTexture->RecordImageBarrier(
+            cb,
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            defaultLayout,
+            0,
+            0,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+    };
+
+    HgiVkReadbackManager* readbacks = _device->GetReadbackManager();
+    readbacks->ReadImmediate(
+        byteSize,
+        (char*) copyOp.cpuDestinationBuffer + copyOp.destinationByteOffset,
+        recordFn);
+}
+
 void
 HgiVkBlitEncoder::ResolveImage(
     HgiResolveImageOp const& resolveOp)
@@ -188,41 +333,25 @@ HgiVkBlitEncoder::ResolveImage(
         return;
     }
 
-    // XXX while vkCmdResolveImage appears to succeed for depth_stencil images
-    // our current usage is not supported by the vulkan spec.
-    // The dst image must be COLOR_ATTACHMENT_BIT and srcImage and dstImage must
-    // be created with the same image format. This rules out using this function
-    // because DEPTH_STENCIL images cannot contain COLOR_ATTACHMENT_BIT.
-    // Instead we need to do this via fullscreen shader render-pass.
-    // Once we have a helper in-place to make fullscreen passes easier via
-    // HgiVkGraphicsEncoder we can replace all of the below code.
-    //
-    // Color:
-    //    layout (binding = 0, set = 0) uniform sampler2DMS colorTex;
-    //    layout(location = 0) out vec4 outputColor;
-    //    void main()
-    //    {
-    //        ivec2 texel = ivec2(gl_FragCoord.xy);
-    //        vec4 color0 = texelFetch(colorTex, texel, 0);
-    //        vec4 color1 = texelFetch(colorTex, texel, 1);
-    //        vec4 color2 = texelFetch(colorTex, texel, 2);
-    //        vec4 color3 = texelFetch(colorTex, texel, 3);
-    //        outputColor = (color0 + color1 + color2 + color3) * 0.25;
-    //    }
-    //
-    // Depth:
-    //    ivec2 texel = ivec2(gl_FragCoord.xy);
-    //    outputDepth = texelFetch(depthTex, texel, 0).x;
+    HgiVkCommandBufferManager* cbm = _device->GetCommandBufferManager();
+    HgiVkCommandBuffer* cb = cbm->GetDrawCommandBuffer();
+
+    // vkCmdResolveImage requires a COLOR_ATTACHMENT_BIT destination with the
+    // format of the source, which rules out depth_stencil images.
+    // Depth is resolved by a fullscreen shader instead.
     bool isDepth =
         dstTexture->GetDescriptor().usage & HgiTextureUsageBitsDepthTarget;
     if (isDepth) {
-        TF_WARN("vkCmdResolveImage dst image must be COLOR_TARGET_BIT");
+        _device->GetFullscreenPass()->Record(
+            cb,
+            HgiVkFullscreenOpDepthResolve,
+            srcTexture,
+            dstTexture);
+        return;
     }
 
-    // XXX Performance warning: We could use pResolveAttachments on the
-    // render pass of the color image to resolve it more efficiently.
-    // And setup as: STORE_OP_DONT_CARE and TRANSIENT.
-    // (Won't apply to depth, because it cannot be in pResolveAttachments)
+    // Performance warning: Color images are resolved more efficiently by
+    // their render pass. See HgiAttachmentDesc::resolveTexture.
 
     // XXX For now we assume this can be recorded as a deferred command.
     // That may not always be what is expected. When the caller wants to
@@ -233,28 +362,26 @@ HgiVkBlitEncoder::ResolveImage(
     // submit immediately and wait for fence to complete.
     // See CopyTextureGpuToCpu.
 
-    HgiVkCommandBufferManager* cbm = _device->GetCommandBufferManager();
-    HgiVkCommandBuffer* cb = cbm->GetDrawCommandBuffer();
+    // The textures are not transitioned back after the resolve. The next
+    // command that uses them adds the barrier it needs, or the command buffer
+    // returns them to their default state before it ends.
 
-    // Src must be in TRANSFER_READ/SRC for vkCmdResolveImage
-    VkImageLayout oldSrcLayout = srcTexture->GetImageLayout();
+    // Src must be in TRANSFER_READ/SRC for vkCmdResolveImage.
+    // Only mip 0 is resolved.
     srcTexture->TransitionImageBarrier(
         cb,
-        srcTexture,
         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, // transition tex to this layout
         VK_ACCESS_TRANSFER_READ_BIT,          // type of access
-        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,    // producer stage
-        VK_PIPELINE_STAGE_TRANSFER_BIT);      // consumer stage
+        VK_PIPELINE_STAGE_TRANSFER_BIT,       // consumer stage
+        0, 1);                                // mip 0
 
     // Dst must be in TRANSFER_WRITE/DST for vkCmdResolveImage
-    VkImageLayout oldDstLayout = dstTexture->GetImageLayout();
     dstTexture->TransitionImageBarrier(
         cb,
-        dstTexture,
         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, // transition tex to this layout
         VK_ACCESS_TRANSFER_WRITE_BIT,         // type of access
-        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,    // producer stage
-        VK_PIPELINE_STAGE_TRANSFER_BIT);      // consumer stage
+        VK_PIPELINE_STAGE_TRANSFER_BIT,       // consumer stage
+        0, 1);                                // mip 0
 
     // Setup image resolve info
     VkImageSubresourceLayers srcInfo;
@@ -287,29 +414,65 @@ HgiVkBlitEncoder::ResolveImage(
     vkCmdResolveImage(
         cb->GetCommandBufferForRecoding(),
         srcTexture->GetImage(),
-        srcTexture->GetImageLayout(),
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
         dstTexture->GetImage(),
-        dstTexture->GetImageLayout(),
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
         1, // region count
         &imageResolve);
+}
 
-    // Transition images back to what they were.
-    srcTexture->TransitionImageBarrier(
-        cb,
+void
+HgiVkBlitEncoder::ConvertTexture(
+    HgiTextureHandle const& source,
+    HgiTextureHandle const& destination)
+{
+    HgiVkTexture* srcTexture = static_cast<HgiVkTexture*>(source);
+    HgiVkTexture* dstTexture = static_cast<HgiVkTexture*>(destination);
+    if (!TF_VERIFY(srcTexture && dstTexture, "Invalid texture handles")) {
+        return;
+    }
+
+    GfVec3i const& srcDim = srcTexture->GetDescriptor().dimensions;
+    GfVec3i const& dstDim = dstTexture->GetDescriptor().dimensions;
+    if (!TF_VERIFY(srcDim[0] == dstDim[0] && srcDim[1] == dstDim[1],
+                   "ConvertTexture requires textures of the same size")) {
+        return;
+    }
+
+    HgiVkCommandBufferManager* cbm = _device->GetCommandBufferManager();
+    _device->GetFullscreenPass()->Record(
+        cbm->GetDrawCommandBuffer(),
+        HgiVkFullscreenOpConvert,
         srcTexture,
-        oldSrcLayout, // transition tex to this layout
-        HgiVkRenderPass::GetDefaultDstAccessMask(), // type of access
-        VK_PIPELINE_STAGE_TRANSFER_BIT,             // producer stage
-        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT);       // consumer stage
+        dstTexture);
+}
 
-    // Transition images back to what they were.
-    dstTexture->TransitionImageBarrier(
-        cb,
-        dstTexture,
-        oldDstLayout, // transition tex to this layout
-        HgiVkRenderPass::GetDefaultDstAccessMask(), // type of access
-        VK_PIPELINE_STAGE_TRANSFER_BIT,             // producer stage
-        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT);       // consumer stage
+void
+HgiVkBlitEncoder::DownsampleTexture(
+    HgiTextureHandle const& source,
+    HgiTextureHandle const& destination)
+{
+    HgiVkTexture* srcTexture = static_cast<HgiVkTexture*>(source);
+    HgiVkTexture* dstTexture = static_cast<HgiVkTexture*>(destination);
+    if (!TF_VERIFY(srcTexture && dstTexture, "Invalid texture handles")) {
+        return;
+    }
+
+    GfVec3i const& srcDim = srcTexture->GetDescriptor().dimensions;
+    GfVec3i const& dstDim = dstTexture->GetDescriptor().dimensions;
+    if (!TF_VERIFY(dstDim[0] == std::max(1, srcDim[0] / 2) &&
+                   dstDim[1] == std::max(1, srcDim[1] / 2),
+                   "DownsampleTexture requires a destination of half the "
+                   "size of the source")) {
+        return;
+    }
+
+    HgiVkCommandBufferManager* cbm = _device->GetCommandBufferManager();
+    _device->GetFullscreenPass()->Record(
+        cbm->GetDrawCommandBuffer(),
+        HgiVkFullscreenOpDownsample,
+        srcTexture,
+        dstTexture);
 }
 
 void
@@ -340,4 +503,53 @@ HgiVkBlitEncoder::PopTimeQuery()
     _commandBuffer->PopTimeQuery();
 }
 
+VkBufferImageCopy
+HgiVkBlitEncoder::_GetBufferImageCopy(
+    HgiTextureGpuToCpuOp const& copyOp,
+    VkDeviceSize bufferOffset)
+{
+    HgiVkTexture* srcTexture =
+        static_cast<HgiVkTexture*>(copyOp.gpuSourceTexture);
+
+    // Setup info to copy data form gpu texture to gpu buffer
+    HgiTextureDesc const& texDesc = srcTexture->GetDescriptor();
+
+    VkOffset3D imageOffset;
+    imageOffset.x = copyOp.sourceTexelOffset[0];
+    imageOffset.y = copyOp.sourceTexelOffset[1];
+    imageOffset.z = copyOp.sourceTexelOffset[2];
+
+    // Copy the requested region, or up to the end of the mip level, so a
+    // small pick region does not copy the entire texture.
+    uint32_t extent[3];
+    for (size_t i=0; i<3; i++) {
+        int mipDim = std::max(texDesc.dimensions[i] >> copyOp.mipLevel, 1);
+        int available = std::max(mipDim - copyOp.sourceTexelOffset[i], 0);
+        int requested = copyOp.sourceTexelExtent[i];
+        extent[i] = (uint32_t) (requested > 0 ?
+            std::min(requested, available) : available);
+    }
+
+    VkExtent3D imageExtent;
+    imageExtent.width = extent[0];
+    imageExtent.height = extent[1];
+    imageExtent.depth = extent[2];
+
+    VkImageSubresourceLayers imageSub;
+    imageSub.aspectMask = HgiVkConversions::GetImageAspectFlag(texDesc.usage);
+    imageSub.baseArrayLayer = copyOp.startLayer;
+    imageSub.layerCount = copyOp.numLayers;
+    imageSub.mipLevel = copyOp.mipLevel;
+
+    // See vulkan docs: Copying Data Between Buffers and Images
+    VkBufferImageCopy region;
+    region.bufferImageHeight = 0; // Buffer is tightly packed, like image
+    region.bufferRowLength = 0;   // Buffer is tightly packed, like image
+    region.bufferOffset = bufferOffset;
+    region.imageExtent = imageExtent;
+    region.imageOffset = imageOffset;
+    region.imageSubresource = imageSub;
+    return region;
+}
+
 PXR_NAMESPACE_CLOSE_SCOPE
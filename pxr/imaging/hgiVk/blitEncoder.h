@@ -3,6 +3,8 @@
 
 #include "pxr/pxr.h"
 #include "pxr/imaging/hgiVk/api.h"
+#include "pxr/imaging/hgiVk/readbackManager.h"
+#include "pxr/imaging/hgiVk/vulkan.h"
 #include "pxr/imaging/hgi/blitEncoder.h"
 
 PXR_NAMESPACE_OPEN_SCOPE
@@ -31,9 +33,48 @@ public:
     HGIVK_API
     void CopyTextureGpuToCpu(HgiTextureGpuToCpuOp const& copyOp) override;
 
+    /// Records the copy into the draw command buffer of the current frame,
+    /// after the draws recorded so far, and returns immediately.
+    /// The data is copied to `copyOp.cpuDestinationBuffer` once the gpu has
+    /// completed the frame, which is usually GetFramesInFlight frames later.
+    /// The destination must stay valid until then. Use the ticket with
+    /// HgiVkReadbackManager to poll, wait or cancel. `callback` is called
+    /// once the data has been copied. Returns 0 on failure.
+    HGIVK_API
+    HgiVkReadbackTicket CopyTextureGpuToCpuAsync(
+        HgiTextureGpuToCpuOp const& copyOp,
+        HgiVkReadbackCallback const& callback = nullptr);
+
+    /// Low latency copy of a small texture region (e.g. the primId or depth
+    /// under the cursor) set via `copyOp.sourceTexelOffset` and
+    /// `copyOp.sourceTexelExtent`. The copy is submitted right away and only
+    /// the copy is waited on, which the gpu runs after the frames submitted
+    /// so far. Nothing is allocated per call.
+    /// Larger copies fall back to CopyTextureGpuToCpu.
+    HGIVK_API
+    void PickTextureGpuToCpu(HgiTextureGpuToCpuOp const& copyOp);
+
+    /// Color textures are resolved with vkCmdResolveImage, depth textures
+    /// with a fullscreen shader (see HgiVkFullscreenPass).
     HGIVK_API
     void ResolveImage(HgiResolveImageOp const& resolveOp) override;
 
+    /// Copies `source` into `destination` of the same size, converting the
+    /// format (e.g. a Float32Vec4 AOV into a UNorm8Vec4 texture).
+    /// Mip 0 of both textures is used.
+    HGIVK_API
+    void ConvertTexture(
+        HgiTextureHandle const& source,
+        HgiTextureHandle const& destination);
+
+    /// Filters `source` into `destination` of half the size (rounded down,
+    /// at least 1) with a 2x2 box filter.
+    /// Mip 0 of both textures is used.
+    HGIVK_API
+    void DownsampleTexture(
+        HgiTextureHandle const& source,
+        HgiTextureHandle const& destination);
+
     HGIVK_API
     void PushDebugGroup(const char* label) override;
 
@@ -51,6 +92,11 @@ private:
     HgiVkBlitEncoder & operator=(const HgiVkBlitEncoder&) = delete;
     HgiVkBlitEncoder(const HgiVkBlitEncoder&) = delete;
 
+    // Returns the copy region of `copyOp` into a buffer at `bufferOffset`.
+    static VkBufferImageCopy _GetBufferImageCopy(
+        HgiTextureGpuToCpuOp const& copyOp,
+        VkDeviceSize bufferOffset);
+
 private:
     HgiVkDevice* _device;
     HgiVkCommandBuffer* _commandBuffer;
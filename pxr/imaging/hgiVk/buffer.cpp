@@ -18,6 +18,7 @@ HgiVkBuffer::HgiVkBuffer(
     , _vkBuffer(nullptr)
     , _vmaBufferAllocation(nullptr)
     , _dataMapped(nullptr)
+    , _isConcurrent(false)
 {
     bool isStagingBuffer = (desc.usage & HgiBufferUsageTransferSrc);
     bool isDestinationBuffer = (desc.usage & HgiBufferUsageTransferDst);
@@ -34,6 +35,20 @@ HgiVkBuffer::HgiVkBuffer(
     bufCreateInfo.usage = HgiVkConversions::GetBufferUsage(desc.usage);
     bufCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE; // gfx queue only
 
+    // Storage and uniform buffers are accessed by compute shaders, which may
+    // run on the async compute queue of another queue family. Instead of
+    // transferring ownership back and forth each frame we share these
+    // buffers between all queue families of the device.
+    std::vector<uint32_t> queueFamilies = device->GetVulkanQueueFamilyIndices();
+    const HgiBufferUsage shaderUsage =
+        HgiBufferUsageStorage | HgiBufferUsageUniform;
+    if ((desc.usage & shaderUsage) && queueFamilies.size() > 1) {
+        bufCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufCreateInfo.queueFamilyIndexCount = (uint32_t) queueFamilies.size();
+        bufCreateInfo.pQueueFamilyIndices = queueFamilies.data();
+    }
+    _isConcurrent = bufCreateInfo.sharingMode == VK_SHARING_MODE_CONCURRENT;
+
     if (desc.data && !isStagingBuffer && !isDestinationBuffer) {
         // It is likely the caller intended for desc.data to be uploaded into
         // the buffer, but did not make this clear in the usage flags.
@@ -195,59 +210,120 @@ HgiVkBuffer::GetDescriptor() const
 void
 HgiVkBuffer::CopyBufferFrom(
     HgiVkCommandBuffer* cb,
-    HgiVkBuffer const& src)
+    HgiVkStagingRegion const& src)
 {
-    HgiBufferDesc const& srcDesc = src.GetDescriptor();
-    bool isStagingBuffer = (srcDesc.usage & HgiBufferUsageTransferSrc);
-    if (!isStagingBuffer) {
-        TF_CODING_ERROR("Buffer [%x] is missing usage flag: "
-                        "HgiBufferUsageTransferSrc", &src);
-        return;
+    if (!_RecordCopyFrom(cb, src)) return;
+
+    // Make sure copy finishes before the first stage that consumes the
+    // buffer. E.g. a SSBO that is only used in the fragment stage does not
+    // stall the vertex stages of the draws that follow.
+    VkBufferMemoryBarrier barrier = {VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT; // what producer does
+    barrier.dstAccessMask = _GetConsumerAccess();         // what consumer does
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = _vkBuffer;
+    barrier.size = VK_WHOLE_SIZE;
+
+    // The barrier is batched with those of other uploads.
+    cb->AddBarrier(
+        VK_PIPELINE_STAGE_TRANSFER_BIT, // producer stage
+        _GetConsumerStages(),           // consumer stage
+        barrier);
+}
+
+void
+HgiVkBuffer::CopyBufferFromTransferQueue(
+    HgiVkCommandBuffer* transferCB,
+    HgiVkCommandBuffer* cb,
+    HgiVkStagingRegion const& src)
+{
+    if (!_RecordCopyFrom(transferCB, src)) return;
+
+    // Vulkan docs: "Queue Family Ownership Transfer".
+    // The buffer is EXCLUSIVE so the graphics queue must acquire ownership
+    // before it can read the data written by the transfer queue.
+    // The release and acquire barriers must match, except for the access
+    // masks that are ignored on the 'other' side.
+    // CONCURRENT buffers need no ownership transfer, the barriers below are
+    // then only execution and memory dependencies.
+    VkBufferMemoryBarrier barrier = {VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+    barrier.srcQueueFamilyIndex = _isConcurrent ? VK_QUEUE_FAMILY_IGNORED :
+        _device->GetVulkanTransferQueueFamilyIndex();
+    barrier.dstQueueFamilyIndex = _isConcurrent ? VK_QUEUE_FAMILY_IGNORED :
+        _device->GetVulkanDeviceQueueFamilyIndex();
+    barrier.buffer = _vkBuffer;
+    barrier.size = VK_WHOLE_SIZE;
+
+    // Release (transfer queue)
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = 0;
+
+    transferCB->AddBarrier(
+        VK_PIPELINE_STAGE_TRANSFER_BIT,       // producer stage
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, // consumer stage (other queue)
+        barrier);
+
+    // Acquire (graphics queue). The semaphore wait covers the transfer stage.
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = _GetConsumerAccess();
+
+    cb->AddBarrier(
+        VK_PIPELINE_STAGE_TRANSFER_BIT, // producer stage (semaphore wait)
+        _GetConsumerStages(),           // consumer stage
+        barrier);
+}
+
+bool
+HgiVkBuffer::_RecordCopyFrom(
+    HgiVkCommandBuffer* cb,
+    HgiVkStagingRegion const& src)
+{
+    if (!src.buffer) {
+        TF_CODING_ERROR("Invalid staging region for buffer [%x]", this);
+        return false;
     }
 
     bool isDestSrc = (_descriptor.usage & HgiBufferUsageTransferDst);
     if (!isDestSrc) {
         TF_CODING_ERROR("Buffer [%x] is missing usage flag: "
                         "HgiBufferUsageTransferDst", this);
-        return;
+        return false;
     }
 
-    if (srcDesc.byteSize > _descriptor.byteSize) {
-        TF_CODING_ERROR("Buffer src [%x] is larger than dest buffer [%x].",
-                        &src, this);
-        return;
+    if (src.size > _descriptor.byteSize) {
+        TF_CODING_ERROR("Staging region is larger than dest buffer [%x].",
+                        this);
+        return false;
     }
 
-    // Copy data from staging buffer to destination (gpu) buffer
+    // Copy data from staging buffer to destination (gpu) buffer.
+    // The copy does not depend on the pending barriers of other uploads.
     VkBufferCopy copyRegion = {};
-    copyRegion.srcOffset = 0;
+    copyRegion.srcOffset = src.offset;
     copyRegion.dstOffset = 0;
-    copyRegion.size = srcDesc.byteSize;
+    copyRegion.size = src.size;
     vkCmdCopyBuffer(
-        cb->GetCommandBufferForRecoding(),
-        src.GetBuffer(),
+        cb->GetCommandBufferForUpload((uint64_t) _vkBuffer),
+        src.buffer,
         _vkBuffer,
         1, // regionCount
         &copyRegion);
 
-    // Make sure copy finishes before the next draw call.
-    // XXX Optimization opportunity: Currently we always set vertex/index
-    // as the consumer stage, but some buffers may be used later, such as an
-    // SSBO used only in the fragment stage.
-    VkBufferMemoryBarrier barrier = {VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
-    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT; // what producer does
-    barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |
-                            VK_ACCESS_INDEX_READ_BIT;     // what consumer does
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.buffer = _vkBuffer;
-    barrier.size = VK_WHOLE_SIZE;
+    return true;
+}
 
-    vkCmdPipelineBarrier(
-        cb->GetCommandBufferForRecoding(),
-        VK_PIPELINE_STAGE_TRANSFER_BIT,     // producer stage
-        VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, // consumer stage
-        0, 0, nullptr, 1, &barrier, 0, nullptr);
+VkPipelineStageFlags
+HgiVkBuffer::_GetConsumerStages() const
+{
+    return HgiVkConversions::GetBufferConsumerStages(
+        _descriptor.usage, _descriptor.stageUsage);
+}
+
+VkAccessFlags
+HgiVkBuffer::_GetConsumerAccess() const
+{
+    return HgiVkConversions::GetBufferConsumerAccess(_descriptor.usage);
 }
 
 void
@@ -4,6 +4,7 @@
 #include "pxr/imaging/hgi/buffer.h"
 
 #include "pxr/imaging/hgiVk/api.h"
+#include "pxr/imaging/hgiVk/stagingRing.h"
 #include "pxr/imaging/hgiVk/vulkan.h"
 
 PXR_NAMESPACE_OPEN_SCOPE
@@ -43,13 +44,24 @@ public:
     HgiBufferDesc const& GetDescriptor() const;
 
     /// Records a GPU->GPU copy command to copy the data from the provided
-    /// source buffer into this (destination) buffer. This requires that the
-    /// source buffer is setup as a staging buffer (HgiBufferUsageTransferSrc)
-    /// and that this (destination) buffer has usage: HgiBufferUsageTransferDst.
+    /// staging region into this (destination) buffer. This requires that this
+    /// (destination) buffer has usage: HgiBufferUsageTransferDst.
     HGIVK_API
     void CopyBufferFrom(
         HgiVkCommandBuffer* cb,
-        HgiVkBuffer const& src);
+        HgiVkStagingRegion const& src);
+
+    /// Same as CopyBufferFrom, but the copy is recorded in `transferCB`, which
+    /// belongs to the device's dedicated transfer queue. Queue family
+    /// ownership of this buffer is released in `transferCB` and acquired in
+    /// `cb` (graphics queue). The caller must make sure the graphics
+    /// submission of `cb` waits on a semaphore signaled by the transfer
+    /// submission of `transferCB`.
+    HGIVK_API
+    void CopyBufferFromTransferQueue(
+        HgiVkCommandBuffer* transferCB,
+        HgiVkCommandBuffer* cb,
+        HgiVkStagingRegion const& src);
 
     /// Copy the entire contents of this buffer to the cpuDestBuffer.
     /// 'cpuDestBuffer' must be off minimum size: GetDescriptor().byteSize.
@@ -64,12 +76,27 @@ private:
     HgiVkBuffer & operator=(const HgiVkBuffer&) = delete;
     HgiVkBuffer(const HgiVkBuffer&) = delete;
 
+    // Validates the buffers and records the copy command.
+    // Returns false if the copy could not be recorded.
+    bool _RecordCopyFrom(
+        HgiVkCommandBuffer* cb,
+        HgiVkStagingRegion const& src);
+
+    // Returns the stages and access of the first consumers of the buffer,
+    // derived from the buffer usage and stageUsage.
+    VkPipelineStageFlags _GetConsumerStages() const;
+    VkAccessFlags _GetConsumerAccess() const;
+
 private:
     HgiVkDevice* _device;
     HgiBufferDesc _descriptor;
     VkBuffer _vkBuffer;
     VmaAllocation _vmaBufferAllocation;
     void* _dataMapped;
+
+    // True if the buffer is shared between queue families without ownership
+    // transfers (VK_SHARING_MODE_CONCURRENT).
+    bool _isConcurrent;
 };
 
 
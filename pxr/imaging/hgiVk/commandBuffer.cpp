@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cstdint>
 #include <string>
 
 #include "pxr/base/tf/diagnostic.h"
@@ -16,6 +18,26 @@
 
 PXR_NAMESPACE_OPEN_SCOPE
 
+// Returns the end of a mip level or array layer range.
+static uint64_t
+_GetRangeEnd(uint32_t base, uint32_t count)
+{
+    // VK_REMAINING_ARRAY_LAYERS has the same value.
+    return count == VK_REMAINING_MIP_LEVELS ?
+        UINT64_MAX : (uint64_t) base + count;
+}
+
+static bool
+_SubresourceRangesOverlap(
+    VkImageSubresourceRange const& a,
+    VkImageSubresourceRange const& b)
+{
+    return (a.aspectMask & b.aspectMask) &&
+        a.baseMipLevel < _GetRangeEnd(b.baseMipLevel, b.levelCount) &&
+        b.baseMipLevel < _GetRangeEnd(a.baseMipLevel, a.levelCount) &&
+        a.baseArrayLayer < _GetRangeEnd(b.baseArrayLayer, b.layerCount) &&
+        b.baseArrayLayer < _GetRangeEnd(a.baseArrayLayer, a.layerCount);
+}
 
 HgiVkCommandBuffer::HgiVkCommandBuffer(
     HgiVkDevice* device,
@@ -28,6 +50,11 @@ HgiVkCommandBuffer::HgiVkCommandBuffer(
     , _vkCommandBuffer(nullptr)
     , _vkTimeStampQueryPool(nullptr)
     , _timeQueriesReset(false)
+    , _resetTimeQueriesOnBegin(false)
+    , _pendingSrcStages(0)
+    , _pendingDstStages(0)
+    , _handsOverTextureStates(false)
+    , _sampledDefaultStates(false)
 {
     //
     // Create command buffer
@@ -51,7 +78,10 @@ HgiVkCommandBuffer::HgiVkCommandBuffer(
     //
     // TimeStamp query pool
     //
-    if (_device->GetDeviceSupportTimeStamps()) {
+    // Draw bundles are recorded once, so their time queries would never be
+    // reset (see ResetTimeQueries).
+    if (_device->GetDeviceSupportTimeStamps() &&
+        _usage != HgiVkCommandBufferUsageSecondaryDrawBundle) {
         _timeQueries.reserve(HGIVK_MAX_TIMESTAMPS/2);
 
         VkQueryPoolCreateInfo queryPoolInfo =
@@ -73,6 +103,8 @@ HgiVkCommandBuffer::~HgiVkCommandBuffer()
 {
     // Prevent vulkan validation from warning that we are destroying a
     // command buffer that is being recorded into.
+    // The tracked textures may already be destroyed, so don't restore them.
+    _trackedTextures.clear();
     EndRecording();
 
     if (_vkTimeStampQueryPool) {
@@ -95,13 +127,25 @@ HgiVkCommandBuffer::SetRenderPass(HgiVkRenderPass* rp)
     _vkInheritanceInfo =
         {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
     _vkInheritanceInfo.renderPass = rp->GetVulkanRenderPass();
-    _vkInheritanceInfo.framebuffer = rp->GetVulkanFramebuffer();
+
+    // Draw bundles are executed in the render passes of different
+    // framebuffers, so they must not specify one.
+    _vkInheritanceInfo.framebuffer =
+        _usage == HgiVkCommandBufferUsageSecondaryDrawBundle ?
+        nullptr : rp->GetVulkanFramebuffer();
 }
 
 void
 HgiVkCommandBuffer::EndRecording()
 {
     if (_isRecording) {
+        // The tracked textures stay available to the command buffer manager
+        // until recording begins again.
+        if (!_handsOverTextureStates) {
+            RestoreTextureStates(std::vector<HgiVkTexture*>());
+        }
+        FlushBarriers();
+
         TF_VERIFY(
             vkEndCommandBuffer(_vkCommandBuffer) == VK_SUCCESS
         );
@@ -126,9 +170,183 @@ VkCommandBuffer
 HgiVkCommandBuffer::GetCommandBufferForRecoding()
 {
     _BeginRecording();
+    FlushBarriers();
     return _vkCommandBuffer;
 }
 
+VkCommandBuffer
+HgiVkCommandBuffer::GetCommandBufferForUpload(uint64_t dstResource)
+{
+    _BeginRecording();
+    if (_pendingResources.count(dstResource)) {
+        FlushBarriers();
+    }
+    return _vkCommandBuffer;
+}
+
+void
+HgiVkCommandBuffer::AddBarrier(
+    VkPipelineStageFlags srcStage,
+    VkPipelineStageFlags dstStage,
+    VkMemoryBarrier const& barrier)
+{
+    // Global memory barriers are not for one resource.
+    _PrepareBarrier(0, srcStage, dstStage);
+    _pendingMemoryBarriers.push_back(barrier);
+}
+
+void
+HgiVkCommandBuffer::AddBarrier(
+    VkPipelineStageFlags srcStage,
+    VkPipelineStageFlags dstStage,
+    VkBufferMemoryBarrier const& barrier)
+{
+    _PrepareBarrier((uint64_t) barrier.buffer, srcStage, dstStage);
+    _pendingBufferBarriers.push_back(barrier);
+}
+
+void
+HgiVkCommandBuffer::AddBarrier(
+    VkPipelineStageFlags srcStage,
+    VkPipelineStageFlags dstStage,
+    VkImageMemoryBarrier const& barrier)
+{
+    // Barriers of other subresources of the same image can be recorded in
+    // the same vkCmdPipelineBarrier.
+    _BeginRecording();
+    if (_HasOverlappingImageBarrier(barrier)) {
+        FlushBarriers();
+    }
+
+    // The image is still tracked for GetCommandBufferForUpload.
+    _PrepareBarrier(0, srcStage, dstStage);
+    _pendingResources.insert((uint64_t) barrier.image);
+    _pendingImageBarriers.push_back(barrier);
+}
+
+void
+HgiVkCommandBuffer::FlushBarriers()
+{
+    if (_pendingMemoryBarriers.empty() &&
+        _pendingBufferBarriers.empty() &&
+        _pendingImageBarriers.empty()) {
+        return;
+    }
+
+    _barrierStats.barriers += (uint32_t) (
+        _pendingMemoryBarriers.size() +
+        _pendingBufferBarriers.size() +
+        _pendingImageBarriers.size());
+    _barrierStats.pipelineBarriers++;
+
+    vkCmdPipelineBarrier(
+        _vkCommandBuffer,
+        _pendingSrcStages,
+        _pendingDstStages,
+        0,
+        (uint32_t) _pendingMemoryBarriers.size(),
+        _pendingMemoryBarriers.data(),
+        (uint32_t) _pendingBufferBarriers.size(),
+        _pendingBufferBarriers.data(),
+        (uint32_t) _pendingImageBarriers.size(),
+        _pendingImageBarriers.data());
+
+    _pendingSrcStages = 0;
+    _pendingDstStages = 0;
+    _pendingMemoryBarriers.clear();
+    _pendingBufferBarriers.clear();
+    _pendingImageBarriers.clear();
+    _pendingResources.clear();
+}
+
+HgiVkTrackedTexture&
+HgiVkCommandBuffer::TrackTexture(
+    HgiVkTexture* tex,
+    HgiVkImageStateVector const& initial,
+    HgiVkImageStateVector const& states)
+{
+    // Beginning clears the textures of the previous recording.
+    _BeginRecording();
+
+    HgiVkTrackedTexture& tracked = _trackedTextures[tex];
+    tracked = HgiVkTrackedTexture();
+    tracked.initial = initial;
+    tracked.states = states;
+    return tracked;
+}
+
+HgiVkTrackedTexture*
+HgiVkCommandBuffer::FindTrackedTexture(HgiVkTexture* tex)
+{
+    // Until recording begins the textures are those of the last recording.
+    if (!_isRecording) return nullptr;
+
+    auto it = _trackedTextures.find(tex);
+    return it != _trackedTextures.end() ? &it->second : nullptr;
+}
+
+HgiVkTrackedTextureMap const&
+HgiVkCommandBuffer::GetTrackedTextures() const
+{
+    return _trackedTextures;
+}
+
+void
+HgiVkCommandBuffer::SetHandsOverTextureStates(bool handsOver)
+{
+    _handsOverTextureStates = handsOver;
+}
+
+bool
+HgiVkCommandBuffer::CanDeferFirstTransition(HgiVkTexture* tex) const
+{
+    if (!_handsOverTextureStates) return false;
+    if (!_isRecording || !_sampledDefaultStates) return true;
+
+    return std::find(
+        _notSampledTextures.begin(),
+        _notSampledTextures.end(),
+        tex) != _notSampledTextures.end();
+}
+
+void
+HgiVkCommandBuffer::RestoreTextureStates(
+    std::vector<HgiVkTexture*> const& keep)
+{
+    // Beginning clears the textures of the previous recording, so it must
+    // not happen while we update them.
+    _BeginRecording();
+
+    for (auto& it : _trackedTextures) {
+        HgiVkTexture* tex = it.first;
+        if (std::find(keep.begin(), keep.end(), tex) == keep.end()) {
+            tex->RestoreDefaultState(this);
+        }
+    }
+
+    // The commands that follow may sample all textures except those in keep.
+    if (!_sampledDefaultStates) {
+        _notSampledTextures = keep;
+    } else {
+        _notSampledTextures.erase(
+            std::remove_if(
+                _notSampledTextures.begin(),
+                _notSampledTextures.end(),
+                [&keep](HgiVkTexture* tex) {
+                    return std::find(keep.begin(), keep.end(), tex) ==
+                        keep.end();
+                }),
+            _notSampledTextures.end());
+    }
+    _sampledDefaultStates = true;
+}
+
+HgiVkBarrierStats const&
+HgiVkCommandBuffer::GetBarrierStats() const
+{
+    return _barrierStats;
+}
+
 VkCommandBuffer
 HgiVkCommandBuffer::GetVulkanCommandBuffer() const
 {
@@ -263,11 +481,17 @@ HgiVkCommandBuffer::ResetTimeQueries(HgiVkCommandBuffer* cb)
     // XXX VK_KHR_performance_query can do it on a device level, which would fit
     // our design much better. But, for now, it is not that well supported.
 
-    vkCmdResetQueryPool(
-        cb->GetCommandBufferForRecoding(), // Don't use internal cmd buf!
-        _vkTimeStampQueryPool,
-        0, // first time stamp
-        HGIVK_MAX_TIMESTAMPS);
+    if (cb == this && !_isRecording) {
+        // Beginning now would submit this command buffer even if it stays
+        // empty, so the reset is recorded in _BeginRecording.
+        _resetTimeQueriesOnBegin = true;
+    } else {
+        vkCmdResetQueryPool(
+            cb->GetCommandBufferForRecoding(), // Don't use internal cmd buf!
+            _vkTimeStampQueryPool,
+            0, // first time stamp
+            HGIVK_MAX_TIMESTAMPS);
+    }
 
     _timeQueries.clear();
     _timeQueriesReset = true;
@@ -280,9 +504,16 @@ HgiVkCommandBuffer::_BeginRecording()
 
         VkCommandBufferBeginInfo beginInfo =
             {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
-        beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
-        if (_usage == HgiVkCommandBufferUsageSecondaryRenderPass) {
+        if (_usage == HgiVkCommandBufferUsageSecondaryDrawBundle) {
+            // A draw bundle may be pending in several in-flight frames.
+            beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+        } else {
+            beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        }
+
+        if (_usage == HgiVkCommandBufferUsageSecondaryRenderPass ||
+            _usage == HgiVkCommandBufferUsageSecondaryDrawBundle) {
             beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
             beginInfo.pInheritanceInfo = &_vkInheritanceInfo;
         }
@@ -293,7 +524,53 @@ HgiVkCommandBuffer::_BeginRecording()
         );
 
         _isRecording = true;
+        _barrierStats = HgiVkBarrierStats();
+
+        _trackedTextures.clear();
+        _sampledDefaultStates = false;
+        _notSampledTextures.clear();
+
+        // Time stamps are written after this, so they see the reset.
+        if (_resetTimeQueriesOnBegin) {
+            vkCmdResetQueryPool(
+                _vkCommandBuffer,
+                _vkTimeStampQueryPool,
+                0, // first time stamp
+                HGIVK_MAX_TIMESTAMPS);
+            _resetTimeQueriesOnBegin = false;
+        }
+    }
+}
+
+void
+HgiVkCommandBuffer::_PrepareBarrier(
+    uint64_t resource,
+    VkPipelineStageFlags srcStage,
+    VkPipelineStageFlags dstStage)
+{
+    _BeginRecording();
+
+    if (resource && !_pendingResources.insert(resource).second) {
+        FlushBarriers();
+        _pendingResources.insert(resource);
+    }
+
+    _pendingSrcStages |= srcStage;
+    _pendingDstStages |= dstStage;
+}
+
+bool
+HgiVkCommandBuffer::_HasOverlappingImageBarrier(
+    VkImageMemoryBarrier const& barrier) const
+{
+    for (VkImageMemoryBarrier const& pending : _pendingImageBarriers) {
+        if (pending.image == barrier.image &&
+            _SubresourceRangesOverlap(
+                pending.subresourceRange, barrier.subresourceRange)) {
+            return true;
+        }
     }
+    return false;
 }
 
 PXR_NAMESPACE_CLOSE_SCOPE
@@ -1,12 +1,15 @@
 #ifndef PXR_IMAGING_HGIVK_COMMAND_BUFFER_H
 #define PXR_IMAGING_HGIVK_COMMAND_BUFFER_H
 
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "pxr/pxr.h"
 #include "pxr/imaging/hgi/encoderOps.h"
 #include "pxr/imaging/hgi/graphicsEncoderDesc.h"
 #include "pxr/imaging/hgiVk/api.h"
+#include "pxr/imaging/hgiVk/texture.h"
 #include "pxr/imaging/hgiVk/vulkan.h"
 
 #define HGIVK_MAX_TIMESTAMPS 16
@@ -32,17 +35,63 @@ class HgiVkRenderPass;
 /// <li>HgiVkCommandBufferUsageSecondaryOther:
 ///   Secondary cmd buf used during parallel command recording outside of
 ///   a render pass (ie. non-draw calls).</li>
+/// <li>HgiVkCommandBufferUsageSecondaryDrawBundle:
+///   Secondary cmd buf of a draw bundle. It is recorded once and executed
+///   in any compatible render pass of many (in-flight) frames.</li>
 /// </ul>
 ///
 enum HgiVkCommandBufferUsage {
     HgiVkCommandBufferUsagePrimary = 0,
     HgiVkCommandBufferUsageSecondaryRenderPass,
     HgiVkCommandBufferUsageSecondaryOther,
+    HgiVkCommandBufferUsageSecondaryDrawBundle,
 
     HgiVkCommandBufferUsageCount
 };
 
 
+/// \struct HgiVkBarrierStats
+///
+/// Number of barriers recorded into command buffers.
+/// `barriers` counts each memory, buffer and image barrier that was added,
+/// `pipelineBarriers` counts the vkCmdPipelineBarrier calls they were batched
+/// into. Without batching both numbers would be the same.
+///
+struct HgiVkBarrierStats {
+    uint32_t barriers = 0;
+    uint32_t pipelineBarriers = 0;
+};
+
+
+/// \struct HgiVkTrackedTexture
+///
+/// Subresource states of a texture in one command buffer.
+///
+/// <ul>
+/// <li>initial:
+///   States the commands expect the texture to be in when the command buffer
+///   begins. The default state, unless the first transition of the texture
+///   was left to the command buffer manager (see TrackTexture).</li>
+/// <li>states:
+///   States the commands recorded so far leave the texture in.</li>
+/// <li>discard:
+///   The contents from before the command buffer are not needed.</li>
+/// <li>firstUsePending:
+///   The contents were discarded, but the first transition is still to
+///   come. It may still be left to the command buffer manager.</li>
+/// </ul>
+///
+struct HgiVkTrackedTexture {
+    HgiVkImageStateVector initial;
+    HgiVkImageStateVector states;
+    bool discard = false;
+    bool firstUsePending = false;
+};
+
+typedef std::unordered_map<HgiVkTexture*, HgiVkTrackedTexture>
+    HgiVkTrackedTextureMap;
+
+
 /// \class HgiVkCommandBuffer
 ///
 /// Wrapper for vulkan command buffer
@@ -75,10 +124,101 @@ public:
     bool IsRecording() const;
 
     /// Ensures the command buffer is ready to record commands and returns the
-    /// vulkan command buffer.
+    /// vulkan command buffer. Pending barriers are recorded first, so the
+    /// commands the caller records are ordered after them.
     HGIVK_API
     VkCommandBuffer GetCommandBufferForRecoding();
 
+    /// Same as GetCommandBufferForRecoding, but pending barriers are only
+    /// recorded first if one of them is for `dstResource`.
+    /// Used by uploads (copies into `dstResource`) that do not depend on the
+    /// barriers of other resources, so the barriers of many uploads are
+    /// batched together.
+    HGIVK_API
+    VkCommandBuffer GetCommandBufferForUpload(uint64_t dstResource);
+
+    /// Adds a barrier to the pending barriers of this command buffer.
+    /// Pending barriers are recorded as one vkCmdPipelineBarrier when the next
+    /// command is recorded (see GetCommandBufferForRecoding), before a render
+    /// pass begins, on FlushBarriers or when the command buffer ends recording.
+    /// The stages of all pending barriers are combined.
+    /// Barriers in one vkCmdPipelineBarrier are not ordered, so if the
+    /// resource already has a pending barrier those are recorded first.
+    /// For images only a pending barrier of an overlapping subresource range
+    /// counts, so e.g. per-mip transitions of a texture are batched.
+    HGIVK_API
+    void AddBarrier(
+        VkPipelineStageFlags srcStage,
+        VkPipelineStageFlags dstStage,
+        VkMemoryBarrier const& barrier);
+
+    HGIVK_API
+    void AddBarrier(
+        VkPipelineStageFlags srcStage,
+        VkPipelineStageFlags dstStage,
+        VkBufferMemoryBarrier const& barrier);
+
+    HGIVK_API
+    void AddBarrier(
+        VkPipelineStageFlags srcStage,
+        VkPipelineStageFlags dstStage,
+        VkImageMemoryBarrier const& barrier);
+
+    /// Records all pending barriers as one vkCmdPipelineBarrier.
+    HGIVK_API
+    void FlushBarriers();
+
+    /// Starts tracking the subresource states of a texture whose state is
+    /// changed by commands of this command buffer and returns them.
+    /// Each command buffer tracks its own states, so command buffers that use
+    /// the same texture can be recorded on different threads.
+    /// Unless the command buffer hands its states over (see
+    /// SetHandsOverTextureStates) the texture is returned to its default
+    /// state before the command buffer ends recording, since the commands of
+    /// other command buffers expect the texture to be in that state.
+    /// Called by HgiVkTexture.
+    HGIVK_API
+    HgiVkTrackedTexture& TrackTexture(
+        HgiVkTexture* tex,
+        HgiVkImageStateVector const& initial,
+        HgiVkImageStateVector const& states);
+
+    /// Returns the subresource states of a texture tracked by this command
+    /// buffer or nullptr if the commands did not use the texture so far.
+    HGIVK_API
+    HgiVkTrackedTexture* FindTrackedTexture(HgiVkTexture* tex);
+
+    /// Returns all textures tracked since recording began.
+    HGIVK_API
+    HgiVkTrackedTextureMap const& GetTrackedTextures() const;
+
+    /// If set, textures keep the state the commands left them in when the
+    /// command buffer ends recording. The command buffer manager then records
+    /// the transitions between the command buffers of a queue submission
+    /// (see HgiVkCommandBufferManager::EndFrame).
+    HGIVK_API
+    void SetHandsOverTextureStates(bool handsOver);
+
+    /// Returns true if the first transition of `tex` in this command buffer
+    /// can be left to the command buffer manager. That is the case if the
+    /// command buffer hands its states over and none of its commands so far
+    /// may have sampled the texture in its default state.
+    HGIVK_API
+    bool CanDeferFirstTransition(HgiVkTexture* tex) const;
+
+    /// Returns all tracked textures, except those in `keep`, to their default
+    /// state. For example, before a render pass begins the textures its draw
+    /// calls may sample must be back in their default (shader read) state,
+    /// while its attachments can stay in their attachment layout.
+    /// The commands that follow may sample any texture except those in
+    /// `keep` (see CanDeferFirstTransition).
+    HGIVK_API
+    void RestoreTextureStates(std::vector<HgiVkTexture*> const& keep);
+
+    /// Returns the number of barriers recorded since recording began.
+    HGIVK_API
+    HgiVkBarrierStats const& GetBarrierStats() const;
+
     /// Returns the vulkan command buffer. Makes no attempt to ensure the
     /// command buffer is ready to record (see AcquireVulkanCommandBuffer);
     HGIVK_API
@@ -104,6 +244,9 @@ public:
     /// Reset time queries. This must be called before any render pass begins.
     /// It is called from the command buffer manager at BeginFrame.
     /// Reset happens in the provided cmd buf, not the internal cmd buf.
+    /// If `cb` is this command buffer and it is not recording, the reset is
+    /// recorded when it begins recording. Used for command buffers that are submitted to another
+    /// queue before the provided cmd buf would execute.
     HGIVK_API
     void ResetTimeQueries(HgiVkCommandBuffer* cb);
 
@@ -115,6 +258,17 @@ private:
     // Ensures a command buffer is ready to record commands.
     void _BeginRecording();
 
+    // Flushes the pending barriers if `resource` has a pending barrier and
+    // adds the pending stages.
+    void _PrepareBarrier(
+        uint64_t resource,
+        VkPipelineStageFlags srcStage,
+        VkPipelineStageFlags dstStage);
+
+    // Returns true if a pending barrier is for the image and a subresource
+    // range that overlaps those of `barrier`.
+    bool _HasOverlappingImageBarrier(VkImageMemoryBarrier const& barrier) const;
+
 private:
     HgiVkDevice* _device;
     HgiVkCommandPool* _commandPool;
@@ -128,6 +282,28 @@ private:
     VkQueryPool _vkTimeStampQueryPool;
     HgiTimeQueryVector _timeQueries;
     bool _timeQueriesReset;
+    bool _resetTimeQueriesOnBegin;
+
+    // Barriers that are not recorded yet and the resources they are for.
+    VkPipelineStageFlags _pendingSrcStages;
+    VkPipelineStageFlags _pendingDstStages;
+    std::vector<VkMemoryBarrier> _pendingMemoryBarriers;
+    std::vector<VkBufferMemoryBarrier> _pendingBufferBarriers;
+    std::vector<VkImageMemoryBarrier> _pendingImageBarriers;
+    std::unordered_set<uint64_t> _pendingResources;
+
+    // Textures used by the commands and the state of their subresources in
+    // this command buffer.
+    HgiVkTrackedTextureMap _trackedTextures;
+    bool _handsOverTextureStates;
+
+    // True once commands may have sampled textures in their default state.
+    // Textures that were in `keep` of every RestoreTextureStates since then
+    // were not sampled.
+    bool _sampledDefaultStates;
+    std::vector<HgiVkTexture*> _notSampledTextures;
+
+    HgiVkBarrierStats _barrierStats;
 };
 
 typedef std::vector<HgiVkCommandBuffer*> HgiVkCommandBufferVector;
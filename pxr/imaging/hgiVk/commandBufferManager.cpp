@@ -1,23 +1,62 @@
+#include <algorithm>
+#include <unordered_map>
+
 #include "pxr/base/tf/diagnostic.h"
+#include "pxr/base/tf/envSetting.h"
 #include "pxr/imaging/hgiVk/commandBufferManager.h"
 #include "pxr/imaging/hgiVk/device.h"
 #include "pxr/imaging/hgiVk/diagnostic.h"
-#include "pxr/imaging/hgiVk/hgi.h"
+#include "pxr/imaging/hgiVk/texture.h"
 #include "pxr/imaging/hgiVk/vulkan.h"
 
 
 PXR_NAMESPACE_OPEN_SCOPE
 
-thread_local uint16_t _HgiVkcmdBufThreadLocalIndex = 0;
-thread_local uint64_t _HgiVkcmdBufThreadLocalFrame = ~0ull;
+TF_DEFINE_ENV_SETTING(HGIVK_DEFERRED_RESOURCE_RECORDING, 0,
+    "Defer recording of HgiVk resource commands until EndFrame");
+
+TF_DEFINE_ENV_SETTING(HGIVK_RESOURCE_RECORDING_WORKERS, 2,
+    "Number of workers that record deferred HgiVk resource commands");
+
+static void
+_RecordComputeToGraphicsBarrier(HgiVkCommandBuffer* cb)
+{
+    // Make compute shader writes visible to the (later) draw commands that
+    // read them as indirect arguments, vertex / index data or in shaders.
+    // Transfers count too, e.g. the culling pass fills the indirect commands
+    // with zeros and skips the dispatch when there is nothing to cull.
+    VkMemoryBarrier barrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT |
+                            VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT |
+                            VK_ACCESS_INDEX_READ_BIT |
+                            VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |
+                            VK_ACCESS_UNIFORM_READ_BIT |
+                            VK_ACCESS_SHADER_READ_BIT;
+
+    cb->AddBarrier(
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+        VK_PIPELINE_STAGE_TRANSFER_BIT,        // producer stage
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+        VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, // consumer stage
+        barrier);
+}
 
 
 HgiVkCommandBufferManager::HgiVkCommandBufferManager(HgiVkDevice* device)
     : _device(device)
     , _frame(~0ull)
-    , _nextAvailableIndex(0)
+    , _deferResourceCommands(
+        TfGetEnvSetting(HGIVK_DEFERRED_RESOURCE_RECORDING) == 1)
     , _parallelEncoderCounter(0)
+    , _transitionCommandPool(nullptr)
+    , _transitionCommandBufferCount(0)
     , _vkSemaphore(nullptr)
+    , _vkTransferSemaphore(nullptr)
+    , _vkComputeSemaphore(nullptr)
+    , _vkComputeWaitSemaphore(nullptr)
 {
     //
     // Create semaphore for gpu-gpu synchronization
@@ -32,6 +71,29 @@ HgiVkCommandBufferManager::HgiVkCommandBufferManager(HgiVkDevice* device)
             HgiVkAllocator(),
             &_vkSemaphore) == VK_SUCCESS
     );
+
+    if (_device->HasDedicatedTransferQueue()) {
+        TF_VERIFY(
+            vkCreateSemaphore(
+                _device->GetVulkanDevice(),
+                &semaCreateInfo,
+                HgiVkAllocator(),
+                &_vkTransferSemaphore) == VK_SUCCESS
+        );
+    }
+
+    if (_device->HasAsyncComputeQueue()) {
+        for (VkSemaphore* sema : {&_vkComputeSemaphore,
+                                  &_vkComputeWaitSemaphore}) {
+            TF_VERIFY(
+                vkCreateSemaphore(
+                    _device->GetVulkanDevice(),
+                    &semaCreateInfo,
+                    HgiVkAllocator(),
+                    sema) == VK_SUCCESS
+            );
+        }
+    }
 }
 
 HgiVkCommandBufferManager::~HgiVkCommandBufferManager()
@@ -43,133 +105,384 @@ HgiVkCommandBufferManager::~HgiVkCommandBufferManager()
         }
     };
 
-    deleteCmdBufsFn(_resourceCommandBuffers);
-    deleteCmdBufsFn(_drawCommandBuffers);
-    deleteCmdBufsFn(_secondaryDrawCommandBuffers);
+    _threadCommandBuffers.ForEach(
+        [&deleteCmdBufsFn](_ThreadCommandBuffers& tcb) {
+            delete tcb.resourceCommandBuffer;
+            delete tcb.drawCommandBuffer;
+            delete tcb.transferCommandBuffer;
+            delete tcb.computeCommandBuffer;
+            deleteCmdBufsFn(tcb.secondaryDrawCommandBuffers);
+
+            delete tcb.commandPool;
+            delete tcb.transferCommandPool;
+            delete tcb.computeCommandPool;
+        });
+
+    deleteCmdBufsFn(_deferredCommandBuffers);
 
-    for (HgiVkCommandPool* cp : _commandPools) {
+    for (HgiVkCommandPool* cp : _deferredCommandPools) {
         delete cp;
     }
 
+    deleteCmdBufsFn(_transitionCommandBuffers);
+    delete _transitionCommandPool;
+
     vkDestroySemaphore(
         _device->GetVulkanDevice(),
         _vkSemaphore, HgiVkAllocator());
+
+    if (_vkTransferSemaphore) {
+        vkDestroySemaphore(
+            _device->GetVulkanDevice(),
+            _vkTransferSemaphore, HgiVkAllocator());
+    }
+
+    for (VkSemaphore sema : {_vkComputeSemaphore, _vkComputeWaitSemaphore}) {
+        if (sema) {
+            vkDestroySemaphore(
+                _device->GetVulkanDevice(),
+                sema, HgiVkAllocator());
+        }
+    }
 }
 
 void
 HgiVkCommandBufferManager::BeginFrame(uint64_t frame)
 {
-    // Change the frame counter. This will let each thread know that they
-    // must re-initializes themselves the next time the thread wants to use
-    // the command buffers. They know this by comparing the frame they stored
-    // thread-locally with _frame. If the number does not match the threads re-
-    // acquire the thread's command buffer.
     _frame = frame;
 
     // Collect all time queries from previous run before resetting.
     _timeQueries.clear();
 
-    auto mergeQueriesFn = [this](HgiVkCommandBufferVector const& v) -> void {
-        for (HgiVkCommandBuffer* cb : v) {
-            if (!cb) continue;
-            HgiTimeQueryVector const& q = cb->GetTimeQueries();
-            _timeQueries.insert(_timeQueries.end(), q.begin(), q.end());
-        }
+    auto mergeQueriesFn = [this](HgiVkCommandBuffer* cb) -> void {
+        if (!cb) return;
+        HgiTimeQueryVector const& q = cb->GetTimeQueries();
+        _timeQueries.insert(_timeQueries.end(), q.begin(), q.end());
     };
 
-    mergeQueriesFn(_resourceCommandBuffers);
-    mergeQueriesFn(_drawCommandBuffers);
-    mergeQueriesFn(_secondaryDrawCommandBuffers);
+    _threadCommandBuffers.ForEach(
+        [&mergeQueriesFn](_ThreadCommandBuffers& tcb) {
+            mergeQueriesFn(tcb.transferCommandBuffer);
+            mergeQueriesFn(tcb.resourceCommandBuffer);
+            mergeQueriesFn(tcb.computeCommandBuffer);
+            mergeQueriesFn(tcb.drawCommandBuffer);
+            for (HgiVkCommandBuffer* cb : tcb.secondaryDrawCommandBuffers) {
+                mergeQueriesFn(cb);
+            }
+        });
+
+    for (HgiVkCommandBuffer* cb : _deferredCommandBuffers) {
+        mergeQueriesFn(cb);
+    }
 
+    // Add the cpu time the queue submissions of the previous run took.
+    // The gpu has completed the previous run of this frame, so all of its
+    // submissions were handed to the queues and the futures are ready.
+    for (auto const& it : _submitFutures) {
+        if (!it.second.valid()) continue;
+        HgiTimeQuery query;
+        query.name = it.first;
+        query.nanoSeconds = it.second.get();
+        _timeQueries.emplace_back(std::move(query));
+    }
+    _submitFutures.clear();
 
     // Reset all command pools of the frame to re-use the command buffers.
-    for (HgiVkCommandPool* cp : _commandPools) {
+    // No thread records into this frame's command buffers during BeginFrame.
+    _threadCommandBuffers.ForEach([](_ThreadCommandBuffers& tcb) {
+        for (HgiVkCommandPool* cp : {tcb.commandPool,
+                                     tcb.transferCommandPool,
+                                     tcb.computeCommandPool}) {
+            if (cp) cp->ResetCommandPool();
+        }
+    });
+
+    for (HgiVkCommandPool* cp : _deferredCommandPools) {
         cp->ResetCommandPool();
     }
 
-    // Make sure there are enough command buffers and pools. One per thread.
-    _CreatePoolsAndBuffers();
+    if (_transitionCommandPool) {
+        _transitionCommandPool->ResetCommandPool();
+    }
+    _transitionCommandBufferCount = 0;
+
+    _CreateDeferredPoolsAndBuffers();
 
     // Reset all time queries for all available command buffers.
     // We do this here instead of in HgiVkCommandBuffer::_BeginRecording,
     // because this reset must happen before any render pass is started.
-    // Secondary command buffers are created on-demand so they may not be ready
-    // yet. As a consequence they will not be able to record time stamps until
+    // Command buffers are created on-demand so they may not be ready yet.
+    // As a consequence they will not be able to record time stamps until
     // a few frames after they have been created.
     HgiVkCommandBuffer* primaryCB = GetResourceCommandBuffer();
 
-    auto resetQueriesFn = [this, primaryCB](HgiVkCommandBufferVector const& v) {
-        for (HgiVkCommandBuffer* cb : v) {
-            if (!cb) continue;
-            cb->ResetTimeQueries(primaryCB);
-        }
+    auto resetQueriesFn = [primaryCB](HgiVkCommandBuffer* cb) {
+        if (!cb) return;
+        cb->ResetTimeQueries(primaryCB);
     };
 
-    resetQueriesFn(_resourceCommandBuffers);
-    resetQueriesFn(_drawCommandBuffers);
-    resetQueriesFn(_secondaryDrawCommandBuffers);
+    _threadCommandBuffers.ForEach(
+        [&resetQueriesFn](_ThreadCommandBuffers& tcb) {
+            resetQueriesFn(tcb.resourceCommandBuffer);
+            resetQueriesFn(tcb.drawCommandBuffer);
+
+            // The compute cmds wait for the resource cmds (that hold the
+            // resets), but the transfer cmds are submitted before them.
+            resetQueriesFn(tcb.computeCommandBuffer);
+            if (HgiVkCommandBuffer* tcmd = tcb.transferCommandBuffer) {
+                tcmd->ResetTimeQueries(tcmd);
+            }
+            for (HgiVkCommandBuffer* cb : tcb.secondaryDrawCommandBuffers) {
+                resetQueriesFn(cb);
+            }
+        });
+
+    for (HgiVkCommandBuffer* cb : _deferredCommandBuffers) {
+        resetQueriesFn(cb);
+    }
 }
 
 void
-HgiVkCommandBufferManager::EndFrame(VkFence fence)
+HgiVkCommandBufferManager::EndFrame()
 {
-    // Build a list of all resource command buffers to submit.
-    std::vector<VkCommandBuffer> resourceCmds;
-    resourceCmds.reserve(_resourceCommandBuffers.size());
-
-    for (HgiVkCommandBuffer* cb : _resourceCommandBuffers) {
-        if (cb->IsRecording()) {
-            cb->EndRecording();
-            resourceCmds.push_back(cb->GetVulkanCommandBuffer());
+    // Record any resource commands that are still in the deferred queue.
+    FlushResourceCommands();
+
+    const bool asyncCompute = _device->HasAsyncComputeQueue();
+
+    _barrierStats = HgiVkBarrierStats();
+
+    // Deferred resource commands go first. They initialize new resources which
+    // the resource commands that were recorded immediately may depend on.
+    HgiVkCommandBufferVector transferCBs;
+    HgiVkCommandBufferVector resourceCBs = _deferredCommandBuffers;
+    HgiVkCommandBufferVector computeCBs;
+    HgiVkCommandBufferVector drawCBs;
+
+    // Build the lists of all command buffers of all threads to submit.
+    _threadCommandBuffers.ForEach(
+        [&](_ThreadCommandBuffers& tcb) {
+            transferCBs.push_back(tcb.transferCommandBuffer);
+            resourceCBs.push_back(tcb.resourceCommandBuffer);
+            computeCBs.push_back(tcb.computeCommandBuffer);
+            drawCBs.push_back(tcb.drawCommandBuffer);
+        });
+
+    // Without an async compute queue, the compute command buffers run on the
+    // graphics queue ahead of the draw command buffers. A barrier at the end
+    // of each compute command buffer makes its writes visible to the draws.
+    if (!asyncCompute) {
+        for (HgiVkCommandBuffer* ccb : computeCBs) {
+            if (ccb && ccb->IsRecording()) {
+                _RecordComputeToGraphicsBarrier(ccb);
+            }
         }
+        drawCBs.insert(drawCBs.begin(), computeCBs.begin(), computeCBs.end());
+        computeCBs.clear();
     }
 
-    // Build a list of all draw command buffers to submit.
+    std::vector<VkCommandBuffer> transferCmds;
+    std::vector<VkCommandBuffer> resourceCmds;
+    std::vector<VkCommandBuffer> computeCmds;
     std::vector<VkCommandBuffer> drawCmds;
-    drawCmds.reserve(_drawCommandBuffers.size());
 
-    for (HgiVkCommandBuffer* cb : _drawCommandBuffers) {
-        if (cb->IsRecording()) {
-            cb->EndRecording();
-            drawCmds.push_back(cb->GetVulkanCommandBuffer());
-        }
+    for (HgiVkCommandBuffer* cb : transferCBs) {
+        _EndRecording(cb, &transferCmds);
     }
 
-    // We submit resource cmds followed by draw cmds.
-    // The draw cmds wait for the resource cmds to signal a semaphore so that
-    // all resources are in the correct state before draw cmds use them.
-    std::vector<VkSubmitInfo> submitInfos;
+    for (HgiVkCommandBuffer* cb : computeCBs) {
+        _EndRecording(cb, &computeCmds);
+    }
+
+    // Textures are back in their default state at the end of each graphics
+    // queue submission, the other queues expect them in that state.
+    _HandOverTextureStates(resourceCBs, &resourceCmds);
+    _HandOverTextureStates(drawCBs, &drawCmds);
+
+    // Submit the uploads recorded for the dedicated transfer queue first.
+    // They signal a semaphore the first graphics submission waits on. The
+    // graphics queue acquires ownership of the uploaded resources in the
+    // resource command buffers, so we wait at the transfer stage.
+    if (!transferCmds.empty()) {
+        VkSubmitInfo transferInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+        transferInfo.commandBufferCount = (uint32_t) transferCmds.size();
+        transferInfo.pCommandBuffers = transferCmds.data();
+        transferInfo.signalSemaphoreCount = 1;
+        transferInfo.pSignalSemaphores = &_vkTransferSemaphore;
+        _submitFutures.emplace_back(
+            "Submit Transfer (CPU)",
+            _device->SubmitToTransferQueue({transferInfo}, VK_NULL_HANDLE));
+    }
+
+    // The semaphores and stage masks below must outlive the submits,
+    // the submit infos point to them.
+    const VkPipelineStageFlags transferWaitMask =
+        VK_PIPELINE_STAGE_TRANSFER_BIT;
+    // Compute cmds may start with transfers (E.g. vkCmdFillBuffer) before
+    // their dispatches.
+    const VkPipelineStageFlags computeWaitMask =
+        VK_PIPELINE_STAGE_TRANSFER_BIT |
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+    // We submit resource cmds followed by compute and draw cmds.
+    // The compute and draw cmds wait for the resource cmds to signal a
+    // semaphore so that all resources are in the correct state before they
+    // use them.
+    std::vector<VkSubmitInfo> resourceInfos;
+
+    VkSemaphore resourceSignals[2];
+    uint32_t resourceSignalCount = 0;
 
     if (!resourceCmds.empty()) {
+        if (!drawCmds.empty()) {
+            resourceSignals[resourceSignalCount++] = _vkSemaphore;
+        }
+        if (!computeCmds.empty()) {
+            resourceSignals[resourceSignalCount++] = _vkComputeWaitSemaphore;
+        }
+
         VkSubmitInfo resourceInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
         resourceInfo.commandBufferCount = (uint32_t) resourceCmds.size();
         resourceInfo.pCommandBuffers = resourceCmds.data();
-        if (!drawCmds.empty()) {
-            resourceInfo.signalSemaphoreCount = 1;
-            resourceInfo.pSignalSemaphores = &_vkSemaphore;
+        resourceInfo.signalSemaphoreCount = resourceSignalCount;
+        resourceInfo.pSignalSemaphores = resourceSignals;
+        if (!transferCmds.empty()) {
+            resourceInfo.waitSemaphoreCount = 1;
+            resourceInfo.pWaitSemaphores = &_vkTransferSemaphore;
+            resourceInfo.pWaitDstStageMask = &transferWaitMask;
         }
-        submitInfos.emplace_back(std::move(resourceInfo));
+        resourceInfos.emplace_back(std::move(resourceInfo));
     }
 
+    // Binary semaphores must be signaled before a wait on them is submitted,
+    // so the resource cmds go to the graphics queue before the compute cmds.
+    _submitFutures.emplace_back(
+        "Submit Resources (CPU)",
+        _device->SubmitToQueue(resourceInfos, VK_NULL_HANDLE));
+
+    // Compute cmds run on the async compute queue alongside the graphics
+    // queue. They signal a semaphore the draw cmds wait on.
+    //
+    // Nothing else orders them after the draw cmds of the previous frame,
+    // which may still read the buffers and images the compute cmds write
+    // (write-after-read). So they also wait for the frame timeline to reach
+    // the previous frame. The timeline is signaled after all graphics cmds of
+    // a frame. Only the stages that write (transfers and dispatches) wait, so
+    // e.g. indirect dispatch argument reads can start before that.
+    const VkPipelineStageFlags previousFrameWaitMask = computeWaitMask;
+    const uint64_t previousFrameValue = _frame > 0 ? _frame - 1 : 0;
+
+    VkSemaphore computeWaits[2];
+    VkPipelineStageFlags computeWaitMasks[2];
+    uint64_t computeWaitValues[2];
+    uint32_t computeWaitCount = 0;
+
+    VkTimelineSemaphoreSubmitInfoKHR computeTimelineInfo =
+        {VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR};
+
+    if (!computeCmds.empty()) {
+        VkSubmitInfo computeInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+        computeInfo.commandBufferCount = (uint32_t) computeCmds.size();
+        computeInfo.pCommandBuffers = computeCmds.data();
+        computeInfo.signalSemaphoreCount = 1;
+        computeInfo.pSignalSemaphores = &_vkComputeSemaphore;
+
+        computeWaits[computeWaitCount] = _device->GetVulkanTimelineSemaphore();
+        computeWaitMasks[computeWaitCount] = previousFrameWaitMask;
+        computeWaitValues[computeWaitCount++] = previousFrameValue;
+
+        // Binary semaphore, its wait value is ignored.
+        if (!resourceCmds.empty()) {
+            computeWaits[computeWaitCount] = _vkComputeWaitSemaphore;
+            computeWaitMasks[computeWaitCount] = computeWaitMask;
+            computeWaitValues[computeWaitCount++] = 0;
+        }
+
+        computeTimelineInfo.waitSemaphoreValueCount = computeWaitCount;
+        computeTimelineInfo.pWaitSemaphoreValues = computeWaitValues;
+
+        computeInfo.pNext = &computeTimelineInfo;
+        computeInfo.waitSemaphoreCount = computeWaitCount;
+        computeInfo.pWaitSemaphores = computeWaits;
+        computeInfo.pWaitDstStageMask = computeWaitMasks;
+
+        _submitFutures.emplace_back(
+            "Submit Compute (CPU)",
+            _device->SubmitToComputeQueue({computeInfo}, VK_NULL_HANDLE));
+    }
+
+    // Semaphores the first graphics batch after the compute submission must
+    // wait on. That is the draw cmds, or the frame timeline signal when there
+    // are no draw cmds.
+    VkSemaphore waitSemaphores[3];
+    VkPipelineStageFlags waitMasks[3];
+    uint32_t waitCount = 0;
+
+    if (!resourceCmds.empty() && !drawCmds.empty()) {
+        waitSemaphores[waitCount] = _vkSemaphore;
+        waitMasks[waitCount++] = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    }
+
+    // The resource cmds already waited on the transfer queue.
+    if (resourceCmds.empty() && !transferCmds.empty()) {
+        waitSemaphores[waitCount] = _vkTransferSemaphore;
+        waitMasks[waitCount++] = transferWaitMask;
+    }
+
+    // Compute results (e.g. skinned points or indirect draw arguments) may
+    // be consumed as indirect arguments, vertex data, in shaders or copied.
+    if (!computeCmds.empty()) {
+        waitSemaphores[waitCount] = _vkComputeSemaphore;
+        waitMasks[waitCount++] = drawCmds.empty() ?
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT :
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+            VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+            VK_PIPELINE_STAGE_TRANSFER_BIT;
+    }
+
+    std::vector<VkSubmitInfo> submitInfos;
+
     if (!drawCmds.empty()) {
         VkSubmitInfo drawInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
         drawInfo.commandBufferCount = (uint32_t) drawCmds.size();
         drawInfo.pCommandBuffers = drawCmds.data();
-        if (!resourceCmds.empty()) {
-            drawInfo.waitSemaphoreCount = 1;
-            drawInfo.pWaitSemaphores = &_vkSemaphore;
-            VkPipelineStageFlags waitMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-            drawInfo.pWaitDstStageMask = &waitMask;
-        }
         submitInfos.emplace_back(std::move(drawInfo));
     }
 
-    // Commit all recorded resource and draw commands from all threads.
-    _device->SubmitToQueue(submitInfos, fence);
+    // Signal the frame timeline. A semaphore signal operation waits for all
+    // commands that occur earlier in submission order, so this empty batch
+    // completes once the resource and draw cmds above have been consumed.
+    // We always submit this, even if no commands were recorded, since the
+    // frame may only be re-used once the timeline reached this frame.
+    VkSemaphore timelineSemaphore = _device->GetVulkanTimelineSemaphore();
+    const uint64_t timelineValue = _frame;
+
+    VkTimelineSemaphoreSubmitInfoKHR timelineInfo =
+        {VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR};
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &timelineValue;
+
+    VkSubmitInfo frameInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    frameInfo.pNext = &timelineInfo;
+    frameInfo.signalSemaphoreCount = 1;
+    frameInfo.pSignalSemaphores = &timelineSemaphore;
+    submitInfos.emplace_back(std::move(frameInfo));
+
+    if (waitCount > 0) {
+        VkSubmitInfo& first = submitInfos.front();
+        first.waitSemaphoreCount = waitCount;
+        first.pWaitSemaphores = waitSemaphores;
+        first.pWaitDstStageMask = waitMasks;
+    }
+
+    // Commit all recorded draw commands from all threads.
+    _submitFutures.emplace_back(
+        "Submit Draw (CPU)",
+        _device->SubmitToQueue(submitInfos, VK_NULL_HANDLE));
 
-    // Next frame's threads must re-acquire a command buffer, so reset index.
-    // (Same applies to parallel encoders)
-    _nextAvailableIndex.store(0);
+    // Next frame's parallel encoders start with id 0 again.
     _parallelEncoderCounter = 0;
 }
 
@@ -177,59 +490,66 @@ HgiVkCommandBuffer*
 HgiVkCommandBufferManager::GetResourceCommandBuffer()
 {
     /* MULTI-THREAD CALL*/
+    return _GetThreadCommandBuffers().resourceCommandBuffer;
+}
 
-    // First ensure this thread has an unique index into the cmd buffer vector.
-    _UpdateThreadLocalIndex();
-
-    if (_HgiVkcmdBufThreadLocalIndex >= _resourceCommandBuffers.size()) {
-        TF_CODING_ERROR("cmdBuf numThreads > HgiVk::GetThreadCount");
-        _HgiVkcmdBufThreadLocalIndex = 0;
-    }
+HgiVkCommandBuffer*
+HgiVkCommandBufferManager::GetDrawCommandBuffer()
+{
+    /* MULTI-THREAD CALL*/
+    return _GetThreadCommandBuffers().drawCommandBuffer;
+}
 
-    return _resourceCommandBuffers[_HgiVkcmdBufThreadLocalIndex];
+HgiVkCommandBuffer*
+HgiVkCommandBufferManager::GetTransferCommandBuffer()
+{
+    /* MULTI-THREAD CALL*/
+    if (!_device->HasDedicatedTransferQueue()) return nullptr;
+    return _GetThreadCommandBuffers().transferCommandBuffer;
 }
 
 HgiVkCommandBuffer*
-HgiVkCommandBufferManager::GetDrawCommandBuffer()
+HgiVkCommandBufferManager::GetComputeCommandBuffer()
 {
     /* MULTI-THREAD CALL*/
+    return _GetThreadCommandBuffers().computeCommandBuffer;
+}
+
+bool
+HgiVkCommandBufferManager::IsDeferringResourceCommands() const
+{
+    return _deferResourceCommands;
+}
 
-    // First ensure this thread has an unique index into the cmd buffer vector.
-    _UpdateThreadLocalIndex();
+void
+HgiVkCommandBufferManager::DeferResourceCommand(
+    HgiVkResourceCommand const& cmd)
+{
+    /* MULTI-THREAD CALL*/
 
-    if (_HgiVkcmdBufThreadLocalIndex >= _drawCommandBuffers.size()) {
-        TF_CODING_ERROR("cmdBuf numThreads > HgiVk::GetThreadCount");
-        _HgiVkcmdBufThreadLocalIndex = 0;
+    if (!TF_VERIFY(_deferResourceCommands,
+        "Deferred resource recording is not enabled")) {
+        return;
     }
 
-    return _drawCommandBuffers[_HgiVkcmdBufThreadLocalIndex];
+    _resourceCommandQueue.Push(cmd);
+}
+
+void
+HgiVkCommandBufferManager::FlushResourceCommands()
+{
+    if (_resourceCommandQueue.IsEmpty()) return;
+    _resourceCommandQueue.Record(_deferredCommandBuffers);
 }
 
 size_t
 HgiVkCommandBufferManager::ReserveSecondaryDrawBuffersForParallelEncoder()
 {
-    size_t index = _parallelEncoderCounter;
-    _parallelEncoderCounter++;
-
-    unsigned numThreads = HgiVk::GetThreadCount();
-    size_t currentSize = _secondaryDrawCommandBuffers.size();
-    size_t requiredSize = _parallelEncoderCounter*numThreads;
-
-    if (requiredSize > currentSize) {
-        // Important! We only make room for the extra command buffers, but we do
-        // not allocate them until GetSecondaryDrawCommandBuffer().
-        // We need to wait until we can be sure the thread has exclusive access
-        // to the command pool that will allocate the new command buffer!
-        // We can't be fully sure of that here. There may be another thread that
-        // is currently doing rendering work (e.g. UI thread).
-        // So why make room now? Because the parallel encoder calls this
-        // before any threading has started, so we can safely resize the vector.
-        // During GetSecondaryDrawCommandBuffer we will be wide and shouldn't
-        // change the size of the vector.
-        _secondaryDrawCommandBuffers.resize(requiredSize, nullptr);
-    }
-
-    return index;
+    // We do not allocate the secondary command buffers here. We need to wait
+    // until GetSecondaryDrawCommandBuffer() where we can be sure the thread
+    // has exclusive access to the command pool that will allocate the new
+    // command buffer.
+    return _parallelEncoderCounter++;
 }
 
 HgiVkCommandBuffer*
@@ -237,41 +557,35 @@ HgiVkCommandBufferManager::GetSecondaryDrawCommandBuffer(size_t id)
 {
     /* MULTI-THREAD CALL*/
 
-    // First ensure this thread has an unique index into the cmd buffer vector.
-    _UpdateThreadLocalIndex();
+    _ThreadCommandBuffers& tcb = _GetThreadCommandBuffers();
 
-    if (_HgiVkcmdBufThreadLocalIndex >= _secondaryDrawCommandBuffers.size()) {
-        TF_CODING_ERROR("cmdBuf numThreads > HgiVk::GetThreadCount");
-        _HgiVkcmdBufThreadLocalIndex = 0;
+    // Only this thread touches its own vector, so it can safely grow here.
+    HgiVkCommandBufferVector& cbs = tcb.secondaryDrawCommandBuffers;
+    if (id >= cbs.size()) {
+        cbs.resize(id + 1, nullptr);
     }
 
-    unsigned numThreads = HgiVk::GetThreadCount();
-    size_t offset = (id * numThreads) + _HgiVkcmdBufThreadLocalIndex;
-    TF_VERIFY(offset < _secondaryDrawCommandBuffers.size());
-
     // If we didn't make the secondary command buffer yet, do so now.
-    if (!_secondaryDrawCommandBuffers[offset]) {
+    if (!cbs[id]) {
 
-        // Important! make sure we always use the same command pool at the
-        // same vector index as resource and draw primary command buffers.
-        // A threadpool cannot be used by two different threads at the same
+        // Important! make sure we always use the same command pool as the
+        // resource and draw primary command buffers of this thread.
+        // A command pool cannot be used by two different threads at the same
         // time. So if a draw command buffer is used by thread-N that same
         // thread-N can only use secondary command buffers that were also
-        // created by that same thread pool.
-        HgiVkCommandPool* cp = _commandPools[_HgiVkcmdBufThreadLocalIndex];
-
+        // created by that same command pool.
         HgiVkCommandBuffer* cb = new HgiVkCommandBuffer(
             _device,
-            cp,
+            tcb.commandPool,
             HgiVkCommandBufferUsageSecondaryRenderPass);
 
         std::string debugLabel = "Secondary " + _debugName;
         cb->SetDebugName(debugLabel.c_str());
 
-        _secondaryDrawCommandBuffers[offset] = cb;
+        cbs[id] = cb;
     }
 
-    return _secondaryDrawCommandBuffers[offset];
+    return cbs[id];
 }
 
 void
@@ -279,27 +593,22 @@ HgiVkCommandBufferManager::ExecuteSecondaryCommandBuffers(
     size_t id,
     HgiVkCommandBuffer* primaryCommandBuffer)
 {
-    unsigned numThreads = HgiVk::GetThreadCount();
-    size_t begin = id * numThreads;
-    size_t end = begin + numThreads;
-
-    size_t vecSize = _secondaryDrawCommandBuffers.size();
-
-    if (!TF_VERIFY(primaryCommandBuffer && end <= vecSize)) {
+    if (!TF_VERIFY(primaryCommandBuffer)) {
         return;
     }
 
     std::vector<VkCommandBuffer> cbs;
-    cbs.reserve(end-begin);
-
-    // End recording on all secondary command buffers.
-    for (size_t i=begin; i<end; i++) {
-        HgiVkCommandBuffer* cb = _secondaryDrawCommandBuffers[i];
-        if (cb && cb->IsRecording()) {
-            cb->EndRecording();
-            cbs.push_back(cb->GetVulkanCommandBuffer());
-        }
-    }
+
+    // End recording on the encoder's secondary command buffers of all threads.
+    _threadCommandBuffers.ForEach(
+        [id, &cbs](_ThreadCommandBuffers& tcb) {
+            if (id >= tcb.secondaryDrawCommandBuffers.size()) return;
+            HgiVkCommandBuffer* cb = tcb.secondaryDrawCommandBuffers[id];
+            if (cb && cb->IsRecording()) {
+                cb->EndRecording();
+                cbs.push_back(cb->GetVulkanCommandBuffer());
+            }
+        });
 
     // Submit secondary command buffers into primary command buffer.
     if (!cbs.empty()) {
@@ -322,20 +631,53 @@ HgiVkCommandBufferManager::SetDebugName(std::string const& name)
         VK_DEBUG_REPORT_OBJECT_TYPE_SEMAPHORE_EXT,
         debugLabel.c_str());
 
-    for (HgiVkCommandPool* pool : _commandPools) {
-        pool->SetDebugName(name);
+    _threadCommandBuffers.ForEach([this](_ThreadCommandBuffers& tcb) {
+        _SetThreadDebugName(tcb);
+    });
+
+    if (_vkTransferSemaphore) {
+        std::string transferLabel = "Semaphore Transfer " + name;
+        HgiVkSetDebugName(
+            _device,
+            (uint64_t)_vkTransferSemaphore,
+            VK_DEBUG_REPORT_OBJECT_TYPE_SEMAPHORE_EXT,
+            transferLabel.c_str());
     }
 
-    auto setDebugNameFn = [name](HgiVkCommandBufferVector const& v) {
-        for (HgiVkCommandBuffer* cb : v) {
-            if (!cb) continue;
-            cb->SetDebugName(name.c_str());
-        }
-    };
 
-    setDebugNameFn(_resourceCommandBuffers);
-    setDebugNameFn(_drawCommandBuffers);
-    setDebugNameFn(_secondaryDrawCommandBuffers);
+    if (_vkComputeSemaphore) {
+        std::string computeLabel = "Semaphore Compute " + name;
+        HgiVkSetDebugName(
+            _device,
+            (uint64_t)_vkComputeSemaphore,
+            VK_DEBUG_REPORT_OBJECT_TYPE_SEMAPHORE_EXT,
+            computeLabel.c_str());
+
+        std::string computeWaitLabel = "Semaphore Compute Wait " + name;
+        HgiVkSetDebugName(
+            _device,
+            (uint64_t)_vkComputeWaitSemaphore,
+            VK_DEBUG_REPORT_OBJECT_TYPE_SEMAPHORE_EXT,
+            computeWaitLabel.c_str());
+    }
+
+    std::string deferredLabel = "Deferred " + name;
+    for (HgiVkCommandPool* pool : _deferredCommandPools) {
+        pool->SetDebugName(deferredLabel);
+    }
+
+    for (HgiVkCommandBuffer* cb : _deferredCommandBuffers) {
+        cb->SetDebugName(deferredLabel.c_str());
+    }
+
+    std::string transitionLabel = "Transition " + name;
+    if (_transitionCommandPool) {
+        _transitionCommandPool->SetDebugName(transitionLabel);
+    }
+
+    for (HgiVkCommandBuffer* cb : _transitionCommandBuffers) {
+        cb->SetDebugName(transitionLabel.c_str());
+    }
 }
 
 HgiTimeQueryVector const &
@@ -344,61 +686,249 @@ HgiVkCommandBufferManager::GetTimeQueries() const
     return _timeQueries;
 }
 
+HgiVkBarrierStats const &
+HgiVkCommandBufferManager::GetBarrierStats() const
+{
+    return _barrierStats;
+}
+
+HgiVkCommandBufferManager::_ThreadCommandBuffers&
+HgiVkCommandBufferManager::_GetThreadCommandBuffers()
+{
+    /* MULTI-THREAD CALL*/
+
+    // Hydra will spawn multiple threads when syncing prims.
+    // We want each mesh, curve, etc to be able to record vulkan commands into
+    // a command buffer for parallel recording.
+    // Each thread owns the pools and buffers at its thread slot, so only the
+    // calling thread creates or uses them here.
+    _ThreadCommandBuffers& tcb = _threadCommandBuffers.Get();
+    if (tcb.commandPool) {
+        return tcb;
+    }
+
+    HgiVkCommandPool* cp = new HgiVkCommandPool(_device);
+
+    tcb.resourceCommandBuffer = new HgiVkCommandBuffer(
+        _device,
+        cp,
+        HgiVkCommandBufferUsagePrimary);
+
+    tcb.drawCommandBuffer = new HgiVkCommandBuffer(
+        _device,
+        cp,
+        HgiVkCommandBufferUsagePrimary);
+
+    // Texture states are handed over between the command buffers of a
+    // graphics queue submission (see _HandOverTextureStates).
+    tcb.resourceCommandBuffer->SetHandsOverTextureStates(true);
+    tcb.drawCommandBuffer->SetHandsOverTextureStates(true);
+
+    // Transfer queue command buffers need a pool of the transfer family.
+    if (_device->HasDedicatedTransferQueue()) {
+        tcb.transferCommandPool = new HgiVkCommandPool(
+            _device,
+            _device->GetVulkanTransferQueueFamilyIndex());
+
+        tcb.transferCommandBuffer = new HgiVkCommandBuffer(
+            _device,
+            tcb.transferCommandPool,
+            HgiVkCommandBufferUsagePrimary);
+    }
+
+    // Compute command buffers need a pool of the compute family. When
+    // compute is submitted to a queue of the graphics family we can use
+    // the same pool as the resource and draw command buffers.
+    HgiVkCommandPool* ccp = cp;
+    uint32_t computeFamily = _device->GetVulkanComputeQueueFamilyIndex();
+    if (computeFamily != _device->GetVulkanDeviceQueueFamilyIndex()) {
+        tcb.computeCommandPool = new HgiVkCommandPool(_device, computeFamily);
+        ccp = tcb.computeCommandPool;
+    }
+
+    tcb.computeCommandBuffer = new HgiVkCommandBuffer(
+        _device,
+        ccp,
+        HgiVkCommandBufferUsagePrimary);
+
+    // Without an async compute queue they are submitted with the draws.
+    if (!_device->HasAsyncComputeQueue()) {
+        tcb.computeCommandBuffer->SetHandsOverTextureStates(true);
+    }
+
+    // Set last, ForEach callers skip threads without a pool.
+    tcb.commandPool = cp;
+
+    _SetThreadDebugName(tcb);
+
+    return tcb;
+}
+
 void
-HgiVkCommandBufferManager::_CreatePoolsAndBuffers()
+HgiVkCommandBufferManager::_EndRecording(
+    HgiVkCommandBuffer* cb,
+    std::vector<VkCommandBuffer>* cmds)
 {
-    unsigned numThreads = HgiVk::GetThreadCount();
+    if (!cb || !cb->IsRecording()) return;
 
-    // Unlikely, but the max number of threads may have changed between frames.
-    // If that happens, we grow the primary command buffers and pools.
-    size_t currentSize = _resourceCommandBuffers.size();
+    cb->EndRecording();
+    cmds->push_back(cb->GetVulkanCommandBuffer());
 
-    for (size_t i=currentSize; i<numThreads; i++) {
-        HgiVkCommandPool* cp = new HgiVkCommandPool(_device);
-        _commandPools.push_back(cp);
+    HgiVkBarrierStats const& stats = cb->GetBarrierStats();
+    _barrierStats.barriers += stats.barriers;
+    _barrierStats.pipelineBarriers += stats.pipelineBarriers;
+}
 
-        _resourceCommandBuffers.push_back(
-            new HgiVkCommandBuffer(
-                _device,
-                cp,
-                HgiVkCommandBufferUsagePrimary)
-        );
+void
+HgiVkCommandBufferManager::_HandOverTextureStates(
+    HgiVkCommandBufferVector const& cbs,
+    std::vector<VkCommandBuffer>* cmds)
+{
+    // States the command buffers so far left the textures in. Textures that
+    // are not in the map are in their default state.
+    std::unordered_map<HgiVkTexture*, HgiVkImageStateVector> states;
+
+    // The transitions between two command buffers are recorded into a
+    // transition command buffer that is submitted between them. It only
+    // begins recording once a barrier is added to it.
+    HgiVkCommandBuffer* transitionCB = _GetTransitionCommandBuffer();
+
+    auto endTransitionsFn = [this, &transitionCB, cmds]() {
+        if (!transitionCB->IsRecording()) return;
+        _EndRecording(transitionCB, cmds);
+        transitionCB = _GetTransitionCommandBuffer();
+    };
 
-        _drawCommandBuffers.push_back(
-            new HgiVkCommandBuffer(
-                _device,
-                cp,
-                HgiVkCommandBufferUsagePrimary)
-        );
+    for (HgiVkCommandBuffer* cb : cbs) {
+        if (!cb || !cb->IsRecording()) continue;
+
+        // cb hands its states over, so ending it does not change them.
+        HgiVkTrackedTextureMap const& tracked = cb->GetTrackedTextures();
+
+        // cb expects the textures it did not track in their default state.
+        for (auto it = states.begin(); it != states.end();) {
+            HgiVkTexture* tex = it->first;
+            if (tracked.find(tex) != tracked.end()) {
+                ++it;
+                continue;
+            }
+            tex->RecordStateHandOver(
+                transitionCB,
+                it->second,
+                tex->GetDefaultStates(),
+                /*discard*/ false);
+            it = states.erase(it);
+        }
 
-        // Last loop
-        if (i==numThreads-1) {
-            // Update debug names on all new pools and buffers
-            SetDebugName(_debugName);
+        // And the textures it tracked in the states its first commands expect.
+        for (auto const& it : tracked) {
+            HgiVkTexture* tex = it.first;
+            auto prev = states.find(tex);
+            tex->RecordStateHandOver(
+                transitionCB,
+                prev != states.end() ? prev->second : tex->GetDefaultStates(),
+                it.second.initial,
+                it.second.discard);
         }
+
+        endTransitionsFn();
+        _EndRecording(cb, cmds);
+
+        for (auto const& it : tracked) {
+            states[it.first] = it.second.states;
+        }
+    }
+
+    // Return all textures to their default state at the end of the
+    // submission.
+    for (auto const& it : states) {
+        it.first->RecordStateHandOver(
+            transitionCB,
+            it.second,
+            it.first->GetDefaultStates(),
+            /*discard*/ false);
+    }
+
+    endTransitionsFn();
+
+    // The last transition command buffer was not used.
+    _transitionCommandBufferCount--;
+}
+
+HgiVkCommandBuffer*
+HgiVkCommandBufferManager::_GetTransitionCommandBuffer()
+{
+    if (!_transitionCommandPool) {
+        _transitionCommandPool = new HgiVkCommandPool(_device);
+        std::string transitionLabel = "Transition " + _debugName;
+        _transitionCommandPool->SetDebugName(transitionLabel);
     }
+
+    if (_transitionCommandBufferCount == _transitionCommandBuffers.size()) {
+        HgiVkCommandBuffer* cb = new HgiVkCommandBuffer(
+            _device,
+            _transitionCommandPool,
+            HgiVkCommandBufferUsagePrimary);
+
+        std::string transitionLabel = "Transition " + _debugName;
+        cb->SetDebugName(transitionLabel.c_str());
+
+        _transitionCommandBuffers.push_back(cb);
+    }
+
+    return _transitionCommandBuffers[_transitionCommandBufferCount++];
 }
 
 void
-HgiVkCommandBufferManager::_UpdateThreadLocalIndex()
+HgiVkCommandBufferManager::_SetThreadDebugName(_ThreadCommandBuffers& tcb)
 {
-    /* MULTI-THREAD CALL*/
+    if (!tcb.commandPool) return;
 
-    // Hydra will spawn multiple threads when syncing prims.
-    // We want each mesh, curve, etc to be able to record vulkan commands into
-    // a command buffer for parallel recording.
+    tcb.commandPool->SetDebugName(_debugName);
+    tcb.resourceCommandBuffer->SetDebugName(_debugName.c_str());
+    tcb.drawCommandBuffer->SetDebugName(_debugName.c_str());
+
+    std::string secondaryLabel = "Secondary " + _debugName;
+    for (HgiVkCommandBuffer* cb : tcb.secondaryDrawCommandBuffers) {
+        if (!cb) continue;
+        cb->SetDebugName(secondaryLabel.c_str());
+    }
+
+    std::string transferLabel = "Transfer " + _debugName;
+    if (tcb.transferCommandPool) {
+        tcb.transferCommandPool->SetDebugName(transferLabel);
+        tcb.transferCommandBuffer->SetDebugName(transferLabel.c_str());
+    }
+
+    std::string computeLabel = "Compute " + _debugName;
+    if (tcb.computeCommandPool) {
+        tcb.computeCommandPool->SetDebugName(computeLabel);
+    }
+    tcb.computeCommandBuffer->SetDebugName(computeLabel.c_str());
+}
 
-    // When such a prim asks for a command buffer we determine what buffer to
-    // return based on _HgiVkcmdBufThreadLocalIndex.
-    // This ensures each thread has an unique command buffer.
+void
+HgiVkCommandBufferManager::_CreateDeferredPoolsAndBuffers()
+{
+    // The deferred resource command buffers are created once. Their count is
+    // fixed and does not depend on the number of threads.
+    if (_deferResourceCommands && _deferredCommandBuffers.empty()) {
+        const int numWorkers =
+            std::max(1, TfGetEnvSetting(HGIVK_RESOURCE_RECORDING_WORKERS));
+
+        for (int i=0; i<numWorkers; i++) {
+            HgiVkCommandPool* cp = new HgiVkCommandPool(_device);
+            _deferredCommandPools.push_back(cp);
 
-    // When the next frame has started, each thread must re-acquire its
-    // _HgiVkcmdBufThreadLocalIndex. This protects against threads being
-    // created, destroyed or the number of threads changing between frames.
+            HgiVkCommandBuffer* cb = new HgiVkCommandBuffer(
+                _device,
+                cp,
+                HgiVkCommandBufferUsagePrimary);
+            cb->SetHandsOverTextureStates(true);
+            _deferredCommandBuffers.push_back(cb);
+        }
 
-    if (_HgiVkcmdBufThreadLocalFrame != _frame) {
-        _HgiVkcmdBufThreadLocalFrame = _frame;
-        _HgiVkcmdBufThreadLocalIndex = _nextAvailableIndex.fetch_add(1);
+        SetDebugName(_debugName);
     }
 }
 
@@ -1,14 +1,18 @@
 #ifndef PXR_IMAGING_HGIVK_COMMAND_BUFFER_MANAGER_H
 #define PXR_IMAGING_HGIVK_COMMAND_BUFFER_MANAGER_H
 
-#include <atomic>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "pxr/pxr.h"
 #include "pxr/imaging/hgiVk/api.h"
 #include "pxr/imaging/hgiVk/commandBuffer.h"
 #include "pxr/imaging/hgiVk/commandPool.h"
+#include "pxr/imaging/hgiVk/resourceCommandQueue.h"
+#include "pxr/imaging/hgiVk/submissionThread.h"
+#include "pxr/imaging/hgiVk/threadSlots.h"
 #include "pxr/imaging/hgiVk/vulkan.h"
 
 PXR_NAMESPACE_OPEN_SCOPE
@@ -24,7 +28,8 @@ class HgiVkCommandBuffer;
 /// render frame. Vulkan command pools & buffers are 'externally synchornized'.
 /// Which means we need to ensure only one thread access them at a time.
 /// The command buffer manager does this by creating a pool & buffer per thread.
-/// Thread local storage is used to assign one pool and buffer to a thread.
+/// Each thread's pool and buffers are stored at the thread's slot (See
+/// HgiVkThreadSlots) and are created the first time the thread asks for them.
 ///
 ///
 class HgiVkCommandBufferManager final
@@ -42,11 +47,15 @@ public:
     void BeginFrame(uint64_t frame);
 
     /// Should be called exactly once at the end of rendering an app frame.
-    /// The provided fence is submitted to the queue and will be signaled once
-    /// the command buffers have been consumed. This would usually be the same
-    /// fence that the Frame waits on.
+    /// The device timeline semaphore is signaled with the frame number (see
+    /// BeginFrame) once the command buffers have been consumed.
+    /// The resource and draw command buffers (and the compute command buffers
+    /// without an async compute queue) leave their textures in the state
+    /// their commands left them in. The transitions between them are recorded
+    /// here, only the end of each graphics queue submission returns the
+    /// textures to their default state (see HgiVkTexture).
     HGIVK_API
-    void EndFrame(VkFence fence);
+    void EndFrame();
 
     /// Returns a (thread_local) resource command buffer.
     /// It is guaranteed the returned command buffer is not currently being
@@ -64,9 +73,58 @@ public:
     HGIVK_API
     HgiVkCommandBuffer* GetDrawCommandBuffer();
 
-    /// Called by each parallel encoder to ensure there is enough secondary
-    /// command buffers space available. Returns the 'unique start id' of the
-    /// encoder's location in the secondary command buffer vector.
+    /// Returns a (thread_local) command buffer of the device's dedicated
+    /// transfer queue, or nullptr if the device has no such queue, in which
+    /// case uploads should be recorded in GetResourceCommandBuffer.
+    /// Resources written in this command buffer must be released to the
+    /// graphics queue family and acquired in the resource command buffer of
+    /// the same thread (See HgiVkBuffer::CopyBufferFromTransferQueue).
+    /// The transfer command buffers are submitted before the graphics command
+    /// buffers and signal a semaphore the graphics submission waits on.
+    /// Thread safety: The returned command buffer is thread_local. It is
+    /// guaranteed no other thread will use this command buffer for recording.
+    HGIVK_API
+    HgiVkCommandBuffer* GetTransferCommandBuffer();
+
+    /// Returns a (thread_local) compute command buffer.
+    /// When the device has an async compute queue these command buffers are
+    /// submitted there after the resource command buffers and the draw command
+    /// buffers wait on a semaphore they signal. Otherwise they are submitted
+    /// on the graphics queue ahead of the draw command buffers.
+    /// Resources shared with the compute queue family must be created with
+    /// VK_SHARING_MODE_CONCURRENT (See HgiVkBuffer and HgiVkTexture).
+    /// Compute command buffers wait for the draw command buffers of the
+    /// previous frame, so they do not overwrite resources those still read.
+    /// Thread safety: The returned command buffer is thread_local. It is
+    /// guaranteed no other thread will use this command buffer for recording.
+    HGIVK_API
+    HgiVkCommandBuffer* GetComputeCommandBuffer();
+
+    /// Returns true if resource commands (buffer and texture uploads) should be
+    /// deferred via DeferResourceCommand instead of being recorded immediately
+    /// into GetResourceCommandBuffer (HGIVK_DEFERRED_RESOURCE_RECORDING).
+    HGIVK_API
+    bool IsDeferringResourceCommands() const;
+
+    /// Adds a resource command to the queue of deferred commands.
+    /// The command is recorded during FlushResourceCommands or EndFrame.
+    /// Thread safety: Lock-free, may be called from any thread.
+    HGIVK_API
+    void DeferResourceCommand(HgiVkResourceCommand const& cmd);
+
+    /// Records all deferred resource commands using a fixed number of workers
+    /// (HGIVK_RESOURCE_RECORDING_WORKERS). Each worker records into its own
+    /// primary command buffer, so this bounds the number of resource command
+    /// buffers we submit, regardless of how wide Hydra's sync went.
+    /// This is called during EndFrame, but may be called earlier to spread
+    /// out the recording work.
+    /// Thread safety: Not thread safe. Must not be called from multiple threads
+    /// at once, but other threads may continue to call DeferResourceCommand.
+    HGIVK_API
+    void FlushResourceCommands();
+
+    /// Called by each parallel encoder to reserve an unique id for the
+    /// encoder's secondary command buffers this frame.
     /// This unique id is needed during GetSecondaryDrawCommandBuffer.
     /// Thread safety: Not thread safe. Must be called before any parallel
     /// rendering begins.
@@ -96,9 +154,16 @@ public:
     void SetDebugName(std::string const& name);
 
     /// Returns the time queries of all command buffers of the previous run.
+    /// This includes the cpu time of each queue submission of the previous run
+    /// (names ending in "(CPU)").
     HGIVK_API
     HgiTimeQueryVector const & GetTimeQueries() const;
 
+    /// Returns the number of barriers recorded into the command buffers that
+    /// were submitted during the last EndFrame.
+    HGIVK_API
+    HgiVkBarrierStats const & GetBarrierStats() const;
+
 private:
     HgiVkCommandBufferManager() = delete;
     HgiVkCommandBufferManager & operator= (
@@ -106,49 +171,113 @@ private:
     HgiVkCommandBufferManager(
         const HgiVkCommandBufferManager&) = delete;
 
-    // Create pools and command buffers for parallel recording.
-    void _CreatePoolsAndBuffers();
-
-    // This function ensures that each thread grabs an unique index in the
-    // command buffer vectors for the current frame.
-    void _UpdateThreadLocalIndex();
+    // The command pools and buffers of one thread.
+    struct _ThreadCommandBuffers {
+        // Resource commands and draw commands are split into seperate command
+        // buffers so we can submit the resources changes first. We want them
+        // to complete before the draw commands begin.
+        HgiVkCommandPool* commandPool = nullptr;
+        HgiVkCommandBuffer* resourceCommandBuffer = nullptr;
+        HgiVkCommandBuffer* drawCommandBuffer = nullptr;
+
+        // Secondary draw command buffers are used to parallize rendering into
+        // a render pass. Indexed by the id of the parallel encoder and grown
+        // as needed. They are allocated from commandPool.
+        HgiVkCommandBufferVector secondaryDrawCommandBuffers;
+
+        // Command buffer and pool of the dedicated transfer queue.
+        // nullptr if the device has no dedicated transfer queue.
+        HgiVkCommandPool* transferCommandPool = nullptr;
+        HgiVkCommandBuffer* transferCommandBuffer = nullptr;
+
+        // If the compute queue is of the graphics family the compute command
+        // buffer uses commandPool and computeCommandPool is nullptr.
+        HgiVkCommandPool* computeCommandPool = nullptr;
+        HgiVkCommandBuffer* computeCommandBuffer = nullptr;
+    };
+
+    typedef HgiVkThreadSlotArray<_ThreadCommandBuffers>
+        _ThreadCommandBuffersArray;
+
+    // Returns the pools and command buffers of the calling thread, creating
+    // them the first time the thread asks for them.
+    _ThreadCommandBuffers& _GetThreadCommandBuffers();
+
+    // Sets the debug name on the pools and command buffers of one thread.
+    void _SetThreadDebugName(_ThreadCommandBuffers& tcb);
+
+    // Create pools and command buffers for deferred resource recording.
+    void _CreateDeferredPoolsAndBuffers();
+
+    // Ends recording of `cb` if it is recording and adds it to `cmds`.
+    void _EndRecording(
+        HgiVkCommandBuffer* cb,
+        std::vector<VkCommandBuffer>* cmds);
+
+    // Ends recording of the command buffers of one queue submission and
+    // adds them to `cmds` in order. Between them transition command buffers
+    // take each texture from the state the earlier command buffers left it
+    // in to the state the next one expects, and after the last one back to
+    // its default state.
+    void _HandOverTextureStates(
+        HgiVkCommandBufferVector const& cbs,
+        std::vector<VkCommandBuffer>* cmds);
+
+    // Returns the next unused transition command buffer of this frame.
+    HgiVkCommandBuffer* _GetTransitionCommandBuffer();
 
 private:
     HgiVkDevice* _device;
 
     uint64_t _frame;
 
-    // This index is reset each frame and allows each thread to grab an
-    // unique index into the command buffer and descriptor pool vectors.
-    std::atomic<uint16_t> _nextAvailableIndex;
-
-    // These are the primary command buffers.
-    // Resource commands and draw commands are split into seperate command
-    // buffers so we can submit the resources changes first. We want them to
-    // complete before the draw commands begin.
-    // The vectors hold a command buffer for each thread.
-    HgiVkCommandBufferVector _resourceCommandBuffers;
-    HgiVkCommandBufferVector _drawCommandBuffers;
-
-    // Secondary draw command buffers are used to parallize rendering into a
-    // render pass. This vector is grown dynamically as needed by parallel
-    // command encoders.
-    HgiVkCommandBufferVector _secondaryDrawCommandBuffers;
+    // Pools and command buffers for each thread that recorded commands.
+    // The command pools are 'externally synchronized', so each thread
+    // allocates from its own pool. A thread keeps its slot across frames.
+    _ThreadCommandBuffersArray _threadCommandBuffers;
 
-    // One command pool per primary command buffer, per thread.
-    HgiVkCommandPoolVector _commandPools;
+    // Deferred resource recording. Resource commands are collected in a queue
+    // and recorded by a fixed number of workers into their own command buffer
+    // (and pool), instead of one resource command buffer per sync thread.
+    bool _deferResourceCommands;
+    HgiVkResourceCommandQueue _resourceCommandQueue;
+    HgiVkCommandBufferVector _deferredCommandBuffers;
+    HgiVkCommandPoolVector _deferredCommandPools;
 
     // This counter keeps track of how many parallel encoders are used each
     // frame so we can make sure we have enough secondary command buffers.
     uint16_t _parallelEncoderCounter;
 
+    // Command buffers that hold the texture transitions between the command
+    // buffers of a queue submission. Only EndFrame records into them.
+    HgiVkCommandPool* _transitionCommandPool;
+    HgiVkCommandBufferVector _transitionCommandBuffers;
+    size_t _transitionCommandBufferCount;
+
     // This semaphore is used to synchronize the submission of resource and draw
     // command buffers.
     VkSemaphore _vkSemaphore;
 
+    // This semaphore is signaled by the transfer queue submission and waited
+    // on by the first graphics queue submission of the frame.
+    VkSemaphore _vkTransferSemaphore;
+
+    // Async compute. The resource submission signals the compute wait
+    // semaphore that the compute submission waits on. The compute submission
+    // signals the compute semaphore the draw submission waits on.
+    VkSemaphore _vkComputeSemaphore;
+    VkSemaphore _vkComputeWaitSemaphore;
+
+    // Queue submissions of the previous run, used to report the cpu time
+    // each submission took as part of the time queries.
+    std::vector<std::pair<std::string, HgiVkSubmitFuture>> _submitFutures;
+
     // Time queries of previous run.
     HgiTimeQueryVector _timeQueries;
 
+    // Barrier counts of the command buffers submitted in the last EndFrame.
+    HgiVkBarrierStats _barrierStats;
+
     // Debug label
     std::string _debugName;
 };
@@ -7,7 +7,9 @@
 PXR_NAMESPACE_OPEN_SCOPE
 
 
-HgiVkCommandPool::HgiVkCommandPool(HgiVkDevice* device)
+HgiVkCommandPool::HgiVkCommandPool(
+    HgiVkDevice* device,
+    uint32_t queueFamilyIndex)
     : _device(device)
     , _vkCommandPool(nullptr)
 {
@@ -15,9 +17,11 @@ HgiVkCommandPool::HgiVkCommandPool(HgiVkDevice* device)
         {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
     poolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
 
-    // XXX If Graphics and Compute were to come from different queue families we
-    // would need to use a different commandpool/buffer for gfx and compute.
-    poolCreateInfo.queueFamilyIndex = device->GetVulkanDeviceQueueFamilyIndex();
+    // Command buffers can only be submitted to queues of the family the pool
+    // was created for. E.g. the dedicated transfer queue needs its own pools.
+    poolCreateInfo.queueFamilyIndex =
+        queueFamilyIndex == VK_QUEUE_FAMILY_IGNORED ?
+        device->GetVulkanDeviceQueueFamilyIndex() : queueFamilyIndex;
 
     TF_VERIFY(
         vkCreateCommandPool(
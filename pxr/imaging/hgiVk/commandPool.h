@@ -20,8 +20,12 @@ class HgiVkDevice;
 class HgiVkCommandPool final
 {
 public:
+    /// Creates a command pool for the provided queue family.
+    /// By default the pool is created for the graphics queue of the device.
     HGIVK_API
-    HgiVkCommandPool(HgiVkDevice* device);
+    HgiVkCommandPool(
+        HgiVkDevice* device,
+        uint32_t queueFamilyIndex = VK_QUEUE_FAMILY_IGNORED);
 
     HGIVK_API
     virtual ~HgiVkCommandPool();
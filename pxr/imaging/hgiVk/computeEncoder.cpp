@@ -1,5 +1,6 @@
 #include "pxr/imaging/hgiVk/computeEncoder.h"
 
+#include "pxr/imaging/hgiVk/commandBuffer.h"
 #include "pxr/imaging/hgiVk/device.h"
 #include "pxr/imaging/hgiVk/diagnostic.h"
 #include "pxr/imaging/hgiVk/pipeline.h"
@@ -14,7 +15,7 @@ HgiVkComputeEncoder::HgiVkComputeEncoder(
     HgiVkCommandBuffer* cb)
     : HgiComputeEncoder()
     , _device(device)
-    , _commandBuffer(_commandBuffer)
+    , _commandBuffer(cb)
     , _isRecording(true)
 {
 }
@@ -37,6 +38,7 @@ HgiVkComputeEncoder::EndEncoding()
 void
 HgiVkComputeEncoder::BindPipeline(HgiPipelineHandle pipeline)
 {
+    if (!TF_VERIFY(_isRecording && _commandBuffer)) return;
     if (HgiVkPipeline* p = static_cast<HgiVkPipeline*>(pipeline)) {
         p->BindPipeline(_commandBuffer, /*renderpass*/ nullptr);
     }
@@ -45,7 +47,11 @@ HgiVkComputeEncoder::BindPipeline(HgiPipelineHandle pipeline)
 void
 HgiVkComputeEncoder::BindResources(HgiResourceBindingsHandle res)
 {
+    if (!TF_VERIFY(_isRecording && _commandBuffer)) return;
     if (HgiVkResourceBindings* r = static_cast<HgiVkResourceBindings*>(res)) {
+        // The dispatch may sample textures that earlier commands of this
+        // command buffer left in another state.
+        _commandBuffer->RestoreTextureStates(std::vector<HgiVkTexture*>());
         r->BindResources(_commandBuffer);
     }
 }
@@ -56,6 +62,8 @@ HgiVkComputeEncoder::Dispatch(
     uint32_t threadGrpCntY,
     uint32_t threadGrpCntZ)
 {
+    if (!TF_VERIFY(_isRecording && _commandBuffer)) return;
+
     vkCmdDispatch(
         _commandBuffer->GetCommandBufferForRecoding(),
         threadGrpCntX,
@@ -77,4 +85,10 @@ HgiVkComputeEncoder::PopDebugGroup()
     HgiVkEndDebugMarker(_commandBuffer);
 }
 
+HgiVkCommandBuffer*
+HgiVkComputeEncoder::GetCommandBuffer() const
+{
+    return _commandBuffer;
+}
+
 PXR_NAMESPACE_CLOSE_SCOPE
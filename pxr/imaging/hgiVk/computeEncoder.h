@@ -46,13 +46,18 @@ public:
         uint32_t threadGrpCntZ) override;
 
     /// Push a debug marker onto the encoder.
-    HGI_API
+    HGIVK_API
     void PushDebugGroup(const char* label) override;
 
     /// Pop the lastest debug marker off encoder.
-    HGI_API
+    HGIVK_API
     void PopDebugGroup() override;
 
+    /// Returns the command buffer the encoder records into.
+    /// Returns nullptr after EndEncoding.
+    HGIVK_API
+    HgiVkCommandBuffer* GetCommandBuffer() const;
+
 private:
     HgiVkComputeEncoder() = delete;
     HgiVkComputeEncoder & operator=(const HgiVkComputeEncoder&) = delete;
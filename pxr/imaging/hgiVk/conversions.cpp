@@ -73,6 +73,7 @@ _TextureUsageTable[][2] =
     {HgiTextureUsageBitsShaderWrite, VK_IMAGE_USAGE_STORAGE_BIT},
     {HgiTextureUsageBitsTransferDst, VK_IMAGE_USAGE_TRANSFER_DST_BIT},
     {HgiTextureUsageBitsTransferSrc, VK_IMAGE_USAGE_TRANSFER_SRC_BIT},
+    {HgiTextureUsageBitsTransient,   VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT},
 };
 
 static const uint32_t
@@ -96,6 +97,27 @@ _BufferUsageTable[][2] =
     {HgiBufferUsageStorage,     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT},
     {HgiBufferUsageTransferSrc, VK_BUFFER_USAGE_TRANSFER_SRC_BIT},
     {HgiBufferUsageTransferDst, VK_BUFFER_USAGE_TRANSFER_DST_BIT},
+    {HgiBufferUsageIndirect,    VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT},
+};
+
+static const uint32_t
+_ShaderStagePipelineStageTable[][2] =
+{
+    {HgiShaderStageVertex,   VK_PIPELINE_STAGE_VERTEX_SHADER_BIT},
+    {HgiShaderStageFragment, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT},
+    {HgiShaderStageCompute,  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT}
+};
+
+static const uint32_t
+_BufferConsumerAccessTable[][2] =
+{
+    {HgiBufferUsageUniform, VK_ACCESS_UNIFORM_READ_BIT},
+    {HgiBufferUsageIndex16, VK_ACCESS_INDEX_READ_BIT},
+    {HgiBufferUsageIndex32, VK_ACCESS_INDEX_READ_BIT},
+    {HgiBufferUsageVertex,  VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT},
+    {HgiBufferUsageStorage, VK_ACCESS_SHADER_READ_BIT |
+                            VK_ACCESS_SHADER_WRITE_BIT},
+    {HgiBufferUsageIndirect, VK_ACCESS_INDIRECT_COMMAND_READ_BIT},
 };
 
 static const uint32_t
@@ -146,6 +168,30 @@ _BindResourceTypeTable[HgiBindResourceTypeCount][2] =
     {HgiBindResourceTypeStorageBuffer,        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER}
 };
 
+static const uint32_t
+_SamplerFilterTable[HgiSamplerFilterCount][2] =
+{
+    {HgiSamplerFilterNearest, VK_FILTER_NEAREST},
+    {HgiSamplerFilterLinear,  VK_FILTER_LINEAR}
+};
+
+static const uint32_t
+_MipFilterTable[HgiMipFilterCount][2] =
+{
+    {HgiMipFilterNearest, VK_SAMPLER_MIPMAP_MODE_NEAREST},
+    {HgiMipFilterLinear,  VK_SAMPLER_MIPMAP_MODE_LINEAR}
+};
+
+static const uint32_t
+_SamplerAddressModeTable[HgiSamplerAddressModeCount][2] =
+{
+    {HgiSamplerAddressModeClampToEdge,        VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE},
+    {HgiSamplerAddressModeMirrorClampToEdge,  VK_SAMPLER_ADDRESS_MODE_MIRROR_CLAMP_TO_EDGE},
+    {HgiSamplerAddressModeRepeat,             VK_SAMPLER_ADDRESS_MODE_REPEAT},
+    {HgiSamplerAddressModeMirrorRepeat,       VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT},
+    {HgiSamplerAddressModeClampToBorderColor, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER}
+};
+
 VkFormat
 HgiVkConversions::GetFormat(HgiFormat inFormat)
 {
@@ -269,6 +315,50 @@ HgiVkConversions::GetBufferUsage(HgiBufferUsage bu)
     return vkFlags;
 }
 
+VkPipelineStageFlags
+HgiVkConversions::GetBufferConsumerStages(
+    HgiBufferUsage bu,
+    HgiShaderStage ss)
+{
+    VkPipelineStageFlags vkFlags = 0;
+
+    if (bu & (HgiBufferUsageVertex |
+              HgiBufferUsageIndex16 |
+              HgiBufferUsageIndex32)) {
+        vkFlags |= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+    }
+
+    if (bu & HgiBufferUsageIndirect) {
+        vkFlags |= VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+    }
+
+    if (bu & (HgiBufferUsageUniform | HgiBufferUsageStorage)) {
+        for (const auto& f : _ShaderStagePipelineStageTable) {
+            if (ss == 0 || (ss & f[0])) vkFlags |= f[1];
+        }
+    }
+
+    // Other buffers (e.g. read-back buffers) have no known consumer.
+    if (vkFlags==0) {
+        vkFlags = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    }
+    return vkFlags;
+}
+
+VkAccessFlags
+HgiVkConversions::GetBufferConsumerAccess(HgiBufferUsage bu)
+{
+    VkAccessFlags vkFlags = 0;
+    for (const auto& f : _BufferConsumerAccessTable) {
+        if (bu & f[0]) vkFlags |= f[1];
+    }
+
+    if (vkFlags==0) {
+        vkFlags = VK_ACCESS_MEMORY_READ_BIT;
+    }
+    return vkFlags;
+}
+
 VkCullModeFlags
 HgiVkConversions::GetCullMode(HgiCullMode cm)
 {
@@ -299,4 +389,22 @@ HgiVkConversions::GetDescriptorType(HgiBindResourceType rt)
     return VkDescriptorType(_BindResourceTypeTable[rt][1]);
 }
 
+VkFilter
+HgiVkConversions::GetSamplerFilter(HgiSamplerFilter sf)
+{
+    return VkFilter(_SamplerFilterTable[sf][1]);
+}
+
+VkSamplerMipmapMode
+HgiVkConversions::GetMipFilter(HgiMipFilter mf)
+{
+    return VkSamplerMipmapMode(_MipFilterTable[mf][1]);
+}
+
+VkSamplerAddressMode
+HgiVkConversions::GetSamplerAddressMode(HgiSamplerAddressMode am)
+{
+    return VkSamplerAddressMode(_SamplerAddressModeTable[am][1]);
+}
+
 PXR_NAMESPACE_CLOSE_SCOPE
@@ -53,6 +53,18 @@ public:
     HGIVK_API
     static VkBufferUsageFlags GetBufferUsage(HgiBufferUsage bu);
 
+    /// Returns the pipeline stages that consume a buffer of usage `bu`.
+    /// Uniform and storage buffers are consumed in the shader stages `ss`, or
+    /// in all shader stages if `ss` is zero.
+    HGIVK_API
+    static VkPipelineStageFlags GetBufferConsumerStages(
+        HgiBufferUsage bu,
+        HgiShaderStage ss);
+
+    /// Returns the access of the consumers of a buffer of usage `bu`.
+    HGIVK_API
+    static VkAccessFlags GetBufferConsumerAccess(HgiBufferUsage bu);
+
     HGIVK_API
     static VkCullModeFlags GetCullMode(HgiCullMode cm);
 
@@ -67,6 +79,15 @@ public:
 
     HGIVK_API
     static VkDescriptorType GetDescriptorType(HgiBindResourceType rt);
+
+    HGIVK_API
+    static VkFilter GetSamplerFilter(HgiSamplerFilter sf);
+
+    HGIVK_API
+    static VkSamplerMipmapMode GetMipFilter(HgiMipFilter mf);
+
+    HGIVK_API
+    static VkSamplerAddressMode GetSamplerAddressMode(HgiSamplerAddressMode am);
 };
 
 
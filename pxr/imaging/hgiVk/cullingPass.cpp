@@ -0,0 +1,293 @@
+#include "pxr/base/tf/diagnostic.h"
+
+#include "pxr/imaging/hgi/encoderOps.h"
+#include "pxr/imaging/hgi/pipeline.h"
+#include "pxr/imaging/hgi/resourceBindings.h"
+#include "pxr/imaging/hgi/shaderFunction.h"
+#include "pxr/imaging/hgi/shaderProgram.h"
+
+#include "pxr/imaging/hgiVk/buffer.h"
+#include "pxr/imaging/hgiVk/commandBuffer.h"
+#include "pxr/imaging/hgiVk/computeEncoder.h"
+#include "pxr/imaging/hgiVk/cullingPass.h"
+#include "pxr/imaging/hgiVk/device.h"
+#include "pxr/imaging/hgiVk/object.h"
+#include "pxr/imaging/hgiVk/pipeline.h"
+#include "pxr/imaging/hgiVk/resourceBindings.h"
+#include "pxr/imaging/hgiVk/shaderFunction.h"
+#include "pxr/imaging/hgiVk/shaderProgram.h"
+
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+static const uint32_t _workgroupSize = 64;
+
+static_assert(sizeof(HgiDrawIndexedIndirectCommand) == 5 * sizeof(uint32_t),
+    "The culling shader copies draw commands as 5 uints");
+
+// The box of a draw is visible unless all of its corners are outside of the
+// same clip plane. Boxes that cross a plane diagonally to the frustum may be
+// kept, but no visible box is culled.
+// Hydra's projections map depth to [-w, w], so the near plane test is
+// conservative for projections that map depth to [0, w].
+static const char* _cullingShader =
+    "#version 450\n"
+    "\n"
+    "layout(local_size_x = 64, local_size_y = 1, local_size_z = 1) in;\n"
+    "\n"
+    "layout(std430, set = 0, binding = 0) readonly buffer Params {\n"
+    "    mat4 viewProjection;\n"
+    "    uint drawCount;\n"
+    "} params;\n"
+    "\n"
+    "layout(std430, set = 0, binding = 1) readonly buffer Bounds {\n"
+    "    vec4 bounds[];\n"
+    "};\n"
+    "\n"
+    "layout(std430, set = 0, binding = 2) readonly buffer DrawCommands {\n"
+    "    uint drawCommands[];\n"
+    "};\n"
+    "\n"
+    "layout(std430, set = 0, binding = 3) writeonly buffer CulledCommands {\n"
+    "    uint culledDrawCommands[];\n"
+    "};\n"
+    "\n"
+    "layout(std430, set = 0, binding = 4) buffer DrawCount {\n"
+    "    uint culledDrawCount;\n"
+    "};\n"
+    "\n"
+    "bool IsVisible(vec3 bmin, vec3 bmax)\n"
+    "{\n"
+    "    int outside[6] = int[6](0, 0, 0, 0, 0, 0);\n"
+    "    for (int i = 0; i < 8; i++) {\n"
+    "        vec3 p = vec3((i & 1) != 0 ? bmax.x : bmin.x,\n"
+    "                      (i & 2) != 0 ? bmax.y : bmin.y,\n"
+    "                      (i & 4) != 0 ? bmax.z : bmin.z);\n"
+    "        // Gf matrices are row-major with row vectors, which reads as\n"
+    "        // the column-major transpose in glsl.\n"
+    "        vec4 c = params.viewProjection * vec4(p, 1.0);\n"
+    "        outside[0] += c.x < -c.w ? 1 : 0;\n"
+    "        outside[1] += c.x >  c.w ? 1 : 0;\n"
+    "        outside[2] += c.y < -c.w ? 1 : 0;\n"
+    "        outside[3] += c.y >  c.w ? 1 : 0;\n"
+    "        outside[4] += c.z < -c.w ? 1 : 0;\n"
+    "        outside[5] += c.z >  c.w ? 1 : 0;\n"
+    "    }\n"
+    "    for (int i = 0; i < 6; i++) {\n"
+    "        if (outside[i] == 8) return false;\n"
+    "    }\n"
+    "    return true;\n"
+    "}\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "    uint draw = gl_GlobalInvocationID.x;\n"
+    "    if (draw >= params.drawCount) return;\n"
+    "\n"
+    "    uint src = draw * 5;\n"
+    "    // Draws without instances are never visible.\n"
+    "    if (drawCommands[src + 1] == 0) return;\n"
+    "\n"
+    "    if (!IsVisible(bounds[draw * 2].xyz, bounds[draw * 2 + 1].xyz)) {\n"
+    "        return;\n"
+    "    }\n"
+    "\n"
+    "    uint dst = atomicAdd(culledDrawCount, 1) * 5;\n"
+    "    for (uint i = 0; i < 5; i++) {\n"
+    "        culledDrawCommands[dst + i] = drawCommands[src + i];\n"
+    "    }\n"
+    "}\n";
+
+
+static HgiBufferBindDesc
+_GetStorageBufferBindDesc(HgiBufferHandle buffer, uint32_t bindingIndex)
+{
+    HgiBufferBindDesc desc;
+    desc.buffers.push_back(buffer);
+    desc.offsets.push_back(0);
+    desc.resourceType = HgiBindResourceTypeStorageBuffer;
+    desc.bindingIndex = bindingIndex;
+    desc.stageUsage = HgiShaderStageCompute;
+    return desc;
+}
+
+HgiVkCullingPass::HgiVkCullingPass(
+    HgiVkDevice* device,
+    HgiVkCullingPassDesc const& desc)
+    : _device(device)
+    , _descriptor(desc)
+    , _shaderFunction(nullptr)
+    , _shaderProgram(nullptr)
+    , _resourceBindings(nullptr)
+    , _pipeline(nullptr)
+{
+    HgiBufferHandle buffers[] = {
+        desc.params,
+        desc.bounds,
+        desc.drawCommands,
+        desc.culledDrawCommands,
+        desc.drawCount};
+
+    for (HgiBufferHandle buffer : buffers) {
+        if (!TF_VERIFY(buffer, "Culling pass is missing a buffer")) {
+            return;
+        }
+    }
+
+    HgiBufferUsage countUsage =
+        static_cast<HgiVkBuffer*>(desc.drawCount)->GetDescriptor().usage;
+    TF_VERIFY(countUsage & HgiBufferUsageTransferDst,
+        "Culling pass draw count buffer must be a transfer destination");
+
+    HgiBufferUsage culledUsage =
+        static_cast<HgiVkBuffer*>(desc.culledDrawCommands)->
+            GetDescriptor().usage;
+    TF_VERIFY(culledUsage & HgiBufferUsageTransferDst,
+        "Culling pass culled draw commands must be a transfer destination");
+
+    HgiShaderFunctionDesc shaderDesc;
+    shaderDesc.debugName = "HgiVkCullingPass";
+    shaderDesc.shaderStage = HgiShaderStageCompute;
+    shaderDesc.shaderCode = _cullingShader;
+    _shaderFunction = new HgiVkShaderFunction(device, shaderDesc);
+
+    if (!_shaderFunction->IsValid()) {
+        TF_CODING_ERROR("Culling shader failed to compile: %s",
+            _shaderFunction->GetCompileErrors().c_str());
+        return;
+    }
+
+    HgiShaderProgramDesc programDesc;
+    programDesc.debugName = "HgiVkCullingPass";
+    programDesc.shaderFunctions.push_back(_shaderFunction);
+    _shaderProgram = new HgiVkShaderProgram(programDesc);
+
+    HgiResourceBindingsDesc bindingsDesc;
+    bindingsDesc.debugName = "HgiVkCullingPass";
+    bindingsDesc.pipelineType = HgiPipelineTypeCompute;
+    uint32_t bindingIndex = 0;
+    for (HgiBufferHandle buffer : buffers) {
+        bindingsDesc.buffers.push_back(
+            _GetStorageBufferBindDesc(buffer, bindingIndex++));
+    }
+    _resourceBindings = new HgiVkResourceBindings(device, bindingsDesc);
+
+    HgiPipelineDesc pipelineDesc;
+    pipelineDesc.debugName = "HgiVkCullingPass";
+    pipelineDesc.pipelineType = HgiPipelineTypeCompute;
+    pipelineDesc.resourceBindings = _resourceBindings;
+    pipelineDesc.shaderProgram = _shaderProgram;
+    _pipeline = new HgiVkPipeline(device, pipelineDesc);
+}
+
+HgiVkCullingPass::~HgiVkCullingPass()
+{
+    // Frames in flight may still run the pass.
+    HgiVkObject object;
+
+    if (_pipeline) {
+        object.type = HgiVkObjectTypePipeline;
+        object.pipeline = _pipeline;
+        _device->DestroyObject(object);
+    }
+
+    if (_resourceBindings) {
+        object.type = HgiVkObjectTypeResourceBindings;
+        object.resourceBindings = _resourceBindings;
+        _device->DestroyObject(object);
+    }
+
+    if (_shaderProgram) {
+        object.type = HgiVkObjectTypeShaderProgram;
+        object.shaderProgram = _shaderProgram;
+        _device->DestroyObject(object);
+    }
+
+    if (_shaderFunction) {
+        object.type = HgiVkObjectTypeShaderFunction;
+        object.shaderFunction = _shaderFunction;
+        _device->DestroyObject(object);
+    }
+}
+
+bool
+HgiVkCullingPass::IsValid() const
+{
+    return _pipeline != nullptr;
+}
+
+void
+HgiVkCullingPass::Record(HgiComputeEncoder* encoder, uint32_t drawCount)
+{
+    if (!TF_VERIFY(encoder) || !TF_VERIFY(IsValid(), "Invalid culling pass")) {
+        return;
+    }
+
+    HgiVkComputeEncoder* enc = static_cast<HgiVkComputeEncoder*>(encoder);
+    HgiVkCommandBuffer* cb = enc->GetCommandBuffer();
+    if (!TF_VERIFY(cb)) return;
+
+    HgiVkBuffer* countBuffer = static_cast<HgiVkBuffer*>(_descriptor.drawCount);
+    HgiVkBuffer* culledBuffer =
+        static_cast<HgiVkBuffer*>(_descriptor.culledDrawCommands);
+
+    // The draws of the previous frame may still read the results if compute
+    // runs on the graphics queue. Writing after reading only needs an
+    // execution dependency. On an async compute queue the submission waits
+    // for the graphics work of the previous frame instead (see
+    // HgiVkCommandBufferManager::EndFrame).
+    VkMemoryBarrier readBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+    cb->AddBarrier(
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT |
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        readBarrier);
+
+    vkCmdFillBuffer(
+        cb->GetCommandBufferForRecoding(),
+        countBuffer->GetBuffer(),
+        0,
+        sizeof(uint32_t),
+        0);
+
+    if (!_device->GetDeviceSupportDrawIndirectCount()) {
+        // Without VK_KHR_draw_indirect_count all commands of the buffer are
+        // drawn. The commands past the count must draw nothing.
+        vkCmdFillBuffer(
+            cb->GetCommandBufferForRecoding(),
+            culledBuffer->GetBuffer(),
+            0,
+            VK_WHOLE_SIZE,
+            0);
+    }
+
+    // The draws see the cleared buffers through the barrier at the end of
+    // the compute command buffer, that covers transfers as well (or the
+    // semaphore the draws wait on with an async compute queue).
+    if (drawCount == 0) return;
+
+    // The shader increments the cleared draw count and writes the commands
+    // over the cleared ones.
+    VkMemoryBarrier clearBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+    clearBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    clearBarrier.dstAccessMask =
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    cb->AddBarrier(
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        clearBarrier);
+
+    enc->BindPipeline(_pipeline);
+    enc->BindResources(_resourceBindings);
+    enc->Dispatch((drawCount + _workgroupSize - 1) / _workgroupSize, 1, 1);
+}
+
+uint32_t
+HgiVkCullingPass::GetWorkgroupSize()
+{
+    return _workgroupSize;
+}
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
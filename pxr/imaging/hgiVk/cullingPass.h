@@ -0,0 +1,126 @@
+#ifndef PXR_IMAGING_HGIVK_CULLING_PASS_H
+#define PXR_IMAGING_HGIVK_CULLING_PASS_H
+
+#include <cstdint>
+
+#include "pxr/pxr.h"
+#include "pxr/imaging/hgi/buffer.h"
+#include "pxr/imaging/hgiVk/api.h"
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+class HgiComputeEncoder;
+class HgiVkDevice;
+class HgiVkPipeline;
+class HgiVkResourceBindings;
+class HgiVkShaderFunction;
+class HgiVkShaderProgram;
+
+
+/// \struct HgiVkCullingParams
+///
+/// Layout of the parameter buffer of HgiVkCullingPass. The client writes it
+/// each frame (e.g. a HgiBufferUsageCpuToGpu storage buffer).
+///
+/// <ul>
+/// <li>viewProjection:
+///   World to clip space matrix, row-major with row vectors (GfMatrix4f).</li>
+/// <li>drawCount:
+///   Number of draws in the bounds and draw command buffers.</li>
+/// </ul>
+///
+struct HgiVkCullingParams {
+    float viewProjection[16];
+    uint32_t drawCount;
+    uint32_t padding[3];
+};
+
+
+/// \struct HgiVkCullingPassDesc
+///
+/// Describes the buffers of a HgiVkCullingPass. All buffers are
+/// HgiBufferUsageStorage buffers.
+///
+/// <ul>
+/// <li>params:
+///   One HgiVkCullingParams.</li>
+/// <li>bounds:
+///   Two vec4 per draw: the world space minimum and maximum of its box.</li>
+/// <li>drawCommands:
+///   One HgiDrawIndexedIndirectCommand per draw.</li>
+/// <li>culledDrawCommands:
+///   Receives the commands of the visible draws, compacted.
+///   Must also be HgiBufferUsageIndirect and HgiBufferUsageTransferDst.
+///   Without VK_KHR_draw_indirect_count the commands past the count are
+///   cleared to zero, so all commands of the buffer can be drawn.</li>
+/// <li>drawCount:
+///   Receives the number of visible draws as one uint32_t.
+///   Must also be HgiBufferUsageIndirect and HgiBufferUsageTransferDst.</li>
+/// </ul>
+///
+struct HgiVkCullingPassDesc {
+    HgiBufferHandle params = nullptr;
+    HgiBufferHandle bounds = nullptr;
+    HgiBufferHandle drawCommands = nullptr;
+    HgiBufferHandle culledDrawCommands = nullptr;
+    HgiBufferHandle drawCount = nullptr;
+};
+
+
+/// \class HgiVkCullingPass
+///
+/// Compute pass that frustum culls draws on the gpu.
+///
+/// Each draw whose bounding box intersects the view frustum has its draw
+/// command appended to `culledDrawCommands` and `drawCount` is set to the
+/// number of appended commands. The results are consumed by
+/// HgiGraphicsEncoder::DrawIndexedIndirectCount, so the draw arguments never
+/// go to the cpu. The order of the compacted commands is not stable.
+///
+/// The pass is recorded into a compute encoder. The compute work of a frame
+/// is synchronized with its draws by the command buffer manager, so the draws
+/// of the same frame may consume the results directly.
+///
+class HgiVkCullingPass final
+{
+public:
+    HGIVK_API
+    HgiVkCullingPass(
+        HgiVkDevice* device,
+        HgiVkCullingPassDesc const& desc);
+
+    HGIVK_API
+    ~HgiVkCullingPass();
+
+    /// Returns true if the shader compiled and the pass can be recorded.
+    HGIVK_API
+    bool IsValid() const;
+
+    /// Records the culling of `drawCount` draws into `encoder`.
+    /// `drawCount` must match the drawCount in the parameter buffer.
+    HGIVK_API
+    void Record(HgiComputeEncoder* encoder, uint32_t drawCount);
+
+    /// Returns the number of draws culled per workgroup.
+    HGIVK_API
+    static uint32_t GetWorkgroupSize();
+
+private:
+    HgiVkCullingPass() = delete;
+    HgiVkCullingPass & operator=(const HgiVkCullingPass&) = delete;
+    HgiVkCullingPass(const HgiVkCullingPass&) = delete;
+
+private:
+    HgiVkDevice* _device;
+    HgiVkCullingPassDesc _descriptor;
+
+    HgiVkShaderFunction* _shaderFunction;
+    HgiVkShaderProgram* _shaderProgram;
+    HgiVkResourceBindings* _resourceBindings;
+    HgiVkPipeline* _pipeline;
+};
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+#endif
@@ -0,0 +1,254 @@
+#include <algorithm>
+
+#include "pxr/base/tf/diagnostic.h"
+#include "pxr/base/tf/stopwatch.h"
+
+#include "pxr/imaging/hgi/enums.h"
+#include "pxr/imaging/hgiVk/conversions.h"
+#include "pxr/imaging/hgiVk/descriptorAllocator.h"
+#include "pxr/imaging/hgiVk/device.h"
+#include "pxr/imaging/hgiVk/diagnostic.h"
+
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+static const uint32_t _setsPerPool = 32;
+
+HgiVkDescriptorAllocator::HgiVkDescriptorAllocator(HgiVkDevice* device)
+    : _device(device)
+    , _liveSets(0)
+{
+}
+
+HgiVkDescriptorAllocator::~HgiVkDescriptorAllocator()
+{
+    // Destroying a pool frees all of its sets.
+    for (_Pool* pool : _pools) {
+        vkDestroyDescriptorPool(
+            _device->GetVulkanDevice(),
+            pool->vkPool,
+            HgiVkAllocator());
+        delete pool;
+    }
+}
+
+HgiVkDescriptorAllocator::Allocation
+HgiVkDescriptorAllocator::Allocate(
+    VkDescriptorSetLayout layout,
+    std::vector<VkDescriptorPoolSize> const& poolSizes)
+{
+    /* MULTI-THREAD CALL*/
+
+    TfStopwatch watch;
+    watch.Start();
+
+    uint32_t descriptorCount = 0;
+    for (VkDescriptorPoolSize const& size : poolSizes) {
+        descriptorCount += size.descriptorCount;
+    }
+
+    uint32_t sizeClass = _GetSizeClass(descriptorCount);
+    _ThreadPools& threadPools = _threadPools.Get();
+
+    Allocation allocation;
+
+    if (sizeClass == _DedicatedSizeClass) {
+        allocation.pool = _CreatePool(sizeClass, poolSizes);
+        allocation.set = _AllocateFromPool(allocation.pool, layout);
+    } else {
+        // Pools at the front of the chain fill up first, so usually the
+        // last pool is the one with free sets.
+        std::vector<_Pool*>& chain = threadPools.chains[sizeClass];
+        for (size_t i=chain.size(); i-- > 0 && !allocation.set;) {
+            if (chain[i]->freeSets == 0) continue;
+            allocation.set = _AllocateFromPool(chain[i], layout);
+            allocation.pool = chain[i];
+        }
+
+        if (!allocation.set) {
+            allocation.pool = _CreatePool(sizeClass, poolSizes);
+            allocation.set = _AllocateFromPool(allocation.pool, layout);
+            chain.push_back(allocation.pool);
+        }
+    }
+
+    TF_VERIFY(allocation.set, "Descriptor set allocation failed");
+
+    watch.Stop();
+    float ns = (float) watch.GetNanoseconds();
+    threadPools.allocations++;
+    threadPools.allocationNanoseconds += ns;
+    threadPools.maxAllocationNanoseconds =
+        std::max(threadPools.maxAllocationNanoseconds, ns);
+
+    return allocation;
+}
+
+void
+HgiVkDescriptorAllocator::Free(Allocation const& allocation)
+{
+    /* MULTI-THREAD CALL*/
+
+    if (!allocation.set) return;
+
+    // The pool may belong to another thread, which could be allocating from
+    // it right now. The set is returned once no thread allocates.
+    std::lock_guard<std::mutex> lock(_lock);
+    _pendingFrees.push_back(allocation);
+}
+
+void
+HgiVkDescriptorAllocator::BeginFrame()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    VkDevice vkDevice = _device->GetVulkanDevice();
+
+    // Return the freed sets to their pools. Dedicated pools hold one set,
+    // so they are destroyed instead.
+    std::vector<_Pool*> destroyedPools;
+    for (Allocation const& allocation : _pendingFrees) {
+        _Pool* pool = allocation.pool;
+        if (pool->sizeClass == _DedicatedSizeClass) {
+            vkDestroyDescriptorPool(vkDevice, pool->vkPool, HgiVkAllocator());
+            destroyedPools.push_back(pool);
+        } else {
+            TF_VERIFY(
+                vkFreeDescriptorSets(
+                    vkDevice, pool->vkPool, 1, &allocation.set) == VK_SUCCESS
+            );
+            pool->freeSets++;
+        }
+    }
+
+    if (!destroyedPools.empty()) {
+        std::sort(destroyedPools.begin(), destroyedPools.end());
+        _pools.erase(
+            std::remove_if(_pools.begin(), _pools.end(),
+                [&destroyedPools](_Pool* pool) {
+                    return std::binary_search(
+                        destroyedPools.begin(), destroyedPools.end(), pool);
+                }),
+            _pools.end());
+        for (_Pool* pool : destroyedPools) {
+            delete pool;
+        }
+    }
+
+    // Gather the statistics of the previous frame.
+    HgiVkDescriptorStats stats;
+    stats.frees = (uint32_t) _pendingFrees.size();
+    _pendingFrees.clear();
+
+    _threadPools.ForEach([&stats](_ThreadPools& threadPools) {
+        stats.allocations += threadPools.allocations;
+        stats.allocationNanoseconds += threadPools.allocationNanoseconds;
+        stats.maxAllocationNanoseconds = std::max(
+            stats.maxAllocationNanoseconds,
+            threadPools.maxAllocationNanoseconds);
+        threadPools.allocations = 0;
+        threadPools.allocationNanoseconds = 0;
+        threadPools.maxAllocationNanoseconds = 0;
+    });
+
+    _liveSets += stats.allocations;
+    _liveSets -= stats.frees;
+
+    stats.pools = (uint32_t) _pools.size();
+    stats.sets = _liveSets;
+    _stats = stats;
+}
+
+HgiVkDescriptorStats const&
+HgiVkDescriptorAllocator::GetStats() const
+{
+    return _stats;
+}
+
+uint32_t
+HgiVkDescriptorAllocator::_GetSizeClass(uint32_t descriptorCount)
+{
+    uint32_t sizeClass = 0;
+    while ((1u << sizeClass) < descriptorCount) {
+        sizeClass++;
+        if (sizeClass == _SizeClassCount) return _DedicatedSizeClass;
+    }
+    return sizeClass;
+}
+
+HgiVkDescriptorAllocator::_Pool*
+HgiVkDescriptorAllocator::_CreatePool(
+    uint32_t sizeClass,
+    std::vector<VkDescriptorPoolSize> const& poolSizes)
+{
+    std::vector<VkDescriptorPoolSize> sizes;
+    uint32_t maxSets = 1;
+
+    if (sizeClass == _DedicatedSizeClass) {
+        // Remove empty descriptorPoolSize or vulkan validation will complain
+        for (VkDescriptorPoolSize const& size : poolSizes) {
+            if (size.descriptorCount > 0) sizes.push_back(size);
+        }
+    } else {
+        // Any set of the size class fits, whatever its descriptor types.
+        maxSets = _setsPerPool;
+        for (size_t i=0; i<HgiBindResourceTypeCount; i++) {
+            VkDescriptorPoolSize size;
+            size.type = HgiVkConversions::GetDescriptorType(
+                HgiBindResourceType(i));
+            size.descriptorCount = (1u << sizeClass) * _setsPerPool;
+            sizes.push_back(size);
+        }
+    }
+
+    VkDescriptorPoolCreateInfo poolInfo =
+        {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    poolInfo.maxSets = maxSets;
+    poolInfo.poolSizeCount = (uint32_t) sizes.size();
+    poolInfo.pPoolSizes = sizes.data();
+
+    _Pool* pool = new _Pool();
+    pool->sizeClass = sizeClass;
+    pool->freeSets = maxSets;
+
+    TF_VERIFY(
+        vkCreateDescriptorPool(
+            _device->GetVulkanDevice(),
+            &poolInfo,
+            HgiVkAllocator(),
+            &pool->vkPool) == VK_SUCCESS
+    );
+
+    std::lock_guard<std::mutex> lock(_lock);
+    _pools.push_back(pool);
+
+    return pool;
+}
+
+VkDescriptorSet
+HgiVkDescriptorAllocator::_AllocateFromPool(
+    _Pool* pool,
+    VkDescriptorSetLayout layout)
+{
+    VkDescriptorSetAllocateInfo allocateInfo =
+        {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+    allocateInfo.descriptorPool = pool->vkPool;
+    allocateInfo.descriptorSetCount = 1;
+    allocateInfo.pSetLayouts = &layout;
+
+    VkDescriptorSet set = nullptr;
+    if (vkAllocateDescriptorSets(
+            _device->GetVulkanDevice(), &allocateInfo, &set) != VK_SUCCESS) {
+        // Freed sets can fragment the pool, so a pool with free sets may
+        // still be full. It is used again once more sets are returned.
+        pool->freeSets = 0;
+        return nullptr;
+    }
+
+    pool->freeSets--;
+    return set;
+}
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
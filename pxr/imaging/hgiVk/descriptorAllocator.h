@@ -0,0 +1,147 @@
+#ifndef PXR_IMAGING_HGIVK_DESCRIPTOR_ALLOCATOR_H
+#define PXR_IMAGING_HGIVK_DESCRIPTOR_ALLOCATOR_H
+
+#include <mutex>
+#include <vector>
+
+#include "pxr/pxr.h"
+#include "pxr/imaging/hgiVk/api.h"
+#include "pxr/imaging/hgiVk/threadSlots.h"
+#include "pxr/imaging/hgiVk/vulkan.h"
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+class HgiVkDevice;
+
+
+/// \struct HgiVkDescriptorStats
+///
+/// Descriptor set usage of the device.
+/// `pools` and `sets` are the pools and sets alive at the start of the
+/// frame. The other members cover the previous frame: the number of sets
+/// allocated and recycled and the cpu time the allocations took.
+///
+struct HgiVkDescriptorStats {
+    uint32_t pools = 0;
+    uint32_t sets = 0;
+    uint32_t allocations = 0;
+    uint32_t frees = 0;
+    float allocationNanoseconds = 0;
+    float maxAllocationNanoseconds = 0;
+};
+
+
+/// \class HgiVkDescriptorAllocator
+///
+/// Allocates the descriptor sets of resource bindings from shared pools.
+///
+/// Each thread has its own chain of pools per size class, so threads do not
+/// contend when they allocate. The size class of a set is its descriptor
+/// count rounded up to a power of two. A pool of a size class has room for
+/// a fixed number of sets of any layout in that class. Sets with more
+/// descriptors than the largest class get a pool of their own.
+///
+/// Freed sets are returned to their pool at the start of the next frame.
+/// Callers free sets when their owner is garbage collected, so the gpu no
+/// longer uses them. A pool with returned sets is used again by its thread.
+///
+class HgiVkDescriptorAllocator final
+{
+    struct _Pool;
+
+public:
+    /// A descriptor set and the pool it was allocated from.
+    struct Allocation {
+        VkDescriptorSet set = nullptr;
+        _Pool* pool = nullptr;
+    };
+
+    HGIVK_API
+    HgiVkDescriptorAllocator(HgiVkDevice* device);
+
+    HGIVK_API
+    ~HgiVkDescriptorAllocator();
+
+    /// Allocates a set of `layout` from the pools of the calling thread.
+    /// `poolSizes` are the descriptor counts of the layout.
+    /// Thread safety: May be called from any thread, but not during
+    /// BeginFrame.
+    HGIVK_API
+    Allocation Allocate(
+        VkDescriptorSetLayout layout,
+        std::vector<VkDescriptorPoolSize> const& poolSizes);
+
+    /// Frees a set. The set is returned to its pool in the next BeginFrame.
+    /// The gpu must no longer use the set.
+    /// Thread safety: May be called from any thread.
+    HGIVK_API
+    void Free(Allocation const& allocation);
+
+    /// Returns freed sets to their pools and gathers the statistics of the
+    /// previous frame. Called by the device when a frame begins, after the
+    /// garbage of the frame was destroyed.
+    HGIVK_API
+    void BeginFrame();
+
+    /// Returns the statistics gathered in the last BeginFrame.
+    HGIVK_API
+    HgiVkDescriptorStats const& GetStats() const;
+
+private:
+    HgiVkDescriptorAllocator() = delete;
+    HgiVkDescriptorAllocator & operator=(
+        const HgiVkDescriptorAllocator&) = delete;
+    HgiVkDescriptorAllocator(const HgiVkDescriptorAllocator&) = delete;
+
+    // Size classes hold sets of 1, 2, 4 ... 64 descriptors.
+    static const uint32_t _SizeClassCount = 7;
+
+    // Size class of the sets that get a dedicated pool.
+    static const uint32_t _DedicatedSizeClass = _SizeClassCount;
+
+    struct _Pool {
+        VkDescriptorPool vkPool = nullptr;
+        uint32_t sizeClass = 0;
+        uint32_t freeSets = 0;
+    };
+
+    // The pools and allocation statistics of one thread.
+    struct _ThreadPools {
+        std::vector<_Pool*> chains[_SizeClassCount];
+        uint32_t allocations = 0;
+        float allocationNanoseconds = 0;
+        float maxAllocationNanoseconds = 0;
+    };
+
+    // Returns the size class for a set with `descriptorCount` descriptors.
+    static uint32_t _GetSizeClass(uint32_t descriptorCount);
+
+    // Creates a pool for `sizeClass`. Dedicated pools are sized by
+    // `poolSizes`, the other pools have room for any set of their class.
+    _Pool* _CreatePool(
+        uint32_t sizeClass,
+        std::vector<VkDescriptorPoolSize> const& poolSizes);
+
+    // Allocates a set from `pool`. Returns nullptr if the pool is full.
+    VkDescriptorSet _AllocateFromPool(
+        _Pool* pool,
+        VkDescriptorSetLayout layout);
+
+private:
+    HgiVkDevice* _device;
+
+    HgiVkThreadSlotArray<_ThreadPools> _threadPools;
+
+    // Pools of all threads and the dedicated pools.
+    std::mutex _lock;
+    std::vector<_Pool*> _pools;
+    std::vector<Allocation> _pendingFrees;
+
+    uint32_t _liveSets;
+    HgiVkDescriptorStats _stats;
+};
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+#endif
@@ -1,14 +1,122 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "pxr/base/arch/fileSystem.h"
+#include "pxr/base/arch/hash.h"
+#include "pxr/base/tf/atomicOfstreamWrapper.h"
 #include "pxr/base/tf/diagnostic.h"
 #include "pxr/base/tf/envSetting.h"
+#include "pxr/base/tf/stringUtils.h"
 
+#include "pxr/imaging/hgiVk/bindlessTextures.h"
 #include "pxr/imaging/hgiVk/device.h"
 #include "pxr/imaging/hgiVk/diagnostic.h"
+#include "pxr/imaging/hgiVk/drawBundle.h"
+#include "pxr/imaging/hgiVk/fullscreenPass.h"
 #include "pxr/imaging/hgiVk/hgi.h"
 #include "pxr/imaging/hgiVk/instance.h"
+#include "pxr/imaging/hgiVk/layoutCache.h"
+#include "pxr/imaging/hgiVk/mipGenerator.h"
+#include "pxr/imaging/hgiVk/readbackManager.h"
 #include "pxr/imaging/hgiVk/renderPass.h"
+#include "pxr/imaging/hgiVk/samplerCache.h"
 
 PXR_NAMESPACE_OPEN_SCOPE
 
+TF_DEFINE_ENV_SETTING(HGIVK_PIPELINE_CACHE, 1,
+    "Enable the on-disk vulkan pipeline cache for HgiVk");
+
+TF_DEFINE_ENV_SETTING(HGIVK_PIPELINE_CACHE_DIR, "",
+    "Directory of the HgiVk pipeline cache file (default: tmp dir)");
+
+TF_DEFINE_ENV_SETTING(HGIVK_FRAMES_IN_FLIGHT, 3,
+    "Number of frames the cpu may record ahead of the gpu (min 1)");
+
+TF_DEFINE_ENV_SETTING(HGIVK_TRANSFER_QUEUE, 1,
+    "Use a dedicated transfer queue for HgiVk uploads when available");
+
+TF_DEFINE_ENV_SETTING(HGIVK_ASYNC_COMPUTE, 1,
+    "Use a second queue for HgiVk compute work when available");
+
+TF_DEFINE_ENV_SETTING(HGIVK_SUBMISSION_THREAD, 0,
+    "Submit HgiVk command buffers from a dedicated submission thread");
+
+TF_DEFINE_ENV_SETTING(HGIVK_BINDLESS_TEXTURES, 0,
+    "Register HgiVk sampled textures into one global descriptor array");
+
+// Upper limit of the global texture array (bindless textures).
+static const uint32_t _maxBindlessTexturesLimit = 65536;
+
+// Descriptors of each type kept free for the resource bindings (set 0) that
+// are used together with the global texture array.
+static const uint32_t _bindlessReservedDescriptors = 1024;
+
+// Returns what remains of an update-after-bind limit once the descriptors of
+// set 0 are reserved. Set 0 can not exceed the regular limit.
+static uint32_t
+_GetBindlessHeadroom(uint32_t updateAfterBindLimit, uint32_t regularLimit)
+{
+    uint32_t reserved = std::min(regularLimit, _bindlessReservedDescriptors);
+    return updateAfterBindLimit > reserved ?
+        updateAfterBindLimit - reserved : 0;
+}
+
+// Header we write in front of the driver provided pipeline cache blob.
+// The vulkan blob has its own header (vendor, device, uuid), but it does not
+// include the driver version and it has no checksum. Some drivers are known to
+// crash when given a truncated or corrupt blob, so we validate it ourselves.
+// https://zeux.io/2019/07/17/serializing-pipeline-cache/
+struct _PipelineCacheFileHeader {
+    uint32_t magic;
+    uint32_t fileVersion;
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint32_t driverVersion;
+    uint8_t  pipelineCacheUUID[VK_UUID_SIZE];
+    uint64_t dataSize;
+    uint64_t dataHash;
+};
+
+static const uint32_t _pipelineCacheMagic = 0x4B564748; // 'HGVK'
+static const uint32_t _pipelineCacheFileVersion = 1;
+
+static bool
+_IsPipelineCacheFileHeaderValid(
+    _PipelineCacheFileHeader const& header,
+    VkPhysicalDeviceProperties const& props)
+{
+    return header.magic == _pipelineCacheMagic &&
+           header.fileVersion == _pipelineCacheFileVersion &&
+           header.vendorID == props.vendorID &&
+           header.deviceID == props.deviceID &&
+           header.driverVersion == props.driverVersion &&
+           memcmp(header.pipelineCacheUUID,
+                  props.pipelineCacheUUID,
+                  VK_UUID_SIZE) == 0;
+}
+
+static bool
+_IsPipelineCacheDataValid(
+    std::vector<char> const& data,
+    VkPhysicalDeviceProperties const& props)
+{
+    // Vulkan spec: "Pipeline Cache Header" (version one).
+    const size_t vkHeaderSize = 16 + VK_UUID_SIZE;
+    if (data.size() < vkHeaderSize) return false;
+
+    uint32_t vkHeader[4];
+    memcpy(vkHeader, data.data(), sizeof(vkHeader));
+
+    return vkHeader[0] >= vkHeaderSize &&
+           vkHeader[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           vkHeader[2] == props.vendorID &&
+           vkHeader[3] == props.deviceID &&
+           memcmp(data.data() + 16,
+                  props.pipelineCacheUUID,
+                  VK_UUID_SIZE) == 0;
+}
 
 static uint32_t
 _GetGraphicsFamilyIndex(
@@ -33,6 +141,95 @@ _GetGraphicsFamilyIndex(
     return VK_QUEUE_FAMILY_IGNORED;
 }
 
+static uint32_t
+_GetTransferFamilyIndex(VkPhysicalDevice physicalDevice)
+{
+    uint32_t queueCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueCount, 0);
+
+    std::vector<VkQueueFamilyProperties> queues(queueCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(
+        physicalDevice,
+        &queueCount,
+        queues.data());
+
+    // We look for a transfer-only family. Those usually map to the dedicated
+    // DMA engines of the GPU and can run while the graphics queue is busy.
+    const VkQueueFlags otherFlags =
+        VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT;
+
+    for (uint32_t i = 0; i < queueCount; i++) {
+        if ((queues[i].queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+            !(queues[i].queueFlags & otherFlags)) {
+            return i;
+        }
+    }
+
+    return VK_QUEUE_FAMILY_IGNORED;
+}
+
+static uint32_t
+_GetComputeFamilyIndex(VkPhysicalDevice physicalDevice)
+{
+    uint32_t queueCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueCount, 0);
+
+    std::vector<VkQueueFamilyProperties> queues(queueCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(
+        physicalDevice,
+        &queueCount,
+        queues.data());
+
+    // We look for a compute family without graphics. On most discrete GPUs
+    // this family runs compute work alongside the graphics queue.
+    for (uint32_t i = 0; i < queueCount; i++) {
+        if ((queues[i].queueFlags & VK_QUEUE_COMPUTE_BIT) &&
+            !(queues[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+            return i;
+        }
+    }
+
+    return VK_QUEUE_FAMILY_IGNORED;
+}
+
+static uint32_t
+_GetQueueCount(VkPhysicalDevice physicalDevice, uint32_t familyIndex)
+{
+    uint32_t queueCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueCount, 0);
+
+    std::vector<VkQueueFamilyProperties> queues(queueCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(
+        physicalDevice,
+        &queueCount,
+        queues.data());
+
+    return familyIndex < queueCount ? queues[familyIndex].queueCount : 0;
+}
+
+static bool
+_SupportsTimelineSemaphore(VkPhysicalDevice physicalDevice)
+{
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(
+        physicalDevice, nullptr, &extensionCount, nullptr);
+
+    std::vector<VkExtensionProperties> extensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(
+        physicalDevice, nullptr, &extensionCount, extensions.data());
+
+    // When the extension is supported the timelineSemaphore feature must be
+    // supported too.
+    for (VkExtensionProperties const& ext : extensions) {
+        if (!strcmp(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME,
+                    ext.extensionName)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 static bool
 _SupportsPresentation(
     VkPhysicalDevice physicalDevice,
@@ -69,12 +266,35 @@ HgiVkDevice::HgiVkDevice(
     , _vkDevice(nullptr)
     , _vkQueueFamilyIndex(0)
     , _vkQueue(nullptr)
+    , _vkTransferQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+    , _vkTransferQueue(nullptr)
+    , _vkComputeQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+    , _vkComputeQueueIndex(0)
+    , _vkComputeQueue(nullptr)
     , _vkPipelineCache(nullptr)
+    , _vkTimelineSemaphore(nullptr)
     , _supportsDebugMarkers(false)
     , _supportsTimeStamps(false)
-    , _frame(~0ull)
+    , _supportsDrawIndirectCount(false)
+    , _supportsSamplerMirrorClampToEdge(false)
+    , _supportsBindlessTextures(false)
+    , _maxBindlessTextures(0)
+    , _supportsPushDescriptor(false)
+    , _maxPushDescriptors(0)
+    , _vkWaitSemaphores(nullptr)
+    , _vkGetSemaphoreCounterValue(nullptr)
+    , _vkCmdDrawIndexedIndirectCount(nullptr)
+    , _vkCmdPushDescriptorSet(nullptr)
+    , _submissionThread(nullptr)
+    , _frame(0)
     , _frameStarted(false)
-    , _ringBufferIndex(-1)
+    , _readbackManager(nullptr)
+    , _fullscreenPass(nullptr)
+    , _mipGenerator(nullptr)
+    , _samplerCache(nullptr)
+    , _descriptorAllocator(nullptr)
+    , _layoutCache(nullptr)
+    , _bindlessTextures(nullptr)
 {
     //
     // Determine physical device
@@ -94,14 +314,16 @@ HgiVkDevice::HgiVkDevice(
     VkPhysicalDevice fallback = nullptr;
     bool discreteTimeStamps = false;
     bool fallbackTimeStamps = false;
-    uint32_t familyIndex = 0;
+    uint32_t discreteFamilyIndex = 0;
+    uint32_t fallbackFamilyIndex = 0;
 
     for (uint32_t i = 0; i < physicalDeviceCount; i++) {
         VkPhysicalDeviceProperties props;
         vkGetPhysicalDeviceProperties(physicalDevices[i], &props);
 
         bool timeStamps = false;
-        familyIndex = _GetGraphicsFamilyIndex(physicalDevices[i], &timeStamps);
+        uint32_t familyIndex =
+            _GetGraphicsFamilyIndex(physicalDevices[i], &timeStamps);
         if (familyIndex == VK_QUEUE_FAMILY_IGNORED) continue;
 
         if (deviceType == HgiVkPresentationType) {
@@ -114,19 +336,29 @@ HgiVkDevice::HgiVkDevice(
 
         if (props.apiVersion < VK_API_VERSION_1_0) continue;
 
+        // Frame pacing has no fallback for devices without timelines.
+        if (!_SupportsTimelineSemaphore(physicalDevices[i])) {
+            TF_WARN("Skipping GPU %s, it does not support "
+                    "VK_KHR_timeline_semaphore", props.deviceName);
+            continue;
+        }
+
         if (!discrete && props.deviceType==VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU){
             discrete = physicalDevices[i];
             discreteTimeStamps = timeStamps;
+            discreteFamilyIndex = familyIndex;
         }
 
         if (!fallback) {
             fallback = physicalDevices[i];
             fallbackTimeStamps = timeStamps;
+            fallbackFamilyIndex = familyIndex;
         }
     }
 
     _vkPhysicalDevice = discrete ? discrete : fallback;
     _supportsTimeStamps = discrete ? discreteTimeStamps : fallbackTimeStamps;
+    _vkQueueFamilyIndex = discrete ? discreteFamilyIndex : fallbackFamilyIndex;
 
     if (_vkPhysicalDevice) {
         vkGetPhysicalDeviceProperties(
@@ -176,12 +408,55 @@ HgiVkDevice::HgiVkDevice(
     // Create Device
     //
 
+    std::vector<VkDeviceQueueCreateInfo> queueInfos;
+    float queuePriorities[] = {1.0f, 1.0f};
+
+    // Compute work runs on a second queue so it can overlap with graphics.
+    // We prefer a compute-only family. If there is none we use a second queue
+    // of the graphics family. If that does not exist either, compute work is
+    // submitted on the graphics queue.
+    if (TfGetEnvSetting(HGIVK_ASYNC_COMPUTE)) {
+        _vkComputeQueueFamilyIndex = _GetComputeFamilyIndex(_vkPhysicalDevice);
+        _vkComputeQueueIndex = 0;
+
+        if (_vkComputeQueueFamilyIndex == VK_QUEUE_FAMILY_IGNORED &&
+            _GetQueueCount(_vkPhysicalDevice, _vkQueueFamilyIndex) > 1) {
+            _vkComputeQueueFamilyIndex = _vkQueueFamilyIndex;
+            _vkComputeQueueIndex = 1;
+        }
+    }
+
     VkDeviceQueueCreateInfo queueInfo =
         {VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO};
-    float queuePriorities[] = {1.0f};
-    queueInfo.queueFamilyIndex = familyIndex;
-    queueInfo.queueCount = 1;
+    queueInfo.queueFamilyIndex = _vkQueueFamilyIndex;
+    queueInfo.queueCount = _vkComputeQueueIndex + 1;
     queueInfo.pQueuePriorities = queuePriorities;
+    queueInfos.push_back(queueInfo);
+
+    if (_vkComputeQueueFamilyIndex != VK_QUEUE_FAMILY_IGNORED &&
+        _vkComputeQueueFamilyIndex != _vkQueueFamilyIndex) {
+        VkDeviceQueueCreateInfo computeInfo =
+            {VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO};
+        computeInfo.queueFamilyIndex = _vkComputeQueueFamilyIndex;
+        computeInfo.queueCount = 1;
+        computeInfo.pQueuePriorities = queuePriorities;
+        queueInfos.push_back(computeInfo);
+    }
+
+    // Staging uploads run on a dedicated transfer queue when the device has
+    // one. Otherwise uploads are recorded on the graphics queue.
+    if (TfGetEnvSetting(HGIVK_TRANSFER_QUEUE)) {
+        _vkTransferQueueFamilyIndex= _GetTransferFamilyIndex(_vkPhysicalDevice);
+    }
+
+    if (_vkTransferQueueFamilyIndex != VK_QUEUE_FAMILY_IGNORED) {
+        VkDeviceQueueCreateInfo transferInfo =
+            {VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO};
+        transferInfo.queueFamilyIndex = _vkTransferQueueFamilyIndex;
+        transferInfo.queueCount = 1;
+        transferInfo.pQueuePriorities = queuePriorities;
+        queueInfos.push_back(transferInfo);
+    }
 
     std::vector<const char*> extensions = {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME
@@ -212,13 +487,73 @@ HgiVkDevice::HgiVkDevice(
         extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
     }
 
+    // Frame pacing uses one timeline semaphore that counts completed frames.
+    // This extension is core as of 1.2. Physical devices without it are not
+    // selected.
+    extensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+
+    // Lets indirect draws read their draw count from a buffer.
+    // This extension is core as of 1.2.
+    _supportsDrawIndirectCount =
+        _IsSupportedExtension(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+    if (_supportsDrawIndirectCount) {
+        extensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+    }
+
+    // Lets samplers mirror the texture once (HgiSamplerAddressMode).
+    // This extension is core as of 1.2.
+    _supportsSamplerMirrorClampToEdge =
+        _IsSupportedExtension(VK_KHR_SAMPLER_MIRROR_CLAMP_TO_EDGE_EXTENSION_NAME);
+    if (_supportsSamplerMirrorClampToEdge) {
+        extensions.push_back(VK_KHR_SAMPLER_MIRROR_CLAMP_TO_EDGE_EXTENSION_NAME);
+    }
+
+    // Lets transient resource bindings write their descriptors directly into
+    // the command buffer (HgiResourceBindingsDesc::transient).
+    _supportsPushDescriptor =
+        _IsSupportedExtension(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+    if (_supportsPushDescriptor) {
+        _maxPushDescriptors = _QueryMaxPushDescriptors(instance);
+        _supportsPushDescriptor = _maxPushDescriptors > 0;
+    }
+    if (_supportsPushDescriptor) {
+        extensions.push_back(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+    }
+
+    // Bindless textures index a global, partially bound array of textures
+    // that is updated while in use. This extension is core as of 1.2.
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures =
+        {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT};
+
+    if (TfGetEnvSetting(HGIVK_BINDLESS_TEXTURES) &&
+        _IsSupportedExtension(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) &&
+        _IsSupportedExtension(VK_KHR_MAINTENANCE3_EXTENSION_NAME)) {
+        _supportsBindlessTextures = _QueryDescriptorIndexing(
+            instance,
+            &indexingFeatures);
+        if (_supportsBindlessTextures) {
+            extensions.push_back(VK_KHR_MAINTENANCE3_EXTENSION_NAME);
+            extensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+        } else {
+            TF_WARN("Device does not support bindless textures");
+        }
+    }
+
     // This extension is needed to allow the viewport to be flipped in Y so that
     // shaders and vertex data can remain the same between opengl and vulkan.
     // See GraphicsEncoder::SetViewport. This extension is core as of 1.1.
     extensions.push_back(VK_KHR_MAINTENANCE1_EXTENSION_NAME);
 
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineFeatures =
+        {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR};
+    timelineFeatures.timelineSemaphore = VK_TRUE;
+    if (_supportsBindlessTextures) {
+        timelineFeatures.pNext = &indexingFeatures;
+    }
+
     VkPhysicalDeviceFeatures2 features =
         {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+    features.pNext = &timelineFeatures;
 
     features.features.samplerAnisotropy =
         _vkDeviceFeatures.samplerAnisotropy;
@@ -226,14 +561,20 @@ HgiVkDevice::HgiVkDevice(
         _vkDeviceFeatures.shaderSampledImageArrayDynamicIndexing;
     features.features.shaderStorageImageArrayDynamicIndexing =
         _vkDeviceFeatures.shaderStorageImageArrayDynamicIndexing;
+    features.features.shaderStorageImageExtendedFormats =
+        _vkDeviceFeatures.shaderStorageImageExtendedFormats;
     features.features.sampleRateShading =
         _vkDeviceFeatures.sampleRateShading;
     features.features.tessellationShader =
         _vkDeviceFeatures.tessellationShader;
+    features.features.multiDrawIndirect =
+        _vkDeviceFeatures.multiDrawIndirect;
+    features.features.drawIndirectFirstInstance =
+        _vkDeviceFeatures.drawIndirectFirstInstance;
 
     VkDeviceCreateInfo createInfo = {VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
-    createInfo.queueCreateInfoCount = 1;
-    createInfo.pQueueCreateInfos = &queueInfo;
+    createInfo.queueCreateInfoCount = (uint32_t) queueInfos.size();
+    createInfo.pQueueCreateInfos = queueInfos.data();
     createInfo.ppEnabledExtensionNames = extensions.data();
     createInfo.enabledExtensionCount = (uint32_t)extensions.size();
     createInfo.pNext = &features;
@@ -268,29 +609,135 @@ HgiVkDevice::HgiVkDevice(
         vmaCreateAllocator(&allocatorInfo, &_vmaAllocator) == VK_SUCCESS
     );
 
+    _readbackManager = new HgiVkReadbackManager(this);
+
+    _samplerCache = new HgiVkSamplerCache(this);
+
+    _descriptorAllocator = new HgiVkDescriptorAllocator(this);
+
+    _layoutCache = new HgiVkLayoutCache(this);
+
+    if (_supportsBindlessTextures) {
+        _bindlessTextures =
+            new HgiVkBindlessTextures(this, _maxBindlessTextures);
+    }
+
     //
-    // Device Queue
+    // Pipeline cache
     //
 
-    // todo For async compute we need to grab a second queue that supports
-    // compute. Dispatch the compute work there and use a fence to verify when
-    // the async compute work is done. If it's a different queue family index we
-    // also need different commandpool/bufs. (See HgiVkCommandPool constructor)
+    _CreatePipelineCache();
+
+    //
+    // Device Queue
+    //
 
     const uint32_t queueIndex = 0;
     vkGetDeviceQueue(_vkDevice, _vkQueueFamilyIndex, queueIndex, &_vkQueue);
 
+    // The compute queue is synchronized with the graphics queue via the
+    // semaphores of the command buffer manager. If it's a different queue
+    // family index we also need different commandpool/bufs.
+    // (See HgiVkCommandPool constructor)
+    if (_vkComputeQueueFamilyIndex != VK_QUEUE_FAMILY_IGNORED) {
+        vkGetDeviceQueue(
+            _vkDevice,
+            _vkComputeQueueFamilyIndex,
+            _vkComputeQueueIndex,
+            &_vkComputeQueue);
+    }
+
+    if (_vkTransferQueueFamilyIndex != VK_QUEUE_FAMILY_IGNORED) {
+        vkGetDeviceQueue(
+            _vkDevice,
+            _vkTransferQueueFamilyIndex,
+            queueIndex,
+            &_vkTransferQueue);
+    }
+
+    //
+    // Frame timeline
+    //
+
+    _vkWaitSemaphores = (PFN_vkWaitSemaphoresKHR)
+        vkGetDeviceProcAddr(_vkDevice, "vkWaitSemaphoresKHR");
+    _vkGetSemaphoreCounterValue = (PFN_vkGetSemaphoreCounterValueKHR)
+        vkGetDeviceProcAddr(_vkDevice, "vkGetSemaphoreCounterValueKHR");
+    TF_VERIFY(_vkWaitSemaphores && _vkGetSemaphoreCounterValue);
+
+    if (_supportsDrawIndirectCount) {
+        _vkCmdDrawIndexedIndirectCount =
+            (PFN_vkCmdDrawIndexedIndirectCountKHR) vkGetDeviceProcAddr(
+                _vkDevice, "vkCmdDrawIndexedIndirectCountKHR");
+        _supportsDrawIndirectCount = _vkCmdDrawIndexedIndirectCount!=nullptr;
+    }
+
+    if (_supportsPushDescriptor) {
+        _vkCmdPushDescriptorSet =
+            (PFN_vkCmdPushDescriptorSetKHR) vkGetDeviceProcAddr(
+                _vkDevice, "vkCmdPushDescriptorSetKHR");
+        _supportsPushDescriptor = _vkCmdPushDescriptorSet != nullptr;
+    }
+
+    // The timeline value is the last frame the gpu has completed. Frame
+    // numbers start at 1 so the initial value of 0 means 'nothing completed'.
+    VkSemaphoreTypeCreateInfoKHR semaTypeInfo =
+        {VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR};
+    semaTypeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+    semaTypeInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaCreateInfo =
+        {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+    semaCreateInfo.pNext = &semaTypeInfo;
+
+    TF_VERIFY(
+        vkCreateSemaphore(
+            _vkDevice,
+            &semaCreateInfo,
+            HgiVkAllocator(),
+            &_vkTimelineSemaphore) == VK_SUCCESS
+    );
+
+    HgiVkSetDebugName(
+        this,
+        (uint64_t)_vkTimelineSemaphore,
+        VK_DEBUG_REPORT_OBJECT_TYPE_SEMAPHORE_EXT,
+        "Semaphore Frame Timeline");
+
+    // vkQueueSubmit can be expensive for large frames. Optionally it is moved
+    // off the render thread to a thread that owns the submission to all of
+    // the device queues.
+    if (TfGetEnvSetting(HGIVK_SUBMISSION_THREAD)) {
+        _submissionThread = new HgiVkSubmissionThread();
+    }
+
     // Create the ring-buffer render frames.
-    for (size_t i=0; i< HgiVkRingBufferSize; i++) {
+    // A depth of 1 fully serializes cpu and gpu (lowest latency), while a
+    // deeper ring-buffer lets the cpu run further ahead (higher throughput).
+    const int framesInFlight =
+        std::max(1, TfGetEnvSetting(HGIVK_FRAMES_IN_FLIGHT));
+
+    for (int i=0; i<framesInFlight; i++) {
         HgiVkRenderFrame* frame = new HgiVkRenderFrame(this);
         std::string debugLabel = "Frame " + std::to_string(i);
         frame->SetDebugName(debugLabel);
         _frames.push_back(frame);
     }
+
+    // Compile the shaders of fullscreen operations up front, so their first
+    // use in a frame does not stall on the shader compiler.
+    _fullscreenPass = new HgiVkFullscreenPass(this);
+
+    // Downsample shaders are compiled per format on first use.
+    _mipGenerator = new HgiVkMipGenerator(this);
 }
 
 HgiVkDevice::~HgiVkDevice()
 {
+    // Hand all queued submissions to the device before we wait for it.
+    delete _submissionThread;
+    _submissionThread = nullptr;
+
     // Make sure device is done consuming all frames before destroying objects.
     TF_VERIFY(vkDeviceWaitIdle(_vkDevice) == VK_SUCCESS);
 
@@ -299,12 +746,45 @@ HgiVkDevice::~HgiVkDevice()
     // Then on clearing the frames, the garbage collector destroys them.
     _renderPassPipelineCache.Clear();
 
+    // The gpu is idle, so pending readbacks can release their buffers.
+    delete _readbackManager;
+    _readbackManager = nullptr;
+
+    delete _fullscreenPass;
+    _fullscreenPass = nullptr;
+
+    delete _mipGenerator;
+    _mipGenerator = nullptr;
+
     // Destroy vulkan objects in the frames before destroying this device.
     for (HgiVkRenderFrame* frame : _frames) {
         delete frame;
     }
     _frames.clear();
 
+    // After the frames, since destroyed textures release their samplers.
+    delete _samplerCache;
+    _samplerCache = nullptr;
+
+    // After the frames, since destroyed resource bindings free their sets.
+    delete _descriptorAllocator;
+    _descriptorAllocator = nullptr;
+
+    // After the frames, since destroyed resource bindings release layouts.
+    delete _layoutCache;
+    _layoutCache = nullptr;
+
+    // After the frames, since destroyed textures unregister themselves.
+    delete _bindlessTextures;
+    _bindlessTextures = nullptr;
+
+    vkDestroySemaphore(_vkDevice, _vkTimelineSemaphore, HgiVkAllocator());
+
+    if (_vkPipelineCache) {
+        SavePipelineCache();
+        vkDestroyPipelineCache(_vkDevice, _vkPipelineCache, HgiVkAllocator());
+    }
+
     vmaDestroyAllocator(_vmaAllocator);
     vkDestroyDevice(_vkDevice, HgiVkAllocator());
 }
@@ -319,12 +799,22 @@ HgiVkDevice::BeginFrame()
     _frame++;
 
     // Each new frame we reset what command buffers are used and switch to the
-    // next index in the 'ring buffer'. This ensures last frames command buffers
-    // are fully consumed by the gpu before we re-use them.
-    _ringBufferIndex = (_ringBufferIndex+1) % HgiVkRingBufferSize;
-    HgiVkRenderFrame* frame = _frames[_ringBufferIndex];
+    // next index in the 'ring buffer'. The frame waits on the timeline
+    // semaphore to ensure its previous command buffers are fully consumed by
+    // the gpu before we re-use them.
+    HgiVkRenderFrame* frame = _GetCurrentRenderFrame();
     frame->BeginFrame(_frame);
 
+    // The garbage of the frame was destroyed, return its descriptor sets.
+    _descriptorAllocator->BeginFrame();
+
+    // Deliver the readbacks of the frames the gpu has completed.
+    _readbackManager->BeginFrame();
+
+    // Release the objects of fullscreen operations of the completed frame.
+    _fullscreenPass->BeginFrame(_frame);
+    _mipGenerator->BeginFrame(_frame);
+
     // Ensure render pass and pipeline cache is configured for a new frame.
     _renderPassPipelineCache.BeginFrame(_frame);
 }
@@ -332,9 +822,12 @@ HgiVkDevice::BeginFrame()
 void
 HgiVkDevice::EndFrame()
 {
-    HgiVkRenderFrame* frame = _frames[_ringBufferIndex];
+    HgiVkRenderFrame* frame = _GetCurrentRenderFrame();
     frame->EndFrame();
 
+    // Readbacks of this frame may now be waited on.
+    _readbackManager->EndFrame(_frame);
+
     // Store all thread_local, newly created render passes.
     _renderPassPipelineCache.EndFrame();
 
@@ -344,36 +837,111 @@ HgiVkDevice::EndFrame()
 HgiVkCommandBufferManager*
 HgiVkDevice::GetCommandBufferManager()
 {
-    HgiVkRenderFrame* frame = _frames[_ringBufferIndex];
+    HgiVkRenderFrame* frame = _GetCurrentRenderFrame();
     return frame->GetCommandBufferManager();
 }
 
-void
+HgiVkStagingRing*
+HgiVkDevice::GetStagingRing()
+{
+    HgiVkRenderFrame* frame = _GetCurrentRenderFrame();
+    return frame->GetStagingRing();
+}
+
+HgiVkReadbackManager*
+HgiVkDevice::GetReadbackManager()
+{
+    return _readbackManager;
+}
+
+HgiVkFullscreenPass*
+HgiVkDevice::GetFullscreenPass()
+{
+    return _fullscreenPass;
+}
+
+HgiVkMipGenerator*
+HgiVkDevice::GetMipGenerator()
+{
+    return _mipGenerator;
+}
+
+HgiVkSamplerCache*
+HgiVkDevice::GetSamplerCache()
+{
+    return _samplerCache;
+}
+
+HgiVkDescriptorAllocator*
+HgiVkDevice::GetDescriptorAllocator()
+{
+    return _descriptorAllocator;
+}
+
+HgiVkLayoutCache*
+HgiVkDevice::GetLayoutCache()
+{
+    return _layoutCache;
+}
+
+HgiVkBindlessTextures*
+HgiVkDevice::GetBindlessTextures()
+{
+    return _bindlessTextures;
+}
+
+HgiVkSubmitFuture
 HgiVkDevice::SubmitToQueue(
     std::vector<VkSubmitInfo> const& submitInfos,
     VkFence fence)
 {
     /* MULTI-THREAD CALL*/
 
-    if (submitInfos.empty()) return;
-
     // The vkQueue must be externally synchronized. We can have another
     // thread submitting to the queue, such as a blitEncoder copy cmd or a
     // compute command that must be immediately submitted for CPU read back.
+    return _Submit(_vkQueue, &_queuelock, submitInfos, fence);
+}
+
+HgiVkSubmitFuture
+HgiVkDevice::SubmitToTransferQueue(
+    std::vector<VkSubmitInfo> const& submitInfos,
+    VkFence fence)
+{
+    /* MULTI-THREAD CALL*/
 
-    std::lock_guard<std::mutex> lock(_queuelock);
+    if (!TF_VERIFY(_vkTransferQueue, "No dedicated transfer queue")) {
+        return HgiVkSubmitFuture();
+    }
 
-    // Commit provided command buffers to queue.
-    // Record and submission order does not guarantee execution order.
-    // Vulkan docs: "Execution Model" and "Implicit Synchronization Guarantees".
+    return _Submit(_vkTransferQueue, &_transferQueuelock, submitInfos, fence);
+}
 
-    TF_VERIFY(
-        vkQueueSubmit(
-            _vkQueue,
-            (uint32_t) submitInfos.size(),
-            submitInfos.data(),
-            fence) == VK_SUCCESS
-    );
+HgiVkSubmitFuture
+HgiVkDevice::SubmitToComputeQueue(
+    std::vector<VkSubmitInfo> const& submitInfos,
+    VkFence fence)
+{
+    /* MULTI-THREAD CALL*/
+
+    if (!TF_VERIFY(_vkComputeQueue, "No async compute queue")) {
+        return HgiVkSubmitFuture();
+    }
+
+    return _Submit(_vkComputeQueue, &_computeQueuelock, submitInfos, fence);
+}
+
+HgiVkSubmitFuture
+HgiVkDevice::PresentToQueue(VkPresentInfoKHR const& presentInfo)
+{
+    /* MULTI-THREAD CALL*/
+
+    if (_submissionThread) {
+        return _submissionThread->Present(_vkQueue, &_queuelock, presentInfo);
+    }
+
+    return HgiVkSubmissionThread::PresentImmediate(
+        _vkQueue, &_queuelock, presentInfo);
 }
 
 VkDevice
@@ -430,12 +998,127 @@ HgiVkDevice::GetVulkanDeviceQueueFamilyIndex() const
     return _vkQueueFamilyIndex;
 }
 
+bool
+HgiVkDevice::HasDedicatedTransferQueue() const
+{
+    return _vkTransferQueue != nullptr;
+}
+
+VkQueue
+HgiVkDevice::GetVulkanTransferQueue() const
+{
+    return _vkTransferQueue;
+}
+
+uint32_t
+HgiVkDevice::GetVulkanTransferQueueFamilyIndex() const
+{
+    return _vkTransferQueueFamilyIndex;
+}
+
+bool
+HgiVkDevice::HasAsyncComputeQueue() const
+{
+    return _vkComputeQueue != nullptr;
+}
+
+VkQueue
+HgiVkDevice::GetVulkanComputeQueue() const
+{
+    return _vkComputeQueue;
+}
+
+uint32_t
+HgiVkDevice::GetVulkanComputeQueueFamilyIndex() const
+{
+    return _vkComputeQueue ? _vkComputeQueueFamilyIndex : _vkQueueFamilyIndex;
+}
+
+std::vector<uint32_t>
+HgiVkDevice::GetVulkanQueueFamilyIndices() const
+{
+    std::vector<uint32_t> families = {_vkQueueFamilyIndex};
+
+    for (uint32_t family : {_vkTransferQueueFamilyIndex,
+                            GetVulkanComputeQueueFamilyIndex()}) {
+        if (family != VK_QUEUE_FAMILY_IGNORED &&
+            std::find(families.begin(), families.end(), family) ==
+                families.end()) {
+            families.push_back(family);
+        }
+    }
+
+    return families;
+}
+
 VkPipelineCache
 HgiVkDevice::GetVulkanPipelineCache() const
 {
     return _vkPipelineCache;
 }
 
+void
+HgiVkDevice::SavePipelineCache()
+{
+    if (!_vkPipelineCache || !TfGetEnvSetting(HGIVK_PIPELINE_CACHE)) return;
+
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(
+            _vkDevice,
+            _vkPipelineCache,
+            &dataSize,
+            nullptr) != VK_SUCCESS || dataSize == 0) {
+        return;
+    }
+
+    std::vector<char> data(dataSize);
+    if (vkGetPipelineCacheData(
+            _vkDevice,
+            _vkPipelineCache,
+            &dataSize,
+            data.data()) != VK_SUCCESS) {
+        TF_WARN("Unable to retrieve vulkan pipeline cache data");
+        return;
+    }
+    data.resize(dataSize);
+
+    _PipelineCacheFileHeader header = {};
+    header.magic = _pipelineCacheMagic;
+    header.fileVersion = _pipelineCacheFileVersion;
+    header.vendorID = _vkDeviceProperties.vendorID;
+    header.deviceID = _vkDeviceProperties.deviceID;
+    header.driverVersion = _vkDeviceProperties.driverVersion;
+    memcpy(header.pipelineCacheUUID,
+           _vkDeviceProperties.pipelineCacheUUID,
+           VK_UUID_SIZE);
+    header.dataSize = data.size();
+    header.dataHash = ArchHash64(data.data(), data.size());
+
+    // Write to a temporary file and rename it on commit. This way a crash
+    // or a second process writing at the same time never leaves a partial
+    // cache file behind.
+    std::string reason;
+    TfAtomicOfstreamWrapper file(_GetPipelineCacheFilePath());
+    if (!file.Open(&reason)) {
+        TF_WARN("Unable to open pipeline cache file: %s", reason.c_str());
+        return;
+    }
+
+    file.GetStream().write((const char*)&header, sizeof(header));
+    file.GetStream().write(data.data(), data.size());
+
+    if (!file.GetStream() || !file.Commit(&reason)) {
+        TF_WARN("Unable to write pipeline cache file: %s", reason.c_str());
+        file.Cancel();
+    }
+}
+
+VkSemaphore
+HgiVkDevice::GetVulkanTimelineSemaphore() const
+{
+    return _vkTimelineSemaphore;
+}
+
 HgiVkShaderCompiler*
 HgiVkDevice::GetShaderCompiler()
 {
@@ -445,13 +1128,53 @@ HgiVkDevice::GetShaderCompiler()
 void
 HgiVkDevice::DestroyObject(HgiVkObject const& object)
 {
-    HgiVkRenderFrame* frame = _frames[_ringBufferIndex];
+    // Draw bundles that recorded the object can no longer be executed.
+    const void* recordable = nullptr;
+    switch (object.type) {
+        case HgiVkObjectTypeBuffer: recordable = object.buffer; break;
+        case HgiVkObjectTypePipeline: recordable = object.pipeline; break;
+        case HgiVkObjectTypeResourceBindings:
+            recordable = object.resourceBindings; break;
+        default: break;
+    }
+
+    if (recordable) {
+        std::lock_guard<std::mutex> lock(_drawBundlesLock);
+        for (HgiVkDrawBundle* bundle : _drawBundles) {
+            bundle->InvalidateIfUsing(recordable);
+        }
+    }
+
+    HgiVkRenderFrame* frame = _GetCurrentRenderFrame();
     frame->GetGarbageCollector()->ScheduleObjectDestruction(object);
 }
 
+void
+HgiVkDevice::RegisterDrawBundle(HgiVkDrawBundle* bundle)
+{
+    /* MULTI-THREAD CALL*/
+    std::lock_guard<std::mutex> lock(_drawBundlesLock);
+    _drawBundles.push_back(bundle);
+}
+
+void
+HgiVkDevice::UnregisterDrawBundle(HgiVkDrawBundle* bundle)
+{
+    /* MULTI-THREAD CALL*/
+    std::lock_guard<std::mutex> lock(_drawBundlesLock);
+    _drawBundles.erase(
+        std::remove(_drawBundles.begin(), _drawBundles.end(), bundle),
+        _drawBundles.end());
+}
+
 void
 HgiVkDevice::WaitForIdle()
 {
+    // Queued submissions must reach the device before we can wait for it.
+    if (_submissionThread) {
+        _submissionThread->Flush();
+    }
+
     TF_VERIFY(
         vkDeviceWaitIdle(_vkDevice) == VK_SUCCESS
     );
@@ -463,6 +1186,45 @@ HgiVkDevice::GetCurrentFrame() const
     return _frame;
 }
 
+uint64_t
+HgiVkDevice::GetCompletedFrame() const
+{
+    /* MULTI-THREAD CALL*/
+
+    uint64_t value = 0;
+    TF_VERIFY(
+        _vkGetSemaphoreCounterValue(
+            _vkDevice,
+            _vkTimelineSemaphore,
+            &value) == VK_SUCCESS
+    );
+    return value;
+}
+
+void
+HgiVkDevice::WaitForFrame(uint64_t frame)
+{
+    /* MULTI-THREAD CALL*/
+
+    if (frame == 0 || GetCompletedFrame() >= frame) return;
+
+    VkSemaphoreWaitInfoKHR waitInfo =
+        {VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR};
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &_vkTimelineSemaphore;
+    waitInfo.pValues = &frame;
+
+    TF_VERIFY(
+        _vkWaitSemaphores(_vkDevice, &waitInfo, 100000000000) == VK_SUCCESS
+    );
+}
+
+uint32_t
+HgiVkDevice::GetFramesInFlight() const
+{
+    return (uint32_t) _frames.size();
+}
+
 void
 HgiVkDevice::GetDeviceMemoryInfo(size_t* used, size_t* unused) const
 {
@@ -493,13 +1255,221 @@ HgiVkDevice::GetDeviceSupportTimeStamps() const
     return _supportsTimeStamps;
 }
 
+bool
+HgiVkDevice::GetDeviceSupportMultiDrawIndirect() const
+{
+    return _vkDeviceFeatures.multiDrawIndirect;
+}
+
+bool
+HgiVkDevice::GetDeviceSupportDrawIndirectFirstInstance() const
+{
+    return _vkDeviceFeatures.drawIndirectFirstInstance;
+}
+
+bool
+HgiVkDevice::GetDeviceSupportDrawIndirectCount() const
+{
+    return _supportsDrawIndirectCount;
+}
+
+bool
+HgiVkDevice::GetDeviceSupportLazilyAllocatedMemory() const
+{
+    for (uint32_t i=0; i<_vkMemoryProperties.memoryTypeCount; i++) {
+        if (_vkMemoryProperties.memoryTypes[i].propertyFlags &
+            VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+HgiVkDevice::GetDeviceSupportSamplerMirrorClampToEdge() const
+{
+    return _supportsSamplerMirrorClampToEdge;
+}
+
+bool
+HgiVkDevice::GetDeviceSupportBindlessTextures() const
+{
+    return _supportsBindlessTextures;
+}
+
+bool
+HgiVkDevice::GetDeviceSupportPushDescriptor() const
+{
+    return _supportsPushDescriptor;
+}
+
+uint32_t
+HgiVkDevice::GetMaxPushDescriptors() const
+{
+    return _maxPushDescriptors;
+}
+
+void
+HgiVkDevice::CmdDrawIndexedIndirectCount(
+    VkCommandBuffer cb,
+    VkBuffer buffer,
+    VkDeviceSize offset,
+    VkBuffer countBuffer,
+    VkDeviceSize countBufferOffset,
+    uint32_t maxDrawCount,
+    uint32_t stride) const
+{
+    if (!TF_VERIFY(_vkCmdDrawIndexedIndirectCount)) return;
+
+    _vkCmdDrawIndexedIndirectCount(
+        cb,
+        buffer,
+        offset,
+        countBuffer,
+        countBufferOffset,
+        maxDrawCount,
+        stride);
+}
+
+void
+HgiVkDevice::CmdPushDescriptorSet(
+    VkCommandBuffer cb,
+    VkPipelineBindPoint bindPoint,
+    VkPipelineLayout layout,
+    uint32_t set,
+    uint32_t writeCount,
+    VkWriteDescriptorSet const* writes) const
+{
+    if (!TF_VERIFY(_vkCmdPushDescriptorSet)) return;
+
+    _vkCmdPushDescriptorSet(
+        cb,
+        bindPoint,
+        layout,
+        set,
+        writeCount,
+        writes);
+}
+
 HgiTimeQueryVector const &
 HgiVkDevice::GetTimeQueries() const
 {
-    HgiVkRenderFrame* frame = _frames[_ringBufferIndex];
+    HgiVkRenderFrame* frame = _GetCurrentRenderFrame();
     return frame->GetTimeQueries();
 }
 
+HgiVkBarrierStats const &
+HgiVkDevice::GetBarrierStats() const
+{
+    HgiVkRenderFrame* frame = _GetCurrentRenderFrame();
+    return frame->GetBarrierStats();
+}
+
+HgiVkDescriptorStats const &
+HgiVkDevice::GetDescriptorStats() const
+{
+    return _descriptorAllocator->GetStats();
+}
+
+bool
+HgiVkDevice::_QueryDescriptorIndexing(
+    HgiVkInstance* instance,
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT* enabledFeatures)
+{
+    // VK_KHR_get_physical_device_properties2 is enabled on the instance.
+    PFN_vkGetPhysicalDeviceFeatures2KHR getFeatures2 =
+        (PFN_vkGetPhysicalDeviceFeatures2KHR) vkGetInstanceProcAddr(
+            instance->GetVulkanInstance(),
+            "vkGetPhysicalDeviceFeatures2KHR");
+    PFN_vkGetPhysicalDeviceProperties2KHR getProperties2 =
+        (PFN_vkGetPhysicalDeviceProperties2KHR) vkGetInstanceProcAddr(
+            instance->GetVulkanInstance(),
+            "vkGetPhysicalDeviceProperties2KHR");
+    if (!getFeatures2 || !getProperties2) {
+        return false;
+    }
+
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT features =
+        {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT};
+    VkPhysicalDeviceFeatures2 features2 =
+        {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+    features2.pNext = &features;
+    getFeatures2(_vkPhysicalDevice, &features2);
+
+    if (!features.runtimeDescriptorArray ||
+        !features.descriptorBindingPartiallyBound ||
+        !features.descriptorBindingSampledImageUpdateAfterBind ||
+        !features.descriptorBindingUpdateUnusedWhilePending ||
+        !features.shaderSampledImageArrayNonUniformIndexing) {
+        return false;
+    }
+
+    VkPhysicalDeviceDescriptorIndexingPropertiesEXT props =
+        {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT};
+    VkPhysicalDeviceProperties2 props2 =
+        {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+    props2.pNext = &props;
+    getProperties2(_vkPhysicalDevice, &props2);
+
+    // Each texture is a combined image sampler, so it counts against both
+    // the sampler and the sampled image limits. The update-after-bind limits
+    // also count the descriptors of set 0 of the same pipeline layout, so
+    // part of each limit is left for them.
+    VkPhysicalDeviceLimits const& limits = props2.properties.limits;
+    _maxBindlessTextures = std::min({
+        _maxBindlessTexturesLimit,
+        _GetBindlessHeadroom(
+            props.maxDescriptorSetUpdateAfterBindSampledImages,
+            limits.maxDescriptorSetSampledImages),
+        _GetBindlessHeadroom(
+            props.maxDescriptorSetUpdateAfterBindSamplers,
+            limits.maxDescriptorSetSamplers),
+        _GetBindlessHeadroom(
+            props.maxPerStageDescriptorUpdateAfterBindSampledImages,
+            limits.maxPerStageDescriptorSampledImages),
+        _GetBindlessHeadroom(
+            props.maxPerStageDescriptorUpdateAfterBindSamplers,
+            limits.maxPerStageDescriptorSamplers),
+        _GetBindlessHeadroom(
+            props.maxPerStageUpdateAfterBindResources,
+            limits.maxPerStageResources)});
+
+    if (_maxBindlessTextures == 0) {
+        return false;
+    }
+
+    // Only enable what we use.
+    enabledFeatures->runtimeDescriptorArray = VK_TRUE;
+    enabledFeatures->descriptorBindingPartiallyBound = VK_TRUE;
+    enabledFeatures->descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    enabledFeatures->descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+    enabledFeatures->shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+
+    return true;
+}
+
+uint32_t
+HgiVkDevice::_QueryMaxPushDescriptors(HgiVkInstance* instance)
+{
+    // VK_KHR_get_physical_device_properties2 is enabled on the instance.
+    PFN_vkGetPhysicalDeviceProperties2KHR getProperties2 =
+        (PFN_vkGetPhysicalDeviceProperties2KHR) vkGetInstanceProcAddr(
+            instance->GetVulkanInstance(),
+            "vkGetPhysicalDeviceProperties2KHR");
+    if (!getProperties2) {
+        return 0;
+    }
+
+    VkPhysicalDevicePushDescriptorPropertiesKHR props =
+        {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR};
+    VkPhysicalDeviceProperties2 props2 =
+        {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+    props2.pNext = &props;
+    getProperties2(_vkPhysicalDevice, &props2);
+
+    return props.maxPushDescriptors;
+}
+
 bool
 HgiVkDevice::_IsSupportedExtension(const char* extensionName) const
 {
@@ -512,5 +1482,107 @@ HgiVkDevice::_IsSupportedExtension(const char* extensionName) const
     return false;
 }
 
+void
+HgiVkDevice::_CreatePipelineCache()
+{
+    // Seed the cache with the data from the previous run if the file was
+    // written by the same device and driver. Stale or corrupt files are
+    // ignored and will be overwritten when the cache is saved again.
+    std::vector<char> data;
+
+    if (TfGetEnvSetting(HGIVK_PIPELINE_CACHE)) {
+        std::ifstream file(_GetPipelineCacheFilePath(), std::ios::binary);
+        _PipelineCacheFileHeader header = {};
+
+        if (file && file.read((char*)&header, sizeof(header)) &&
+            _IsPipelineCacheFileHeaderValid(header, _vkDeviceProperties)) {
+
+            data.assign(std::istreambuf_iterator<char>(file),
+                        std::istreambuf_iterator<char>());
+
+            if (data.size() != header.dataSize ||
+                ArchHash64(data.data(), data.size()) != header.dataHash ||
+                !_IsPipelineCacheDataValid(data, _vkDeviceProperties)) {
+                TF_WARN("Ignoring corrupt vulkan pipeline cache file");
+                data.clear();
+            }
+        }
+    }
+
+    VkPipelineCacheCreateInfo cacheInfo =
+        {VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+    cacheInfo.initialDataSize = data.size();
+    cacheInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+    if (vkCreatePipelineCache(
+            _vkDevice,
+            &cacheInfo,
+            HgiVkAllocator(),
+            &_vkPipelineCache) != VK_SUCCESS && !data.empty()) {
+        // Driver rejected the data. Start with an empty cache.
+        cacheInfo.initialDataSize = 0;
+        cacheInfo.pInitialData = nullptr;
+        TF_VERIFY(
+            vkCreatePipelineCache(
+                _vkDevice,
+                &cacheInfo,
+                HgiVkAllocator(),
+                &_vkPipelineCache) == VK_SUCCESS
+        );
+    }
+
+    HgiVkSetDebugName(
+        this,
+        (uint64_t)_vkPipelineCache,
+        VK_DEBUG_REPORT_OBJECT_TYPE_PIPELINE_CACHE_EXT,
+        "PipelineCache");
+}
+
+HgiVkSubmitFuture
+HgiVkDevice::_Submit(
+    VkQueue queue,
+    std::mutex* queueLock,
+    std::vector<VkSubmitInfo> const& submitInfos,
+    VkFence fence)
+{
+    /* MULTI-THREAD CALL*/
+
+    if (submitInfos.empty()) return HgiVkSubmitFuture();
+
+    // All queues go via the submission thread (when enabled) so that the
+    // submission order between the queues is preserved.
+    if (_submissionThread) {
+        return _submissionThread->Submit(queue, queueLock, submitInfos, fence);
+    }
+
+    return HgiVkSubmissionThread::SubmitImmediate(
+        queue, queueLock, submitInfos, fence);
+}
+
+HgiVkRenderFrame*
+HgiVkDevice::_GetCurrentRenderFrame() const
+{
+    return _frames[_frame % _frames.size()];
+}
+
+std::string
+HgiVkDevice::_GetPipelineCacheFilePath() const
+{
+    std::string dir = TfGetEnvSetting(HGIVK_PIPELINE_CACHE_DIR);
+    if (dir.empty()) {
+        dir = ArchGetTmpDir();
+    }
+
+    // One file per device and driver so multi-gpu machines or driver updates
+    // do not keep invalidating each others cache.
+    std::string fileName = TfStringPrintf(
+        "hgiVk_pipelineCache_%x_%x_%x.bin",
+        _vkDeviceProperties.vendorID,
+        _vkDeviceProperties.deviceID,
+        _vkDeviceProperties.driverVersion);
+
+    return TfStringCatPaths(dir, fileName);
+}
+
 
 PXR_NAMESPACE_CLOSE_SCOPE
@@ -2,14 +2,17 @@
 #define PXR_IMAGING_HGIVK_DEVICE_H
 
 #include <mutex>
+#include <string>
 #include <vector>
 
 #include "pxr/pxr.h"
 #include "pxr/imaging/hgiVk/api.h"
+#include "pxr/imaging/hgiVk/descriptorAllocator.h"
 #include "pxr/imaging/hgiVk/frame.h"
 #include "pxr/imaging/hgiVk/object.h"
 #include "pxr/imaging/hgiVk/renderPassPipelineCache.h"
 #include "pxr/imaging/hgiVk/shaderCompiler.h"
+#include "pxr/imaging/hgiVk/submissionThread.h"
 #include "pxr/imaging/hgiVk/vulkan.h"
 
 
@@ -20,12 +23,20 @@ class HgiVkCommands;
 class HgiVkCommandBuffer;
 class HgiVkCommandBufferManager;
 class HgiVkCommandPool;
+class HgiVkDrawBundle;
+class HgiVkFullscreenPass;
+class HgiVkMipGenerator;
+class HgiVkReadbackManager;
+class HgiVkBindlessTextures;
+class HgiVkLayoutCache;
+class HgiVkSamplerCache;
 
 
 /// Device configuration settings
+/// The number of frames in flight (ring buffer depth) is a runtime setting.
+/// See HGIVK_FRAMES_IN_FLIGHT and HgiVkDevice::GetFramesInFlight.
 enum HgiVkDeviceSettings{
-    HgiVkPresentationType = 0,
-    HgiVkRingBufferSize = 3
+    HgiVkPresentationType = 0
 };
 
 
@@ -58,14 +69,88 @@ public:
     HGIVK_API
     HgiVkCommandBufferManager* GetCommandBufferManager();
 
+    /// Returns the staging ring of the current frame.
+    /// Data that is uploaded via the ring must be copied to the gpu by
+    /// command buffers of the same frame.
+    /// Do not hold onto this ptr. It is valid only for one frame and must be
+    /// re-acquired each frame.
+    HGIVK_API
+    HgiVkStagingRing* GetStagingRing();
+
+    /// Returns the manager of asynchronous gpu to cpu copies.
+    /// Unlike the staging ring, the manager is shared by all frames.
+    HGIVK_API
+    HgiVkReadbackManager* GetReadbackManager();
+
+    /// Returns the helper that records fullscreen operations, such as depth
+    /// resolves. Its shaders are compiled when the device is created.
+    HGIVK_API
+    HgiVkFullscreenPass* GetFullscreenPass();
+
+    /// Returns the compute downsample used to generate the mips of textures
+    /// whose format cannot be blitted.
+    HGIVK_API
+    HgiVkMipGenerator* GetMipGenerator();
+
+    /// Returns the cache that shares one VkSampler between all samplers and
+    /// textures with the same sampler state.
+    HGIVK_API
+    HgiVkSamplerCache* GetSamplerCache();
+
+    /// Returns the allocator of the descriptor sets of resource bindings.
+    HGIVK_API
+    HgiVkDescriptorAllocator* GetDescriptorAllocator();
+
+    /// Returns the cache that shares descriptor set layouts and pipeline
+    /// layouts between resource bindings of the same shape.
+    HGIVK_API
+    HgiVkLayoutCache* GetLayoutCache();
+
+    /// Returns the global array of sampled textures, or nullptr if bindless
+    /// textures are disabled (see GetDeviceSupportBindlessTextures).
+    HGIVK_API
+    HgiVkBindlessTextures* GetBindlessTextures();
+
     /// Commits provided command buffers to queue.
     /// `fence` is optional and can be nullptr.
+    /// With HGIVK_SUBMISSION_THREAD enabled the submission happens later on
+    /// the submission thread. The returned future becomes ready once the
+    /// command buffers were handed to the queue and holds the cpu time that
+    /// took. The future is invalid if there was nothing to submit.
+    /// Thread safety: This call ensures only one thread can submit at once.
+    HGIVK_API
+    HgiVkSubmitFuture SubmitToQueue(
+        std::vector<VkSubmitInfo> const& submitInfos,
+        VkFence fence);
+
+    /// Commits provided command buffers to the dedicated transfer queue.
+    /// Only valid if HasDedicatedTransferQueue returns true.
+    /// `fence` is optional and can be nullptr.
+    /// Returns a future, see SubmitToQueue.
+    /// Thread safety: This call ensures only one thread can submit at once.
+    HGIVK_API
+    HgiVkSubmitFuture SubmitToTransferQueue(
+        std::vector<VkSubmitInfo> const& submitInfos,
+        VkFence fence);
+
+    /// Commits provided command buffers to the async compute queue.
+    /// Only valid if HasAsyncComputeQueue returns true.
+    /// `fence` is optional and can be nullptr.
+    /// Returns a future, see SubmitToQueue.
     /// Thread safety: This call ensures only one thread can submit at once.
     HGIVK_API
-    void SubmitToQueue(
+    HgiVkSubmitFuture SubmitToComputeQueue(
         std::vector<VkSubmitInfo> const& submitInfos,
         VkFence fence);
 
+    /// Presents swapchain images on the graphics queue. The presentation is
+    /// ordered after all earlier submissions. Returns a future, see
+    /// SubmitToQueue. Out-of-date swapchains are not reported here, they are
+    /// detected when the next swapchain image is acquired.
+    /// Thread safety: This call ensures only one thread can submit at once.
+    HGIVK_API
+    HgiVkSubmitFuture PresentToQueue(VkPresentInfoKHR const& presentInfo);
+
     /// Returns the vulkan device
     HGIVK_API
     VkDevice GetVulkanDevice() const;
@@ -105,10 +190,60 @@ public:
     HGIVK_API
     uint32_t GetVulkanDeviceQueueFamilyIndex() const;
 
+    /// Returns true if the device has a transfer-only queue (usually DMA)
+    /// that uploads can use to overlap with graphics work.
+    HGIVK_API
+    bool HasDedicatedTransferQueue() const;
+
+    /// Returns the dedicated transfer queue or nullptr if there is none.
+    HGIVK_API
+    VkQueue GetVulkanTransferQueue() const;
+
+    /// Returns the family index of the dedicated transfer queue or
+    /// VK_QUEUE_FAMILY_IGNORED if there is none.
+    HGIVK_API
+    uint32_t GetVulkanTransferQueueFamilyIndex() const;
+
+    /// Returns true if the device has a second queue for compute work that
+    /// can run alongside the graphics queue (HGIVK_ASYNC_COMPUTE).
+    HGIVK_API
+    bool HasAsyncComputeQueue() const;
+
+    /// Returns the async compute queue or nullptr if there is none.
+    HGIVK_API
+    VkQueue GetVulkanComputeQueue() const;
+
+    /// Returns the family index of the queue that compute work is submitted
+    /// to. This is the graphics family if there is no async compute queue, or
+    /// if the async compute queue is a second queue of the graphics family.
+    HGIVK_API
+    uint32_t GetVulkanComputeQueueFamilyIndex() const;
+
+    /// Returns the unique family indices of all queues the device uses.
+    /// Resources that are shared between queues without ownership transfers
+    /// are created with VK_SHARING_MODE_CONCURRENT for these families.
+    HGIVK_API
+    std::vector<uint32_t> GetVulkanQueueFamilyIndices() const;
+
     /// Returns the vulkan pipeline cache
     HGIVK_API
     VkPipelineCache GetVulkanPipelineCache() const;
 
+    /// Returns the timeline semaphore that counts the frames the gpu has
+    /// completed. Each frame signals its frame number on this semaphore.
+    HGIVK_API
+    VkSemaphore GetVulkanTimelineSemaphore() const;
+
+    /// Writes the pipeline cache to disk so the next process that creates a
+    /// device for the same GPU and driver can skip most pipeline compilation.
+    /// The file is written atomically (temp file + rename).
+    /// This is called during device destruction, but may be called at any
+    /// time (e.g. after the first frame of a large stage has been drawn).
+    /// Thread safety: The pipeline cache is internally synchronized by vulkan,
+    /// but this call should not be made from multiple threads at once.
+    HGIVK_API
+    void SavePipelineCache();
+
     /// Returns the glsl to SPIRV shader compiler
     HGIVK_API
     HgiVkShaderCompiler* GetShaderCompiler();
@@ -122,15 +257,44 @@ public:
     HGIVK_API
     void DestroyObject(HgiVkObject const& object);
 
+    /// Registers a draw bundle. When a pipeline, resource bindings or buffer
+    /// is destroyed (DestroyObject) the bundles that recorded it are
+    /// invalidated.
+    /// Thread safety: May be called from any thread.
+    HGIVK_API
+    void RegisterDrawBundle(HgiVkDrawBundle* bundle);
+
+    /// Unregisters a draw bundle that is being destroyed.
+    /// Thread safety: May be called from any thread.
+    HGIVK_API
+    void UnregisterDrawBundle(HgiVkDrawBundle* bundle);
+
     /// Wait for all queued up commands to have been processed on device.
+    /// This includes submissions still queued on the submission thread.
     /// This should ideally never be used as it creates very big stalls.
     HGIVK_API
     void WaitForIdle();
 
     /// Returns the (internal) frame counter value.
+    /// The first frame is 1. Frame 0 means no frame has been started.
     HGIVK_API
     uint64_t GetCurrentFrame() const;
 
+    /// Returns the last frame the gpu has fully completed.
+    /// Any object used in a frame <= this value is no longer in use by the gpu.
+    HGIVK_API
+    uint64_t GetCompletedFrame() const;
+
+    /// Blocks the cpu until the gpu has completed the provided frame.
+    /// Returns immediately if the frame was already completed.
+    HGIVK_API
+    void WaitForFrame(uint64_t frame);
+
+    /// Returns the number of frames the cpu may record ahead of the gpu.
+    /// This is the depth of the frame ring-buffer (HGIVK_FRAMES_IN_FLIGHT).
+    HGIVK_API
+    uint32_t GetFramesInFlight() const;
+
     /// Returns device used and unused memmory.
     HGIVK_API
     void GetDeviceMemoryInfo(size_t* used, size_t* unused) const;
@@ -143,9 +307,86 @@ public:
     HGIVK_API
     bool GetDeviceSupportTimeStamps() const;
 
+    /// Returns true if indirect draws can execute more than one draw
+    /// (multiDrawIndirect feature).
+    HGIVK_API
+    bool GetDeviceSupportMultiDrawIndirect() const;
+
+    /// Returns true if indirect draws can start at a firstInstance other than
+    /// zero (drawIndirectFirstInstance feature). Without it the firstInstance
+    /// of every indirect command must be zero.
+    HGIVK_API
+    bool GetDeviceSupportDrawIndirectFirstInstance() const;
+
+    /// Returns true if indirect draws can read the draw count from a buffer
+    /// (VK_KHR_draw_indirect_count).
+    HGIVK_API
+    bool GetDeviceSupportDrawIndirectCount() const;
+
+    /// Returns true if the device has lazily allocated memory, which
+    /// transient attachments (HgiTextureUsageBitsTransient) can use so they
+    /// may never be backed by memory on tiled gpus.
+    HGIVK_API
+    bool GetDeviceSupportLazilyAllocatedMemory() const;
+
+    /// Returns true if samplers can use VK_SAMPLER_ADDRESS_MODE_MIRROR_CLAMP_TO_EDGE
+    /// (VK_KHR_sampler_mirror_clamp_to_edge).
+    HGIVK_API
+    bool GetDeviceSupportSamplerMirrorClampToEdge() const;
+
+    /// Returns true if sampled textures are registered into a global
+    /// descriptor array (HGIVK_BINDLESS_TEXTURES and
+    /// VK_EXT_descriptor_indexing).
+    HGIVK_API
+    bool GetDeviceSupportBindlessTextures() const;
+
+    /// Returns true if descriptors can be pushed into command buffers
+    /// (VK_KHR_push_descriptor).
+    HGIVK_API
+    bool GetDeviceSupportPushDescriptor() const;
+
+    /// Returns the maximum number of descriptors in a push descriptor set.
+    HGIVK_API
+    uint32_t GetMaxPushDescriptors() const;
+
+    /// Records vkCmdDrawIndexedIndirectCountKHR.
+    /// Requires GetDeviceSupportDrawIndirectCount.
+    HGIVK_API
+    void CmdDrawIndexedIndirectCount(
+        VkCommandBuffer cb,
+        VkBuffer buffer,
+        VkDeviceSize offset,
+        VkBuffer countBuffer,
+        VkDeviceSize countBufferOffset,
+        uint32_t maxDrawCount,
+        uint32_t stride) const;
+
+    /// Records vkCmdPushDescriptorSetKHR.
+    /// Requires GetDeviceSupportPushDescriptor.
+    HGIVK_API
+    void CmdPushDescriptorSet(
+        VkCommandBuffer cb,
+        VkPipelineBindPoint bindPoint,
+        VkPipelineLayout layout,
+        uint32_t set,
+        uint32_t writeCount,
+        VkWriteDescriptorSet const* writes) const;
+
     /// Returns time queries recorded in the previous run of the current frame.
     HgiTimeQueryVector const & GetTimeQueries() const;
 
+    /// Returns the barrier counts of the last run of the current frame.
+    /// `barriers` is the number of barriers that were requested and
+    /// `pipelineBarriers` the number of vkCmdPipelineBarrier calls after
+    /// batching.
+    HGIVK_API
+    HgiVkBarrierStats const & GetBarrierStats() const;
+
+    /// Returns the descriptor pool and set counts and the descriptor set
+    /// allocation time of the previous frame.
+    HGIVK_API
+    HgiVkDescriptorStats const & GetDescriptorStats() const;
+
 private:
     HgiVkDevice() = delete;
     HgiVkDevice & operator=(const HgiVkDevice&) = delete;
@@ -154,6 +395,33 @@ private:
     // Returns true if the provided extension is supported by the device
     bool _IsSupportedExtension(const char* extensionName) const;
 
+    // Returns true if the physical device has the descriptor indexing
+    // features bindless textures need. Fills `enabledFeatures` with those
+    // features and sets the size of the global texture array.
+    bool _QueryDescriptorIndexing(
+        HgiVkInstance* instance,
+        VkPhysicalDeviceDescriptorIndexingFeaturesEXT* enabledFeatures);
+
+    // Returns the maximum number of descriptors in a push descriptor set.
+    uint32_t _QueryMaxPushDescriptors(HgiVkInstance* instance);
+
+    // Creates the pipeline cache and seeds it from disk if a valid cache file
+    // exists for this physical device and driver.
+    void _CreatePipelineCache();
+
+    // Returns the file path of the pipeline cache for this physical device.
+    std::string _GetPipelineCacheFilePath() const;
+
+    // Submits to the queue directly or via the submission thread.
+    HgiVkSubmitFuture _Submit(
+        VkQueue queue,
+        std::mutex* queueLock,
+        std::vector<VkSubmitInfo> const& submitInfos,
+        VkFence fence);
+
+    // Returns the render frame (ring-buffer slot) of the current frame.
+    HgiVkRenderFrame* _GetCurrentRenderFrame() const;
+
 private:
     // Vulkan device objects
     VmaAllocator _vmaAllocator;
@@ -164,13 +432,40 @@ private:
     VkDevice _vkDevice;
     uint32_t _vkQueueFamilyIndex;
     VkQueue _vkQueue;
+    uint32_t _vkTransferQueueFamilyIndex;
+    VkQueue _vkTransferQueue;
+    uint32_t _vkComputeQueueFamilyIndex;
+    uint32_t _vkComputeQueueIndex;
+    VkQueue _vkComputeQueue;
     VkPipelineCache _vkPipelineCache;
+    VkSemaphore _vkTimelineSemaphore;
     std::vector<VkExtensionProperties> _extensions;
     bool _supportsDebugMarkers;
     bool _supportsTimeStamps;
+    bool _supportsDrawIndirectCount;
+    bool _supportsSamplerMirrorClampToEdge;
+    bool _supportsBindlessTextures;
+    uint32_t _maxBindlessTextures;
+    bool _supportsPushDescriptor;
+    uint32_t _maxPushDescriptors;
+
+    // VK_KHR_timeline_semaphore functions
+    PFN_vkWaitSemaphoresKHR _vkWaitSemaphores;
+    PFN_vkGetSemaphoreCounterValueKHR _vkGetSemaphoreCounterValue;
+
+    // VK_KHR_draw_indirect_count functions
+    PFN_vkCmdDrawIndexedIndirectCountKHR _vkCmdDrawIndexedIndirectCount;
+
+    // VK_KHR_push_descriptor functions
+    PFN_vkCmdPushDescriptorSetKHR _vkCmdPushDescriptorSet;
 
     // Vulkan queue is externally synchronized
     std::mutex _queuelock;
+    std::mutex _transferQueuelock;
+    std::mutex _computeQueuelock;
+
+    // Optional thread that submits to the queues (HGIVK_SUBMISSION_THREAD).
+    HgiVkSubmissionThread* _submissionThread;
 
     // glsl SPIRV shader compiler
     HgiVkShaderCompiler _shaderCompiler;
@@ -182,9 +477,35 @@ private:
     // Internal cache of render passes that map to client created pipelines.
     HgiVkRenderPassPipelineCache _renderPassPipelineCache;
 
+    // Asynchronous gpu to cpu copies of all frames.
+    HgiVkReadbackManager* _readbackManager;
+
+    // Fullscreen operations (depth resolve, format conversion, downsample).
+    HgiVkFullscreenPass* _fullscreenPass;
+
+    // Compute mip generation (see HgiTextureDesc::generateMips).
+    HgiVkMipGenerator* _mipGenerator;
+
+    // Deduplicated, refcounted samplers of all textures and samplers.
+    HgiVkSamplerCache* _samplerCache;
+
+    // Shared, per-thread pools of resource binding descriptor sets.
+    HgiVkDescriptorAllocator* _descriptorAllocator;
+
+    // Refcounted layouts shared by resource bindings of the same shape.
+    HgiVkLayoutCache* _layoutCache;
+
+    // Global array of sampled textures when bindless textures are enabled.
+    HgiVkBindlessTextures* _bindlessTextures;
+
+    // Draw bundles that must be invalidated when objects they use are
+    // destroyed.
+    std::mutex _drawBundlesLock;
+    std::vector<HgiVkDrawBundle*> _drawBundles;
+
     // We can have multiple frames in-flight (ring-buffer) where the CPU is
     // recording new command for frame N while the GPU is rendering frame N-2.
-    int8_t _ringBufferIndex;
+    // The ring-buffer slot of a frame is: frame % _frames.size().
     HgiVkRenderFrameVector _frames;
 };
 
@@ -0,0 +1,214 @@
+#include "pxr/base/tf/diagnostic.h"
+
+#include "pxr/imaging/hgiVk/commandBuffer.h"
+#include "pxr/imaging/hgiVk/commandPool.h"
+#include "pxr/imaging/hgiVk/device.h"
+#include "pxr/imaging/hgiVk/drawBundle.h"
+#include "pxr/imaging/hgiVk/graphicsEncoder.h"
+#include "pxr/imaging/hgiVk/object.h"
+#include "pxr/imaging/hgiVk/renderPass.h"
+#include "pxr/imaging/hgiVk/texture.h"
+
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+
+HgiVkDrawBundle::HgiVkDrawBundle(
+    HgiVkDevice* device,
+    HgiGraphicsEncoderDesc const& desc)
+    : _device(device)
+    , _compatibilityKey(_GetCompatibilityKey(desc))
+    , _renderPass(nullptr)
+    , _isRecording(false)
+    , _isValid(false)
+{
+    // The bundle owns its render pass, so the render pass cache may destroy
+    // its render passes while the bundle is still in use.
+    _renderPass = new HgiVkRenderPass(device, desc);
+
+    _device->RegisterDrawBundle(this);
+}
+
+HgiVkDrawBundle::~HgiVkDrawBundle()
+{
+    _device->UnregisterDrawBundle(this);
+
+    _DestroyRecording();
+
+    HgiVkObject object;
+    object.type = HgiVkObjectTypeRenderPass;
+    object.renderPass = _renderPass;
+    _device->DestroyObject(object);
+}
+
+void
+HgiVkDrawBundle::BeginRecording()
+{
+    if (!TF_VERIFY(!_isRecording, "Draw bundle is already recording")) {
+        return;
+    }
+
+    _DestroyRecording();
+    _isRecording = true;
+}
+
+HgiGraphicsEncoderUniquePtr
+HgiVkDrawBundle::CreateGraphicsEncoder()
+{
+    /* MULTI-THREAD CALL*/
+
+    if (!TF_VERIFY(_isRecording, "Draw bundle is not recording")) {
+        return nullptr;
+    }
+
+    // Pools are not reset per frame like the pools of the command buffer
+    // manager, so the recording survives until the bundle re-records.
+    HgiVkCommandPool* pool = new HgiVkCommandPool(_device);
+    HgiVkCommandBuffer* cb = new HgiVkCommandBuffer(
+        _device, pool, HgiVkCommandBufferUsageSecondaryDrawBundle);
+    cb->SetRenderPass(_renderPass);
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _commandPools.push_back(pool);
+        _commandBuffers.push_back(cb);
+    }
+
+    HgiVkGraphicsEncoder* enc = new HgiVkGraphicsEncoder(
+        _device, cb, _renderPass, this);
+
+    return HgiGraphicsEncoderUniquePtr(enc);
+}
+
+void
+HgiVkDrawBundle::EndRecording()
+{
+    if (!TF_VERIFY(_isRecording, "Draw bundle is not recording")) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    for (HgiVkCommandBuffer* cb : _commandBuffers) {
+        // Encoders that recorded nothing did not begin their command buffer.
+        if (cb->IsRecording()) {
+            cb->EndRecording();
+            _vkCommandBuffers.push_back(cb->GetVulkanCommandBuffer());
+        }
+    }
+
+    _isRecording = false;
+    _isValid.store(true);
+}
+
+bool
+HgiVkDrawBundle::IsValid() const
+{
+    return _isValid.load();
+}
+
+bool
+HgiVkDrawBundle::IsCompatible(HgiVkRenderPass* renderPass) const
+{
+    return renderPass &&
+        _GetCompatibilityKey(renderPass->GetDescriptor()) == _compatibilityKey;
+}
+
+void
+HgiVkDrawBundle::Execute(HgiVkCommandBuffer* primaryCB)
+{
+    if (!TF_VERIFY(primaryCB) || !TF_VERIFY(IsValid(), "Invalid draw bundle")) {
+        return;
+    }
+
+    if (_vkCommandBuffers.empty()) return;
+
+    // Inside a render pass that begun with secondary command buffer contents
+    // the primary command buffer can not record barriers, so use the vulkan
+    // command buffer directly (see ExecuteSecondaryCommandBuffers).
+    vkCmdExecuteCommands(
+        primaryCB->GetVulkanCommandBuffer(),
+        (uint32_t) _vkCommandBuffers.size(),
+        _vkCommandBuffers.data());
+}
+
+void
+HgiVkDrawBundle::TrackObject(const void* object)
+{
+    /* MULTI-THREAD CALL*/
+
+    if (!object) return;
+
+    std::lock_guard<std::mutex> lock(_lock);
+    _objects.insert(object);
+}
+
+void
+HgiVkDrawBundle::InvalidateIfUsing(const void* object)
+{
+    /* MULTI-THREAD CALL*/
+
+    std::lock_guard<std::mutex> lock(_lock);
+    if (_objects.count(object)) {
+        _isValid.store(false);
+    }
+}
+
+std::vector<uint32_t>
+HgiVkDrawBundle::_GetCompatibilityKey(HgiGraphicsEncoderDesc const& desc)
+{
+    // Vulkan render passes are compatible if their attachments have the
+    // same formats and sample counts (see renderpass-compatibility).
+    // Load and store ops, layouts and the image views do not matter.
+    std::vector<uint32_t> key;
+
+    HgiAttachmentDescConstPtrVector attachments =
+        HgiVkRenderPass::GetCombinedAttachments(desc);
+
+    for (HgiAttachmentDesc const* attachment : attachments) {
+        HgiVkTexture* tex = static_cast<HgiVkTexture*>(attachment->texture);
+        if (!TF_VERIFY(tex)) continue;
+
+        HgiTextureDesc const& texDesc = tex->GetDescriptor();
+        // The BGRA bit changes the vulkan format of swapchain images.
+        key.push_back(texDesc.usage &
+            (HgiTextureUsageBitsDepthTarget | HgiTextureUsageBitsBGRA));
+        key.push_back(texDesc.format);
+        key.push_back(texDesc.sampleCount);
+        // Resolve attachments are part of the subpass.
+        key.push_back(attachment->resolveTexture != nullptr);
+    }
+
+    return key;
+}
+
+void
+HgiVkDrawBundle::_DestroyRecording()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    // Earlier frames may still execute the recording on the gpu.
+    // Command buffers are destroyed before the pool they were allocated from.
+    for (HgiVkCommandBuffer* cb : _commandBuffers) {
+        HgiVkObject object;
+        object.type = HgiVkObjectTypeCommandBuffer;
+        object.commandBuffer = cb;
+        _device->DestroyObject(object);
+    }
+
+    for (HgiVkCommandPool* pool : _commandPools) {
+        HgiVkObject object;
+        object.type = HgiVkObjectTypeCommandPool;
+        object.commandPool = pool;
+        _device->DestroyObject(object);
+    }
+
+    _commandBuffers.clear();
+    _commandPools.clear();
+    _vkCommandBuffers.clear();
+    _objects.clear();
+    _isValid.store(false);
+}
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
@@ -0,0 +1,133 @@
+#ifndef PXR_IMAGING_HGIVK_DRAW_BUNDLE_H
+#define PXR_IMAGING_HGIVK_DRAW_BUNDLE_H
+
+#include <atomic>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "pxr/pxr.h"
+#include "pxr/imaging/hgi/graphicsEncoder.h"
+#include "pxr/imaging/hgi/graphicsEncoderDesc.h"
+#include "pxr/imaging/hgiVk/api.h"
+#include "pxr/imaging/hgiVk/commandBuffer.h"
+#include "pxr/imaging/hgiVk/vulkan.h"
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+class HgiVkCommandPool;
+class HgiVkDevice;
+class HgiVkRenderPass;
+
+
+/// \class HgiVkDrawBundle
+///
+/// A list of draws that is recorded once into secondary command buffers and
+/// executed in the render passes of many frames (vkCmdExecuteCommands).
+///
+/// A bundle is executed via HgiVkParallelGraphicsEncoder::ExecuteDrawBundle
+/// in any render pass that is compatible with the HgiGraphicsEncoderDesc the
+/// bundle was created with (same attachment count, formats and sample
+/// counts). The attachment textures themselves may differ.
+///
+/// Everything recorded into the bundle is fixed, including viewport, scissor
+/// and push constant values. Per-frame data (e.g. the camera) must be read by
+/// the shaders from buffers that are updated each frame.
+///
+/// The bundle becomes invalid when a pipeline, resource bindings or buffer it
+/// recorded is destroyed and must then be recorded again.
+///
+class HgiVkDrawBundle final
+{
+public:
+    HGIVK_API
+    HgiVkDrawBundle(
+        HgiVkDevice* device,
+        HgiGraphicsEncoderDesc const& desc);
+
+    HGIVK_API
+    ~HgiVkDrawBundle();
+
+    /// Discards the previously recorded draws and starts a new recording.
+    /// Frames that are still in flight keep using the previous recording.
+    HGIVK_API
+    void BeginRecording();
+
+    /// Returns a graphics encoder that records into a new secondary command
+    /// buffer of the bundle. Encoders may record in parallel, but each
+    /// encoder must only be used by one thread. Pipelines the encoders bind
+    /// are created for the bundle's render pass on first use (see
+    /// HgiVkPipeline::AcquirePipeline).
+    /// The encoder must set the viewport and scissor, since the draw bundle
+    /// does not inherit them from the render pass it is executed in.
+    /// Thread safety: May be called from any thread during recording.
+    HGIVK_API
+    HgiGraphicsEncoderUniquePtr CreateGraphicsEncoder();
+
+    /// Ends the recording. The encoders of the bundle must have ended.
+    HGIVK_API
+    void EndRecording();
+
+    /// Returns true if the bundle has a recording that can be executed.
+    HGIVK_API
+    bool IsValid() const;
+
+    /// Returns true if the bundle can be executed in `renderPass`.
+    HGIVK_API
+    bool IsCompatible(HgiVkRenderPass* renderPass) const;
+
+    /// Records the execution of the bundle into the primary command buffer.
+    /// The render pass of the primary command buffer must have begun with
+    /// secondary command buffer contents.
+    HGIVK_API
+    void Execute(HgiVkCommandBuffer* primaryCB);
+
+    /// Adds a pipeline, resource bindings or buffer used by the recording.
+    /// Thread safety: May be called from any thread during recording.
+    HGIVK_API
+    void TrackObject(const void* object);
+
+    /// Invalidates the bundle if its recording uses `object`.
+    /// Called by the device when an object is destroyed.
+    /// Thread safety: May be called from any thread.
+    HGIVK_API
+    void InvalidateIfUsing(const void* object);
+
+private:
+    HgiVkDrawBundle() = delete;
+    HgiVkDrawBundle & operator=(const HgiVkDrawBundle&) = delete;
+    HgiVkDrawBundle(const HgiVkDrawBundle&) = delete;
+
+    // Returns the compatibility key of the attachments in `desc`.
+    static std::vector<uint32_t> _GetCompatibilityKey(
+        HgiGraphicsEncoderDesc const& desc);
+
+    // Schedules destruction of the command buffers of the current recording.
+    void _DestroyRecording();
+
+private:
+    HgiVkDevice* _device;
+
+    // Usage, format and sample count of each attachment. Render passes with
+    // the same key are compatible.
+    std::vector<uint32_t> _compatibilityKey;
+
+    // Render pass the bundle is recorded for. Only used for its compatibility
+    // with the render passes the bundle is executed in.
+    HgiVkRenderPass* _renderPass;
+
+    // Each encoder records with its own pool, so they can record in parallel.
+    std::mutex _lock;
+    std::vector<HgiVkCommandPool*> _commandPools;
+    HgiVkCommandBufferVector _commandBuffers;
+    std::vector<VkCommandBuffer> _vkCommandBuffers;
+    std::unordered_set<const void*> _objects;
+
+    bool _isRecording;
+    std::atomic<bool> _isValid;
+};
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+#endif
@@ -10,24 +10,13 @@ PXR_NAMESPACE_OPEN_SCOPE
 HgiVkRenderFrame::HgiVkRenderFrame(HgiVkDevice* device)
     : _device(device)
     , _commandBufferManager(device)
-    , _vkFence(nullptr)
+    , _frame(0)
+    , _stagingRing(device)
 {
-    // Create fence (for cpu synchronization)
-    VkFenceCreateInfo fenceInfo = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-    TF_VERIFY(
-        vkCreateFence(
-            _device->GetVulkanDevice(),
-            &fenceInfo,
-            HgiVkAllocator(),
-            &_vkFence) == VK_SUCCESS
-    );
 }
 
 HgiVkRenderFrame::~HgiVkRenderFrame()
 {
-    vkDestroyFence(_device->GetVulkanDevice(), _vkFence, HgiVkAllocator());
 }
 
 void
@@ -35,28 +24,18 @@ HgiVkRenderFrame::BeginFrame(uint64_t frame)
 {
     // Wait until the command buffers we are about to re-use have been
     // consumed by GPU. Which may result in no wait at all since we use a
-    // ring-buffer of cmd buffers. Reset fence so it may be re-used.
-    TF_VERIFY(
-        vkWaitForFences(
-            _device->GetVulkanDevice(),
-            1,
-            &_vkFence,
-            VK_TRUE,
-            100000000000) == VK_SUCCESS
-    );
-
-    TF_VERIFY(
-        vkResetFences(
-            _device->GetVulkanDevice(),
-            1,
-            &_vkFence)  == VK_SUCCESS
-    );
-
-    // Above we waited to ensure the command buffers are no longer in flight.
-    // This means we can now delete all objects that were put in the garbage
-    // collector several frames ago.
+    // ring-buffer of cmd buffers.
+    _device->WaitForFrame(_frame);
+    _frame = frame;
+
+    // Above we waited until the gpu completed value >= the frame this ring
+    // buffer slot was last used for. This means we can now delete all objects
+    // that were put in the garbage collector several frames ago.
     _garbageCollector.DestroyGarbage(frame);
 
+    // The gpu has also finished copying out of the staging ring.
+    _stagingRing.Reset();
+
     // Command buffer manager should reset command pools etc
     _commandBufferManager.BeginFrame(frame);
 }
@@ -64,7 +43,9 @@ HgiVkRenderFrame::BeginFrame(uint64_t frame)
 void
 HgiVkRenderFrame::EndFrame()
 {
-    _commandBufferManager.EndFrame(_vkFence);
+    // Submits the command buffers and signals the device timeline semaphore
+    // with the frame number once the gpu has consumed them.
+    _commandBufferManager.EndFrame();
 }
 
 HgiVkGarbageCollector*
@@ -79,17 +60,17 @@ HgiVkRenderFrame::GetCommandBufferManager()
     return &_commandBufferManager;
 }
 
+HgiVkStagingRing*
+HgiVkRenderFrame::GetStagingRing()
+{
+    return &_stagingRing;
+}
+
 void
 HgiVkRenderFrame::SetDebugName(std::string const& name)
 {
-    std::string debugLabel = "Fence " + name;
-    HgiVkSetDebugName(
-        _device,
-        (uint64_t)_vkFence,
-        VK_DEBUG_REPORT_OBJECT_TYPE_FENCE_EXT,
-        debugLabel.c_str());
-
     _commandBufferManager.SetDebugName(name);
+    _stagingRing.SetDebugName(name);
 }
 
 HgiTimeQueryVector const &
@@ -98,4 +79,10 @@ HgiVkRenderFrame::GetTimeQueries() const
     return _commandBufferManager.GetTimeQueries();
 }
 
+HgiVkBarrierStats const &
+HgiVkRenderFrame::GetBarrierStats() const
+{
+    return _commandBufferManager.GetBarrierStats();
+}
+
 PXR_NAMESPACE_CLOSE_SCOPE
@@ -9,6 +9,7 @@
 #include "pxr/imaging/hgiVk/api.h"
 #include "pxr/imaging/hgiVk/commandBufferManager.h"
 #include "pxr/imaging/hgiVk/garbageCollector.h"
+#include "pxr/imaging/hgiVk/stagingRing.h"
 #include "pxr/imaging/hgiVk/vulkan.h"
 
 
@@ -26,6 +27,10 @@ class HgiVkDevice;
 /// Deletion of objects must also take care not to delete objects still being
 /// consumed by the GPU. The frame has a 'garbage collector' that handles this.
 ///
+/// Frames do not own a fence. The device has one timeline semaphore that the
+/// gpu signals with the frame number once a frame is completed. A frame can be
+/// re-used once the completed value >= the frame it last submitted.
+///
 class HgiVkRenderFrame final {
 public:
     HgiVkRenderFrame(HgiVkDevice* device);
@@ -47,12 +52,19 @@ public:
     HGIVK_API
     HgiVkCommandBufferManager* GetCommandBufferManager();
 
+    /// Returns the staging ring of the frame.
+    HGIVK_API
+    HgiVkStagingRing* GetStagingRing();
+
     /// Set debug name the vulkan objects held by this frame will have.
     void SetDebugName(std::string const& name);
 
     /// Returns all time queries recorded in the previous run of the frame.
     HgiTimeQueryVector const & GetTimeQueries() const;
 
+    /// Returns the barrier counts of the last run of the frame.
+    HgiVkBarrierStats const & GetBarrierStats() const;
+
 private:
     HgiVkRenderFrame() = delete;
     HgiVkRenderFrame & operator=(const HgiVkRenderFrame&) = delete;
@@ -64,12 +76,16 @@ private:
     // Thread-safe managing of one frame's command buffers.
     HgiVkCommandBufferManager _commandBufferManager;
 
-    // This fence is used to make sure the cpu does not re-use the command
-    // buffers until the gpu has finished consuming them.
-    VkFence _vkFence;
+    // The frame number that was last recorded into this frame.
+    // Used to make sure the cpu does not re-use the command buffers until the
+    // gpu has finished consuming them (device timeline semaphore).
+    uint64_t _frame;
 
     // Expired objects (deferred deleted when no longer used by gpu)
     HgiVkGarbageCollector _garbageCollector;
+
+    // Staging memory for uploads recorded in this frame.
+    HgiVkStagingRing _stagingRing;
 };
 
 typedef std::vector<HgiVkRenderFrame*> HgiVkRenderFrameVector;
@@ -0,0 +1,551 @@
+#include <algorithm>
+
+#include "pxr/base/tf/diagnostic.h"
+
+#include "pxr/imaging/hgiVk/buffer.h"
+#include "pxr/imaging/hgiVk/commandBuffer.h"
+#include "pxr/imaging/hgiVk/commandBufferManager.h"
+#include "pxr/imaging/hgiVk/conversions.h"
+#include "pxr/imaging/hgiVk/device.h"
+#include "pxr/imaging/hgiVk/diagnostic.h"
+#include "pxr/imaging/hgiVk/frameGraph.h"
+#include "pxr/imaging/hgiVk/object.h"
+#include "pxr/imaging/hgiVk/texture.h"
+
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+
+struct _AccessDesc {
+    HgiVkFrameGraphAccess access;
+    bool isRead;
+    bool isWrite;
+
+    // If the graph transitions textures before the pass, else the encoder
+    // does (attachments, transfer destinations).
+    // Layout UNDEFINED is the default layout of the texture.
+    bool transitionsTexture;
+    VkImageLayout layout;
+
+    VkAccessFlags vkAccess;
+
+    // Zero for shader accesses, whose stages come from the stage usage.
+    VkPipelineStageFlags stages;
+};
+
+// Attachments are read and written, since the pass may load the contents.
+static const _AccessDesc _accessTable[HgiVkFrameGraphAccessCount] =
+{
+    {HgiVkFrameGraphAccessShaderRead, true, false,
+        true, VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT,
+        0},
+
+    {HgiVkFrameGraphAccessShaderWrite, true, true,
+        false, VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+        0},
+
+    {HgiVkFrameGraphAccessVertexInput, true, false,
+        false, VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+        VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+        VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT},
+
+    {HgiVkFrameGraphAccessColorTarget, true, true,
+        false, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT},
+
+    {HgiVkFrameGraphAccessDepthTarget, true, true,
+        false, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT},
+
+    {HgiVkFrameGraphAccessTransferSrc, true, false,
+        true, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        VK_ACCESS_TRANSFER_READ_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT},
+
+    {HgiVkFrameGraphAccessTransferDst, false, true,
+        false, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT},
+};
+
+static const uint32_t _NotScheduled = ~0u;
+
+static VkPipelineStageFlags
+_GetStages(_AccessDesc const& desc, HgiShaderStage stageUsage)
+{
+    if (desc.stages) return desc.stages;
+
+    // Storage usage maps the shader stages without adding vertex input.
+    return HgiVkConversions::GetBufferConsumerStages(
+        HgiBufferUsageStorage, stageUsage);
+}
+
+// Transient textures can share a texture if they would create the same
+// image. The debug name is not part of that.
+static bool
+_IsCompatible(HgiTextureDesc const& a, HgiTextureDesc const& b)
+{
+    return a.usage == b.usage &&
+           a.format == b.format &&
+           a.dimensions == b.dimensions &&
+           a.layerCount == b.layerCount &&
+           a.mipLevels == b.mipLevels &&
+           a.sampleCount == b.sampleCount;
+}
+
+HgiVkFrameGraph::HgiVkFrameGraph(HgiVkDevice* device)
+    : _device(device)
+{
+}
+
+HgiVkFrameGraph::~HgiVkFrameGraph()
+{
+    _DestroyTransients(_transientTextures);
+}
+
+void
+HgiVkFrameGraph::Reset()
+{
+    _resources.clear();
+    _passes.clear();
+}
+
+HgiVkFrameGraphResource
+HgiVkFrameGraph::ImportTexture(HgiVkTexture* texture)
+{
+    TF_VERIFY(texture, "Invalid texture");
+
+    _Resource resource;
+    resource.texture = texture;
+    _resources.push_back(resource);
+    return (HgiVkFrameGraphResource) _resources.size() - 1;
+}
+
+HgiVkFrameGraphResource
+HgiVkFrameGraph::ImportBuffer(HgiVkBuffer* buffer)
+{
+    TF_VERIFY(buffer, "Invalid buffer");
+
+    _Resource resource;
+    resource.buffer = buffer;
+    _resources.push_back(resource);
+    return (HgiVkFrameGraphResource) _resources.size() - 1;
+}
+
+HgiVkFrameGraphResource
+HgiVkFrameGraph::CreateTexture(HgiTextureDesc const& desc)
+{
+    TF_VERIFY(!desc.pixelData, "Transient textures can not have pixel data");
+
+    _Resource resource;
+    resource.isTransient = true;
+    resource.desc = desc;
+    resource.desc.pixelData = nullptr;
+    resource.desc.pixelsByteSize = 0;
+    _resources.push_back(resource);
+    return (HgiVkFrameGraphResource) _resources.size() - 1;
+}
+
+HgiVkFrameGraphPass
+HgiVkFrameGraph::AddPass(
+    std::string const& name,
+    HgiVkFrameGraphExecuteFn const& fn,
+    bool hasSideEffects)
+{
+    _Pass pass;
+    pass.name = name;
+    pass.fn = fn;
+    pass.hasSideEffects = hasSideEffects;
+    _passes.push_back(pass);
+    return (HgiVkFrameGraphPass) _passes.size() - 1;
+}
+
+void
+HgiVkFrameGraph::UseResource(
+    HgiVkFrameGraphPass pass,
+    HgiVkFrameGraphResource resource,
+    HgiVkFrameGraphAccess access,
+    HgiShaderStage stageUsage)
+{
+    if (!TF_VERIFY(pass < _passes.size(), "Invalid pass") ||
+        !TF_VERIFY(resource < _resources.size(), "Invalid resource") ||
+        !TF_VERIFY(access < HgiVkFrameGraphAccessCount, "Invalid access")) {
+        return;
+    }
+
+    _Usage usage;
+    usage.resource = resource;
+    usage.access = access;
+    usage.stageUsage = stageUsage;
+    _passes[pass].usages.push_back(usage);
+}
+
+void
+HgiVkFrameGraph::Execute()
+{
+    HgiVkCommandBuffer* cb =
+        _device->GetCommandBufferManager()->GetDrawCommandBuffer();
+
+    std::vector<uint32_t> topology = _GetTopology();
+    if (topology != _schedule.topology) {
+        _Compile(cb, std::move(topology));
+    }
+
+    for (_ScheduledPass const& sp : _schedule.passes) {
+        // Barriers are only added here. They are recorded together with the
+        // barriers of the pass's encoder, before its first command.
+        for (_TextureTransition const& t : sp.textureTransitions) {
+            HgiVkTexture* tex = GetTexture(t.resource);
+            if (!tex) continue;
+
+            VkImageLayout layout = t.layout == VK_IMAGE_LAYOUT_UNDEFINED ?
+                tex->GetImageLayout() : t.layout;
+
+            tex->TransitionImageBarrier(cb, layout, t.access, t.stages);
+        }
+
+        for (_BufferBarrier const& b : sp.bufferBarriers) {
+            HgiVkBuffer* buf = GetBuffer(b.resource);
+            if (!buf) continue;
+
+            VkBufferMemoryBarrier barrier =
+                {VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+            barrier.srcAccessMask = b.srcAccess;
+            barrier.dstAccessMask = b.dstAccess;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.buffer = buf->GetBuffer();
+            barrier.offset = 0;
+            barrier.size = VK_WHOLE_SIZE;
+
+            cb->AddBarrier(b.srcStages, b.dstStages, barrier);
+        }
+
+        _Pass const& pass = _passes[sp.pass];
+        HgiVkBeginDebugMarker(cb, pass.name.c_str());
+        if (pass.fn) {
+            pass.fn(this);
+        }
+        HgiVkEndDebugMarker(cb);
+    }
+
+    _stats.declaredPasses = (uint32_t) _passes.size();
+    _stats.executedPasses = (uint32_t) _schedule.passes.size();
+    _stats.transientTextures = (uint32_t) _transientTextures.size();
+}
+
+HgiVkTexture*
+HgiVkFrameGraph::GetTexture(HgiVkFrameGraphResource resource) const
+{
+    if (!TF_VERIFY(resource < _resources.size(), "Invalid resource")) {
+        return nullptr;
+    }
+
+    _Resource const& r = _resources[resource];
+    if (!r.isTransient) {
+        return r.texture;
+    }
+
+    if (resource >= _schedule.transientSlots.size()) {
+        return nullptr;
+    }
+
+    int32_t slot = _schedule.transientSlots[resource];
+    return slot < 0 ? nullptr : _transientTextures[slot].texture;
+}
+
+HgiVkBuffer*
+HgiVkFrameGraph::GetBuffer(HgiVkFrameGraphResource resource) const
+{
+    if (!TF_VERIFY(resource < _resources.size(), "Invalid resource")) {
+        return nullptr;
+    }
+
+    return _resources[resource].buffer;
+}
+
+HgiVkFrameGraphStats const&
+HgiVkFrameGraph::GetStats() const
+{
+    return _stats;
+}
+
+std::vector<uint32_t>
+HgiVkFrameGraph::_GetTopology() const
+{
+    std::vector<uint32_t> topology;
+    topology.reserve(_resources.size() * 2 + _passes.size() * 8);
+
+    topology.push_back((uint32_t) _resources.size());
+    for (_Resource const& r : _resources) {
+        if (r.isTransient) {
+            topology.push_back(2);
+            topology.push_back(r.desc.usage);
+            topology.push_back(r.desc.format);
+            topology.push_back(r.desc.dimensions[0]);
+            topology.push_back(r.desc.dimensions[1]);
+            topology.push_back(r.desc.dimensions[2]);
+            topology.push_back(r.desc.layerCount);
+            topology.push_back(r.desc.mipLevels);
+            topology.push_back(r.desc.sampleCount);
+        } else {
+            topology.push_back(r.buffer ? 1 : 0);
+        }
+    }
+
+    topology.push_back((uint32_t) _passes.size());
+    for (_Pass const& p : _passes) {
+        topology.push_back(p.hasSideEffects ? 1 : 0);
+        topology.push_back((uint32_t) p.usages.size());
+        for (_Usage const& u : p.usages) {
+            topology.push_back(u.resource);
+            topology.push_back(u.access);
+            topology.push_back(u.stageUsage);
+        }
+    }
+
+    return topology;
+}
+
+void
+HgiVkFrameGraph::_Compile(
+    HgiVkCommandBuffer* cb,
+    std::vector<uint32_t>&& topology)
+{
+    _schedule.topology = std::move(topology);
+    _schedule.passes.clear();
+
+    std::vector<bool> live = _CullPasses();
+    for (size_t i=0; i<_passes.size(); i++) {
+        if (!live[i]) continue;
+        _ScheduledPass sp;
+        sp.pass = (HgiVkFrameGraphPass) i;
+        _schedule.passes.push_back(sp);
+    }
+
+    _ComputeBarriers();
+    _AllocateTransients(cb);
+
+    _stats.compileCount++;
+}
+
+std::vector<bool>
+HgiVkFrameGraph::_CullPasses() const
+{
+    std::vector<bool> live(_passes.size(), false);
+    std::vector<bool> needed(_resources.size(), false);
+
+    // Walk the passes back to front. A pass is kept if it has side effects,
+    // writes an imported resource, or writes a resource a kept pass after it
+    // reads. The resources a kept pass reads are needed by earlier passes.
+    for (size_t i=_passes.size(); i-- > 0;) {
+        _Pass const& pass = _passes[i];
+
+        bool keep = pass.hasSideEffects;
+        for (_Usage const& u : pass.usages) {
+            if (keep) break;
+            if (!_accessTable[u.access].isWrite) continue;
+            _Resource const& r = _resources[u.resource];
+            keep = !r.isTransient || needed[u.resource];
+        }
+
+        if (!keep) continue;
+        live[i] = true;
+
+        for (_Usage const& u : pass.usages) {
+            if (_accessTable[u.access].isRead) {
+                needed[u.resource] = true;
+            }
+        }
+    }
+
+    return live;
+}
+
+void
+HgiVkFrameGraph::_ComputeBarriers()
+{
+    // Hazards of each buffer since its last write in the schedule.
+    struct _BufferState {
+        bool used = false;
+        VkPipelineStageFlags writeStages = 0;
+        VkAccessFlags writeAccess = 0;
+        VkPipelineStageFlags readStages = 0;
+        VkAccessFlags readAccess = 0;
+    };
+
+    std::vector<_BufferState> states(_resources.size());
+
+    for (_ScheduledPass& sp : _schedule.passes) {
+        for (_Usage const& u : _passes[sp.pass].usages) {
+            _AccessDesc const& desc = _accessTable[u.access];
+            VkPipelineStageFlags stages = _GetStages(desc, u.stageUsage);
+            _Resource const& r = _resources[u.resource];
+
+            if (!r.buffer) {
+                // Only reads are transitioned here. Writes are transitioned
+                // by the encoder that records them.
+                if (desc.transitionsTexture) {
+                    _TextureTransition t;
+                    t.resource = u.resource;
+                    t.layout = desc.layout;
+                    t.access = desc.vkAccess & ~VK_ACCESS_UNIFORM_READ_BIT;
+                    t.stages = stages;
+                    sp.textureTransitions.push_back(t);
+                }
+                continue;
+            }
+
+            _BufferState& state = states[u.resource];
+
+            _BufferBarrier b;
+            b.resource = u.resource;
+            b.dstStages = stages;
+            b.dstAccess = desc.vkAccess;
+            b.srcStages = 0;
+            b.srcAccess = 0;
+
+            if (desc.isWrite) {
+                if (!state.used) {
+                    // Writes outside of the graph, or by the previous frame,
+                    // are in earlier submissions on the same queue.
+                    b.srcStages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+                    b.srcAccess = VK_ACCESS_MEMORY_WRITE_BIT;
+                } else if (state.readStages) {
+                    // Write after read only needs an execution dependency.
+                    b.srcStages = state.readStages;
+                } else {
+                    b.srcStages = state.writeStages;
+                    b.srcAccess = state.writeAccess;
+                }
+
+                state.writeStages = stages;
+                state.writeAccess = desc.vkAccess & ~VK_ACCESS_SHADER_READ_BIT;
+                state.readStages = 0;
+                state.readAccess = 0;
+            } else if (state.writeStages &&
+                       ((state.readStages & stages) != stages ||
+                        (state.readAccess & desc.vkAccess) != desc.vkAccess)) {
+                // Read after write, unless an earlier read already waited
+                // for the write in the same stages.
+                b.srcStages = state.writeStages;
+                b.srcAccess = state.writeAccess;
+
+                state.readStages |= stages;
+                state.readAccess |= desc.vkAccess;
+            } else {
+                // Buffers read before any write in the graph were made
+                // visible by their producer (e.g. the upload barrier).
+                state.readStages |= stages;
+                state.readAccess |= desc.vkAccess;
+            }
+
+            state.used = true;
+
+            if (b.srcStages) {
+                sp.bufferBarriers.push_back(b);
+            }
+        }
+    }
+}
+
+void
+HgiVkFrameGraph::_AllocateTransients(HgiVkCommandBuffer* cb)
+{
+    // Lifetime of each transient as range of scheduled pass indices.
+    std::vector<uint32_t> first(_resources.size(), _NotScheduled);
+    std::vector<uint32_t> last(_resources.size(), 0);
+
+    for (uint32_t i=0; i<_schedule.passes.size(); i++) {
+        for (_Usage const& u : _passes[_schedule.passes[i].pass].usages) {
+            if (!_resources[u.resource].isTransient) continue;
+            first[u.resource] = std::min(first[u.resource], i);
+            last[u.resource] = i;
+        }
+    }
+
+    std::vector<HgiVkFrameGraphResource> order;
+    for (uint32_t r=0; r<_resources.size(); r++) {
+        if (first[r] != _NotScheduled) {
+            order.push_back(r);
+        }
+    }
+
+    std::sort(order.begin(), order.end(),
+        [&first](HgiVkFrameGraphResource a, HgiVkFrameGraphResource b) {
+            return first[a] < first[b];
+        });
+
+    // Textures of the previous schedule are re-used when compatible, so a
+    // topology change does not re-create all transients.
+    std::vector<_TransientTexture> available;
+    available.swap(_transientTextures);
+
+    // Pass index after which each texture in _transientTextures is free.
+    std::vector<uint32_t> busyUntil;
+
+    _schedule.transientSlots.assign(_resources.size(), -1);
+
+    for (HgiVkFrameGraphResource r : order) {
+        HgiTextureDesc const& desc = _resources[r].desc;
+
+        int32_t slot = -1;
+        for (size_t i=0; i<_transientTextures.size(); i++) {
+            if (busyUntil[i] < first[r] &&
+                _IsCompatible(_transientTextures[i].desc, desc)) {
+                slot = (int32_t) i;
+                break;
+            }
+        }
+
+        if (slot < 0) {
+            _TransientTexture transient = {desc, nullptr};
+
+            auto it = std::find_if(available.begin(), available.end(),
+                [&desc](_TransientTexture const& t) {
+                    return _IsCompatible(t.desc, desc);
+                });
+
+            if (it != available.end()) {
+                transient.texture = it->texture;
+                available.erase(it);
+            } else {
+                transient.texture = new HgiVkTexture(_device, cb, desc);
+            }
+
+            slot = (int32_t) _transientTextures.size();
+            _transientTextures.push_back(transient);
+            busyUntil.push_back(0);
+        }
+
+        busyUntil[slot] = last[r];
+        _schedule.transientSlots[r] = slot;
+    }
+
+    _DestroyTransients(available);
+}
+
+void
+HgiVkFrameGraph::_DestroyTransients(
+    std::vector<_TransientTexture> const& transients)
+{
+    // Earlier frames may still use the textures on the gpu.
+    for (_TransientTexture const& t : transients) {
+        HgiVkObject object;
+        object.type = HgiVkObjectTypeTexture;
+        object.texture = t.texture;
+        _device->DestroyObject(object);
+    }
+}
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
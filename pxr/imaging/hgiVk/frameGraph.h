@@ -0,0 +1,262 @@
+#ifndef PXR_IMAGING_HGIVK_FRAME_GRAPH_H
+#define PXR_IMAGING_HGIVK_FRAME_GRAPH_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "pxr/pxr.h"
+#include "pxr/imaging/hgi/enums.h"
+#include "pxr/imaging/hgi/texture.h"
+#include "pxr/imaging/hgiVk/api.h"
+#include "pxr/imaging/hgiVk/vulkan.h"
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+class HgiVkBuffer;
+class HgiVkCommandBuffer;
+class HgiVkDevice;
+class HgiVkFrameGraph;
+class HgiVkTexture;
+
+typedef uint32_t HgiVkFrameGraphResource;
+typedef uint32_t HgiVkFrameGraphPass;
+
+/// Records the commands of one pass. Called during HgiVkFrameGraph::Execute.
+typedef std::function<void(HgiVkFrameGraph* graph)> HgiVkFrameGraphExecuteFn;
+
+
+/// \enum HgiVkFrameGraphAccess
+///
+/// Describes how a pass uses a resource.
+///
+/// <ul>
+/// <li>HgiVkFrameGraphAccessShaderRead:
+///   Sampled texture or uniform / storage buffer read in shaders.</li>
+/// <li>HgiVkFrameGraphAccessShaderWrite:
+///   Storage buffer written (and read) in shaders.</li>
+/// <li>HgiVkFrameGraphAccessVertexInput:
+///   Vertex, index or indirect argument buffer.</li>
+/// <li>HgiVkFrameGraphAccessColorTarget:
+///   Color attachment of a render pass.</li>
+/// <li>HgiVkFrameGraphAccessDepthTarget:
+///   Depth attachment of a render pass.</li>
+/// <li>HgiVkFrameGraphAccessTransferSrc:
+///   Source of a copy, blit or resolve.</li>
+/// <li>HgiVkFrameGraphAccessTransferDst:
+///   Destination of a copy, blit or resolve.</li>
+/// </ul>
+///
+enum HgiVkFrameGraphAccess {
+    HgiVkFrameGraphAccessShaderRead = 0,
+    HgiVkFrameGraphAccessShaderWrite,
+    HgiVkFrameGraphAccessVertexInput,
+    HgiVkFrameGraphAccessColorTarget,
+    HgiVkFrameGraphAccessDepthTarget,
+    HgiVkFrameGraphAccessTransferSrc,
+    HgiVkFrameGraphAccessTransferDst,
+
+    HgiVkFrameGraphAccessCount
+};
+
+
+/// \struct HgiVkFrameGraphStats
+///
+/// Statistics of the last HgiVkFrameGraph::Execute.
+///
+struct HgiVkFrameGraphStats {
+    uint32_t declaredPasses = 0;
+    uint32_t executedPasses = 0;
+    uint32_t transientTextures = 0;
+    uint32_t compileCount = 0;
+};
+
+
+/// \class HgiVkFrameGraph
+///
+/// Optional render graph for the passes of a frame.
+///
+/// Each frame the client declares its passes (render passes, resolves,
+/// copies, compute) and the textures and buffers each pass uses. Execute then
+/// runs the passes in declaration order, with these differences to recording
+/// them directly:
+///
+/// <ul>
+/// <li>Passes whose outputs are not read by a later pass are culled.
+///   Writes to imported resources, and passes with side effects (e.g.
+///   readbacks) are always kept.</li>
+/// <li>The barriers each pass needs are known up front and are added before
+///   the pass records its first command, so they are merged into one
+///   vkCmdPipelineBarrier with the attachment transitions of the pass.</li>
+/// <li>Transient textures are allocated by the graph. Transients that are
+///   never alive at the same time share one texture.</li>
+/// </ul>
+///
+/// The schedule (culled pass list, barriers and transient allocation) is
+/// compiled when the topology of the graph changes and is re-used for
+/// following frames. Imported textures and buffers may change between frames
+/// (e.g. after a resize) without recompiling.
+///
+/// Attachment and transfer destination writes are transitioned by the
+/// encoder that records them (see HgiVkRenderPass::BeginRenderPass). The graph
+/// only adds them to the dependencies.
+///
+class HgiVkFrameGraph final
+{
+public:
+    HGIVK_API
+    HgiVkFrameGraph(HgiVkDevice* device);
+
+    HGIVK_API
+    ~HgiVkFrameGraph();
+
+    /// Removes the passes and resources of the previous frame.
+    /// The compiled schedule and transient textures are kept.
+    HGIVK_API
+    void Reset();
+
+    /// Adds an external texture to the graph, such as an AOV.
+    HGIVK_API
+    HgiVkFrameGraphResource ImportTexture(HgiVkTexture* texture);
+
+    /// Adds an external buffer to the graph.
+    HGIVK_API
+    HgiVkFrameGraphResource ImportBuffer(HgiVkBuffer* buffer);
+
+    /// Adds a transient texture that is allocated by the graph.
+    /// Its contents are undefined when the first pass that uses it begins, so
+    /// that pass must clear or overwrite it.
+    HGIVK_API
+    HgiVkFrameGraphResource CreateTexture(HgiTextureDesc const& desc);
+
+    /// Adds a pass. Passes are executed in the order they were added.
+    /// If `hasSideEffects` the pass is never culled.
+    HGIVK_API
+    HgiVkFrameGraphPass AddPass(
+        std::string const& name,
+        HgiVkFrameGraphExecuteFn const& fn,
+        bool hasSideEffects = false);
+
+    /// Declares that `pass` uses `resource` with `access`.
+    /// `stageUsage` are the shader stages of shader accesses (0 for all).
+    HGIVK_API
+    void UseResource(
+        HgiVkFrameGraphPass pass,
+        HgiVkFrameGraphResource resource,
+        HgiVkFrameGraphAccess access,
+        HgiShaderStage stageUsage = 0);
+
+    /// Compiles the graph if its topology changed and records the passes
+    /// that were not culled into the draw command buffer of the calling
+    /// thread. Passes must record on the calling thread.
+    HGIVK_API
+    void Execute();
+
+    /// Returns the texture of `resource`.
+    /// Returns nullptr for transient textures no executed pass uses.
+    HGIVK_API
+    HgiVkTexture* GetTexture(HgiVkFrameGraphResource resource) const;
+
+    /// Returns the buffer of `resource`.
+    HGIVK_API
+    HgiVkBuffer* GetBuffer(HgiVkFrameGraphResource resource) const;
+
+    /// Returns the statistics of the last Execute.
+    HGIVK_API
+    HgiVkFrameGraphStats const& GetStats() const;
+
+private:
+    HgiVkFrameGraph() = delete;
+    HgiVkFrameGraph & operator=(const HgiVkFrameGraph&) = delete;
+    HgiVkFrameGraph(const HgiVkFrameGraph&) = delete;
+
+    struct _Resource {
+        HgiVkTexture* texture = nullptr;
+        HgiVkBuffer* buffer = nullptr;
+        bool isTransient = false;
+        HgiTextureDesc desc;
+    };
+
+    struct _Usage {
+        HgiVkFrameGraphResource resource;
+        HgiVkFrameGraphAccess access;
+        HgiShaderStage stageUsage;
+    };
+
+    struct _Pass {
+        std::string name;
+        HgiVkFrameGraphExecuteFn fn;
+        bool hasSideEffects;
+        std::vector<_Usage> usages;
+    };
+
+    // Image layout UNDEFINED means the default layout of the texture.
+    struct _TextureTransition {
+        HgiVkFrameGraphResource resource;
+        VkImageLayout layout;
+        VkAccessFlags access;
+        VkPipelineStageFlags stages;
+    };
+
+    struct _BufferBarrier {
+        HgiVkFrameGraphResource resource;
+        VkPipelineStageFlags srcStages;
+        VkAccessFlags srcAccess;
+        VkPipelineStageFlags dstStages;
+        VkAccessFlags dstAccess;
+    };
+
+    struct _ScheduledPass {
+        HgiVkFrameGraphPass pass;
+        std::vector<_TextureTransition> textureTransitions;
+        std::vector<_BufferBarrier> bufferBarriers;
+    };
+
+    struct _Schedule {
+        std::vector<uint32_t> topology;
+        std::vector<_ScheduledPass> passes;
+
+        // Index into _transientTextures per resource (-1 if not allocated).
+        std::vector<int32_t> transientSlots;
+    };
+
+    struct _TransientTexture {
+        HgiTextureDesc desc;
+        HgiVkTexture* texture;
+    };
+
+    // Returns a key that describes the passes, their resource usages and the
+    // transient texture descriptors, but not the imported resources.
+    std::vector<uint32_t> _GetTopology() const;
+
+    // Builds the schedule for the current passes.
+    void _Compile(HgiVkCommandBuffer* cb, std::vector<uint32_t>&& topology);
+
+    // Returns for each pass if it must be executed.
+    std::vector<bool> _CullPasses() const;
+
+    // Computes the barriers of each scheduled pass.
+    void _ComputeBarriers();
+
+    // Assigns a texture to each transient resource used by a scheduled pass.
+    void _AllocateTransients(HgiVkCommandBuffer* cb);
+
+    // Destroys the transient textures.
+    void _DestroyTransients(std::vector<_TransientTexture> const& transients);
+
+private:
+    HgiVkDevice* _device;
+
+    std::vector<_Resource> _resources;
+    std::vector<_Pass> _passes;
+
+    _Schedule _schedule;
+    std::vector<_TransientTexture> _transientTextures;
+
+    HgiVkFrameGraphStats _stats;
+};
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+#endif
@@ -0,0 +1,781 @@
+#include <algorithm>
+
+#include "pxr/base/tf/diagnostic.h"
+
+#include "pxr/imaging/hgi/shaderFunction.h"
+
+#include "pxr/imaging/hgiVk/commandBuffer.h"
+#include "pxr/imaging/hgiVk/conversions.h"
+#include "pxr/imaging/hgiVk/device.h"
+#include "pxr/imaging/hgiVk/diagnostic.h"
+#include "pxr/imaging/hgiVk/fullscreenPass.h"
+#include "pxr/imaging/hgiVk/shaderFunction.h"
+#include "pxr/imaging/hgiVk/texture.h"
+
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+static const uint32_t _descriptorSetsPerPool = 64;
+
+// One triangle that covers the viewport. The viewport is not flipped, so uv
+// (0,0) is texel (0,0) of the source.
+static const char* _vertexShaderCode =
+    "#version 450\n"
+    "\n"
+    "layout(location = 0) out vec2 uv;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "    uv = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);\n"
+    "    gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);\n"
+    "}\n";
+
+static const char* _depthResolveShader =
+    "#version 450\n"
+    "\n"
+    "layout(set = 0, binding = 0) uniform sampler2DMS sourceTex;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "    gl_FragDepth = texelFetch(sourceTex, ivec2(gl_FragCoord.xy), 0).x;\n"
+    "}\n";
+
+static const char* _convertShader =
+    "#version 450\n"
+    "\n"
+    "layout(set = 0, binding = 0) uniform sampler2D sourceTex;\n"
+    "layout(location = 0) out vec4 outColor;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "    outColor = texelFetch(sourceTex, ivec2(gl_FragCoord.xy), 0);\n"
+    "}\n";
+
+// The center of a destination pixel lies on the corner of four source
+// texels, so a linear sample averages them.
+static const char* _downsampleShader =
+    "#version 450\n"
+    "\n"
+    "layout(set = 0, binding = 0) uniform sampler2D sourceTex;\n"
+    "layout(location = 0) in vec2 uv;\n"
+    "layout(location = 0) out vec4 outColor;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "    outColor = textureLod(sourceTex, uv, 0.0);\n"
+    "}\n";
+
+
+static bool
+_IsDepth(HgiVkTexture* texture)
+{
+    return texture->GetDescriptor().usage & HgiTextureUsageBitsDepthTarget;
+}
+
+static bool
+_IsIntegerFormat(HgiFormat format)
+{
+    return format >= HgiFormatInt32 && format <= HgiFormatInt32Vec4;
+}
+
+static VkFormat
+_GetFormat(HgiVkTexture* texture)
+{
+    return _IsDepth(texture) ? VK_FORMAT_D32_SFLOAT_S8_UINT :
+        HgiVkConversions::GetFormat(texture->GetDescriptor().format);
+}
+
+static HgiVkShaderFunction*
+_CompileShader(
+    HgiVkDevice* device,
+    HgiShaderStage stage,
+    const char* name,
+    const char* code)
+{
+    HgiShaderFunctionDesc desc;
+    desc.debugName = name;
+    desc.shaderStage = stage;
+    desc.shaderCode = code;
+    HgiVkShaderFunction* shader = new HgiVkShaderFunction(device, desc);
+
+    if (!shader->IsValid()) {
+        TF_CODING_ERROR("%s shader failed to compile: %s",
+            name, shader->GetCompileErrors().c_str());
+    }
+
+    return shader;
+}
+
+HgiVkFullscreenPass::HgiVkFullscreenPass(HgiVkDevice* device)
+    : _device(device)
+    , _vertexShader(nullptr)
+    , _nearestSampler(nullptr)
+    , _linearSampler(nullptr)
+    , _vkDescriptorSetLayout(nullptr)
+    , _vkPipelineLayout(nullptr)
+{
+    //
+    // Shaders
+    // Compiled once here, so operations have no compile cost at runtime.
+    //
+    _vertexShader = _CompileShader(
+        device, HgiShaderStageVertex,
+        "HgiVkFullscreenPass", _vertexShaderCode);
+
+    _fragmentShaders[HgiVkFullscreenOpDepthResolve] = _CompileShader(
+        device, HgiShaderStageFragment,
+        "HgiVkFullscreenPass DepthResolve", _depthResolveShader);
+
+    _fragmentShaders[HgiVkFullscreenOpConvert] = _CompileShader(
+        device, HgiShaderStageFragment,
+        "HgiVkFullscreenPass Convert", _convertShader);
+
+    _fragmentShaders[HgiVkFullscreenOpDownsample] = _CompileShader(
+        device, HgiShaderStageFragment,
+        "HgiVkFullscreenPass Downsample", _downsampleShader);
+
+    //
+    // Samplers
+    // Depth formats may not support linear filtering, so texel fetches use
+    // the nearest sampler.
+    //
+    VkSamplerCreateInfo sampler = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+    sampler.magFilter = VK_FILTER_NEAREST;
+    sampler.minFilter = VK_FILTER_NEAREST;
+    sampler.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    sampler.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler.compareOp = VK_COMPARE_OP_NEVER;
+    sampler.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+    sampler.minLod = 0.0f;
+    sampler.maxLod = 0.0f;
+
+    TF_VERIFY(
+        vkCreateSampler(
+            device->GetVulkanDevice(),
+            &sampler,
+            HgiVkAllocator(),
+            &_nearestSampler) == VK_SUCCESS
+    );
+
+    sampler.magFilter = VK_FILTER_LINEAR;
+    sampler.minFilter = VK_FILTER_LINEAR;
+
+    TF_VERIFY(
+        vkCreateSampler(
+            device->GetVulkanDevice(),
+            &sampler,
+            HgiVkAllocator(),
+            &_linearSampler) == VK_SUCCESS
+    );
+
+    //
+    // Pipeline layout
+    // All operations read one texture.
+    //
+    VkDescriptorSetLayoutBinding binding = {};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    binding.descriptorCount = 1;
+    binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo setLayoutInfo =
+        {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+    setLayoutInfo.bindingCount = 1;
+    setLayoutInfo.pBindings = &binding;
+
+    TF_VERIFY(
+        vkCreateDescriptorSetLayout(
+            device->GetVulkanDevice(),
+            &setLayoutInfo,
+            HgiVkAllocator(),
+            &_vkDescriptorSetLayout) == VK_SUCCESS
+    );
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo =
+        {VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &_vkDescriptorSetLayout;
+
+    TF_VERIFY(
+        vkCreatePipelineLayout(
+            device->GetVulkanDevice(),
+            &pipelineLayoutInfo,
+            HgiVkAllocator(),
+            &_vkPipelineLayout) == VK_SUCCESS
+    );
+
+    _frameObjects.resize(device->GetFramesInFlight());
+}
+
+HgiVkFullscreenPass::~HgiVkFullscreenPass()
+{
+    // The device is idle when the fullscreen pass is destroyed.
+    VkDevice vkDevice = _device->GetVulkanDevice();
+
+    for (size_t i=0; i<_frameObjects.size(); i++) {
+        // Destroys the views and framebuffers of the slot.
+        BeginFrame(i);
+        for (VkDescriptorPool pool : _frameObjects[i].descriptorPools) {
+            vkDestroyDescriptorPool(vkDevice, pool, HgiVkAllocator());
+        }
+    }
+
+    for (_Pipeline const& p : _pipelines) {
+        vkDestroyPipeline(vkDevice, p.vkPipeline, HgiVkAllocator());
+    }
+
+    for (_RenderPass const& rp : _renderPasses) {
+        vkDestroyRenderPass(vkDevice, rp.vkRenderPass, HgiVkAllocator());
+    }
+
+    vkDestroyPipelineLayout(vkDevice, _vkPipelineLayout, HgiVkAllocator());
+    vkDestroyDescriptorSetLayout(
+        vkDevice, _vkDescriptorSetLayout, HgiVkAllocator());
+    vkDestroySampler(vkDevice, _linearSampler, HgiVkAllocator());
+    vkDestroySampler(vkDevice, _nearestSampler, HgiVkAllocator());
+
+    for (HgiVkShaderFunction* shader : _fragmentShaders) {
+        delete shader;
+    }
+    delete _vertexShader;
+}
+
+void
+HgiVkFullscreenPass::Record(
+    HgiVkCommandBuffer* cb,
+    HgiVkFullscreenOp op,
+    HgiVkTexture* source,
+    HgiVkTexture* destination,
+    uint32_t sourceMipLevel,
+    uint32_t destinationMipLevel)
+{
+    /* MULTI-THREAD CALL*/
+
+    if (!TF_VERIFY(cb && source && destination)) return;
+
+    if (!_fragmentShaders[op]->IsValid() || !_vertexShader->IsValid()) {
+        return;
+    }
+
+    HgiTextureDesc const& srcDesc = source->GetDescriptor();
+    HgiTextureDesc const& dstDesc = destination->GetDescriptor();
+
+    bool isDepthOp = op == HgiVkFullscreenOpDepthResolve;
+
+    if (_IsDepth(source) != isDepthOp || _IsDepth(destination) != isDepthOp) {
+        TF_CODING_ERROR("Fullscreen op %d used with the wrong texture type",
+            op);
+        return;
+    }
+
+    if (isDepthOp && (srcDesc.sampleCount == HgiSampleCount1 ||
+                      dstDesc.sampleCount != HgiSampleCount1)) {
+        TF_CODING_ERROR("Depth resolve requires a multisample source and a "
+            "single sample destination");
+        return;
+    }
+
+    if (!isDepthOp && (srcDesc.sampleCount != HgiSampleCount1 ||
+                       _IsIntegerFormat(srcDesc.format) ||
+                       _IsIntegerFormat(dstDesc.format))) {
+        TF_CODING_ERROR("Fullscreen op %d requires single sample, non "
+            "integer color textures", op);
+        return;
+    }
+
+    if (!(HgiVkConversions::GetTextureUsage(srcDesc.usage) &
+          VK_IMAGE_USAGE_SAMPLED_BIT) ||
+        (dstDesc.usage & HgiTextureUsageBitsSwapchain)) {
+        TF_CODING_ERROR("Fullscreen source must be sampled and destination "
+            "cannot be a swapchain image");
+        return;
+    }
+
+    if (!TF_VERIFY(sourceMipLevel < srcDesc.mipLevels &&
+                   destinationMipLevel < dstDesc.mipLevels)) {
+        return;
+    }
+
+    uint32_t width = std::max(1, dstDesc.dimensions[0] >> destinationMipLevel);
+    uint32_t height = std::max(1, dstDesc.dimensions[1] >> destinationMipLevel);
+
+    // Downsampling halves the size, the other ops keep it.
+    uint32_t shift = op == HgiVkFullscreenOpDownsample ? 1 : 0;
+    uint32_t srcWidth = std::max(1, srcDesc.dimensions[0] >> sourceMipLevel);
+    uint32_t srcHeight = std::max(1, srcDesc.dimensions[1] >> sourceMipLevel);
+
+    if (!TF_VERIFY(width == std::max(1u, srcWidth >> shift) &&
+                   height == std::max(1u, srcHeight >> shift),
+                   "Fullscreen op %d destination size %ux%u does not match "
+                   "source size %ux%u", op, width, height,
+                   srcWidth, srcHeight)) {
+        return;
+    }
+
+    VkFormat format = _GetFormat(destination);
+    VkSampleCountFlagBits samples =
+        HgiVkConversions::GetSampleCount(dstDesc.sampleCount);
+
+    //
+    // Transition the textures
+    // The destination stays in its attachment layout. The next command that
+    // uses it adds the barrier it needs.
+    //
+    source->TransitionImageBarrier(
+        cb,
+        isDepthOp ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL :
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_ACCESS_SHADER_READ_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        sourceMipLevel, 1);
+
+    // The operation overwrites all pixels of the destination mip.
+    if (dstDesc.mipLevels == 1 && dstDesc.layerCount == 1) {
+        destination->InvalidateContents(cb);
+    }
+
+    if (isDepthOp) {
+        destination->TransitionImageBarrier(
+            cb,
+            VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+            VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+            destinationMipLevel, 1);
+    } else {
+        destination->TransitionImageBarrier(
+            cb,
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            destinationMipLevel, 1);
+    }
+
+    //
+    // Pipeline state, views and descriptor set of this operation
+    //
+    VkImageView srcView = _CreateImageView(source, sourceMipLevel, true);
+    VkImageView dstView = _CreateImageView(destination, destinationMipLevel,
+                                           false);
+
+    VkRenderPass renderPass;
+    VkPipeline pipeline;
+    VkDescriptorSet descriptorSet;
+    VkFramebuffer framebuffer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        renderPass = _AcquireRenderPass(format, samples);
+        pipeline = _AcquirePipeline(op, format, samples);
+
+        _FrameObjects& frameObjects = _frameObjects[
+            _device->GetCurrentFrame() % _frameObjects.size()];
+
+        descriptorSet = _AllocateDescriptorSet(&frameObjects);
+
+        VkFramebufferCreateInfo fbufCreateInfo =
+            {VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO};
+        fbufCreateInfo.renderPass = renderPass;
+        fbufCreateInfo.attachmentCount = 1;
+        fbufCreateInfo.pAttachments = &dstView;
+        fbufCreateInfo.width = width;
+        fbufCreateInfo.height = height;
+        fbufCreateInfo.layers = 1;
+
+        TF_VERIFY(
+            vkCreateFramebuffer(
+                _device->GetVulkanDevice(),
+                &fbufCreateInfo,
+                HgiVkAllocator(),
+                &framebuffer) == VK_SUCCESS
+        );
+
+        frameObjects.imageViews.push_back(srcView);
+        frameObjects.imageViews.push_back(dstView);
+        frameObjects.framebuffers.push_back(framebuffer);
+    }
+
+    if (!pipeline || !descriptorSet || !framebuffer) return;
+
+    VkDescriptorImageInfo imageInfo;
+    imageInfo.sampler = op == HgiVkFullscreenOpDownsample ?
+        _linearSampler : _nearestSampler;
+    imageInfo.imageView = srcView;
+    imageInfo.imageLayout = isDepthOp ?
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL :
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkWriteDescriptorSet write = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+    write.dstSet = descriptorSet;
+    write.dstBinding = 0;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.pImageInfo = &imageInfo;
+
+    vkUpdateDescriptorSets(
+        _device->GetVulkanDevice(), 1, &write, 0, nullptr);
+
+    //
+    // Draw
+    //
+    VkRenderPassBeginInfo beginInfo = {VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
+    beginInfo.renderPass = renderPass;
+    beginInfo.framebuffer = framebuffer;
+    beginInfo.renderArea.extent.width = width;
+    beginInfo.renderArea.extent.height = height;
+
+    // Pending barriers of the command buffer are recorded before the render
+    // pass begins (see GetCommandBufferForRecoding).
+    VkCommandBuffer vkCommandBuffer = cb->GetCommandBufferForRecoding();
+
+    vkCmdBeginRenderPass(
+        vkCommandBuffer,
+        &beginInfo,
+        VK_SUBPASS_CONTENTS_INLINE);
+
+    vkCmdBindPipeline(
+        vkCommandBuffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        pipeline);
+
+    VkViewport viewport = {0, 0, (float) width, (float) height, 0, 1};
+    vkCmdSetViewport(vkCommandBuffer, 0, 1, &viewport);
+
+    VkRect2D scissor = {{0, 0}, {width, height}};
+    vkCmdSetScissor(vkCommandBuffer, 0, 1, &scissor);
+
+    vkCmdBindDescriptorSets(
+        vkCommandBuffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        _vkPipelineLayout,
+        0,
+        1,
+        &descriptorSet,
+        0,
+        nullptr);
+
+    vkCmdDraw(vkCommandBuffer, 3, 1, 0, 0);
+
+    vkCmdEndRenderPass(vkCommandBuffer);
+}
+
+void
+HgiVkFullscreenPass::BeginFrame(uint64_t frame)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    // The device has waited for the gpu to complete the frame that
+    // previously used this slot.
+    _FrameObjects& frameObjects = _frameObjects[frame % _frameObjects.size()];
+    VkDevice vkDevice = _device->GetVulkanDevice();
+
+    for (VkFramebuffer framebuffer : frameObjects.framebuffers) {
+        vkDestroyFramebuffer(vkDevice, framebuffer, HgiVkAllocator());
+    }
+    frameObjects.framebuffers.clear();
+
+    for (VkImageView view : frameObjects.imageViews) {
+        vkDestroyImageView(vkDevice, view, HgiVkAllocator());
+    }
+    frameObjects.imageViews.clear();
+
+    for (VkDescriptorPool pool : frameObjects.descriptorPools) {
+        TF_VERIFY(vkResetDescriptorPool(vkDevice, pool, 0) == VK_SUCCESS);
+    }
+    frameObjects.descriptorPoolIndex = 0;
+}
+
+VkRenderPass
+HgiVkFullscreenPass::_AcquireRenderPass(
+    VkFormat format,
+    VkSampleCountFlagBits samples)
+{
+    for (_RenderPass const& rp : _renderPasses) {
+        if (rp.format == format && rp.samples == samples) {
+            return rp.vkRenderPass;
+        }
+    }
+
+    bool isDepth = format == VK_FORMAT_D32_SFLOAT_S8_UINT;
+
+    VkAttachmentReference ref;
+    ref.attachment = 0;
+    ref.layout = isDepth ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL :
+                           VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    // The attachment is transitioned before the pass begins and stays in its
+    // attachment layout, so the pass itself never transitions it.
+    VkAttachmentDescription desc;
+    desc.flags = 0;
+    desc.format = format;
+    desc.samples = samples;
+    desc.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    desc.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    desc.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    desc.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    desc.initialLayout = ref.layout;
+    desc.finalLayout = ref.layout;
+
+    VkSubpassDescription subpassDescription = {};
+    subpassDescription.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    if (isDepth) {
+        subpassDescription.pDepthStencilAttachment = &ref;
+    } else {
+        subpassDescription.colorAttachmentCount = 1;
+        subpassDescription.pColorAttachments = &ref;
+    }
+
+    VkRenderPassCreateInfo renderPassInfo =
+        {VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO};
+    renderPassInfo.attachmentCount = 1;
+    renderPassInfo.pAttachments = &desc;
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpassDescription;
+
+    _RenderPass rp;
+    rp.format = format;
+    rp.samples = samples;
+    rp.vkRenderPass = nullptr;
+
+    TF_VERIFY(
+        vkCreateRenderPass(
+            _device->GetVulkanDevice(),
+            &renderPassInfo,
+            HgiVkAllocator(),
+            &rp.vkRenderPass) == VK_SUCCESS
+    );
+
+    HgiVkSetDebugName(
+        _device,
+        (uint64_t)rp.vkRenderPass,
+        VK_DEBUG_REPORT_OBJECT_TYPE_RENDER_PASS_EXT,
+        "Render Pass HgiVkFullscreenPass");
+
+    _renderPasses.push_back(rp);
+    return rp.vkRenderPass;
+}
+
+VkPipeline
+HgiVkFullscreenPass::_AcquirePipeline(
+    HgiVkFullscreenOp op,
+    VkFormat format,
+    VkSampleCountFlagBits samples)
+{
+    for (_Pipeline const& p : _pipelines) {
+        if (p.op == op && p.format == format && p.samples == samples) {
+            return p.vkPipeline;
+        }
+    }
+
+    bool isDepth = op == HgiVkFullscreenOpDepthResolve;
+
+    VkGraphicsPipelineCreateInfo pipeCreateInfo =
+        {VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+
+    //
+    // Shaders
+    //
+    HgiVkShaderFunction* shaders[] = {_vertexShader, _fragmentShaders[op]};
+    VkPipelineShaderStageCreateInfo stages[2];
+
+    for (size_t i=0; i<2; i++) {
+        stages[i] = {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO};
+        stages[i].stage = shaders[i]->GetShaderStage();
+        stages[i].module = shaders[i]->GetShaderModule();
+        stages[i].pName = shaders[i]->GetShaderFunctionName();
+    }
+
+    pipeCreateInfo.stageCount = 2;
+    pipeCreateInfo.pStages = stages;
+
+    //
+    // Vertex input
+    // The vertex shader generates the triangle from gl_VertexIndex.
+    //
+    VkPipelineVertexInputStateCreateInfo vertexInput =
+        {VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
+    pipeCreateInfo.pVertexInputState = &vertexInput;
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly =
+        {VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO};
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    pipeCreateInfo.pInputAssemblyState = &inputAssembly;
+
+    pipeCreateInfo.layout = _vkPipelineLayout;
+
+    VkPipelineViewportStateCreateInfo viewportState =
+        {VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO};
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+    pipeCreateInfo.pViewportState = &viewportState;
+
+    VkPipelineRasterizationStateCreateInfo rasterState =
+        {VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO};
+    rasterState.lineWidth = 1.0f;
+    rasterState.cullMode = VK_CULL_MODE_NONE;
+    rasterState.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterState.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    pipeCreateInfo.pRasterizationState = &rasterState;
+
+    VkPipelineMultisampleStateCreateInfo multisampleState =
+        {VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO};
+    multisampleState.rasterizationSamples = samples;
+    pipeCreateInfo.pMultisampleState = &multisampleState;
+
+    // Depth is only written when the depth test is enabled.
+    VkPipelineDepthStencilStateCreateInfo depthStencilState =
+        {VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO};
+    depthStencilState.depthTestEnable = isDepth;
+    depthStencilState.depthWriteEnable = isDepth;
+    depthStencilState.depthCompareOp = VK_COMPARE_OP_ALWAYS;
+    pipeCreateInfo.pDepthStencilState = &depthStencilState;
+
+    VkPipelineColorBlendAttachmentState colorAttachState = {};
+    colorAttachState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT |
+                                      VK_COLOR_COMPONENT_G_BIT |
+                                      VK_COLOR_COMPONENT_B_BIT |
+                                      VK_COLOR_COMPONENT_A_BIT;
+
+    VkPipelineColorBlendStateCreateInfo colorBlendState =
+        {VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO};
+    colorBlendState.attachmentCount = isDepth ? 0 : 1;
+    colorBlendState.pAttachments = &colorAttachState;
+    pipeCreateInfo.pColorBlendState = &colorBlendState;
+
+    VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT,
+                                      VK_DYNAMIC_STATE_SCISSOR};
+
+    VkPipelineDynamicStateCreateInfo dynamicState =
+        {VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO};
+    dynamicState.dynamicStateCount = HgiVkArraySize(dynamicStates);
+    dynamicState.pDynamicStates = dynamicStates;
+    pipeCreateInfo.pDynamicState = &dynamicState;
+
+    pipeCreateInfo.renderPass = _AcquireRenderPass(format, samples);
+
+    _Pipeline pipeline;
+    pipeline.op = op;
+    pipeline.format = format;
+    pipeline.samples = samples;
+    pipeline.vkPipeline = nullptr;
+
+    // Seeded from the device pipeline cache, so the micro-code is usually
+    // not recompiled between runs.
+    TF_VERIFY(
+        vkCreateGraphicsPipelines(
+            _device->GetVulkanDevice(),
+            _device->GetVulkanPipelineCache(),
+            1,
+            &pipeCreateInfo,
+            HgiVkAllocator(),
+            &pipeline.vkPipeline) == VK_SUCCESS
+    );
+
+    HgiVkSetDebugName(
+        _device,
+        (uint64_t)pipeline.vkPipeline,
+        VK_DEBUG_REPORT_OBJECT_TYPE_PIPELINE_EXT,
+        "Graphics Pipeline HgiVkFullscreenPass");
+
+    _pipelines.push_back(pipeline);
+    return pipeline.vkPipeline;
+}
+
+VkDescriptorSet
+HgiVkFullscreenPass::_AllocateDescriptorSet(_FrameObjects* frameObjects)
+{
+    VkDescriptorSetAllocateInfo allocInfo =
+        {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &_vkDescriptorSetLayout;
+
+    std::vector<VkDescriptorPool>& pools = frameObjects->descriptorPools;
+    size_t& index = frameObjects->descriptorPoolIndex;
+
+    // Move on to the next pool of the frame when a pool is full.
+    for (; index < pools.size(); index++) {
+        allocInfo.descriptorPool = pools[index];
+        VkDescriptorSet set = nullptr;
+        if (vkAllocateDescriptorSets(
+                _device->GetVulkanDevice(), &allocInfo, &set) == VK_SUCCESS) {
+            return set;
+        }
+    }
+
+    VkDescriptorPoolSize poolSize;
+    poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSize.descriptorCount = _descriptorSetsPerPool;
+
+    VkDescriptorPoolCreateInfo poolInfo =
+        {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+    poolInfo.maxSets = _descriptorSetsPerPool;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+
+    VkDescriptorPool pool = nullptr;
+    if (!TF_VERIFY(
+        vkCreateDescriptorPool(
+            _device->GetVulkanDevice(),
+            &poolInfo,
+            HgiVkAllocator(),
+            &pool) == VK_SUCCESS)) {
+        return nullptr;
+    }
+
+    pools.push_back(pool);
+    index = pools.size() - 1;
+
+    allocInfo.descriptorPool = pool;
+    VkDescriptorSet set = nullptr;
+    TF_VERIFY(
+        vkAllocateDescriptorSets(
+            _device->GetVulkanDevice(), &allocInfo, &set) == VK_SUCCESS
+    );
+
+    return set;
+}
+
+VkImageView
+HgiVkFullscreenPass::_CreateImageView(
+    HgiVkTexture* texture,
+    uint32_t mipLevel,
+    bool isSampled)
+{
+    bool isDepth = _IsDepth(texture);
+
+    VkImageViewCreateInfo view = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+    view.image = texture->GetImage();
+    view.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    view.format = _GetFormat(texture);
+    view.components = { VK_COMPONENT_SWIZZLE_R,
+                        VK_COMPONENT_SWIZZLE_G,
+                        VK_COMPONENT_SWIZZLE_B,
+                        VK_COMPONENT_SWIZZLE_A };
+
+    // A sampled view of a depth-stencil image may only have one aspect.
+    view.subresourceRange.aspectMask =
+        !isDepth ? VK_IMAGE_ASPECT_COLOR_BIT :
+        isSampled ? VK_IMAGE_ASPECT_DEPTH_BIT :
+        VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+    view.subresourceRange.baseMipLevel = mipLevel;
+    view.subresourceRange.levelCount = 1;
+    view.subresourceRange.baseArrayLayer = 0;
+    view.subresourceRange.layerCount = 1;
+
+    VkImageView imageView = nullptr;
+    TF_VERIFY(
+        vkCreateImageView(
+            _device->GetVulkanDevice(),
+            &view,
+            HgiVkAllocator(),
+            &imageView) == VK_SUCCESS
+    );
+
+    return imageView;
+}
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
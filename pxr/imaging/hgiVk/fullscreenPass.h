@@ -0,0 +1,153 @@
+#ifndef PXR_IMAGING_HGIVK_FULLSCREEN_PASS_H
+#define PXR_IMAGING_HGIVK_FULLSCREEN_PASS_H
+
+#include <mutex>
+#include <vector>
+
+#include "pxr/pxr.h"
+#include "pxr/imaging/hgiVk/api.h"
+#include "pxr/imaging/hgiVk/vulkan.h"
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+class HgiVkCommandBuffer;
+class HgiVkDevice;
+class HgiVkShaderFunction;
+class HgiVkTexture;
+
+
+/// \enum HgiVkFullscreenOp
+///
+/// Operations of HgiVkFullscreenPass.
+///
+/// <ul>
+/// <li>HgiVkFullscreenOpDepthResolve:
+///   Writes sample 0 of a multisample depth texture into a single sample
+///   depth texture. Stencil is not resolved.</li>
+/// <li>HgiVkFullscreenOpConvert:
+///   Copies a color texture into a color texture of the same size and
+///   another (non integer) format.</li>
+/// <li>HgiVkFullscreenOpDownsample:
+///   Filters a color texture into a color texture of half the size (rounded
+///   down, at least 1) with a 2x2 box filter.</li>
+/// </ul>
+///
+enum HgiVkFullscreenOp {
+    HgiVkFullscreenOpDepthResolve = 0,
+    HgiVkFullscreenOpConvert,
+    HgiVkFullscreenOpDownsample,
+
+    HgiVkFullscreenOpCount
+};
+
+
+/// \class HgiVkFullscreenPass
+///
+/// Draws a fullscreen triangle that reads one texture and writes another.
+/// Used for operations that transfer commands cannot do, such as resolving
+/// depth or converting formats.
+///
+/// The shaders are compiled once when the device is created. Pipelines are
+/// cached per operation, format and sample count and render passes per
+/// format and sample count, so after first use an operation creates no
+/// pipeline state. The image views, framebuffers and descriptor sets of an
+/// operation live until its frame is re-used.
+///
+class HgiVkFullscreenPass final
+{
+public:
+    HGIVK_API
+    HgiVkFullscreenPass(HgiVkDevice* device);
+
+    HGIVK_API
+    ~HgiVkFullscreenPass();
+
+    /// Records `op` into `cb`. Reads mip `sourceMipLevel` of `source` and
+    /// overwrites mip `destinationMipLevel` of `destination`. Only layer 0 is
+    /// processed. Must be recorded outside of a render pass.
+    /// Thread safety: May be called from any thread.
+    HGIVK_API
+    void Record(
+        HgiVkCommandBuffer* cb,
+        HgiVkFullscreenOp op,
+        HgiVkTexture* source,
+        HgiVkTexture* destination,
+        uint32_t sourceMipLevel = 0,
+        uint32_t destinationMipLevel = 0);
+
+    /// Releases the objects of the operations of the frame that previously
+    /// used the ring-buffer slot of `frame`.
+    /// Called by the device when a frame begins.
+    HGIVK_API
+    void BeginFrame(uint64_t frame);
+
+private:
+    HgiVkFullscreenPass() = delete;
+    HgiVkFullscreenPass & operator=(const HgiVkFullscreenPass&) = delete;
+    HgiVkFullscreenPass(const HgiVkFullscreenPass&) = delete;
+
+    struct _RenderPass {
+        VkFormat format;
+        VkSampleCountFlagBits samples;
+        VkRenderPass vkRenderPass;
+    };
+
+    struct _Pipeline {
+        HgiVkFullscreenOp op;
+        VkFormat format;
+        VkSampleCountFlagBits samples;
+        VkPipeline vkPipeline;
+    };
+
+    // Objects of the operations of one ring-buffer slot.
+    struct _FrameObjects {
+        std::vector<VkDescriptorPool> descriptorPools;
+        size_t descriptorPoolIndex = 0;
+        std::vector<VkImageView> imageViews;
+        std::vector<VkFramebuffer> framebuffers;
+    };
+
+    // Returns the cached render pass for `format` and `samples`.
+    // Caller must hold _lock.
+    VkRenderPass _AcquireRenderPass(
+        VkFormat format,
+        VkSampleCountFlagBits samples);
+
+    // Returns the cached pipeline for `op`, `format` and `samples`.
+    // Caller must hold _lock.
+    VkPipeline _AcquirePipeline(
+        HgiVkFullscreenOp op,
+        VkFormat format,
+        VkSampleCountFlagBits samples);
+
+    // Returns a descriptor set for the source of an operation.
+    // Caller must hold _lock.
+    VkDescriptorSet _AllocateDescriptorSet(_FrameObjects* frameObjects);
+
+    // Creates a 2d view of one mip level of `texture`.
+    VkImageView _CreateImageView(
+        HgiVkTexture* texture,
+        uint32_t mipLevel,
+        bool isSampled);
+
+private:
+    HgiVkDevice* _device;
+
+    HgiVkShaderFunction* _vertexShader;
+    HgiVkShaderFunction* _fragmentShaders[HgiVkFullscreenOpCount];
+
+    VkSampler _nearestSampler;
+    VkSampler _linearSampler;
+    VkDescriptorSetLayout _vkDescriptorSetLayout;
+    VkPipelineLayout _vkPipelineLayout;
+
+    std::mutex _lock;
+    std::vector<_RenderPass> _renderPasses;
+    std::vector<_Pipeline> _pipelines;
+    std::vector<_FrameObjects> _frameObjects;
+};
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+#endif
@@ -1,11 +1,14 @@
 #include "pxr/base/tf/diagnostic.h"
 
 #include "pxr/imaging/hgiVk/buffer.h"
+#include "pxr/imaging/hgiVk/commandBuffer.h"
+#include "pxr/imaging/hgiVk/commandPool.h"
 #include "pxr/imaging/hgiVk/garbageCollector.h"
 #include "pxr/imaging/hgiVk/hgi.h"
 #include "pxr/imaging/hgiVk/pipeline.h"
 #include "pxr/imaging/hgiVk/renderPass.h"
 #include "pxr/imaging/hgiVk/resourceBindings.h"
+#include "pxr/imaging/hgiVk/sampler.h"
 #include "pxr/imaging/hgiVk/shaderFunction.h"
 #include "pxr/imaging/hgiVk/shaderProgram.h"
 #include "pxr/imaging/hgiVk/surface.h"
@@ -15,14 +18,8 @@
 
 PXR_NAMESPACE_OPEN_SCOPE
 
-thread_local uint16_t _HgiVkgcThreadLocalIndex = 0;
-thread_local uint64_t _HgiVkgcThreadLocalFrame = ~0ull;
-
-
 HgiVkGarbageCollector::HgiVkGarbageCollector()
-    : _numUsedExpired(0)
-    , _frame(~0ull)
-    , _frameStarted(false)
+    : _frameStarted(false)
 {
 }
 
@@ -35,30 +32,17 @@ void
 HgiVkGarbageCollector::ScheduleObjectDestruction(
     HgiVkObject const& obj)
 {
-    // First time thread is used in new frame, reserve index into vector.
-    if (_HgiVkgcThreadLocalFrame != _frame) {
-        _HgiVkgcThreadLocalFrame = _frame;
-        _HgiVkgcThreadLocalIndex = _numUsedExpired.fetch_add(1);
-    }
-
-    if (_HgiVkgcThreadLocalIndex >= _expiredVulkanObjects.size()) {
-        TF_CODING_ERROR("GC numThreads > HgiVk::GetThreadCount");
-        _HgiVkgcThreadLocalIndex = 0;
-    }
+    /* MULTI-THREAD CALL*/
 
-    _expiredVulkanObjects[_HgiVkgcThreadLocalIndex].emplace_back(obj);
+    // Each thread appends to the vector of its own thread slot.
+    _expiredVulkanObjects.Get().emplace_back(obj);
 }
 
 void
 HgiVkGarbageCollector::DestroyGarbage(uint64_t frame)
 {
-    // Change the frame counter. This will let each thread know that they
-    // must re-initializes themselves the next time the thread wants to schedule
-    // an object for destruction.
-    _frame = frame;
-
     // Loop the expired objects for each thread
-    for (VkObjectVector const& vec : _expiredVulkanObjects) {
+    _expiredVulkanObjects.ForEach([](VkObjectVector& vec) {
         // Loop each object and destroy it
         for (HgiVkObject const& obj : vec) {
             switch(obj.type) {
@@ -109,18 +93,27 @@ HgiVkGarbageCollector::DestroyGarbage(uint64_t frame)
                     delete s;
                     break;
                 }
+               case HgiVkObjectTypeCommandBuffer: {
+                    HgiVkCommandBuffer* c = obj.commandBuffer;
+                    delete c;
+                    break;
+                }
+               case HgiVkObjectTypeCommandPool: {
+                    HgiVkCommandPool* c = obj.commandPool;
+                    delete c;
+                    break;
+                }
+               case HgiVkObjectTypeSampler: {
+                    HgiVkSampler* s = obj.sampler;
+                    delete s;
+                    break;
+                }
             }
         }
-    }
-
-    _expiredVulkanObjects.clear();
-    _expiredVulkanObjects.shrink_to_fit();
-    _numUsedExpired.store(0);
 
-    // Make sure we have enough room for each thread, just in case the thread
-    // count has changed since last frame.
-    uint32_t numThreads = HgiVk::GetThreadCount();
-    _expiredVulkanObjects.resize(numThreads);
+        vec.clear();
+        vec.shrink_to_fit();
+    });
 }
 
 
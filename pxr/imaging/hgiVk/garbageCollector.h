@@ -1,13 +1,13 @@
 #ifndef PXR_IMAGING_HGIVK_GARBAGE_COLLECTOR_H
 #define PXR_IMAGING_HGIVK_GARBAGE_COLLECTOR_H
 
-#include <atomic>
 #include <vector>
 
 #include "pxr/pxr.h"
 
 #include "pxr/imaging/hgiVk/api.h"
 #include "pxr/imaging/hgiVk/object.h"
+#include "pxr/imaging/hgiVk/threadSlots.h"
 
 PXR_NAMESPACE_OPEN_SCOPE
 
@@ -44,14 +44,12 @@ private:
     HgiVkGarbageCollector(const HgiVkGarbageCollector&) = delete;
 
     typedef std::vector<HgiVkObject> VkObjectVector;
-    typedef std::vector<VkObjectVector> VkObjectThreadLocalVector;
+    typedef HgiVkThreadSlotArray<VkObjectVector> VkObjectThreadLocalVector;
 
     // Per-thread vectors of objects to be deleted in the future.
-    std::atomic<uint16_t> _numUsedExpired;
     VkObjectThreadLocalVector _expiredVulkanObjects;
 
     // Frame information
-    uint64_t _frame;
     bool _frameStarted;
 };
 
@@ -5,6 +5,7 @@
 #include "pxr/imaging/hgiVk/conversions.h"
 #include "pxr/imaging/hgiVk/device.h"
 #include "pxr/imaging/hgiVk/diagnostic.h"
+#include "pxr/imaging/hgiVk/drawBundle.h"
 #include "pxr/imaging/hgiVk/graphicsEncoder.h"
 #include "pxr/imaging/hgiVk/pipeline.h"
 #include "pxr/imaging/hgiVk/renderPass.h"
@@ -22,6 +23,7 @@ HgiVkGraphicsEncoder::HgiVkGraphicsEncoder(
     , _device(device)
     , _commandBuffer(cb)
     , _renderPass(nullptr)
+    , _drawBundle(nullptr)
     , _isParallelEncoder(false)
     , _isRecording(true)
 {
@@ -32,11 +34,13 @@ HgiVkGraphicsEncoder::HgiVkGraphicsEncoder(
 HgiVkGraphicsEncoder::HgiVkGraphicsEncoder(
     HgiVkDevice* device,
     HgiVkCommandBuffer* cb,
-    HgiVkRenderPass* renderPass)
+    HgiVkRenderPass* renderPass,
+    HgiVkDrawBundle* drawBundle)
     : HgiGraphicsEncoder()
     , _device(device)
     , _commandBuffer(cb)
     , _renderPass(renderPass)
+    , _drawBundle(drawBundle)
     , _isParallelEncoder(true)
     , _isRecording(true)
 {
@@ -123,6 +127,7 @@ HgiVkGraphicsEncoder::BindPipeline(HgiPipelineHandle pipeline)
 {
     if (HgiVkPipeline* p = static_cast<HgiVkPipeline*>(pipeline)) {
         p->BindPipeline(_commandBuffer, _renderPass);
+        if (_drawBundle) _drawBundle->TrackObject(p);
     }
 }
 
@@ -131,6 +136,7 @@ HgiVkGraphicsEncoder::BindResources(HgiResourceBindingsHandle res)
 {
     if (HgiVkResourceBindings* r = static_cast<HgiVkResourceBindings*>(res)) {
         r->BindResources(_commandBuffer);
+        if (_drawBundle) _drawBundle->TrackObject(r);
     }
 }
 
@@ -147,6 +153,7 @@ HgiVkGraphicsEncoder::BindVertexBuffers(
         if (vkBuf) {
             buffers.push_back(vkBuf);
             bufferOffsets.push_back(0);
+            if (_drawBundle) _drawBundle->TrackObject(buf);
         }
     }
 
@@ -190,17 +197,7 @@ HgiVkGraphicsEncoder::DrawIndexed(
 {
     TF_VERIFY(instanceCount>0);
 
-    HgiVkBuffer* vkIndexBuf = static_cast<HgiVkBuffer*>(indexBuffer);
-    HgiBufferDesc const& indexDesc = vkIndexBuf->GetDescriptor();
-
-    VkIndexType indexType = (indexDesc.usage & HgiBufferUsageIndex16) ?
-        VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
-
-    vkCmdBindIndexBuffer(
-        _commandBuffer->GetCommandBufferForRecoding(),
-        vkIndexBuf->GetBuffer(),
-        indexBufferByteOffset,
-        indexType);
+    _BindIndexBuffer(indexBuffer, indexBufferByteOffset);
 
     vkCmdDrawIndexed(
         _commandBuffer->GetCommandBufferForRecoding(),
@@ -211,8 +208,95 @@ HgiVkGraphicsEncoder::DrawIndexed(
         firstInstance);
 }
 
-// XXX Draw calls could also be build up in a buffer and submitted to gpu, see:
-// vkCmdDrawIndexedIndirect and vkCmdDrawIndexedIndirectCount
+void
+HgiVkGraphicsEncoder::DrawIndexedIndirect(
+    HgiBufferHandle const& indexBuffer,
+    HgiBufferHandle const& drawParameterBuffer,
+    uint32_t drawBufferByteOffset,
+    uint32_t drawCount,
+    uint32_t stride)
+{
+    HgiVkBuffer* drawBuf = static_cast<HgiVkBuffer*>(drawParameterBuffer);
+    if (!TF_VERIFY(drawBuf) || drawCount == 0) return;
+
+    TF_VERIFY(drawBuf->GetDescriptor().usage & HgiBufferUsageIndirect,
+              "Draw parameter buffer is missing HgiBufferUsageIndirect");
+
+    if (stride == 0) stride = sizeof(HgiDrawIndexedIndirectCommand);
+
+    _BindIndexBuffer(indexBuffer, 0);
+    if (_drawBundle) _drawBundle->TrackObject(drawBuf);
+
+    VkCommandBuffer cb = _commandBuffer->GetCommandBufferForRecoding();
+
+    if (_device->GetDeviceSupportMultiDrawIndirect()) {
+        vkCmdDrawIndexedIndirect(
+            cb,
+            drawBuf->GetBuffer(),
+            drawBufferByteOffset,
+            drawCount,
+            stride);
+    } else {
+        // Without multiDrawIndirect each call can only execute one draw.
+        for (uint32_t i=0; i<drawCount; i++) {
+            vkCmdDrawIndexedIndirect(
+                cb,
+                drawBuf->GetBuffer(),
+                drawBufferByteOffset + (VkDeviceSize) i * stride,
+                1,
+                stride);
+        }
+    }
+}
+
+void
+HgiVkGraphicsEncoder::DrawIndexedIndirectCount(
+    HgiBufferHandle const& indexBuffer,
+    HgiBufferHandle const& drawParameterBuffer,
+    uint32_t drawBufferByteOffset,
+    HgiBufferHandle const& countBuffer,
+    uint32_t countBufferByteOffset,
+    uint32_t maxDrawCount,
+    uint32_t stride)
+{
+    HgiVkBuffer* drawBuf = static_cast<HgiVkBuffer*>(drawParameterBuffer);
+    HgiVkBuffer* countBuf = static_cast<HgiVkBuffer*>(countBuffer);
+    if (!TF_VERIFY(drawBuf && countBuf) || maxDrawCount == 0) return;
+
+    if (!_device->GetDeviceSupportDrawIndirectCount()) {
+        // The count can not be read on the gpu. Commands past the count are
+        // expected to have an instanceCount of zero (see HgiGraphicsEncoder).
+        DrawIndexedIndirect(
+            indexBuffer,
+            drawParameterBuffer,
+            drawBufferByteOffset,
+            maxDrawCount,
+            stride);
+        return;
+    }
+
+    TF_VERIFY(drawBuf->GetDescriptor().usage & HgiBufferUsageIndirect,
+              "Draw parameter buffer is missing HgiBufferUsageIndirect");
+    TF_VERIFY(countBuf->GetDescriptor().usage & HgiBufferUsageIndirect,
+              "Count buffer is missing HgiBufferUsageIndirect");
+
+    if (stride == 0) stride = sizeof(HgiDrawIndexedIndirectCommand);
+
+    _BindIndexBuffer(indexBuffer, 0);
+    if (_drawBundle) {
+        _drawBundle->TrackObject(drawBuf);
+        _drawBundle->TrackObject(countBuf);
+    }
+
+    _device->CmdDrawIndexedIndirectCount(
+        _commandBuffer->GetCommandBufferForRecoding(),
+        drawBuf->GetBuffer(),
+        drawBufferByteOffset,
+        countBuf->GetBuffer(),
+        countBufferByteOffset,
+        maxDrawCount,
+        stride);
+}
 
 void
 HgiVkGraphicsEncoder::PushDebugGroup(const char* label)
@@ -242,4 +326,25 @@ HgiVkGraphicsEncoder::PopTimeQuery()
     _commandBuffer->PopTimeQuery();
 }
 
+void
+HgiVkGraphicsEncoder::_BindIndexBuffer(
+    HgiBufferHandle const& indexBuffer,
+    uint32_t byteOffset)
+{
+    HgiVkBuffer* vkIndexBuf = static_cast<HgiVkBuffer*>(indexBuffer);
+    if (!TF_VERIFY(vkIndexBuf)) return;
+
+    HgiBufferDesc const& indexDesc = vkIndexBuf->GetDescriptor();
+    if (_drawBundle) _drawBundle->TrackObject(vkIndexBuf);
+
+    VkIndexType indexType = (indexDesc.usage & HgiBufferUsageIndex16) ?
+        VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+
+    vkCmdBindIndexBuffer(
+        _commandBuffer->GetCommandBufferForRecoding(),
+        vkIndexBuf->GetBuffer(),
+        byteOffset,
+        indexType);
+}
+
 PXR_NAMESPACE_CLOSE_SCOPE
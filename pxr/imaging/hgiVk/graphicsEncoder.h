@@ -16,6 +16,7 @@ PXR_NAMESPACE_OPEN_SCOPE
 
 class HgiVkCommandBuffer;
 class HgiVkDevice;
+class HgiVkDrawBundle;
 class HgiVkRenderPass;
 struct HgiGraphicsEncoderDesc;
 
@@ -34,12 +35,15 @@ public:
         HgiVkCommandBuffer* cb,
         HgiGraphicsEncoderDesc const& desc);
 
-    /// Constructor for parallel recording into secondary command buffer
+    /// Constructor for parallel recording into secondary command buffer.
+    /// When recording into a draw bundle, `drawBundle` is told about the
+    /// objects the commands use.
     HGIVK_API
     HgiVkGraphicsEncoder(
         HgiVkDevice* device,
         HgiVkCommandBuffer* cb,
-        HgiVkRenderPass* renderPass);
+        HgiVkRenderPass* renderPass,
+        HgiVkDrawBundle* drawBundle = nullptr);
 
     HGIVK_API
     virtual ~HgiVkGraphicsEncoder();
@@ -80,6 +84,30 @@ public:
         uint32_t instanceCount,
         uint32_t firstInstance) override;
 
+    /// Without the multiDrawIndirect feature each draw is a separate call.
+    /// Commands with a firstInstance other than zero require the
+    /// drawIndirectFirstInstance feature (see
+    /// HgiVkDevice::GetDeviceSupportDrawIndirectFirstInstance).
+    HGIVK_API
+    void DrawIndexedIndirect(
+        HgiBufferHandle const& indexBuffer,
+        HgiBufferHandle const& drawParameterBuffer,
+        uint32_t drawBufferByteOffset,
+        uint32_t drawCount,
+        uint32_t stride) override;
+
+    /// Without VK_KHR_draw_indirect_count `maxDrawCount` draws are executed.
+    /// firstInstance has the same requirement as in DrawIndexedIndirect.
+    HGIVK_API
+    void DrawIndexedIndirectCount(
+        HgiBufferHandle const& indexBuffer,
+        HgiBufferHandle const& drawParameterBuffer,
+        uint32_t drawBufferByteOffset,
+        HgiBufferHandle const& countBuffer,
+        uint32_t countBufferByteOffset,
+        uint32_t maxDrawCount,
+        uint32_t stride) override;
+
     HGIVK_API
     void PushDebugGroup(const char* label) override;
 
@@ -97,10 +125,16 @@ private:
     HgiVkGraphicsEncoder & operator=(const HgiVkGraphicsEncoder&) = delete;
     HgiVkGraphicsEncoder(const HgiVkGraphicsEncoder&) = delete;
 
+    // Binds the index buffer for the following indexed draws.
+    void _BindIndexBuffer(
+        HgiBufferHandle const& indexBuffer,
+        uint32_t byteOffset);
+
 private:
     HgiVkDevice* _device;
     HgiVkCommandBuffer* _commandBuffer;
     HgiVkRenderPass* _renderPass;
+    HgiVkDrawBundle* _drawBundle;
     bool _isParallelEncoder;
     bool _isRecording;
 
@@ -19,6 +19,8 @@
 #include "pxr/imaging/hgiVk/buffer.h"
 #include "pxr/imaging/hgiVk/commandBuffer.h"
 #include "pxr/imaging/hgiVk/commandBufferManager.h"
+#include "pxr/imaging/hgiVk/computeEncoder.h"
+#include "pxr/imaging/hgiVk/conversions.h"
 #include "pxr/imaging/hgiVk/device.h"
 #include "pxr/imaging/hgiVk/hgi.h"
 #include "pxr/imaging/hgiVk/instance.h"
@@ -26,8 +28,11 @@
 #include "pxr/imaging/hgiVk/parallelGraphicsEncoder.h"
 #include "pxr/imaging/hgiVk/pipeline.h"
 #include "pxr/imaging/hgiVk/resourceBindings.h"
+#include "pxr/imaging/hgiVk/resourceCommandQueue.h"
+#include "pxr/imaging/hgiVk/sampler.h"
 #include "pxr/imaging/hgiVk/shaderFunction.h"
 #include "pxr/imaging/hgiVk/shaderProgram.h"
+#include "pxr/imaging/hgiVk/stagingRing.h"
 #include "pxr/imaging/hgiVk/surface.h"
 #include "pxr/imaging/hgiVk/swapchain.h"
 #include "pxr/imaging/hgiVk/texture.h"
@@ -172,35 +177,68 @@ HgiVk::CreateBlitEncoder()
     return HgiBlitEncoderUniquePtr(new HgiVkBlitEncoder(device, cb));
 }
 
+HgiComputeEncoderUniquePtr
+HgiVk::CreateComputeEncoder()
+{
+    HgiVkDevice* device = GetPrimaryDevice();
+    HgiVkCommandBufferManager* cbm = device->GetCommandBufferManager();
+    HgiVkCommandBuffer* cb = cbm->GetComputeCommandBuffer();
+    return HgiComputeEncoderUniquePtr(new HgiVkComputeEncoder(device, cb));
+}
+
 HgiTextureHandle
 HgiVk::CreateTexture(HgiTextureDesc const& desc)
 {
     HgiVkDevice* device = GetPrimaryDevice();
     HgiVkCommandBufferManager* cbm = device->GetCommandBufferManager();
-    HgiVkCommandBuffer* cb = cbm->GetResourceCommandBuffer();
-    HgiVkTexture* tex = new HgiVkTexture(device, cb, desc);
 
-    // If caller provided data to copy into this texture we create a staging
-    // buffer to transfer this data from cpu to gpu. This allows the final gpu
-    // texture to be of a 'faster' type while we do a non-blocking copy.
+    bool hasPixels = desc.pixelData && desc.pixelsByteSize > 0;
 
-    if (desc.pixelData && desc.pixelsByteSize > 0) {
-        // create staging buffer for cpu to gpu copy
-        HgiBufferDesc stagingDesc;
-        stagingDesc.usage = HgiBufferUsageTransferSrc;
-        stagingDesc.byteSize = desc.pixelsByteSize;
-        stagingDesc.data = desc.pixelData;
+    // When resource commands are deferred the texture does not record its
+    // initial layout transition. We queue a command to do so instead.
+    // Uploads that go via the dedicated transfer queue also skip the initial
+    // transition, since the transfer queue will transition the image.
+    bool deferred = cbm->IsDeferringResourceCommands();
+    HgiVkCommandBuffer* cb =
+        deferred ? nullptr : cbm->GetResourceCommandBuffer();
+    HgiVkCommandBuffer* transferCB =
+        (deferred || !hasPixels) ? nullptr : cbm->GetTransferCommandBuffer();
 
-        HgiVkBuffer* stagingBuffer = new HgiVkBuffer(device, stagingDesc);
+    HgiVkTexture* tex =
+        new HgiVkTexture(device, transferCB ? nullptr : cb, desc);
+
+    // If caller provided data to copy into this texture we copy it into the
+    // frame's staging memory to transfer this data from cpu to gpu. This allows
+    // the final gpu texture to be of a 'faster' type while we do a
+    // non-blocking copy.
+
+    HgiVkStagingRegion staging;
+
+    if (hasPixels) {
+        // Buffer to image copies need an offset that is a multiple of 4 and
+        // of the texel size.
+        uint32_t bpp =
+            std::max(1u, HgiVkConversions::GetBytesPerPixel(desc.format));
+        uint32_t alignment = bpp;
+        while (alignment % 4 != 0) alignment += bpp;
+
+        staging = device->GetStagingRing()->Upload(
+            desc.pixelData, desc.pixelsByteSize, alignment);
 
         // Record the copy
-        tex->CopyTextureFrom(cb, *stagingBuffer);
+        if (transferCB) {
+            tex->CopyTextureFromTransferQueue(transferCB, cb, staging);
+        } else if (!deferred) {
+            tex->CopyTextureFrom(cb, staging);
+        }
+    }
 
-        // Schedule destruction of staging buffer 3 frames from now.
-        HgiVkObject stagingObject;
-        stagingObject.buffer = stagingBuffer;
-        stagingObject.type = HgiVkObjectTypeBuffer;
-        device->DestroyObject(stagingObject);
+    if (deferred) {
+        HgiVkResourceCommand cmd;
+        cmd.type = HgiVkResourceCommandTypeInitTexture;
+        cmd.texture = tex;
+        cmd.staging = staging;
+        cbm->DeferResourceCommand(cmd);
     }
 
     return tex;
@@ -220,6 +258,27 @@ HgiVk::DestroyTexture(HgiTextureHandle* texHandle)
     }
 }
 
+HgiSamplerHandle
+HgiVk::CreateSampler(HgiSamplerDesc const& desc)
+{
+    HgiVkDevice* device = GetPrimaryDevice();
+    return new HgiVkSampler(device, desc);
+}
+
+void
+HgiVk::DestroySampler(HgiSamplerHandle* samplerHandle)
+{
+    if (TF_VERIFY(samplerHandle, "Invalid sampler")) {
+        HgiVkDevice* device = GetPrimaryDevice();
+        HgiVkObject object;
+        object.type = HgiVkObjectTypeSampler;
+        if (object.sampler = static_cast<HgiVkSampler*>(*samplerHandle)) {
+            device->DestroyObject(object);
+            *samplerHandle = nullptr;
+        }
+    }
+}
+
 HgiBufferHandle
 HgiVk::CreateBuffer(HgiBufferDesc const& desc)
 {
@@ -227,28 +286,30 @@ HgiVk::CreateBuffer(HgiBufferDesc const& desc)
     HgiVkCommandBufferManager* cbm = device->GetCommandBufferManager();
     HgiVkBuffer* buffer = new HgiVkBuffer(device, desc);
 
-    // If caller provided data to copy into this buffer we create a staging
-    // buffer to transfer this data from cpu to gpu. This allows the final gpu
-    // buffer to be of a 'faster' type while we do a non-blocking copy.
+    // If caller provided data to copy into this buffer we copy it into the
+    // frame's staging memory to transfer this data from cpu to gpu. This allows
+    // the final gpu buffer to be of a 'faster' type while we do a non-blocking
+    // copy.
 
     if (desc.data && desc.byteSize > 0) {
-        // create staging buffer for cpu to gpu copy
-        HgiBufferDesc stagingDesc;
-        stagingDesc.usage = HgiBufferUsageTransferSrc;
-        stagingDesc.byteSize = desc.byteSize;
-        stagingDesc.data = desc.data;
-
-        HgiVkBuffer* stagingBuffer = new HgiVkBuffer(device, stagingDesc);
-
-        // Record the copy
-        HgiVkCommandBuffer* cb = cbm->GetResourceCommandBuffer();
-        buffer->CopyBufferFrom(cb, *stagingBuffer);
-
-        // Schedule destruction of staging buffer 3 frames from now.
-        HgiVkObject stagingObject;
-        stagingObject.buffer = stagingBuffer;
-        stagingObject.type = HgiVkObjectTypeBuffer;
-        device->DestroyObject(stagingObject);
+        HgiVkStagingRegion staging = device->GetStagingRing()->Upload(
+            desc.data, desc.byteSize, 16);
+
+        // Record the copy, or queue it when resource commands are deferred.
+        if (cbm->IsDeferringResourceCommands()) {
+            HgiVkResourceCommand cmd;
+            cmd.type = HgiVkResourceCommandTypeCopyBuffer;
+            cmd.buffer = buffer;
+            cmd.staging = staging;
+            cbm->DeferResourceCommand(cmd);
+        } else if (HgiVkCommandBuffer* tcb = cbm->GetTransferCommandBuffer()) {
+            // Copy on the dedicated transfer queue, graphics acquires it.
+            HgiVkCommandBuffer* cb = cbm->GetResourceCommandBuffer();
+            buffer->CopyBufferFromTransferQueue(tcb, cb, staging);
+        } else {
+            HgiVkCommandBuffer* cb = cbm->GetResourceCommandBuffer();
+            buffer->CopyBufferFrom(cb, staging);
+        }
     }
 
     return buffer;
@@ -433,9 +494,26 @@ HgiVk::DestroySwapchain(HgiVkSwapchainHandle* swapchainHandle)
     }
 }
 
+void
+HgiVk::FlushResourceCommands()
+{
+    for (HgiVkDevice* device : _devices) {
+        device->GetCommandBufferManager()->FlushResourceCommands();
+    }
+}
+
+void
+HgiVk::SavePipelineCache()
+{
+    for (HgiVkDevice* device : _devices) {
+        device->SavePipelineCache();
+    }
+}
+
 void
 HgiVk::DestroyHgiVk()
 {
+    // Devices write their pipeline cache to disk on destruction.
     for (HgiVkDevice* device : _devices) {
         delete device;
     }
@@ -450,9 +528,9 @@ HgiVk::GetThreadCount()
 {
     // Hydra's RenderIndex uses WorkParallelForN to sync prims.
 
-    // HgiVk parallel command recording relies on thread local storage vectors
-    // that must be large enough so each thread has an index. So we must know
-    // the maximum threads the WorkParallelForN may spawn.
+    // HgiVk parallel command recording does not depend on this number, its
+    // per-thread storage grows with the threads that record (HgiVkThreadSlots).
+    // Clients can use it to estimate how wide the WorkParallelForN may go.
 
     // While we can ask libWork what the limit is, it may not match with the
     // limit set inside TBB (we found libWork to often be 1 smaller than tbb).
@@ -53,12 +53,21 @@ public:
     HGIVK_API
     HgiBlitEncoderUniquePtr CreateBlitEncoder() override;
 
+    HGIVK_API
+    HgiComputeEncoderUniquePtr CreateComputeEncoder() override;
+
     HGIVK_API
     HgiTextureHandle CreateTexture(HgiTextureDesc const& desc) override;
 
     HGIVK_API
     void DestroyTexture(HgiTextureHandle* texHandle) override;
 
+    HGIVK_API
+    HgiSamplerHandle CreateSampler(HgiSamplerDesc const& desc) override;
+
+    HGIVK_API
+    void DestroySampler(HgiSamplerHandle* samplerHandle) override;
+
     HGIVK_API
     HgiBufferHandle CreateBuffer(HgiBufferDesc const& desc) override;
 
@@ -135,12 +144,26 @@ public:
     HGIVK_API
     void DestroySwapchain(HgiVkSwapchainHandle* swapchainHandle);
 
+    /// Records all deferred resource commands of the current frame.
+    /// Only has an effect when HGIVK_DEFERRED_RESOURCE_RECORDING is enabled.
+    /// Deferred commands are always recorded during EndFrame, but an
+    /// application may flush earlier, e.g. right after Hydra's sync.
+    HGIVK_API
+    void FlushResourceCommands();
+
+    /// Writes the pipeline cache of all devices to disk.
+    /// This also happens during DestroyHgiVk, but an application may want to
+    /// save the cache earlier, e.g. after the first frame of a large stage.
+    HGIVK_API
+    void SavePipelineCache();
+
     /// Destroys all devices and vulkan instance.
     /// Should be called once during application shutdown.
     HGIVK_API
     void DestroyHgiVk();
 
     /// Returns the max number of threads we expect to run.
+    /// This is an estimate, more threads may record commands.
     HGIVK_API
     static uint32_t GetThreadCount();
 
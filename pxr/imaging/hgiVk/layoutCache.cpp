@@ -0,0 +1,223 @@
+#include <algorithm>
+
+#include "pxr/base/arch/hash.h"
+#include "pxr/base/tf/diagnostic.h"
+
+#include "pxr/imaging/hgiVk/device.h"
+#include "pxr/imaging/hgiVk/diagnostic.h"
+#include "pxr/imaging/hgiVk/layoutCache.h"
+
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+size_t
+HgiVkLayoutCache::_KeyHash::operator()(_Key const& key) const
+{
+    return (size_t) ArchHash64(
+        (const char*) key.data(),
+        key.size() * sizeof(uint32_t));
+}
+
+HgiVkLayoutCache::HgiVkLayoutCache(HgiVkDevice* device)
+    : _device(device)
+{
+}
+
+HgiVkLayoutCache::~HgiVkLayoutCache()
+{
+    // Resource bindings the application did not destroy still hold
+    // references. The device is idle, so their layouts can be destroyed.
+    for (auto const& it : _pipelineLayouts.entries) {
+        vkDestroyPipelineLayout(
+            _device->GetVulkanDevice(),
+            it.second.layout,
+            HgiVkAllocator());
+    }
+
+    for (auto const& it : _setLayouts.entries) {
+        vkDestroyDescriptorSetLayout(
+            _device->GetVulkanDevice(),
+            it.second.layout,
+            HgiVkAllocator());
+    }
+}
+
+VkDescriptorSetLayout
+HgiVkLayoutCache::AcquireDescriptorSetLayout(
+    std::vector<VkDescriptorSetLayoutBinding> const& bindings,
+    VkDescriptorSetLayoutCreateFlags flags)
+{
+    /* MULTI-THREAD CALL*/
+
+    // Sort by binding index so the same shape always has the same key.
+    std::vector<VkDescriptorSetLayoutBinding> sorted = bindings;
+    std::sort(sorted.begin(), sorted.end(),
+        [](VkDescriptorSetLayoutBinding const& a,
+           VkDescriptorSetLayoutBinding const& b) {
+            return a.binding < b.binding;
+        });
+
+    _Key key;
+    key.reserve(1 + sorted.size() * 4);
+    key.push_back((uint32_t) flags);
+    for (VkDescriptorSetLayoutBinding const& b : sorted) {
+        TF_VERIFY(!b.pImmutableSamplers, "Immutable samplers not supported");
+        key.push_back(b.binding);
+        key.push_back((uint32_t) b.descriptorType);
+        key.push_back(b.descriptorCount);
+        key.push_back((uint32_t) b.stageFlags);
+    }
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto it = _setLayouts.entries.find(key);
+    if (it != _setLayouts.entries.end()) {
+        it->second.refCount++;
+        return it->second.layout;
+    }
+
+    VkDescriptorSetLayoutCreateInfo setCreateInfo =
+        {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+    setCreateInfo.flags = flags;
+    setCreateInfo.bindingCount = (uint32_t) sorted.size();
+    setCreateInfo.pBindings = sorted.data();
+
+    _Entry<VkDescriptorSetLayout> entry;
+    entry.layout = nullptr;
+    entry.refCount = 1;
+
+    TF_VERIFY(
+        vkCreateDescriptorSetLayout(
+            _device->GetVulkanDevice(),
+            &setCreateInfo,
+            HgiVkAllocator(),
+            &entry.layout) == VK_SUCCESS
+    );
+
+    _setLayouts.keys.emplace(entry.layout, key);
+    _setLayouts.entries.emplace(std::move(key), entry);
+
+    return entry.layout;
+}
+
+void
+HgiVkLayoutCache::ReleaseDescriptorSetLayout(VkDescriptorSetLayout layout)
+{
+    /* MULTI-THREAD CALL*/
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    if (_Release(&_setLayouts, layout)) {
+        vkDestroyDescriptorSetLayout(
+            _device->GetVulkanDevice(),
+            layout,
+            HgiVkAllocator());
+    }
+}
+
+VkPipelineLayout
+HgiVkLayoutCache::AcquirePipelineLayout(
+    std::vector<VkDescriptorSetLayout> const& setLayouts,
+    std::vector<VkPushConstantRange> const& pushConstantRanges)
+{
+    /* MULTI-THREAD CALL*/
+
+    // Set layouts are unique per shape, so the handle identifies the shape.
+    _Key key;
+    key.reserve(1 + setLayouts.size() * 2 + pushConstantRanges.size() * 3);
+    key.push_back((uint32_t) setLayouts.size());
+    for (VkDescriptorSetLayout setLayout : setLayouts) {
+        uint64_t setLayoutId = (uint64_t) setLayout;
+        key.push_back((uint32_t) (setLayoutId & 0xFFFFFFFF));
+        key.push_back((uint32_t) (setLayoutId >> 32));
+    }
+    for (VkPushConstantRange const& r : pushConstantRanges) {
+        key.push_back(r.offset);
+        key.push_back(r.size);
+        key.push_back((uint32_t) r.stageFlags);
+    }
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto it = _pipelineLayouts.entries.find(key);
+    if (it != _pipelineLayouts.entries.end()) {
+        it->second.refCount++;
+        return it->second.layout;
+    }
+
+    VkPipelineLayoutCreateInfo pipeLayCreateInfo =
+        {VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
+    pipeLayCreateInfo.pushConstantRangeCount =
+        (uint32_t) pushConstantRanges.size();
+    pipeLayCreateInfo.pPushConstantRanges = pushConstantRanges.data();
+    pipeLayCreateInfo.setLayoutCount = (uint32_t) setLayouts.size();
+    pipeLayCreateInfo.pSetLayouts = setLayouts.data();
+
+    _Entry<VkPipelineLayout> entry;
+    entry.layout = nullptr;
+    entry.refCount = 1;
+
+    TF_VERIFY(
+        vkCreatePipelineLayout(
+            _device->GetVulkanDevice(),
+            &pipeLayCreateInfo,
+            HgiVkAllocator(),
+            &entry.layout) == VK_SUCCESS
+    );
+
+    _pipelineLayouts.keys.emplace(entry.layout, key);
+    _pipelineLayouts.entries.emplace(std::move(key), entry);
+
+    return entry.layout;
+}
+
+void
+HgiVkLayoutCache::ReleasePipelineLayout(VkPipelineLayout layout)
+{
+    /* MULTI-THREAD CALL*/
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    if (_Release(&_pipelineLayouts, layout)) {
+        vkDestroyPipelineLayout(
+            _device->GetVulkanDevice(),
+            layout,
+            HgiVkAllocator());
+    }
+}
+
+size_t
+HgiVkLayoutCache::GetDescriptorSetLayoutCount()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _setLayouts.entries.size();
+}
+
+size_t
+HgiVkLayoutCache::GetPipelineLayoutCount()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _pipelineLayouts.entries.size();
+}
+
+template <class T>
+bool
+HgiVkLayoutCache::_Release(_Layouts<T>* layouts, T layout)
+{
+    if (!layout) return false;
+
+    auto keyIt = layouts->keys.find(layout);
+    if (!TF_VERIFY(keyIt != layouts->keys.end(), "Layout not in cache")) {
+        return false;
+    }
+
+    auto it = layouts->entries.find(keyIt->second);
+    if (--it->second.refCount > 0) return false;
+
+    layouts->entries.erase(it);
+    layouts->keys.erase(keyIt);
+    return true;
+}
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
@@ -0,0 +1,116 @@
+#ifndef PXR_IMAGING_HGIVK_LAYOUT_CACHE_H
+#define PXR_IMAGING_HGIVK_LAYOUT_CACHE_H
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "pxr/pxr.h"
+#include "pxr/imaging/hgiVk/api.h"
+#include "pxr/imaging/hgiVk/vulkan.h"
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+class HgiVkDevice;
+
+
+/// \class HgiVkLayoutCache
+///
+/// Shares descriptor set layouts and pipeline layouts between resource
+/// bindings of the same shape.
+///
+/// Most draw items of a scene share a handful of binding shapes (binding
+/// index, descriptor type, count and stages, plus push constant ranges).
+/// Layouts are looked up by a hash of their shape, so resource bindings of
+/// the same shape share one VkDescriptorSetLayout and one VkPipelineLayout.
+/// Pipelines created with the same layout are compatible, so binding the
+/// resources of one draw item does not disturb those of the next.
+/// Layouts are refcounted and destroyed when their last user releases them.
+///
+class HgiVkLayoutCache final
+{
+public:
+    HGIVK_API
+    HgiVkLayoutCache(HgiVkDevice* device);
+
+    HGIVK_API
+    ~HgiVkLayoutCache();
+
+    /// Returns the descriptor set layout for `bindings` and `flags` and adds
+    /// a reference to it. The order of `bindings` does not matter.
+    /// Thread safety: May be called from any thread.
+    HGIVK_API
+    VkDescriptorSetLayout AcquireDescriptorSetLayout(
+        std::vector<VkDescriptorSetLayoutBinding> const& bindings,
+        VkDescriptorSetLayoutCreateFlags flags);
+
+    /// Removes a reference from a layout returned by
+    /// AcquireDescriptorSetLayout. Callers release their layouts during
+    /// garbage collection.
+    /// Thread safety: May be called from any thread.
+    HGIVK_API
+    void ReleaseDescriptorSetLayout(VkDescriptorSetLayout layout);
+
+    /// Returns the pipeline layout with descriptor sets of `setLayouts` and
+    /// `pushConstantRanges`, and adds a reference to it.
+    /// Thread safety: May be called from any thread.
+    HGIVK_API
+    VkPipelineLayout AcquirePipelineLayout(
+        std::vector<VkDescriptorSetLayout> const& setLayouts,
+        std::vector<VkPushConstantRange> const& pushConstantRanges);
+
+    /// Removes a reference from a layout returned by AcquirePipelineLayout.
+    /// Thread safety: May be called from any thread.
+    HGIVK_API
+    void ReleasePipelineLayout(VkPipelineLayout layout);
+
+    /// Returns the number of unique descriptor set layouts.
+    HGIVK_API
+    size_t GetDescriptorSetLayoutCount();
+
+    /// Returns the number of unique pipeline layouts.
+    HGIVK_API
+    size_t GetPipelineLayoutCount();
+
+private:
+    HgiVkLayoutCache() = delete;
+    HgiVkLayoutCache & operator=(const HgiVkLayoutCache&) = delete;
+    HgiVkLayoutCache(const HgiVkLayoutCache&) = delete;
+
+    // The shape of a layout, packed into 32 bit words.
+    typedef std::vector<uint32_t> _Key;
+
+    struct _KeyHash {
+        size_t operator()(_Key const& key) const;
+    };
+
+    template <class T>
+    struct _Entry {
+        T layout;
+        uint32_t refCount;
+    };
+
+    // Layouts by shape and the shape of each layout, for releasing.
+    template <class T>
+    struct _Layouts {
+        std::unordered_map<_Key, _Entry<T>, _KeyHash> entries;
+        std::unordered_map<T, _Key> keys;
+    };
+
+    // Removes a reference from `layout`. Returns true if it was the last one.
+    // Caller must hold _lock.
+    template <class T>
+    bool _Release(_Layouts<T>* layouts, T layout);
+
+private:
+    HgiVkDevice* _device;
+
+    std::mutex _lock;
+    _Layouts<VkDescriptorSetLayout> _setLayouts;
+    _Layouts<VkPipelineLayout> _pipelineLayouts;
+};
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+#endif
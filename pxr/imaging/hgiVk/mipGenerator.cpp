@@ -0,0 +1,467 @@
+#include <algorithm>
+#include <string>
+
+#include "pxr/base/tf/diagnostic.h"
+
+#include "pxr/imaging/hgi/shaderFunction.h"
+
+#include "pxr/imaging/hgiVk/commandBuffer.h"
+#include "pxr/imaging/hgiVk/conversions.h"
+#include "pxr/imaging/hgiVk/device.h"
+#include "pxr/imaging/hgiVk/diagnostic.h"
+#include "pxr/imaging/hgiVk/mipGenerator.h"
+#include "pxr/imaging/hgiVk/shaderFunction.h"
+#include "pxr/imaging/hgiVk/texture.h"
+
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+static const uint32_t _descriptorSetsPerPool = 64;
+static const uint32_t _workgroupSize = 8;
+
+// The glsl image format of each HgiFormat, nullptr if it has none.
+static const char*
+_GetImageFormat(HgiFormat format)
+{
+    switch (format) {
+        case HgiFormatUNorm8: return "r8";
+        case HgiFormatUNorm8Vec2: return "rg8";
+        case HgiFormatUNorm8Vec4: return "rgba8";
+        case HgiFormatSNorm8: return "r8_snorm";
+        case HgiFormatSNorm8Vec2: return "rg8_snorm";
+        case HgiFormatSNorm8Vec4: return "rgba8_snorm";
+        case HgiFormatFloat16: return "r16f";
+        case HgiFormatFloat16Vec2: return "rg16f";
+        case HgiFormatFloat16Vec4: return "rgba16f";
+        case HgiFormatFloat32: return "r32f";
+        case HgiFormatFloat32Vec2: return "rg32f";
+        case HgiFormatFloat32Vec4: return "rgba32f";
+        default: return nullptr;
+    }
+}
+
+// True if the glsl image format of `format` is not one of the storage image
+// formats every device supports (shaderStorageImageExtendedFormats).
+static bool
+_IsExtendedImageFormat(HgiFormat format)
+{
+    switch (format) {
+        case HgiFormatUNorm8Vec4:
+        case HgiFormatSNorm8Vec4:
+        case HgiFormatFloat16Vec4:
+        case HgiFormatFloat32:
+        case HgiFormatFloat32Vec4:
+            return false;
+        default:
+            return true;
+    }
+}
+
+// Texels past the edge of odd sized mips are clamped, so the last texel of
+// the destination averages the last source texels.
+static std::string
+_GetDownsampleShader(HgiFormat format)
+{
+    return std::string(
+        "#version 450\n"
+        "\n"
+        "layout(local_size_x = 8, local_size_y = 8, local_size_z = 1) in;\n"
+        "\n"
+        "layout(set = 0, binding = 0) uniform sampler2D sourceTex;\n"
+        "layout(set = 0, binding = 1, ") + _GetImageFormat(format) + ")\n"
+        "    uniform writeonly image2D destinationImage;\n"
+        "\n"
+        "layout(push_constant) uniform Params {\n"
+        "    ivec2 destinationSize;\n"
+        "} params;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);\n"
+        "    if (any(greaterThanEqual(texel, params.destinationSize))) {\n"
+        "        return;\n"
+        "    }\n"
+        "\n"
+        "    ivec2 last = textureSize(sourceTex, 0) - 1;\n"
+        "    ivec2 src = texel * 2;\n"
+        "    vec4 color =\n"
+        "        texelFetch(sourceTex, min(src, last), 0) +\n"
+        "        texelFetch(sourceTex, min(src + ivec2(1, 0), last), 0) +\n"
+        "        texelFetch(sourceTex, min(src + ivec2(0, 1), last), 0) +\n"
+        "        texelFetch(sourceTex, min(src + ivec2(1, 1), last), 0);\n"
+        "    imageStore(destinationImage, texel, color * 0.25);\n"
+        "}\n";
+}
+
+HgiVkMipGenerator::HgiVkMipGenerator(HgiVkDevice* device)
+    : _device(device)
+    , _vkSampler(nullptr)
+    , _vkDescriptorSetLayout(nullptr)
+    , _vkPipelineLayout(nullptr)
+{
+    std::fill(_shaders, _shaders + HgiFormatCount, nullptr);
+    std::fill(_pipelines, _pipelines + HgiFormatCount, nullptr);
+
+    // The shader only fetches texels, which needs no filtering support.
+    VkSamplerCreateInfo sampler = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+    sampler.magFilter = VK_FILTER_NEAREST;
+    sampler.minFilter = VK_FILTER_NEAREST;
+    sampler.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    sampler.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler.compareOp = VK_COMPARE_OP_NEVER;
+    sampler.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+
+    TF_VERIFY(
+        vkCreateSampler(
+            device->GetVulkanDevice(),
+            &sampler,
+            HgiVkAllocator(),
+            &_vkSampler) == VK_SUCCESS
+    );
+
+    VkDescriptorSetLayoutBinding bindings[2] = {};
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutCreateInfo setLayoutInfo =
+        {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+    setLayoutInfo.bindingCount = HgiVkArraySize(bindings);
+    setLayoutInfo.pBindings = bindings;
+
+    TF_VERIFY(
+        vkCreateDescriptorSetLayout(
+            device->GetVulkanDevice(),
+            &setLayoutInfo,
+            HgiVkAllocator(),
+            &_vkDescriptorSetLayout) == VK_SUCCESS
+    );
+
+    VkPushConstantRange pushConstants;
+    pushConstants.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstants.offset = 0;
+    pushConstants.size = 2 * sizeof(int32_t);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo =
+        {VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &_vkDescriptorSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstants;
+
+    TF_VERIFY(
+        vkCreatePipelineLayout(
+            device->GetVulkanDevice(),
+            &pipelineLayoutInfo,
+            HgiVkAllocator(),
+            &_vkPipelineLayout) == VK_SUCCESS
+    );
+
+    _frameObjects.resize(device->GetFramesInFlight());
+}
+
+HgiVkMipGenerator::~HgiVkMipGenerator()
+{
+    // The device is idle when the mip generator is destroyed.
+    VkDevice vkDevice = _device->GetVulkanDevice();
+
+    for (size_t i=0; i<_frameObjects.size(); i++) {
+        // Destroys the views of the slot.
+        BeginFrame(i);
+        for (VkDescriptorPool pool : _frameObjects[i].descriptorPools) {
+            vkDestroyDescriptorPool(vkDevice, pool, HgiVkAllocator());
+        }
+    }
+
+    for (size_t i=0; i<HgiFormatCount; i++) {
+        if (_pipelines[i]) {
+            vkDestroyPipeline(vkDevice, _pipelines[i], HgiVkAllocator());
+        }
+        delete _shaders[i];
+    }
+
+    vkDestroyPipelineLayout(vkDevice, _vkPipelineLayout, HgiVkAllocator());
+    vkDestroyDescriptorSetLayout(
+        vkDevice, _vkDescriptorSetLayout, HgiVkAllocator());
+    vkDestroySampler(vkDevice, _vkSampler, HgiVkAllocator());
+}
+
+bool
+HgiVkMipGenerator::IsFormatSupported(HgiFormat format) const
+{
+    if (!_GetImageFormat(format)) return false;
+
+    return !_IsExtendedImageFormat(format) ||
+        _device->GetVulkanPhysicalDeviceFeatures().
+            shaderStorageImageExtendedFormats;
+}
+
+void
+HgiVkMipGenerator::RecordDownsample(
+    HgiVkCommandBuffer* cb,
+    HgiVkTexture* texture,
+    uint32_t sourceMipLevel,
+    uint32_t layer)
+{
+    /* MULTI-THREAD CALL*/
+
+    if (!TF_VERIFY(cb && texture)) return;
+
+    HgiTextureDesc const& desc = texture->GetDescriptor();
+    if (!TF_VERIFY(IsFormatSupported(desc.format) &&
+                   sourceMipLevel + 1 < desc.mipLevels &&
+                   desc.dimensions[2] <= 1,
+                   "Unsupported compute downsample")) {
+        return;
+    }
+
+    uint32_t dstMipLevel = sourceMipLevel + 1;
+    int32_t destinationSize[2] = {
+        std::max(1, desc.dimensions[0] >> dstMipLevel),
+        std::max(1, desc.dimensions[1] >> dstMipLevel)};
+
+    VkImageView srcView = _CreateImageView(texture, sourceMipLevel, layer);
+    VkImageView dstView = _CreateImageView(texture, dstMipLevel, layer);
+
+    VkPipeline pipeline;
+    VkDescriptorSet descriptorSet;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        pipeline = _AcquirePipeline(desc.format);
+
+        _FrameObjects& frameObjects = _frameObjects[
+            _device->GetCurrentFrame() % _frameObjects.size()];
+
+        descriptorSet = _AllocateDescriptorSet(&frameObjects);
+
+        frameObjects.imageViews.push_back(srcView);
+        frameObjects.imageViews.push_back(dstView);
+    }
+
+    if (!pipeline || !descriptorSet) return;
+
+    VkDescriptorImageInfo imageInfos[2];
+    imageInfos[0].sampler = _vkSampler;
+    imageInfos[0].imageView = srcView;
+    imageInfos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfos[1].sampler = nullptr;
+    imageInfos[1].imageView = dstView;
+    imageInfos[1].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    VkWriteDescriptorSet writes[2] = {};
+    for (uint32_t i=0; i<2; i++) {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = descriptorSet;
+        writes[i].dstBinding = i;
+        writes[i].descriptorCount = 1;
+        writes[i].pImageInfo = &imageInfos[i];
+    }
+    writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+
+    vkUpdateDescriptorSets(
+        _device->GetVulkanDevice(),
+        HgiVkArraySize(writes),
+        writes,
+        0,
+        nullptr);
+
+    VkCommandBuffer vkCommandBuffer = cb->GetCommandBufferForRecoding();
+
+    vkCmdBindPipeline(
+        vkCommandBuffer,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        pipeline);
+
+    vkCmdBindDescriptorSets(
+        vkCommandBuffer,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        _vkPipelineLayout,
+        0,
+        1,
+        &descriptorSet,
+        0,
+        nullptr);
+
+    vkCmdPushConstants(
+        vkCommandBuffer,
+        _vkPipelineLayout,
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0,
+        sizeof(destinationSize),
+        destinationSize);
+
+    vkCmdDispatch(
+        vkCommandBuffer,
+        (destinationSize[0] + _workgroupSize - 1) / _workgroupSize,
+        (destinationSize[1] + _workgroupSize - 1) / _workgroupSize,
+        1);
+}
+
+void
+HgiVkMipGenerator::BeginFrame(uint64_t frame)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    // The device has waited for the gpu to complete the frame that
+    // previously used this slot.
+    _FrameObjects& frameObjects = _frameObjects[frame % _frameObjects.size()];
+    VkDevice vkDevice = _device->GetVulkanDevice();
+
+    for (VkImageView view : frameObjects.imageViews) {
+        vkDestroyImageView(vkDevice, view, HgiVkAllocator());
+    }
+    frameObjects.imageViews.clear();
+
+    for (VkDescriptorPool pool : frameObjects.descriptorPools) {
+        TF_VERIFY(vkResetDescriptorPool(vkDevice, pool, 0) == VK_SUCCESS);
+    }
+    frameObjects.descriptorPoolIndex = 0;
+}
+
+VkPipeline
+HgiVkMipGenerator::_AcquirePipeline(HgiFormat format)
+{
+    if (_pipelines[format]) return _pipelines[format];
+
+    // A shader that failed to compile is not compiled again.
+    if (_shaders[format]) return nullptr;
+
+    HgiShaderFunctionDesc shaderDesc;
+    shaderDesc.debugName = "HgiVkMipGenerator";
+    shaderDesc.shaderStage = HgiShaderStageCompute;
+    shaderDesc.shaderCode = _GetDownsampleShader(format);
+    _shaders[format] = new HgiVkShaderFunction(_device, shaderDesc);
+
+    if (!_shaders[format]->IsValid()) {
+        TF_CODING_ERROR("Downsample shader failed to compile: %s",
+            _shaders[format]->GetCompileErrors().c_str());
+        return nullptr;
+    }
+
+    VkComputePipelineCreateInfo pipeCreateInfo =
+        {VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO};
+    pipeCreateInfo.stage.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipeCreateInfo.stage.stage = _shaders[format]->GetShaderStage();
+    pipeCreateInfo.stage.module = _shaders[format]->GetShaderModule();
+    pipeCreateInfo.stage.pName = _shaders[format]->GetShaderFunctionName();
+    pipeCreateInfo.layout = _vkPipelineLayout;
+
+    TF_VERIFY(
+        vkCreateComputePipelines(
+            _device->GetVulkanDevice(),
+            _device->GetVulkanPipelineCache(),
+            1,
+            &pipeCreateInfo,
+            HgiVkAllocator(),
+            &_pipelines[format]) == VK_SUCCESS
+    );
+
+    HgiVkSetDebugName(
+        _device,
+        (uint64_t)_pipelines[format],
+        VK_DEBUG_REPORT_OBJECT_TYPE_PIPELINE_EXT,
+        "Compute Pipeline HgiVkMipGenerator");
+
+    return _pipelines[format];
+}
+
+VkDescriptorSet
+HgiVkMipGenerator::_AllocateDescriptorSet(_FrameObjects* frameObjects)
+{
+    VkDescriptorSetAllocateInfo allocInfo =
+        {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &_vkDescriptorSetLayout;
+
+    std::vector<VkDescriptorPool>& pools = frameObjects->descriptorPools;
+    size_t& index = frameObjects->descriptorPoolIndex;
+
+    // Move on to the next pool of the frame when a pool is full.
+    for (; index < pools.size(); index++) {
+        allocInfo.descriptorPool = pools[index];
+        VkDescriptorSet set = nullptr;
+        if (vkAllocateDescriptorSets(
+                _device->GetVulkanDevice(), &allocInfo, &set) == VK_SUCCESS) {
+            return set;
+        }
+    }
+
+    VkDescriptorPoolSize poolSizes[2];
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[0].descriptorCount = _descriptorSetsPerPool;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    poolSizes[1].descriptorCount = _descriptorSetsPerPool;
+
+    VkDescriptorPoolCreateInfo poolInfo =
+        {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+    poolInfo.maxSets = _descriptorSetsPerPool;
+    poolInfo.poolSizeCount = HgiVkArraySize(poolSizes);
+    poolInfo.pPoolSizes = poolSizes;
+
+    VkDescriptorPool pool = nullptr;
+    if (!TF_VERIFY(
+        vkCreateDescriptorPool(
+            _device->GetVulkanDevice(),
+            &poolInfo,
+            HgiVkAllocator(),
+            &pool) == VK_SUCCESS)) {
+        return nullptr;
+    }
+
+    pools.push_back(pool);
+    index = pools.size() - 1;
+
+    allocInfo.descriptorPool = pool;
+    VkDescriptorSet set = nullptr;
+    TF_VERIFY(
+        vkAllocateDescriptorSets(
+            _device->GetVulkanDevice(), &allocInfo, &set) == VK_SUCCESS
+    );
+
+    return set;
+}
+
+VkImageView
+HgiVkMipGenerator::_CreateImageView(
+    HgiVkTexture* texture,
+    uint32_t mipLevel,
+    uint32_t layer)
+{
+    VkImageViewCreateInfo view = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+    view.image = texture->GetImage();
+    view.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    view.format = HgiVkConversions::GetFormat(texture->GetDescriptor().format);
+    view.components = { VK_COMPONENT_SWIZZLE_R,
+                        VK_COMPONENT_SWIZZLE_G,
+                        VK_COMPONENT_SWIZZLE_B,
+                        VK_COMPONENT_SWIZZLE_A };
+    view.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    view.subresourceRange.baseMipLevel = mipLevel;
+    view.subresourceRange.levelCount = 1;
+    view.subresourceRange.baseArrayLayer = layer;
+    view.subresourceRange.layerCount = 1;
+
+    VkImageView imageView = nullptr;
+    TF_VERIFY(
+        vkCreateImageView(
+            _device->GetVulkanDevice(),
+            &view,
+            HgiVkAllocator(),
+            &imageView) == VK_SUCCESS
+    );
+
+    return imageView;
+}
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
@@ -0,0 +1,105 @@
+#ifndef PXR_IMAGING_HGIVK_MIP_GENERATOR_H
+#define PXR_IMAGING_HGIVK_MIP_GENERATOR_H
+
+#include <mutex>
+#include <vector>
+
+#include "pxr/pxr.h"
+#include "pxr/imaging/hgi/types.h"
+#include "pxr/imaging/hgiVk/api.h"
+#include "pxr/imaging/hgiVk/vulkan.h"
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+class HgiVkCommandBuffer;
+class HgiVkDevice;
+class HgiVkShaderFunction;
+class HgiVkTexture;
+
+
+/// \class HgiVkMipGenerator
+///
+/// Compute downsample for the mip chains of textures whose format cannot be
+/// blitted with a linear filter (see HgiTextureDesc::generateMips).
+/// Other formats are downsampled with vkCmdBlitImage by the texture itself.
+///
+/// Each destination texel is the average of the 2x2 source texels it covers.
+/// The shader of a format is compiled the first time a texture of that
+/// format generates its mips. The image views and descriptor sets of a
+/// downsample live until its frame is re-used.
+///
+class HgiVkMipGenerator final
+{
+public:
+    HGIVK_API
+    HgiVkMipGenerator(HgiVkDevice* device);
+
+    HGIVK_API
+    ~HgiVkMipGenerator();
+
+    /// Returns true if `format` can be written by the compute downsample.
+    /// Formats other than rgba8, rgba8_snorm, rgba16f, rgba32f and r32f are
+    /// only supported if the device has shaderStorageImageExtendedFormats.
+    HGIVK_API
+    bool IsFormatSupported(HgiFormat format) const;
+
+    /// Records the downsample of mip `sourceMipLevel` into the next mip of
+    /// one layer of a 2d texture. The source mip must be in
+    /// SHADER_READ_ONLY_OPTIMAL and the destination mip in GENERAL layout.
+    /// Thread safety: May be called from any thread.
+    HGIVK_API
+    void RecordDownsample(
+        HgiVkCommandBuffer* cb,
+        HgiVkTexture* texture,
+        uint32_t sourceMipLevel,
+        uint32_t layer);
+
+    /// Releases the objects of the downsamples of the frame that previously
+    /// used the ring-buffer slot of `frame`.
+    /// Called by the device when a frame begins.
+    HGIVK_API
+    void BeginFrame(uint64_t frame);
+
+private:
+    HgiVkMipGenerator() = delete;
+    HgiVkMipGenerator & operator=(const HgiVkMipGenerator&) = delete;
+    HgiVkMipGenerator(const HgiVkMipGenerator&) = delete;
+
+    // Objects of the downsamples of one ring-buffer slot.
+    struct _FrameObjects {
+        std::vector<VkDescriptorPool> descriptorPools;
+        size_t descriptorPoolIndex = 0;
+        std::vector<VkImageView> imageViews;
+    };
+
+    // Returns the pipeline for `format`, compiling its shader on first use.
+    // Caller must hold _lock.
+    VkPipeline _AcquirePipeline(HgiFormat format);
+
+    // Returns a descriptor set for one downsample.
+    // Caller must hold _lock.
+    VkDescriptorSet _AllocateDescriptorSet(_FrameObjects* frameObjects);
+
+    // Creates a 2d view of one mip level of one layer of `texture`.
+    VkImageView _CreateImageView(
+        HgiVkTexture* texture,
+        uint32_t mipLevel,
+        uint32_t layer);
+
+private:
+    HgiVkDevice* _device;
+
+    VkSampler _vkSampler;
+    VkDescriptorSetLayout _vkDescriptorSetLayout;
+    VkPipelineLayout _vkPipelineLayout;
+
+    std::mutex _lock;
+    HgiVkShaderFunction* _shaders[HgiFormatCount];
+    VkPipeline _pipelines[HgiFormatCount];
+    std::vector<_FrameObjects> _frameObjects;
+};
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+#endif
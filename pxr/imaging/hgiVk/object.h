@@ -17,6 +17,9 @@ typedef enum HgiVkObjectType {
     HgiVkObjectTypeShaderProgram = 7,
     HgiVkObjectTypeSurface = 8,
     HgiVkObjectTypeSwapchain = 9,
+    HgiVkObjectTypeCommandBuffer = 10,
+    HgiVkObjectTypeCommandPool = 11,
+    HgiVkObjectTypeSampler = 12,
 };
 
 
@@ -38,6 +41,9 @@ struct HgiVkObject {
         class HgiVkShaderProgram* shaderProgram;
         class HgiVkSurface* surface;
         class HgiVkSwapchain* swapchain;
+        class HgiVkCommandBuffer* commandBuffer;
+        class HgiVkCommandPool* commandPool;
+        class HgiVkSampler* sampler;
     };
 };
 
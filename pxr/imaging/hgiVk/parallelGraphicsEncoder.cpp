@@ -4,6 +4,7 @@
 #include "pxr/imaging/hgiVk/commandBufferManager.h"
 #include "pxr/imaging/hgiVk/device.h"
 #include "pxr/imaging/hgiVk/diagnostic.h"
+#include "pxr/imaging/hgiVk/drawBundle.h"
 #include "pxr/imaging/hgiVk/graphicsEncoder.h"
 #include "pxr/imaging/hgiVk/hgi.h"
 #include "pxr/imaging/hgiVk/parallelGraphicsEncoder.h"
@@ -48,9 +49,10 @@ HgiVkParallelGraphicsEncoder::HgiVkParallelGraphicsEncoder(
     // Client will call BindPipeline on each graphics encoder, but we must make
     // sure that the right vkPipeline is our internal 'renderpass-pipeline'
     // cache that lives inside HgiVkPipeline. Normally this vkPipeline is
-    // created on-the-fly during BindPipeline, but that call is not threadsafe.
-    // By calling it here, we make sure the vkPipeline is created and inside
-    // the cache for when the parallel encoders try to acquire it.
+    // created on-the-fly during BindPipeline, which serializes the threads
+    // while the pipeline compiles. By calling it here, we make sure the
+    // vkPipeline is created and inside the cache for when the parallel
+    // encoders try to acquire it.
     if (HgiVkPipeline* p = static_cast<HgiVkPipeline*>(pipeline)) {
         p->AcquirePipeline(_renderPass);
     }
@@ -85,6 +87,29 @@ HgiVkParallelGraphicsEncoder::EndEncoding()
     _isRecording = false;
 }
 
+void
+HgiVkParallelGraphicsEncoder::ExecuteDrawBundle(HgiVkDrawBundle* bundle)
+{
+    if (!TF_VERIFY(_isRecording, "Parallel recording ended") ||
+        !TF_VERIFY(bundle)) {
+        return;
+    }
+
+    if (!bundle->IsValid()) {
+        TF_CODING_ERROR("Draw bundle must be recorded (again) before use");
+        return;
+    }
+
+    if (!bundle->IsCompatible(_renderPass)) {
+        TF_CODING_ERROR("Draw bundle is not compatible with render pass");
+        return;
+    }
+
+    // The secondary command buffers of the graphics encoders are executed
+    // during EndEncoding, so bundles are executed first.
+    bundle->Execute(_primaryCommandBuffer);
+}
+
 HgiGraphicsEncoderUniquePtr
 HgiVkParallelGraphicsEncoder::CreateGraphicsEncoder()
 {
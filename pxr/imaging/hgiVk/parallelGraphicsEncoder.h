@@ -14,6 +14,7 @@ PXR_NAMESPACE_OPEN_SCOPE
 
 class HgiVkCommandBuffer;
 class HgiVkDevice;
+class HgiVkDrawBundle;
 class HgiVkRenderPass;
 struct HgiGraphicsEncoderDesc;
 
@@ -42,6 +43,14 @@ public:
     HGIVK_API
     void EndEncoding() override;
 
+    /// Executes the draws recorded in `bundle`. Bundles are executed before
+    /// the draws of the graphics encoders of this parallel encoder.
+    /// The bundle must be valid and compatible with the render pass of this
+    /// encoder (see HgiVkDrawBundle).
+    /// Must be called on the thread that created this parallel encoder.
+    HGIVK_API
+    void ExecuteDrawBundle(HgiVkDrawBundle* bundle);
+
 private:
     HgiVkParallelGraphicsEncoder() = delete;
     HgiVkParallelGraphicsEncoder & operator=(
@@ -56,6 +56,8 @@ HgiVkPipeline::BindPipeline(
 VkPipeline
 HgiVkPipeline::AcquirePipeline(HgiVkRenderPass* rp)
 {
+    /* MULTI-THREAD CALL*/
+
     // We don't want clients to have to worry about pipeline - render pass
     // compatibility in Hgi. Clients manage pipelines independently and bind
     // pipelines to encoders. It is therefor possible they may not create an
@@ -64,6 +66,8 @@ HgiVkPipeline::AcquirePipeline(HgiVkRenderPass* rp)
     // receive an incompatible graphics encoder (aka render pass).
     // For more info see vulkan docs: renderpass-compatibility.
 
+    std::lock_guard<std::mutex> lock(_lock);
+
     if (_descriptor.pipelineType==HgiPipelineTypeGraphics) {
 
         // First check the cache if we have already created a pipeline for the
@@ -321,11 +325,10 @@ HgiVkPipeline::_AcquireGraphicsPipeline(HgiVkRenderPass* rp)
     _Pipeline pipeline;
     pipeline.desc = rpDesc;
 
-    // xxx we need to add a pipeline cache to avoid app having to keep compiling
-    // shader micro-code for every pipeline combination. We except that the
-    // spir-V shader code is not compiled for the target device until this point
-    // where we create the pipeline. So a pipeline cache can be helpful.
-    // https://zeux.io/2019/07/17/serializing-pipeline-cache/
+    // The spir-V shader code is not compiled for the target device until this
+    // point where we create the pipeline. The device pipeline cache is seeded
+    // from disk (see HgiVkDevice::SavePipelineCache) so we avoid recompiling
+    // the shader micro-code for every pipeline combination on every run.
     TF_VERIFY(
         vkCreateGraphicsPipelines(
             _device->GetVulkanDevice(),
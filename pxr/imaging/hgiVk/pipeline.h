@@ -1,6 +1,7 @@
 #ifndef PXR_IMAGING_HGIVK_PIPELINE_H
 #define PXR_IMAGING_HGIVK_PIPELINE_H
 
+#include <mutex>
 #include <vector>
 
 #include "pxr/pxr.h"
@@ -41,6 +42,8 @@ public:
         HgiVkRenderPass* rp);
 
     // Create pipeline object for _descriptor and render pass.
+    // Thread safety: May be called from any thread, e.g. by the encoders of
+    // a draw bundle that record in parallel.
     HGIVK_API
     VkPipeline AcquirePipeline(HgiVkRenderPass* rp);
 
@@ -66,6 +69,9 @@ private:
 private:
     HgiVkDevice* _device;
     HgiPipelineDesc _descriptor;
+
+    // Guards _pipelines, pipelines are created on demand during recording.
+    std::mutex _lock;
     std::vector<_Pipeline> _pipelines;
     VkPrimitiveTopology _vkTopology;
 };
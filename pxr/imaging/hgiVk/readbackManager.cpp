@@ -0,0 +1,431 @@
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "pxr/base/tf/diagnostic.h"
+
+#include "pxr/imaging/hgiVk/commandBuffer.h"
+#include "pxr/imaging/hgiVk/commandPool.h"
+#include "pxr/imaging/hgiVk/device.h"
+#include "pxr/imaging/hgiVk/diagnostic.h"
+#include "pxr/imaging/hgiVk/readbackManager.h"
+
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+// Pooled buffers are rounded up to a power of two (at least this size), so
+// readbacks of similar sizes share buffers.
+static const VkDeviceSize _minBufferSize = 64 * 1024;
+
+// Buffers beyond this count are destroyed when their readback completes.
+static const size_t _maxFreeBuffers = 16;
+
+
+HgiVkReadbackManager::HgiVkReadbackManager(HgiVkDevice* device)
+    : _device(device)
+    , _nextTicket(1)
+    , _submittedFrame(0)
+    , _immediatePool(nullptr)
+    , _immediateCB(nullptr)
+    , _immediateFence(nullptr)
+{
+}
+
+HgiVkReadbackManager::~HgiVkReadbackManager()
+{
+    // The device waits for the gpu to be idle before destroying the manager.
+    std::lock_guard<std::mutex> lock(_lock);
+
+    for (_Readback const& readback : _pending) {
+        _freeBuffers.push_back(readback.buffer);
+    }
+    _pending.clear();
+
+    for (_Buffer const& buffer : _freeBuffers) {
+        _DestroyBuffer(buffer);
+    }
+    _freeBuffers.clear();
+
+    if (_immediateBuffer.vkBuffer) {
+        _DestroyBuffer(_immediateBuffer);
+    }
+
+    if (_immediateFence) {
+        vkDestroyFence(
+            _device->GetVulkanDevice(),
+            _immediateFence,
+            HgiVkAllocator());
+    }
+
+    // The command buffer must be freed before its pool.
+    delete _immediateCB;
+    delete _immediatePool;
+}
+
+HgiVkReadbackRegion
+HgiVkReadbackManager::AddReadback(
+    size_t byteSize,
+    void* cpuDestination,
+    HgiVkReadbackCallback const& callback)
+{
+    /* MULTI-THREAD CALL*/
+
+    if (!TF_VERIFY(byteSize > 0 && cpuDestination, "Invalid readback")) {
+        return HgiVkReadbackRegion();
+    }
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    _Buffer buffer = _AcquireBuffer(byteSize);
+    if (!buffer.vkBuffer) {
+        return HgiVkReadbackRegion();
+    }
+
+    _Readback readback;
+    readback.ticket = _nextTicket++;
+    readback.frame = _device->GetCurrentFrame();
+    readback.buffer = buffer;
+    readback.cpuDestination = cpuDestination;
+    readback.byteSize = byteSize;
+    readback.callback = callback;
+    _pending.push_back(readback);
+
+    HgiVkReadbackRegion region;
+    region.ticket = readback.ticket;
+    region.buffer = buffer.vkBuffer;
+    region.offset = 0;
+    region.size = byteSize;
+    return region;
+}
+
+bool
+HgiVkReadbackManager::IsComplete(HgiVkReadbackTicket ticket)
+{
+    /* MULTI-THREAD CALL*/
+
+    _CompleteReadbacks();
+
+    std::lock_guard<std::mutex> lock(_lock);
+    for (_Readback const& readback : _pending) {
+        if (readback.ticket == ticket) return false;
+    }
+    return true;
+}
+
+bool
+HgiVkReadbackManager::Wait(HgiVkReadbackTicket ticket)
+{
+    /* MULTI-THREAD CALL*/
+
+    uint64_t frame = 0;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        for (_Readback const& readback : _pending) {
+            if (readback.ticket == ticket) {
+                frame = readback.frame;
+                break;
+            }
+        }
+
+        // Waiting on a frame that was not submitted would never return.
+        if (frame > _submittedFrame) {
+            TF_CODING_ERROR("Readback %llu waits on a frame that did not end",
+                (unsigned long long) ticket);
+            return false;
+        }
+    }
+
+    _device->WaitForFrame(frame);
+    _CompleteReadbacks();
+    return true;
+}
+
+void
+HgiVkReadbackManager::Cancel(HgiVkReadbackTicket ticket)
+{
+    /* MULTI-THREAD CALL*/
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    for (_Readback& readback : _pending) {
+        if (readback.ticket == ticket) {
+            // Keep the buffer with the readback until the gpu is done with
+            // it, but do not deliver the data.
+            readback.cpuDestination = nullptr;
+            readback.callback = nullptr;
+            return;
+        }
+    }
+}
+
+bool
+HgiVkReadbackManager::ReadImmediate(
+    size_t byteSize,
+    void* cpuDestination,
+    HgiVkReadbackRecordFn const& recordFn)
+{
+    /* MULTI-THREAD CALL*/
+
+    if (!TF_VERIFY(byteSize > 0 && cpuDestination && recordFn,
+        "Invalid readback")) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_immediateLock);
+
+    if (!_immediatePool) {
+        _immediatePool = new HgiVkCommandPool(_device);
+        _immediatePool->SetDebugName("Immediate Readback");
+        _immediateCB = new HgiVkCommandBuffer(
+            _device, _immediatePool, HgiVkCommandBufferUsagePrimary);
+        _immediateCB->SetDebugName("Immediate Readback");
+
+        VkFenceCreateInfo fenceInfo = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+        TF_VERIFY(
+            vkCreateFence(
+                _device->GetVulkanDevice(),
+                &fenceInfo,
+                HgiVkAllocator(),
+                &_immediateFence) == VK_SUCCESS
+        );
+    }
+
+    // The buffer only grows, so repeated picks never allocate.
+    if (_immediateBuffer.size < byteSize) {
+        if (_immediateBuffer.vkBuffer) {
+            _DestroyBuffer(_immediateBuffer);
+        }
+        _immediateBuffer = _CreateBuffer(byteSize);
+        if (!_immediateBuffer.vkBuffer) {
+            return false;
+        }
+    }
+
+    // The previous immediate readback has completed (we waited on it), so
+    // the command buffer can be recorded again.
+    _immediatePool->ResetCommandPool();
+
+    HgiVkReadbackRegion region;
+    region.buffer = _immediateBuffer.vkBuffer;
+    region.offset = 0;
+    region.size = byteSize;
+
+    recordFn(_immediateCB, region);
+
+    // Make the copy visible to the host.
+    VkBufferMemoryBarrier barrier = {VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = region.buffer;
+    barrier.offset = region.offset;
+    barrier.size = region.size;
+
+    _immediateCB->AddBarrier(
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_HOST_BIT,
+        barrier);
+
+    _immediateCB->EndRecording();
+
+    TF_VERIFY(
+        vkResetFences(
+            _device->GetVulkanDevice(),
+            1,
+            &_immediateFence) == VK_SUCCESS
+    );
+
+    std::vector<VkSubmitInfo> submitInfos;
+    VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submitInfo.commandBufferCount = 1;
+    VkCommandBuffer vkCmdBuf = _immediateCB->GetVulkanCommandBuffer();
+    submitInfo.pCommandBuffers = &vkCmdBuf;
+    submitInfos.emplace_back(std::move(submitInfo));
+    _device->SubmitToQueue(submitInfos, _immediateFence);
+
+    // Only this small copy is waited on, not the frames in flight.
+    if (!TF_VERIFY(
+        vkWaitForFences(
+            _device->GetVulkanDevice(),
+            1,
+            &_immediateFence,
+            VK_TRUE,
+            100000000000) == VK_SUCCESS)) {
+        return false;
+    }
+
+    vmaInvalidateAllocation(
+        _device->GetVulkanMemoryAllocator(),
+        _immediateBuffer.vmaAllocation,
+        0,
+        byteSize);
+
+    memcpy(cpuDestination, _immediateBuffer.dataMapped, byteSize);
+    return true;
+}
+
+void
+HgiVkReadbackManager::BeginFrame()
+{
+    _CompleteReadbacks();
+}
+
+void
+HgiVkReadbackManager::EndFrame(uint64_t frame)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    _submittedFrame = frame;
+}
+
+HgiVkReadbackManager::_Buffer
+HgiVkReadbackManager::_AcquireBuffer(VkDeviceSize byteSize)
+{
+    // Best fit from the pool.
+    auto best = _freeBuffers.end();
+    for (auto it = _freeBuffers.begin(); it != _freeBuffers.end(); ++it) {
+        if (it->size >= byteSize &&
+            (best == _freeBuffers.end() || it->size < best->size)) {
+            best = it;
+        }
+    }
+
+    if (best != _freeBuffers.end()) {
+        _Buffer buffer = *best;
+        _freeBuffers.erase(best);
+        return buffer;
+    }
+
+    VkDeviceSize size = _minBufferSize;
+    while (size < byteSize) {
+        size *= 2;
+    }
+
+    return _CreateBuffer(size);
+}
+
+HgiVkReadbackManager::_Buffer
+HgiVkReadbackManager::_CreateBuffer(VkDeviceSize byteSize)
+{
+    VkBufferCreateInfo bufCreateInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    bufCreateInfo.size = byteSize;
+    bufCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    bufCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    // GPU_TO_CPU memory is host cached, but may not be host coherent.
+    VmaAllocationCreateInfo allocInfo = {};
+    allocInfo.usage = VMA_MEMORY_USAGE_GPU_TO_CPU;
+
+    // MoltenVK does not fill GPU_TO_CPU buffers (see HgiVkBuffer).
+    #if defined(__APPLE__)
+        allocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+    #endif
+
+    _Buffer buffer;
+    if (!TF_VERIFY(
+        vmaCreateBuffer(
+            _device->GetVulkanMemoryAllocator(),
+            &bufCreateInfo,
+            &allocInfo,
+            &buffer.vkBuffer,
+            &buffer.vmaAllocation,
+            nullptr) == VK_SUCCESS)) {
+        return _Buffer();
+    }
+
+    // Persistently map the buffer. It is only unmapped on destruction.
+    void* dataMapped = nullptr;
+    TF_VERIFY(
+        vmaMapMemory(
+            _device->GetVulkanMemoryAllocator(),
+            buffer.vmaAllocation,
+            &dataMapped) == VK_SUCCESS
+    );
+
+    buffer.dataMapped = (char*) dataMapped;
+    buffer.size = byteSize;
+
+    HgiVkSetDebugName(
+        _device,
+        (uint64_t)buffer.vkBuffer,
+        VK_DEBUG_REPORT_OBJECT_TYPE_BUFFER_EXT,
+        "Readback Buffer");
+
+    return buffer;
+}
+
+void
+HgiVkReadbackManager::_DestroyBuffer(_Buffer const& buffer)
+{
+    if (buffer.dataMapped) {
+        vmaUnmapMemory(
+            _device->GetVulkanMemoryAllocator(),
+            buffer.vmaAllocation);
+    }
+
+    vmaDestroyBuffer(
+        _device->GetVulkanMemoryAllocator(),
+        buffer.vkBuffer,
+        buffer.vmaAllocation);
+}
+
+void
+HgiVkReadbackManager::_CompleteReadbacks()
+{
+    /* MULTI-THREAD CALL*/
+
+    const uint64_t completedFrame = _device->GetCompletedFrame();
+
+    typedef std::pair<HgiVkReadbackCallback, HgiVkReadbackTicket> _Callback;
+    std::vector<_Callback> callbacks;
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        for (size_t i=0; i<_pending.size();) {
+            _Readback& readback = _pending[i];
+            if (readback.frame > completedFrame) {
+                i++;
+                continue;
+            }
+
+            if (readback.cpuDestination && readback.buffer.dataMapped) {
+                vmaInvalidateAllocation(
+                    _device->GetVulkanMemoryAllocator(),
+                    readback.buffer.vmaAllocation,
+                    0,
+                    readback.byteSize);
+
+                memcpy(
+                    readback.cpuDestination,
+                    readback.buffer.dataMapped,
+                    readback.byteSize);
+            }
+
+            if (readback.callback) {
+                callbacks.emplace_back(readback.callback, readback.ticket);
+            }
+
+            // The gpu has completed the frame, so the buffer can be re-used
+            // or destroyed right away.
+            if (_freeBuffers.size() < _maxFreeBuffers) {
+                _freeBuffers.push_back(readback.buffer);
+            } else {
+                _DestroyBuffer(readback.buffer);
+            }
+
+            if (i + 1 < _pending.size()) {
+                _pending[i] = std::move(_pending.back());
+            }
+            _pending.pop_back();
+        }
+    }
+
+    // Callbacks may add new readbacks, so they are called without the lock.
+    for (auto const& callback : callbacks) {
+        callback.first(callback.second);
+    }
+}
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
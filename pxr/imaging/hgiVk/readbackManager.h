@@ -0,0 +1,175 @@
+#ifndef PXR_IMAGING_HGIVK_READBACK_MANAGER_H
+#define PXR_IMAGING_HGIVK_READBACK_MANAGER_H
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "pxr/pxr.h"
+#include "pxr/imaging/hgiVk/api.h"
+#include "pxr/imaging/hgiVk/vulkan.h"
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+class HgiVkCommandBuffer;
+class HgiVkCommandPool;
+class HgiVkDevice;
+
+/// Identifies an asynchronous readback. 0 is never a valid ticket.
+typedef uint64_t HgiVkReadbackTicket;
+
+/// Called once the data of a readback was copied to its cpu destination.
+typedef std::function<void(HgiVkReadbackTicket ticket)> HgiVkReadbackCallback;
+
+
+/// \struct HgiVkReadbackRegion
+///
+/// Host visible memory the gpu copies the data of a readback into.
+///
+struct HgiVkReadbackRegion {
+    HgiVkReadbackTicket ticket = 0;
+    VkBuffer buffer = nullptr;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+};
+
+/// Records the copy of an immediate readback into `region`.
+typedef std::function<void(
+    HgiVkCommandBuffer* cb,
+    HgiVkReadbackRegion const& region)> HgiVkReadbackRecordFn;
+
+
+/// \class HgiVkReadbackManager
+///
+/// Asynchronous gpu to cpu copies.
+///
+/// A readback is recorded into the command buffers of the current frame. Its
+/// data is copied into a buffer from a pool of persistently mapped readback
+/// buffers. Once the gpu has completed the frame the data is copied to the
+/// cpu destination of the readback and the buffer returns to the pool.
+/// The cpu never waits on the gpu, unless Wait is called.
+///
+/// Completed readbacks are processed when a frame begins, or when the client
+/// polls (IsComplete) or waits (Wait) for a readback. Callbacks are called on
+/// the thread that processes the readback.
+///
+class HgiVkReadbackManager final
+{
+public:
+    HGIVK_API
+    HgiVkReadbackManager(HgiVkDevice* device);
+
+    HGIVK_API
+    ~HgiVkReadbackManager();
+
+    /// Adds a readback of `byteSize` bytes to the current frame.
+    /// The caller records the copy of the data into the returned region.
+    /// `cpuDestination` must stay valid until the readback completes or is
+    /// cancelled.
+    /// Thread safety: May be called from any thread.
+    HGIVK_API
+    HgiVkReadbackRegion AddReadback(
+        size_t byteSize,
+        void* cpuDestination,
+        HgiVkReadbackCallback const& callback);
+
+    /// Returns true if the data of `ticket` has been copied to its cpu
+    /// destination. Never blocks.
+    /// Thread safety: May be called from any thread.
+    HGIVK_API
+    bool IsComplete(HgiVkReadbackTicket ticket);
+
+    /// Blocks the cpu until the data of `ticket` has been copied to its cpu
+    /// destination. The frame of the readback must have ended, otherwise
+    /// false is returned.
+    /// Thread safety: May be called from any thread.
+    HGIVK_API
+    bool Wait(HgiVkReadbackTicket ticket);
+
+    /// Drops a readback. Its data is not copied and its callback not called.
+    /// Used when the cpu destination is destroyed before the readback
+    /// completed.
+    /// Thread safety: May be called from any thread.
+    HGIVK_API
+    void Cancel(HgiVkReadbackTicket ticket);
+
+    /// Low latency readback of a few bytes, such as a pick region.
+    /// `recordFn` records the copy into a command buffer that is submitted
+    /// on its own, ahead of the frames that are still being recorded. The
+    /// cpu waits for that copy only, then `byteSize` bytes are copied to
+    /// `cpuDestination`. The command buffer, fence and readback buffer are
+    /// re-used, so nothing is allocated per call.
+    /// Thread safety: May be called from any thread. Immediate readbacks
+    /// are serialized.
+    HGIVK_API
+    bool ReadImmediate(
+        size_t byteSize,
+        void* cpuDestination,
+        HgiVkReadbackRecordFn const& recordFn);
+
+    /// Completes the readbacks of the frames the gpu has finished.
+    /// Called by the device when a frame begins.
+    HGIVK_API
+    void BeginFrame();
+
+    /// Marks the readbacks of `frame` as submitted.
+    /// Called by the device when a frame ends.
+    HGIVK_API
+    void EndFrame(uint64_t frame);
+
+private:
+    HgiVkReadbackManager() = delete;
+    HgiVkReadbackManager & operator=(const HgiVkReadbackManager&) = delete;
+    HgiVkReadbackManager(const HgiVkReadbackManager&) = delete;
+
+    struct _Buffer {
+        VkBuffer vkBuffer = nullptr;
+        VmaAllocation vmaAllocation = nullptr;
+        char* dataMapped = nullptr;
+        VkDeviceSize size = 0;
+    };
+
+    struct _Readback {
+        HgiVkReadbackTicket ticket;
+        uint64_t frame;
+        _Buffer buffer;
+        void* cpuDestination;
+        size_t byteSize;
+        HgiVkReadbackCallback callback;
+    };
+
+    // Returns a pooled buffer of at least `byteSize` bytes.
+    // Caller must hold _lock.
+    _Buffer _AcquireBuffer(VkDeviceSize byteSize);
+
+    // Creates a persistently mapped readback buffer.
+    _Buffer _CreateBuffer(VkDeviceSize byteSize);
+
+    // Destroys a buffer that the gpu no longer uses.
+    void _DestroyBuffer(_Buffer const& buffer);
+
+    // Copies the data of the readbacks of completed frames to their cpu
+    // destination and calls their callbacks.
+    void _CompleteReadbacks();
+
+private:
+    HgiVkDevice* _device;
+
+    std::mutex _lock;
+    std::vector<_Buffer> _freeBuffers;
+    std::vector<_Readback> _pending;
+    HgiVkReadbackTicket _nextTicket;
+    uint64_t _submittedFrame;
+
+    // Objects of immediate readbacks, created on first use.
+    std::mutex _immediateLock;
+    HgiVkCommandPool* _immediatePool;
+    HgiVkCommandBuffer* _immediateCB;
+    VkFence _immediateFence;
+    _Buffer _immediateBuffer;
+};
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+#endif
@@ -37,7 +37,28 @@ HgiVkRenderPass::HgiVkRenderPass(
 
     HgiAttachmentDescConstPtrVector attachments = GetCombinedAttachments(desc);
     for (HgiAttachmentDesc const* attachDesc : attachments) {
-        usage |= _ProcessAttachment(*attachDesc);
+        usage |= _ProcessAttachment(*attachDesc, /*isResolve*/ false);
+    }
+
+    // Multisample color attachments are resolved at the end of the subpass,
+    // while their samples are still in tile memory. The resolve textures are
+    // appended after the color and depth attachments.
+    if (desc.depthAttachment.resolveTexture) {
+        TF_CODING_ERROR("Depth attachments cannot declare a resolve texture");
+    }
+
+    HgiAttachmentDescConstPtrVector resolves = GetResolveAttachments(desc);
+    if (!resolves.empty()) {
+        _vkResolveReferences.resize(
+            desc.colorAttachments.size(),
+            {VK_ATTACHMENT_UNUSED, VK_IMAGE_LAYOUT_UNDEFINED});
+
+        for (size_t i=0; i<desc.colorAttachments.size(); i++) {
+            HgiAttachmentDesc const& color = desc.colorAttachments[i];
+            if (!color.resolveTexture) continue;
+            usage |= _ProcessAttachment(color, /*isResolve*/ true);
+            _vkResolveReferences[i] = _vkReferences.back();
+        }
     }
 
     bool isSwapchain = usage & HgiTextureUsageBitsSwapchain;
@@ -63,12 +84,22 @@ HgiVkRenderPass::HgiVkRenderPass(
             &_vkReferences[desc.colorAttachments.size()];
     }
 
+    if (!_vkResolveReferences.empty()) {
+        subpassDescription.pResolveAttachments = _vkResolveReferences.data();
+    }
+
     //
     // SubPass dependencies
     //
     // Use subpass dependencies to transition image layouts and act as barrier
     // to ensure the read and write operations happen when it is allowed.
     //
+    // The attachments of regular passes are transitioned with the texture's
+    // tracked state before the pass begins (see BeginRenderPass) and stay in
+    // their attachment layout after the pass. The next command that uses the
+    // texture adds the barrier it needs. So only the swapchain, which manages
+    // its own image layouts, needs external dependencies.
+    //
     VkSubpassDependency dependencies[2];
 
     // Start of subpass -- ensure shader reading is completed before FB write.
@@ -76,15 +107,9 @@ HgiVkRenderPass::HgiVkRenderPass(
     dependencies[0].dstSubpass = 0;
     dependencies[0].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
 
-    dependencies[0].srcStageMask = isSwapchain ?
-        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT :
-        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
     dependencies[0].dstStageMask= VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-
-    dependencies[0].srcAccessMask = isSwapchain ?
-        VK_ACCESS_MEMORY_READ_BIT :
-        HgiVkRenderPass::GetDefaultDstAccessMask();
+    dependencies[0].srcAccessMask = VK_ACCESS_MEMORY_READ_BIT;
 
     dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
                                     VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
@@ -95,28 +120,24 @@ HgiVkRenderPass::HgiVkRenderPass(
     dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
 
     dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    dependencies[1].dstStageMask = isSwapchain ?
-        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT :
-        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
 
     dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
                                     VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
 
-    dependencies[1].dstAccessMask = isSwapchain ?
-        VK_ACCESS_MEMORY_READ_BIT :
-        HgiVkRenderPass::GetDefaultDstAccessMask();
+    dependencies[1].dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
 
     //
     // Create the renderpass
     //
     VkRenderPassCreateInfo renderPassInfo = {};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    renderPassInfo.attachmentCount = attachments.size();
+    renderPassInfo.attachmentCount = _vkDescriptions.size();
     renderPassInfo.pAttachments = _vkDescriptions.data();
     renderPassInfo.subpassCount = 1;
     renderPassInfo.pSubpasses = &subpassDescription;
-    renderPassInfo.dependencyCount = 2;
-    renderPassInfo.pDependencies = &dependencies[0];
+    renderPassInfo.dependencyCount = isSwapchain ? 2 : 0;
+    renderPassInfo.pDependencies = isSwapchain ? &dependencies[0] : nullptr;
 
     TF_VERIFY(
         vkCreateRenderPass(
@@ -139,7 +160,7 @@ HgiVkRenderPass::HgiVkRenderPass(
     VkFramebufferCreateInfo fbufCreateInfo =
         {VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO};
     fbufCreateInfo.renderPass = _vkRenderPass;
-    fbufCreateInfo.attachmentCount = attachments.size();
+    fbufCreateInfo.attachmentCount = _vkImageViews.size();
     fbufCreateInfo.pAttachments = _vkImageViews.data();
     fbufCreateInfo.width = desc.width;
     fbufCreateInfo.height = desc.height;
@@ -198,6 +219,46 @@ HgiVkRenderPass::BeginRenderPass(
     // Prevent the render pass cache from deleting this render pass
     _lastUsedFrame = _device->GetCurrentFrame();
 
+    // Draws of the pass may sample textures that earlier commands of this
+    // command buffer left in another state. Attachments keep their state, so
+    // rendering into the same attachments again needs no layout transition.
+    cb->RestoreTextureStates(_textures);
+
+    HgiAttachmentDescConstPtrVector attachments =
+        GetCombinedAttachments(_descriptor);
+
+    for (size_t i=0; i<_textures.size(); i++) {
+        HgiVkTexture* tex = _textures[i];
+        if (!tex) continue;
+
+        bool isDepthBuffer =
+            tex->GetDescriptor().usage & HgiTextureUsageBitsDepthTarget;
+
+        // Cleared attachments don't need their previous contents.
+        // Resolve textures (after the attachments) are fully overwritten.
+        if (i >= attachments.size() ||
+            attachments[i]->loadOp != HgiAttachmentLoadOpLoad) {
+            tex->InvalidateContents(cb);
+        }
+
+        if (isDepthBuffer) {
+            tex->TransitionImageBarrier(
+                cb,
+                _vkReferences[i].layout,
+                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT);
+        } else {
+            tex->TransitionImageBarrier(
+                cb,
+                _vkReferences[i].layout,
+                VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+                VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+        }
+    }
+
     // Begin render pass in primary command buffer
     VkRenderPassBeginInfo renderPassBeginInfo =
         {VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
@@ -212,6 +273,8 @@ HgiVkRenderPass::BeginRenderPass(
         VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS :
         VK_SUBPASS_CONTENTS_INLINE;
 
+    // Pending barriers of the command buffer are recorded before the render
+    // pass begins (see GetCommandBufferForRecoding).
     vkCmdBeginRenderPass(
         cb->GetCommandBufferForRecoding(),
         &renderPassBeginInfo,
@@ -248,6 +311,20 @@ HgiVkRenderPass::GetImageViews() const
     return _vkImageViews;
 }
 
+HgiAttachmentDescConstPtrVector
+HgiVkRenderPass::GetResolveAttachments(HgiGraphicsEncoderDesc const& desc)
+{
+    HgiAttachmentDescConstPtrVector vec;
+
+    for (HgiAttachmentDesc const& color : desc.colorAttachments) {
+        if (color.resolveTexture) {
+            vec.push_back(&color);
+        }
+    }
+
+    return vec;
+}
+
 HgiAttachmentDescConstPtrVector
 HgiVkRenderPass::GetCombinedAttachments(HgiGraphicsEncoderDesc const& desc)
 {
@@ -265,28 +342,6 @@ HgiVkRenderPass::GetCombinedAttachments(HgiGraphicsEncoderDesc const& desc)
     return vec;
 }
 
-VkAccessFlags
-HgiVkRenderPass::GetDefaultDstAccessMask()
-{
-    // We are currently not tracking the 'dstAccessMask' state a texture is in.
-    // So when a render pass or other command transitions the image to a
-    // different dstAccessMask for a command to operate on the texture, we want
-    // that cmd to transition the image back to this default mask.
-    // For example HgiVkBlitEncoder::CopyTextureGpuToCpu transitions an texture
-    // TRANSFER_READ_BIT to copy the texture into a buffer.
-    // It will transfer it back to SHADER_READ so the next render pass that
-    // uses the texture knows that its current mask is SHADER_READ
-
-    // XXX Performance warning:
-    // Currently we always transition back to SHADER_READ at the end of a
-    // renderpass (see HgiVkRenderPass constructor) as that is the most likely
-    // next usage of a color target. A render-graph system could perhaps
-    // give us more fine-tuned transition and shader stage information and that
-    // will likely be better for performance.
-
-    return VK_ACCESS_SHADER_READ_BIT;
-}
-
 uint64_t
 HgiVkRenderPass::GetLastUsedFrame() const
 {
@@ -294,14 +349,24 @@ HgiVkRenderPass::GetLastUsedFrame() const
 }
 
 HgiTextureUsage
-HgiVkRenderPass::_ProcessAttachment(HgiAttachmentDesc const& attachment)
+HgiVkRenderPass::_ProcessAttachment(
+    HgiAttachmentDesc const& attachment,
+    bool isResolve)
 {
-    HgiVkTexture const* tex =
-        static_cast<HgiVkTexture const*>(attachment.texture);
+    HgiVkTexture* tex = static_cast<HgiVkTexture*>(
+        isResolve ? attachment.resolveTexture : attachment.texture);
     if (!TF_VERIFY(tex)) return HgiTextureUsageBitsUndefined;
 
     HgiTextureDesc const& texDesc = tex->GetDescriptor();
 
+    if (isResolve) {
+        HgiVkTexture* msaa = static_cast<HgiVkTexture*>(attachment.texture);
+        TF_VERIFY(msaa && texDesc.sampleCount == HgiSampleCount1 &&
+                  texDesc.format == msaa->GetDescriptor().format,
+            "Resolve texture must be single sample and match the format of "
+            "the multisample attachment");
+    }
+
     bool isDepthBuffer = texDesc.usage & HgiTextureUsageBitsDepthTarget;
     bool isSwapchain = texDesc.usage & HgiTextureUsageBitsSwapchain;
 
@@ -324,8 +389,11 @@ HgiVkRenderPass::_ProcessAttachment(HgiAttachmentDesc const& attachment)
     desc.flags = 0;
     desc.format = format;
     desc.samples = HgiVkConversions::GetSampleCount(texDesc.sampleCount);
-    desc.loadOp = HgiVkConversions::GetLoadOp(attachment.loadOp);
-    desc.storeOp = HgiVkConversions::GetStoreOp(attachment.storeOp);
+    // The resolve overwrites all pixels of the resolve texture.
+    desc.loadOp = isResolve ? VK_ATTACHMENT_LOAD_OP_DONT_CARE :
+        HgiVkConversions::GetLoadOp(attachment.loadOp);
+    desc.storeOp = isResolve ? VK_ATTACHMENT_STORE_OP_STORE :
+        HgiVkConversions::GetStoreOp(attachment.storeOp);
     desc.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;       // XXX
     desc.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE; // XXX
 
@@ -337,21 +405,12 @@ HgiVkRenderPass::_ProcessAttachment(HgiAttachmentDesc const& attachment)
     // VkAttachmentReference array, and then the subpass dependency tells
     // the subpass when to change the layout.
 
-    // Layout of image just before RenderPass (here we use tex layout, but could
-    // also be the finalLayout of a previous render-pass)
-    desc.initialLayout = tex->GetImageLayout();
-
     VkClearValue clearValue;
 
     if (isDepthBuffer) {
         clearValue.depthStencil.depth = attachment.clearValue[0];
         clearValue.depthStencil.stencil = uint32_t(attachment.clearValue[1]);
 
-        // The layout of the image at the end of the entire pass
-        desc.finalLayout = isSwapchain ?
-            VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL :
-            VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
-
         // The desired layout for this image during a subpass
         ref.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
     } else {
@@ -360,15 +419,20 @@ HgiVkRenderPass::_ProcessAttachment(HgiAttachmentDesc const& attachment)
         clearValue.color.float32[2] = attachment.clearValue[2];
         clearValue.color.float32[3] = attachment.clearValue[3];
 
-        // The layout of the image at the end of the entire pass
-        desc.finalLayout = isSwapchain ?
-            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL :
-            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
         // The desired layout for this image during a subpass
         ref.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
     }
 
+    // Layout of image just before and at the end of the entire pass.
+    // The attachment is transitioned into this layout before the pass begins
+    // and stays in it afterwards, so the pass itself never transitions it.
+    // (Swapchain images are transitioned by the swapchain.)
+    desc.initialLayout = ref.layout;
+    desc.finalLayout = ref.layout;
+
+    // The state of swapchain images is not tracked.
+    _textures.push_back(isSwapchain ? nullptr : tex);
+
     _vkImageViews.push_back(tex->GetImageView());
     _vkClearValues.emplace_back(std::move(clearValue));
     _vkDescriptions.emplace_back(std::move(desc));
@@ -14,6 +14,7 @@ PXR_NAMESPACE_OPEN_SCOPE
 
 class HgiVkDevice;
 class HgiVkCommandBuffer;
+class HgiVkTexture;
 
 typedef std::vector<HgiAttachmentDesc const*> HgiAttachmentDescConstPtrVector;
 
@@ -76,14 +77,17 @@ public:
     HGIVK_API
     std::vector<VkImageView> const& GetImageViews() const;
 
-    /// Combines the color and depth attachments in one vector.
+    /// Returns the color attachments that have a resolve texture.
+    /// The resolve textures follow the combined attachments in the image
+    /// views of the render pass, in this order.
     HGIVK_API
-    static HgiAttachmentDescConstPtrVector GetCombinedAttachments(
+    static HgiAttachmentDescConstPtrVector GetResolveAttachments(
         HgiGraphicsEncoderDesc const& desc);
 
-    /// Helper to transition images back to a known dest access mask.
+    /// Combines the color and depth attachments in one vector.
     HGIVK_API
-    static VkAccessFlags GetDefaultDstAccessMask();
+    static HgiAttachmentDescConstPtrVector GetCombinedAttachments(
+        HgiGraphicsEncoderDesc const& desc);
 
     /// Returns the frame the render pass was last used
     HGIVK_API
@@ -96,7 +100,10 @@ private:
 
     // Extracts the render pass information for one texture.
     // Returns that usage type of the texture (e.g. color target)
-    HgiTextureUsage _ProcessAttachment(HgiAttachmentDesc const& attachDesc);
+    // If `isResolve` the resolve texture of the attachment is processed.
+    HgiTextureUsage _ProcessAttachment(
+        HgiAttachmentDesc const& attachDesc,
+        bool isResolve);
 
 private:
     HgiVkDevice* _device;
@@ -108,6 +115,10 @@ private:
     std::vector<VkImageView> _vkImageViews;
     std::vector<VkAttachmentDescription> _vkDescriptions;
     std::vector<VkAttachmentReference> _vkReferences;
+    std::vector<VkAttachmentReference> _vkResolveReferences;
+
+    // Textures of the attachments. Nullptr for swapchain images.
+    std::vector<HgiVkTexture*> _textures;
 
     std::atomic_flag _acquired = ATOMIC_FLAG_INIT;
     uint64_t _lastUsedFrame;
@@ -15,10 +15,6 @@
 
 PXR_NAMESPACE_OPEN_SCOPE
 
-thread_local uint16_t _HgiVkrpcThreadLocalIndex = 0;
-thread_local uint64_t _HgiVkrpcThreadLocalFrame = ~0ull;
-
-
 struct HgiVkRenderPassCacheItem {
     ~HgiVkRenderPassCacheItem() {
         HgiVkObject object;
@@ -95,13 +91,25 @@ _CompareHgiGraphicsEncoderDesc(
         if (renderPassView != tex->GetImageView()) return false;
     }
 
+    // The resolve textures follow the attachments.
+    HgiAttachmentDescConstPtrVector resolveL =
+        HgiVkRenderPass::GetResolveAttachments(newDesc);
+
+    for (size_t i=0; i<resolveL.size(); i++) {
+        VkImageView renderPassView = imageViews[attachmentL.size() + i];
+
+        HgiVkTexture* tex =
+            static_cast<HgiVkTexture*>(resolveL[i]->resolveTexture);
+
+        if (renderPassView != tex->GetImageView()) return false;
+    }
+
     return true;
 }
 
 HgiVkRenderPassPipelineCache::HgiVkRenderPassPipelineCache()
     : _frame(~0ull)
     , _frameStarted(false)
-    , _nextThreadLocalIndex(0)
 {
 }
 
@@ -135,23 +143,11 @@ HgiVkRenderPassPipelineCache::AcquireRenderPass(
         }
     }
 
-    // Acquire this thread's index into the thread local passes / pipelines.
-
-    if (_HgiVkrpcThreadLocalFrame != _frame) {
-        _HgiVkrpcThreadLocalIndex = _nextThreadLocalIndex.fetch_add(1);
-        _HgiVkrpcThreadLocalFrame = _frame;
-    }
-
     // If we didn't find the render pass in the global cache, look for it in
     // our thread_local vector to see if we already created a matching
     // render pass this frame.
 
-    if (_HgiVkrpcThreadLocalIndex >= _threadRenderPasses.size()) {
-        TF_CODING_ERROR("rpc numThreads > HgiVk::GetThreadCount");
-        _HgiVkrpcThreadLocalIndex = 0;
-    }
-
-    HgiVkRenderPassCacheVec& pv= _threadRenderPasses[_HgiVkrpcThreadLocalIndex];
+    HgiVkRenderPassCacheVec& pv = _threadRenderPasses.Get();
     for (size_t i=0; i<pv.size(); i++) {
         HgiVkRenderPassCacheItem* item = pv[i];
         if (_CompareHgiGraphicsEncoderDesc(desc, *item)) {
@@ -173,16 +169,7 @@ HgiVkRenderPassPipelineCache::BeginFrame(uint64_t frame)
     if (_frameStarted) return;
     _frameStarted = true;
 
-    // Change the frame counter. This will let each thread know that they
-    // must re-initializes themselves the next time a thread uses the locals.
     _frame = frame;
-
-    // Ensure the thread_local vectors have enough room for each thread.
-    uint32_t numThreads = HgiVk::GetThreadCount();
-
-    if (_threadRenderPasses.size() != numThreads) {
-        _threadRenderPasses.resize(numThreads);
-    }
 }
 
 void
@@ -203,11 +190,11 @@ HgiVkRenderPassPipelineCache::EndFrame()
     // These dups will eventually be removed from the cache when
     // the cache size limit is reached.
 
-    for (HgiVkRenderPassCacheVec& v : _threadRenderPasses) {
+    _threadRenderPasses.ForEach([&passCache](HgiVkRenderPassCacheVec& v) {
         passCache.insert(passCache.end(), v.begin(), v.end());
         v.clear();
         v.shrink_to_fit();
-    }
+    });
     std::sort(passCache.begin(), passCache.end());
 
     // If we reached the max size of the cache remove the oldest items.
@@ -220,8 +207,6 @@ HgiVkRenderPassPipelineCache::EndFrame()
         }
     }
 
-    // Next frame each thread should acquire a new index into thread_local vecs.
-    _nextThreadLocalIndex.store(0);
     _frameStarted = false;
 }
 
@@ -1,7 +1,6 @@
 #ifndef PXR_IMAGING_HGIVK_RENDERPASS_PIPELINE_CACHE_H
 #define PXR_IMAGING_HGIVK_RENDERPASS_PIPELINE_CACHE_H
 
-#include <atomic>
 #include <vector>
 
 #include "pxr/pxr.h"
@@ -10,6 +9,7 @@
 #include "pxr/imaging/hgi/pipeline.h"
 
 #include "pxr/imaging/hgiVk/api.h"
+#include "pxr/imaging/hgiVk/threadSlots.h"
 
 
 PXR_NAMESPACE_OPEN_SCOPE
@@ -20,7 +20,8 @@ class HgiVkRenderPass;
 
 
 typedef std::vector<struct HgiVkRenderPassCacheItem*> HgiVkRenderPassCacheVec;
-typedef std::vector<HgiVkRenderPassCacheVec> HgiVkRenderPassThreadLocalVec;
+typedef HgiVkThreadSlotArray<HgiVkRenderPassCacheVec>
+    HgiVkRenderPassThreadLocalVec;
 
 typedef std::vector<struct HgiVkPipelineCacheItem*> HgiVkPipelineCacheVec;
 typedef std::vector<HgiVkPipelineCacheVec> HgiVkPipelineThreadLocalVec;
@@ -77,8 +78,6 @@ private:
     uint64_t _frame;
     bool _frameStarted;
 
-    std::atomic<uint16_t> _nextThreadLocalIndex;
-
     HgiVkRenderPassCacheVec _renderPassReadOnlyCache;
     HgiVkRenderPassThreadLocalVec _threadRenderPasses;
 };
@@ -1,9 +1,12 @@
+#include "pxr/imaging/hgiVk/bindlessTextures.h"
 #include "pxr/imaging/hgiVk/buffer.h"
 #include "pxr/imaging/hgiVk/commandBuffer.h"
 #include "pxr/imaging/hgiVk/conversions.h"
 #include "pxr/imaging/hgiVk/device.h"
 #include "pxr/imaging/hgiVk/diagnostic.h"
+#include "pxr/imaging/hgiVk/layoutCache.h"
 #include "pxr/imaging/hgiVk/resourceBindings.h"
+#include "pxr/imaging/hgiVk/sampler.h"
 #include "pxr/imaging/hgiVk/texture.h"
 #include "pxr/imaging/hgiVk/vulkan.h"
 
@@ -18,6 +21,7 @@ HgiVkResourceBindings::HgiVkResourceBindings(
     , _vkDescriptorSetLayout(nullptr)
     , _vkDescriptorSet(nullptr)
     , _vkPipelineLayout(nullptr)
+    , _pushDescriptors(false)
 {
     // initialize the pool sizes for each descriptor type we support
     std::vector<VkDescriptorPoolSize> poolSizes;
@@ -44,8 +48,8 @@ HgiVkResourceBindings::HgiVkResourceBindings(
         VkDescriptorSetLayoutBinding d = {};
         d.binding = t.bindingIndex;
         d.descriptorType = HgiVkConversions::GetDescriptorType(t.resourceType);
-        poolSizes[t.resourceType].descriptorCount++;
         d.descriptorCount = (uint32_t) t.textures.size();
+        poolSizes[t.resourceType].descriptorCount += d.descriptorCount;
         d.stageFlags = HgiVkConversions::GetShaderStages(t.stageUsage);
         d.pImmutableSamplers = nullptr;
         bindings.emplace_back(std::move(d));
@@ -55,104 +59,49 @@ HgiVkResourceBindings::HgiVkResourceBindings(
         VkDescriptorSetLayoutBinding d = {};
         d.binding = b.bindingIndex;
         d.descriptorType = HgiVkConversions::GetDescriptorType(b.resourceType);
-        poolSizes[b.resourceType].descriptorCount++;
         d.descriptorCount = (uint32_t) b.buffers.size();
+        poolSizes[b.resourceType].descriptorCount += d.descriptorCount;
         d.stageFlags = HgiVkConversions::GetShaderStages(b.stageUsage);
         d.pImmutableSamplers = nullptr;
         bindings.emplace_back(std::move(d));
     }
 
-    VkDescriptorSetLayoutCreateInfo setCreateInfo =
-        {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
-    setCreateInfo.bindingCount = (uint32_t) bindings.size();
-    setCreateInfo.pBindings = bindings.data();
-
-    TF_VERIFY(
-        vkCreateDescriptorSetLayout(
-            _device->GetVulkanDevice(),
-            &setCreateInfo,
-            HgiVkAllocator(),
-            &_vkDescriptorSetLayout) == VK_SUCCESS
-    );
-
-    // Debug label
-    if (!_descriptor.debugName.empty()) {
-        std::string debugLabel = "Descriptor Set Layout " + _descriptor.debugName;
-        HgiVkSetDebugName(
-            _device,
-            (uint64_t)_vkDescriptorSetLayout,
-            VK_DEBUG_REPORT_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT_EXT,
-            debugLabel.c_str());
+    // Transient resource bindings push their descriptors into the command
+    // buffer when they are bound, so they need no descriptor set. Without
+    // VK_KHR_push_descriptor, or with more descriptors than a push set may
+    // hold, they use a descriptor set like all other resource bindings.
+    uint32_t descriptorCount = 0;
+    for (VkDescriptorPoolSize const& p : poolSizes) {
+        descriptorCount += p.descriptorCount;
     }
+    _pushDescriptors = desc.transient &&
+        _device->GetDeviceSupportPushDescriptor() &&
+        descriptorCount <= _device->GetMaxPushDescriptors();
+
+    // Resource bindings of the same shape share their layouts, so pipelines
+    // created for one are compatible with the descriptor sets of the others.
+    HgiVkLayoutCache* layoutCache = _device->GetLayoutCache();
+    _vkDescriptorSetLayout = layoutCache->AcquireDescriptorSetLayout(
+        bindings,
+        _pushDescriptors ?
+            VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR : 0);
 
     //
-    // Create the descriptor pool.
+    // Allocate the descriptor set from the device's shared pools.
     //
-    // XXX For now each resource bindings gets its own pool to allocate its
-    // descriptor set from. We can't have a global descriptor pool since we have
-    // multiple threads creating resourceBindings. On top of that, when the
-    // resourceBindings gets destroyed it must de-allocate its descriptor set
-    // in the correct descriptor pool (which is different than command buffers
-    // where the entire pool is reset at the beginning of a new frame).
+    // The set is freed when the resourceBindings is garbage collected, once
+    // the gpu no longer uses it.
     //
-    // If having a descriptor pool per resourceBindings turns out to be too much
-    // overhead (e.g. if many resourceBindings are created/destroyed each frame)
-    // then we can consider an approach similar to thread local command buffers.
-    // We could allocate larger descriptor pools per frame and per thread.
-    //
-
-    for (size_t i=poolSizes.size(); i-- > 0;) {
-        // Remove empty descriptorPoolSize or vulkan validation will complain
-        if (poolSizes[i].descriptorCount == 0) {
-            std::iter_swap(poolSizes.begin() + i, poolSizes.end() - 1);
-            poolSizes.pop_back();
-        }
-    }
-
-    VkDescriptorPoolCreateInfo pool_info = {};
-    pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-    pool_info.maxSets = 1; // Each resourceBinding has own pool -- read above
-    pool_info.poolSizeCount = (uint32_t) poolSizes.size();
-    pool_info.pPoolSizes = poolSizes.data();
-
-    TF_VERIFY(
-        vkCreateDescriptorPool(
-            _device->GetVulkanDevice(),
-            &pool_info,
-            HgiVkAllocator(),
-            &_vkDescriptorPool) == VK_SUCCESS
-    );
 
-    // Debug label
-    if (!_descriptor.debugName.empty()) {
-        std::string debugLabel = "Descriptor Pool " + _descriptor.debugName;
-        HgiVkSetDebugName(
-            _device,
-            (uint64_t)_vkDescriptorPool,
-            VK_DEBUG_REPORT_OBJECT_TYPE_DESCRIPTOR_POOL_EXT,
-            debugLabel.c_str());
+    if (!_pushDescriptors) {
+        _descriptorAllocation = _device->GetDescriptorAllocator()->Allocate(
+            _vkDescriptorSetLayout,
+            poolSizes);
+        _vkDescriptorSet = _descriptorAllocation.set;
     }
 
-    //
-    // Create Descriptor Set
-    //
-    VkDescriptorSetAllocateInfo allocateInfo =
-        {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
-
-    allocateInfo.descriptorPool = _vkDescriptorPool;
-    allocateInfo.descriptorSetCount = 1;
-    allocateInfo.pSetLayouts = &_vkDescriptorSetLayout;
-
-    TF_VERIFY(
-        vkAllocateDescriptorSets(
-            _device->GetVulkanDevice(),
-            &allocateInfo,
-            &_vkDescriptorSet) == VK_SUCCESS
-    );
-
     // Debug label
-    if (!_descriptor.debugName.empty()) {
+    if (_vkDescriptorSet && !_descriptor.debugName.empty()) {
         std::string debugLabel = "Descriptor Set " + _descriptor.debugName;
         HgiVkSetDebugName(
             _device,
@@ -167,7 +116,9 @@ HgiVkResourceBindings::HgiVkResourceBindings(
 
     std::vector<VkWriteDescriptorSet> writeSets;
 
-    // Array-of-textures platform limits:
+    // Array-of-textures platform limits. These also apply with bindless
+    // textures, the texture bindings of set 0 are still written here. Only
+    // the global texture array (set 1) is not limited by them.
     #if defined(__ANDROID__) // Android 9
         #define AF_DESCRIPTOR_CNT_MAX 79u
     #elif defined(__APPLE__) && defined(__MACH__) // macOS 10.14
@@ -182,19 +133,34 @@ HgiVkResourceBindings::HgiVkResourceBindings(
               "Array-of-texture size exceeded: %d",
               AF_DESCRIPTOR_CNT_MAX);
 
+    // Each write set points into _imageInfos, so it must not reallocate.
     _imageInfos.clear();
+    size_t imageInfoCount = 0;
+    for (HgiTextureBindDesc const& texDesc : desc.textures) {
+        imageInfoCount += texDesc.textures.size();
+    }
+    _imageInfos.reserve(imageInfoCount);
 
     for (size_t i=0; i<desc.textures.size(); i++) {
         HgiTextureBindDesc const& texDesc = desc.textures[i];
+        const size_t firstImageInfo = _imageInfos.size();
 
         TF_VERIFY(texDesc.textures.size() < AF_DESCRIPTOR_CNT_MAX,
                   "Array-of-texture size exceeded: %d", AF_DESCRIPTOR_CNT_MAX);
 
-        for (HgiTextureHandle const& texHandle : texDesc.textures) {
-            HgiVkTexture* tex = static_cast<HgiVkTexture*>(texHandle);
+        // Textures without a sampler use their default sampler.
+        TF_VERIFY(texDesc.samplers.empty() ||
+                  texDesc.samplers.size() == texDesc.textures.size(),
+                  "Need one sampler per texture");
+
+        for (size_t j=0; j<texDesc.textures.size(); j++) {
+            HgiVkTexture* tex = static_cast<HgiVkTexture*>(texDesc.textures[j]);
             if (!TF_VERIFY(tex)) continue;
+            HgiVkSampler* sampler = j < texDesc.samplers.size() ?
+                static_cast<HgiVkSampler*>(texDesc.samplers[j]) : nullptr;
             VkDescriptorImageInfo imageInfo;
-            imageInfo.sampler = tex->GetSampler();
+            imageInfo.sampler =
+                sampler ? sampler->GetSampler() : tex->GetSampler();
             imageInfo.imageLayout = tex->GetImageLayout();
             imageInfo.imageView = tex->GetImageView();
             _imageInfos.emplace_back(std::move(imageInfo));
@@ -203,10 +169,11 @@ HgiVkResourceBindings::HgiVkResourceBindings(
         VkWriteDescriptorSet writeSet= {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
         writeSet.dstBinding = texDesc.bindingIndex;
         writeSet.dstArrayElement = 0;
-        writeSet.descriptorCount = (uint32_t) texDesc.textures.size();
+        writeSet.descriptorCount =
+            (uint32_t) (_imageInfos.size() - firstImageInfo);
         writeSet.dstSet = _vkDescriptorSet;
         writeSet.pBufferInfo = nullptr;
-        writeSet.pImageInfo = _imageInfos.data();
+        writeSet.pImageInfo = _imageInfos.data() + firstImageInfo;
         writeSet.pTexelBufferView = nullptr;
         writeSet.descriptorType =
             HgiVkConversions::GetDescriptorType(texDesc.resourceType);
@@ -217,19 +184,27 @@ HgiVkResourceBindings::HgiVkResourceBindings(
     // Buffers
     //
 
+    // Each write set points into _bufferInfos, so it must not reallocate.
     _bufferInfos.clear();
+    size_t bufferInfoCount = 0;
+    for (HgiBufferBindDesc const& bufDesc : desc.buffers) {
+        bufferInfoCount += bufDesc.buffers.size();
+    }
+    _bufferInfos.reserve(bufferInfoCount);
 
     for (size_t i=0; i<desc.buffers.size(); i++) {
         HgiBufferBindDesc const& bufDesc = desc.buffers[i];
+        const size_t firstBufferInfo = _bufferInfos.size();
 
         TF_VERIFY(bufDesc.buffers.size() == bufDesc.offsets.size());
 
-        for (HgiBufferHandle const& bufHandle : bufDesc.buffers) {
-            HgiVkBuffer* buf = static_cast<HgiVkBuffer*>(bufHandle);
+        for (size_t j=0; j<bufDesc.buffers.size(); j++) {
+            HgiVkBuffer* buf = static_cast<HgiVkBuffer*>(bufDesc.buffers[j]);
             if (!TF_VERIFY(buf)) continue;
             VkDescriptorBufferInfo bufferInfo;
             bufferInfo.buffer = buf->GetBuffer();
-            bufferInfo.offset = bufDesc.offsets[i];
+            bufferInfo.offset =
+                j < bufDesc.offsets.size() ? bufDesc.offsets[j] : 0;
             bufferInfo.range = VK_WHOLE_SIZE;
             _bufferInfos.emplace_back(std::move(bufferInfo));
         }
@@ -237,9 +212,10 @@ HgiVkResourceBindings::HgiVkResourceBindings(
         VkWriteDescriptorSet writeSet= {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
         writeSet.dstBinding = bufDesc.bindingIndex;
         writeSet.dstArrayElement = 0;
-        writeSet.descriptorCount = (uint32_t) bufDesc.buffers.size();
+        writeSet.descriptorCount =
+            (uint32_t) (_bufferInfos.size() - firstBufferInfo);
         writeSet.dstSet = _vkDescriptorSet;
-        writeSet.pBufferInfo = _bufferInfos.data();
+        writeSet.pBufferInfo = _bufferInfos.data() + firstBufferInfo;
         writeSet.pImageInfo = nullptr;
         writeSet.pTexelBufferView = nullptr;
         writeSet.descriptorType =
@@ -247,15 +223,21 @@ HgiVkResourceBindings::HgiVkResourceBindings(
         writeSets.emplace_back(std::move(writeSet));
     }
 
-    // Note: this update happens immediate. It is not recorded via a command.
-    // This means we should only do this if the descriptorSet is not currently
-    // in use on GPU.
-    vkUpdateDescriptorSets(
-        _device->GetVulkanDevice(),
-        (uint32_t) writeSets.size(),
-        writeSets.data(),
-        0,        // copy count
-        nullptr); // copy_desc
+    // Push descriptors are written when the resources are bound.
+    // The write sets keep pointing into _imageInfos and _bufferInfos.
+    if (_pushDescriptors) {
+        _pushWriteSets = std::move(writeSets);
+    } else {
+        // Note: this update happens immediate. It is not recorded via a
+        // command. This means we should only do this if the descriptorSet is
+        // not currently in use on GPU.
+        vkUpdateDescriptorSets(
+            _device->GetVulkanDevice(),
+            (uint32_t) writeSets.size(),
+            writeSets.data(),
+            0,        // copy count
+            nullptr); // copy_desc
+    }
 
     //
     // Pipeline layout contains descriptor set layouts and push constant ranges.
@@ -273,59 +255,28 @@ HgiVkResourceBindings::HgiVkResourceBindings(
         pcRanges.emplace_back(std::move(pushConstantRange));
     }
 
-    VkPipelineLayoutCreateInfo pipeLayCreateInfo =
-        {VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
-    pipeLayCreateInfo.pushConstantRangeCount = (uint32_t) pcRanges.size();
-    pipeLayCreateInfo.pPushConstantRanges = pcRanges.data();
-    pipeLayCreateInfo.setLayoutCount = 1;
-    pipeLayCreateInfo.pSetLayouts = &_vkDescriptorSetLayout;
-
-    TF_VERIFY(
-        vkCreatePipelineLayout(
-            _device->GetVulkanDevice(),
-            &pipeLayCreateInfo,
-            HgiVkAllocator(),
-            &_vkPipelineLayout) == VK_SUCCESS
-    );
-
-    // Debug label
-    if (!_descriptor.debugName.empty()) {
-        std::string debugLabel = "Pipeline Layout " + _descriptor.debugName;
-        HgiVkSetDebugName(
-            _device,
-            (uint64_t)_vkPipelineLayout,
-            VK_DEBUG_REPORT_OBJECT_TYPE_PIPELINE_LAYOUT_EXT,
-            debugLabel.c_str());
+    // In bindless mode every pipeline layout also has the global texture
+    // array, so any shader can index it.
+    std::vector<VkDescriptorSetLayout> setLayouts = {_vkDescriptorSetLayout};
+    if (HgiVkBindlessTextures* bindless = _device->GetBindlessTextures()) {
+        TF_VERIFY(setLayouts.size() == HgiVkBindlessTextures::SetIndex);
+        setLayouts.push_back(bindless->GetDescriptorSetLayout());
     }
+
+    _vkPipelineLayout = layoutCache->AcquirePipelineLayout(
+        setLayouts,
+        pcRanges);
 }
 
 HgiVkResourceBindings::~HgiVkResourceBindings()
 {
-    vkDestroyDescriptorSetLayout(
-        _device->GetVulkanDevice(),
-        _vkDescriptorSetLayout,
-        HgiVkAllocator());
-
-    vkDestroyPipelineLayout(
-        _device->GetVulkanDevice(),
-        _vkPipelineLayout,
-        HgiVkAllocator());
+    if (!_pushDescriptors) {
+        _device->GetDescriptorAllocator()->Free(_descriptorAllocation);
+    }
 
-    // Since we have one pool for this resourceBindings we can reset the pool
-    // instead of freeing the descriptorSet.
-    //
-    // if (_vkDescriptorSet) {
-    //     vkFreeDescriptorSets(
-    //         _device->GetVulkanDevice(),
-    //         _vkDescriptorPool,
-    //         1,
-    //         &_vkDescriptorSet);
-    // }
-    //
-    vkDestroyDescriptorPool(
-        _device->GetVulkanDevice(),
-        _vkDescriptorPool,
-        HgiVkAllocator());
+    HgiVkLayoutCache* layoutCache = _device->GetLayoutCache();
+    layoutCache->ReleasePipelineLayout(_vkPipelineLayout);
+    layoutCache->ReleaseDescriptorSetLayout(_vkDescriptorSetLayout);
 }
 
 HgiBufferBindDescVector const&
@@ -359,13 +310,43 @@ HgiVkResourceBindings::BindResources(HgiVkCommandBuffer* cb)
     // are no longer compatible with the layout for the new pipeline.
     // This essentially unbinds the old resources.
 
+    VkCommandBuffer vkCommandBuffer = cb->GetCommandBufferForRecoding();
+
+    // Transient resource bindings record their descriptors into the command
+    // buffer as set 0.
+    uint32_t firstSet = 0;
+    if (_pushDescriptors) {
+        _device->CmdPushDescriptorSet(
+            vkCommandBuffer,
+            bindPoint,
+            _vkPipelineLayout,
+            0, // set
+            (uint32_t) _pushWriteSets.size(),
+            _pushWriteSets.data());
+        firstSet = 1;
+    }
+
+    // In bindless mode the global texture array is bound in the same call.
+    VkDescriptorSet sets[2];
+    uint32_t setCount = 0;
+    if (!_pushDescriptors) {
+        sets[setCount++] = _vkDescriptorSet;
+    }
+    if (HgiVkBindlessTextures* bindless = _device->GetBindlessTextures()) {
+        sets[setCount++] = bindless->GetDescriptorSet();
+    }
+
+    if (setCount == 0) {
+        return;
+    }
+
     vkCmdBindDescriptorSets(
-        cb->GetCommandBufferForRecoding(),
+        vkCommandBuffer,
         bindPoint,
         _vkPipelineLayout,
-        0, // firstSet
-        1, // descriptorSetCount -- strict limits, see maxBoundDescriptorSets
-        &_vkDescriptorSet,
+        firstSet,
+        setCount, // strict limits, see maxBoundDescriptorSets
+        sets,
         0, // dynamicOffset
         nullptr);
 }
@@ -382,6 +363,12 @@ HgiVkResourceBindings::GetDescriptorSet() const
     return _vkDescriptorSet;
 }
 
+bool
+HgiVkResourceBindings::IsPushDescriptor() const
+{
+    return _pushDescriptors;
+}
+
 VkDescriptorImageInfoVector const&
 HgiVkResourceBindings::GetImageInfos() const
 {
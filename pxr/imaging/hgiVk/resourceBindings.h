@@ -7,6 +7,7 @@
 
 #include "pxr/imaging/hgi/resourceBindings.h"
 #include "pxr/imaging/hgiVk/api.h"
+#include "pxr/imaging/hgiVk/descriptorAllocator.h"
 #include "pxr/imaging/hgiVk/vulkan.h"
 
 
@@ -31,8 +32,18 @@ typedef std::vector<VkDescriptorBufferInfo> VkDescriptorBufferInfoVector;
 /// This does not affect how many sets you can make, but you likely want to
 /// group resources together so you don't have to bind more than ~4 sets.
 ///
-/// You also want to avoid re-creating resourceBindings frequently as our
-/// design is to have one descriptor pool per resourceBindings.
+/// The descriptor set is allocated from the device's descriptor allocator
+/// (see HgiVkDescriptorAllocator). The descriptor set layout and pipeline
+/// layout are shared with other resource bindings of the same shape
+/// (see HgiVkLayoutCache).
+///
+/// Transient resource bindings (HgiResourceBindingsDesc::transient) push
+/// their descriptors into the command buffer with vkCmdPushDescriptorSetKHR
+/// instead, when the device supports VK_KHR_push_descriptor.
+///
+/// With bindless textures the global texture array is set 1 of every
+/// pipeline layout and is bound together with the descriptor set
+/// (see HgiVkBindlessTextures).
 ///
 class HgiVkResourceBindings final : public HgiResourceBindings {
 public:
@@ -64,10 +75,16 @@ public:
     HGIVK_API
     VkPipelineLayout GetPipelineLayout() const;
 
-    /// Returns the descriptor set
+    /// Returns the descriptor set.
+    /// Returns nullptr if the descriptors are pushed (see IsPushDescriptor).
     HGIVK_API
     VkDescriptorSet GetDescriptorSet() const;
 
+    /// Returns true if the descriptors are pushed into the command buffer
+    /// when the resources are bound, instead of using a descriptor set.
+    HGIVK_API
+    bool IsPushDescriptor() const;
+
     /// Returns the vector of imageInfo's used to make this resourceBindings.
     HGIVK_API
     VkDescriptorImageInfoVector const& GetImageInfos() const;
@@ -88,10 +105,14 @@ private:
     VkDescriptorImageInfoVector _imageInfos;
     VkDescriptorBufferInfoVector _bufferInfos;
 
-    VkDescriptorPool _vkDescriptorPool;
+    HgiVkDescriptorAllocator::Allocation _descriptorAllocation;
     VkDescriptorSetLayout _vkDescriptorSetLayout;
     VkDescriptorSet _vkDescriptorSet;
     VkPipelineLayout _vkPipelineLayout;
+
+    // Transient resource bindings with VK_KHR_push_descriptor.
+    bool _pushDescriptors;
+    std::vector<VkWriteDescriptorSet> _pushWriteSets;
 };
 
 
@@ -0,0 +1,129 @@
+#include <algorithm>
+
+#include "pxr/base/tf/diagnostic.h"
+#include "pxr/base/work/loops.h"
+
+#include "pxr/imaging/hgiVk/buffer.h"
+#include "pxr/imaging/hgiVk/resourceCommandQueue.h"
+#include "pxr/imaging/hgiVk/texture.h"
+
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+
+static void
+_RecordResourceCommand(
+    HgiVkCommandBuffer* cb,
+    HgiVkResourceCommand const& cmd)
+{
+    switch(cmd.type) {
+        default: TF_CODING_ERROR("Unknown resource command"); break;
+
+        case HgiVkResourceCommandTypeCopyBuffer: {
+            if (TF_VERIFY(cmd.buffer && cmd.staging.buffer)) {
+                cmd.buffer->CopyBufferFrom(cb, cmd.staging);
+            }
+            break;
+        }
+        case HgiVkResourceCommandTypeInitTexture: {
+            if (TF_VERIFY(cmd.texture)) {
+                cmd.texture->RecordDeferredInitialization(
+                    cb, cmd.staging.buffer ? &cmd.staging : nullptr);
+            }
+            break;
+        }
+    }
+}
+
+HgiVkResourceCommandQueue::HgiVkResourceCommandQueue()
+    : _head(nullptr)
+{
+}
+
+HgiVkResourceCommandQueue::~HgiVkResourceCommandQueue()
+{
+    // Commands that were never recorded are dropped. The resources they
+    // point to are owned (and destroyed) elsewhere.
+    for (HgiVkResourceCommand* cmd : _PopAll()) {
+        delete cmd;
+    }
+}
+
+void
+HgiVkResourceCommandQueue::Push(HgiVkResourceCommand const& cmd)
+{
+    /* MULTI-THREAD CALL*/
+
+    HgiVkResourceCommand* node = new HgiVkResourceCommand(cmd);
+    node->next = _head.load(std::memory_order_relaxed);
+
+    while (!_head.compare_exchange_weak(
+            node->next,
+            node,
+            std::memory_order_release,
+            std::memory_order_relaxed)) {
+        // node->next was updated with the current head, try again.
+    }
+}
+
+bool
+HgiVkResourceCommandQueue::IsEmpty() const
+{
+    return _head.load(std::memory_order_acquire) == nullptr;
+}
+
+void
+HgiVkResourceCommandQueue::Record(
+    HgiVkCommandBufferVector const& commandBuffers)
+{
+    if (!TF_VERIFY(!commandBuffers.empty())) return;
+
+    HgiVkResourceCommandVector cmds = _PopAll();
+    if (cmds.empty()) return;
+
+    // Don't spin up more workers than we have commands.
+    const size_t numWorkers = std::min(commandBuffers.size(), cmds.size());
+    const size_t rangeSize = (cmds.size() + numWorkers - 1) / numWorkers;
+
+    // Each worker records one contiguous range into its own command buffer.
+    // Each resource appears in exactly one command, so the order between the
+    // ranges does not matter.
+    WorkParallelForN(
+        numWorkers,
+        [&cmds, &commandBuffers, rangeSize](size_t begin, size_t end) {
+            for (size_t w=begin; w<end; w++) {
+                HgiVkCommandBuffer* cb = commandBuffers[w];
+                size_t first = w * rangeSize;
+                size_t last = std::min(first + rangeSize, cmds.size());
+                for (size_t i=first; i<last; i++) {
+                    _RecordResourceCommand(cb, *cmds[i]);
+                }
+            }
+        },
+        1);
+
+    for (HgiVkResourceCommand* cmd : cmds) {
+        delete cmd;
+    }
+}
+
+HgiVkResourceCommandVector
+HgiVkResourceCommandQueue::_PopAll()
+{
+    HgiVkResourceCommandVector cmds;
+
+    HgiVkResourceCommand* node =
+        _head.exchange(nullptr, std::memory_order_acquire);
+
+    while (node) {
+        cmds.push_back(node);
+        node = node->next;
+    }
+
+    // The list is newest-first, record in the order the commands were pushed.
+    std::reverse(cmds.begin(), cmds.end());
+    return cmds;
+}
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
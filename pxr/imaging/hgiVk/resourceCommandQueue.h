@@ -0,0 +1,102 @@
+#ifndef PXR_IMAGING_HGIVK_RESOURCE_COMMAND_QUEUE_H
+#define PXR_IMAGING_HGIVK_RESOURCE_COMMAND_QUEUE_H
+
+#include <atomic>
+#include <vector>
+
+#include "pxr/pxr.h"
+#include "pxr/imaging/hgiVk/api.h"
+#include "pxr/imaging/hgiVk/commandBuffer.h"
+#include "pxr/imaging/hgiVk/stagingRing.h"
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+class HgiVkBuffer;
+class HgiVkTexture;
+
+
+enum HgiVkResourceCommandType {
+    HgiVkResourceCommandTypeUnknown = 0,
+    HgiVkResourceCommandTypeCopyBuffer = 1,
+    HgiVkResourceCommandTypeInitTexture = 2
+};
+
+/// \struct HgiVkResourceCommand
+///
+/// A lightweight record of a resource command that is recorded into a command
+/// buffer at a later time (deferred resource recording).
+///
+/// <ul>
+/// <li>CopyBuffer:
+///   Copies `staging` into `buffer`.</li>
+/// <li>InitTexture:
+///   Transitions `texture` into its default layout and copies `staging`
+///   into the texture if its buffer is not nullptr.</li>
+/// </ul>
+///
+struct HgiVkResourceCommand {
+    HgiVkResourceCommandType type = HgiVkResourceCommandTypeUnknown;
+    union {
+        HgiVkBuffer* buffer = nullptr;
+        HgiVkTexture* texture;
+    };
+    HgiVkStagingRegion staging;
+
+    // Intrusive link used by HgiVkResourceCommandQueue.
+    HgiVkResourceCommand* next = nullptr;
+};
+
+typedef std::vector<HgiVkResourceCommand*> HgiVkResourceCommandVector;
+
+
+/// \class HgiVkResourceCommandQueue
+///
+/// Lock-free multi-producer, single-consumer queue of resource commands.
+/// Hydra's sync threads push commands and the thread that ends the frame (or
+/// explicitly flushes) records them with a bounded number of workers.
+///
+class HgiVkResourceCommandQueue final
+{
+public:
+    HGIVK_API
+    HgiVkResourceCommandQueue();
+
+    HGIVK_API
+    ~HgiVkResourceCommandQueue();
+
+    /// Adds a copy of the command to the queue.
+    /// Thread safety: May be called from any number of threads at once.
+    HGIVK_API
+    void Push(HgiVkResourceCommand const& cmd);
+
+    /// Returns true if there are no commands in the queue.
+    HGIVK_API
+    bool IsEmpty() const;
+
+    /// Removes all commands from the queue and records them into the provided
+    /// command buffers. The commands are split into one contiguous range per
+    /// command buffer and each range is recorded by its own worker, so the
+    /// number of command buffers determines the recording width.
+    /// Thread safety: Only one thread may record at a time. Each command
+    /// buffer must have its own command pool.
+    HGIVK_API
+    void Record(HgiVkCommandBufferVector const& commandBuffers);
+
+private:
+    HgiVkResourceCommandQueue & operator=(
+        const HgiVkResourceCommandQueue&) = delete;
+    HgiVkResourceCommandQueue(const HgiVkResourceCommandQueue&) = delete;
+
+    // Removes all commands from the queue, in the order they were pushed.
+    HgiVkResourceCommandVector _PopAll();
+
+private:
+    // Newest command first. Producers push with a CAS on the head, the
+    // consumer takes the entire list with one exchange.
+    std::atomic<HgiVkResourceCommand*> _head;
+};
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+#endif
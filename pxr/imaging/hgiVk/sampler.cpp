@@ -0,0 +1,35 @@
+#include "pxr/imaging/hgiVk/device.h"
+#include "pxr/imaging/hgiVk/sampler.h"
+#include "pxr/imaging/hgiVk/samplerCache.h"
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+HgiVkSampler::HgiVkSampler(
+    HgiVkDevice* device,
+    HgiSamplerDesc const& desc)
+    : HgiSampler(desc)
+    , _device(device)
+    , _descriptor(desc)
+    , _vkSampler(nullptr)
+{
+    _vkSampler = device->GetSamplerCache()->AcquireSampler(desc);
+}
+
+HgiVkSampler::~HgiVkSampler()
+{
+    _device->GetSamplerCache()->ReleaseSampler(_vkSampler);
+}
+
+VkSampler
+HgiVkSampler::GetSampler() const
+{
+    return _vkSampler;
+}
+
+HgiSamplerDesc const&
+HgiVkSampler::GetDescriptor() const
+{
+    return _descriptor;
+}
+
+PXR_NAMESPACE_CLOSE_SCOPE
@@ -0,0 +1,55 @@
+#ifndef PXR_IMAGING_HGIVK_SAMPLER_H
+#define PXR_IMAGING_HGIVK_SAMPLER_H
+
+#include "pxr/pxr.h"
+#include "pxr/imaging/hgi/sampler.h"
+
+#include "pxr/imaging/hgiVk/api.h"
+#include "pxr/imaging/hgiVk/vulkan.h"
+
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+class HgiVkDevice;
+
+
+/// \class HgiVkSampler
+///
+/// Vulkan implementation of HgiSampler.
+///
+/// The VkSampler is owned by the device's sampler cache and shared with all
+/// samplers and textures of the same sampler state.
+///
+class HgiVkSampler final : public HgiSampler {
+public:
+    HGIVK_API
+    HgiVkSampler(
+        HgiVkDevice* device,
+        HgiSamplerDesc const& desc);
+
+    HGIVK_API
+    virtual ~HgiVkSampler();
+
+    /// Returns the vulkan sampler.
+    HGIVK_API
+    VkSampler GetSampler() const;
+
+    /// Returns the descriptor of the sampler.
+    HGIVK_API
+    HgiSamplerDesc const& GetDescriptor() const;
+
+private:
+    HgiVkSampler() = delete;
+    HgiVkSampler & operator=(const HgiVkSampler&) = delete;
+    HgiVkSampler(const HgiVkSampler&) = delete;
+
+private:
+    HgiVkDevice* _device;
+    HgiSamplerDesc _descriptor;
+    VkSampler _vkSampler;
+};
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+#endif
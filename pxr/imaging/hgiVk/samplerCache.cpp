@@ -0,0 +1,181 @@
+#include <algorithm>
+
+#include "pxr/base/arch/hash.h"
+#include "pxr/base/tf/diagnostic.h"
+
+#include "pxr/imaging/hgiVk/conversions.h"
+#include "pxr/imaging/hgiVk/device.h"
+#include "pxr/imaging/hgiVk/diagnostic.h"
+#include "pxr/imaging/hgiVk/samplerCache.h"
+
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+bool
+HgiVkSamplerCache::_Key::operator==(_Key const& other) const
+{
+    return magFilter == other.magFilter &&
+           minFilter == other.minFilter &&
+           mipmapMode == other.mipmapMode &&
+           addressModeU == other.addressModeU &&
+           addressModeV == other.addressModeV &&
+           addressModeW == other.addressModeW &&
+           maxAnisotropy == other.maxAnisotropy;
+}
+
+size_t
+HgiVkSamplerCache::_KeyHash::operator()(_Key const& key) const
+{
+    // All members are 4 bytes, so the key has no padding.
+    return (size_t) ArchHash64((const char*) &key, sizeof(key));
+}
+
+HgiVkSamplerCache::HgiVkSamplerCache(HgiVkDevice* device)
+    : _device(device)
+{
+}
+
+HgiVkSamplerCache::~HgiVkSamplerCache()
+{
+    // Textures and samplers the application did not destroy still hold
+    // references. The device is idle, so their samplers can be destroyed.
+    for (auto const& it : _samplers) {
+        vkDestroySampler(
+            _device->GetVulkanDevice(),
+            it.second.sampler,
+            HgiVkAllocator());
+    }
+}
+
+VkSampler
+HgiVkSamplerCache::AcquireSampler(HgiSamplerDesc const& desc)
+{
+    /* MULTI-THREAD CALL*/
+
+    _Key key = _GetKey(desc);
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto it = _samplers.find(key);
+    if (it != _samplers.end()) {
+        it->second.refCount++;
+        return it->second.sampler;
+    }
+
+    VkSamplerCreateInfo sampler = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+    sampler.magFilter = key.magFilter;
+    sampler.minFilter = key.minFilter;
+    sampler.mipmapMode = key.mipmapMode;
+    sampler.addressModeU = key.addressModeU;
+    sampler.addressModeV = key.addressModeV;
+    sampler.addressModeW = key.addressModeW;
+    sampler.compareOp = VK_COMPARE_OP_NEVER;
+    sampler.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+    sampler.mipLodBias = 0.0f;
+    sampler.minLod = 0.0f;
+    sampler.maxLod = VK_LOD_CLAMP_NONE; // The image view limits the mips
+    sampler.maxAnisotropy = key.maxAnisotropy;
+    sampler.anisotropyEnable = key.maxAnisotropy > 1.0f ? VK_TRUE : VK_FALSE;
+
+    _Entry entry;
+    entry.refCount = 1;
+    entry.sampler = nullptr;
+
+    TF_VERIFY(
+        vkCreateSampler(
+            _device->GetVulkanDevice(),
+            &sampler,
+            HgiVkAllocator(),
+            &entry.sampler) == VK_SUCCESS
+    );
+
+    // Debug label
+    if (!desc.debugName.empty()) {
+        std::string debugLabel = "Sampler " + desc.debugName;
+        HgiVkSetDebugName(
+            _device,
+            (uint64_t)entry.sampler,
+            VK_DEBUG_REPORT_OBJECT_TYPE_SAMPLER_EXT,
+            debugLabel.c_str());
+    }
+
+    uint32_t maxSamplers = _device->GetVulkanPhysicalDeviceProperties().
+        limits.maxSamplerAllocationCount;
+    if (_samplers.size() == maxSamplers) {
+        TF_WARN("Exceeding maxSamplerAllocationCount (%u)", maxSamplers);
+    }
+
+    _samplers.emplace(key, entry);
+    _keys.emplace(entry.sampler, key);
+
+    return entry.sampler;
+}
+
+void
+HgiVkSamplerCache::ReleaseSampler(VkSampler sampler)
+{
+    /* MULTI-THREAD CALL*/
+
+    if (!sampler) return;
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto keyIt = _keys.find(sampler);
+    if (!TF_VERIFY(keyIt != _keys.end(), "Sampler not in cache")) return;
+
+    auto it = _samplers.find(keyIt->second);
+    if (--it->second.refCount > 0) return;
+
+    vkDestroySampler(
+        _device->GetVulkanDevice(),
+        sampler,
+        HgiVkAllocator());
+
+    _samplers.erase(it);
+    _keys.erase(keyIt);
+}
+
+size_t
+HgiVkSamplerCache::GetSamplerCount()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _samplers.size();
+}
+
+HgiVkSamplerCache::_Key
+HgiVkSamplerCache::_GetKey(HgiSamplerDesc const& desc) const
+{
+    _Key key;
+    key.magFilter = HgiVkConversions::GetSamplerFilter(desc.magFilter);
+    key.minFilter = HgiVkConversions::GetSamplerFilter(desc.minFilter);
+    key.mipmapMode = HgiVkConversions::GetMipFilter(desc.mipFilter);
+    key.addressModeU = HgiVkConversions::GetSamplerAddressMode(desc.addressModeU);
+    key.addressModeV = HgiVkConversions::GetSamplerAddressMode(desc.addressModeV);
+    key.addressModeW = HgiVkConversions::GetSamplerAddressMode(desc.addressModeW);
+
+    // Without the extension the closest mode mirrors every other repetition.
+    if (!_device->GetDeviceSupportSamplerMirrorClampToEdge()) {
+        VkSamplerAddressMode* modes[] = {
+            &key.addressModeU, &key.addressModeV, &key.addressModeW};
+        for (VkSamplerAddressMode* mode : modes) {
+            if (*mode == VK_SAMPLER_ADDRESS_MODE_MIRROR_CLAMP_TO_EDGE) {
+                *mode = VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
+            }
+        }
+    }
+
+    // Descriptors that ask for more anisotropy than the device supports
+    // share the sampler of the device limit.
+    float maxAnisotropy = 1.0f;
+    if (_device->GetVulkanPhysicalDeviceFeatures().samplerAnisotropy) {
+        maxAnisotropy = _device->GetVulkanPhysicalDeviceProperties().
+            limits.maxSamplerAnisotropy;
+    }
+    key.maxAnisotropy = std::min(std::max(desc.maxAnisotropy, 1.0f),
+                                 maxAnisotropy);
+
+    return key;
+}
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
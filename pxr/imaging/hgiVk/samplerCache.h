@@ -0,0 +1,94 @@
+#ifndef PXR_IMAGING_HGIVK_SAMPLER_CACHE_H
+#define PXR_IMAGING_HGIVK_SAMPLER_CACHE_H
+
+#include <mutex>
+#include <unordered_map>
+
+#include "pxr/pxr.h"
+#include "pxr/imaging/hgi/sampler.h"
+#include "pxr/imaging/hgiVk/api.h"
+#include "pxr/imaging/hgiVk/vulkan.h"
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+class HgiVkDevice;
+
+
+/// \class HgiVkSamplerCache
+///
+/// Shares one VkSampler between all users of the same sampler state.
+///
+/// Scenes with many textures would otherwise create one VkSampler per
+/// texture and run into maxSamplerAllocationCount. Sampler states are hashed
+/// after they were adjusted to the device (e.g. anisotropy limit), so
+/// descriptors that end up the same share one sampler. Samplers are
+/// refcounted and destroyed when their last user releases them.
+///
+class HgiVkSamplerCache final
+{
+public:
+    HGIVK_API
+    HgiVkSamplerCache(HgiVkDevice* device);
+
+    HGIVK_API
+    ~HgiVkSamplerCache();
+
+    /// Returns the sampler for `desc` and adds a reference to it.
+    /// The debug name of `desc` is only used if a new sampler is created.
+    /// Thread safety: May be called from any thread.
+    HGIVK_API
+    VkSampler AcquireSampler(HgiSamplerDesc const& desc);
+
+    /// Removes a reference from a sampler returned by AcquireSampler.
+    /// The gpu must no longer use the sampler if this is the last reference,
+    /// i.e. callers release their samplers during garbage collection.
+    /// Thread safety: May be called from any thread.
+    HGIVK_API
+    void ReleaseSampler(VkSampler sampler);
+
+    /// Returns the number of unique samplers.
+    HGIVK_API
+    size_t GetSamplerCount();
+
+private:
+    HgiVkSamplerCache() = delete;
+    HgiVkSamplerCache & operator=(const HgiVkSamplerCache&) = delete;
+    HgiVkSamplerCache(const HgiVkSamplerCache&) = delete;
+
+    // Sampler state after it was adjusted to the device.
+    struct _Key {
+        VkFilter magFilter;
+        VkFilter minFilter;
+        VkSamplerMipmapMode mipmapMode;
+        VkSamplerAddressMode addressModeU;
+        VkSamplerAddressMode addressModeV;
+        VkSamplerAddressMode addressModeW;
+        float maxAnisotropy;
+
+        bool operator==(_Key const& other) const;
+    };
+
+    struct _KeyHash {
+        size_t operator()(_Key const& key) const;
+    };
+
+    struct _Entry {
+        VkSampler sampler;
+        uint32_t refCount;
+    };
+
+    // Returns the state of a vulkan sampler for `desc`.
+    _Key _GetKey(HgiSamplerDesc const& desc) const;
+
+private:
+    HgiVkDevice* _device;
+
+    std::mutex _lock;
+    std::unordered_map<_Key, _Entry, _KeyHash> _samplers;
+    std::unordered_map<VkSampler, _Key> _keys;
+};
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+#endif
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <cstring>
+
+#include "pxr/base/tf/diagnostic.h"
+#include "pxr/base/tf/envSetting.h"
+
+#include "pxr/imaging/hgiVk/buffer.h"
+#include "pxr/imaging/hgiVk/device.h"
+#include "pxr/imaging/hgiVk/diagnostic.h"
+#include "pxr/imaging/hgiVk/object.h"
+#include "pxr/imaging/hgiVk/stagingRing.h"
+
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+TF_DEFINE_ENV_SETTING(HGIVK_STAGING_RING_SIZE, 16,
+    "Size in MB of the per-frame HgiVk staging ring (0 disables the ring)");
+
+
+HgiVkStagingRing::HgiVkStagingRing(HgiVkDevice* device)
+    : _device(device)
+    , _capacity(0)
+    , _vkBuffer(nullptr)
+    , _vmaAllocation(nullptr)
+    , _dataMapped(nullptr)
+    , _head(0)
+{
+    const int sizeMB = TfGetEnvSetting(HGIVK_STAGING_RING_SIZE);
+    if (sizeMB <= 0) return;
+
+    VkBufferCreateInfo bufCreateInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    bufCreateInfo.size = (VkDeviceSize) sizeMB * 1024 * 1024;
+    bufCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    bufCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    // CPU_ONLY memory is HOST_COHERENT, so writes need no flush.
+    // (See HgiVkBuffer for staging buffers)
+    VmaAllocationCreateInfo allocInfo = {};
+    allocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+
+    if (!TF_VERIFY(
+        vmaCreateBuffer(
+            _device->GetVulkanMemoryAllocator(),
+            &bufCreateInfo,
+            &allocInfo,
+            &_vkBuffer,
+            &_vmaAllocation,
+            nullptr) == VK_SUCCESS)) {
+        return;
+    }
+
+    // Persistently map the ring. It is only unmapped on destruction.
+    void* dataMapped = nullptr;
+    TF_VERIFY(
+        vmaMapMemory(
+            _device->GetVulkanMemoryAllocator(),
+            _vmaAllocation,
+            &dataMapped) == VK_SUCCESS
+    );
+
+    _dataMapped = (char*) dataMapped;
+    _capacity = _dataMapped ? bufCreateInfo.size : 0;
+}
+
+HgiVkStagingRing::~HgiVkStagingRing()
+{
+    if (!_vkBuffer) return;
+
+    if (_dataMapped) {
+        vmaUnmapMemory(
+            _device->GetVulkanMemoryAllocator(),
+            _vmaAllocation);
+    }
+
+    vmaDestroyBuffer(
+        _device->GetVulkanMemoryAllocator(),
+        _vkBuffer,
+        _vmaAllocation);
+}
+
+void
+HgiVkStagingRing::Reset()
+{
+    _head.store(0, std::memory_order_relaxed);
+}
+
+HgiVkStagingRegion
+HgiVkStagingRing::Upload(
+    const void* data,
+    size_t byteSize,
+    uint32_t alignment)
+{
+    /* MULTI-THREAD CALL*/
+
+    // Large uploads (e.g. textures) would quickly use up the ring and force
+    // all small uploads after them into dedicated buffers.
+    VkDeviceSize offset = 0;
+    if (byteSize > _capacity / 4 ||
+        !_Allocate(byteSize, std::max(alignment, 1u), &offset)) {
+        return _UploadDedicated(data, byteSize);
+    }
+
+    memcpy(_dataMapped + offset, data, byteSize);
+
+    HgiVkStagingRegion region;
+    region.buffer = _vkBuffer;
+    region.offset = offset;
+    region.size = byteSize;
+    return region;
+}
+
+void
+HgiVkStagingRing::SetDebugName(std::string const& name)
+{
+    if (!_vkBuffer) return;
+
+    std::string debugLabel = "Staging Ring " + name;
+    HgiVkSetDebugName(
+        _device,
+        (uint64_t)_vkBuffer,
+        VK_DEBUG_REPORT_OBJECT_TYPE_BUFFER_EXT,
+        debugLabel.c_str());
+}
+
+bool
+HgiVkStagingRing::_Allocate(
+    VkDeviceSize byteSize,
+    VkDeviceSize alignment,
+    VkDeviceSize* offset)
+{
+    /* MULTI-THREAD CALL*/
+
+    // Alignment may be a texel size (e.g. 12 bytes), so we can't use a mask.
+    VkDeviceSize head = _head.load(std::memory_order_relaxed);
+    VkDeviceSize begin;
+    do {
+        begin = ((head + alignment - 1) / alignment) * alignment;
+        if (begin + byteSize > _capacity) {
+            return false;
+        }
+    } while (!_head.compare_exchange_weak(
+                head,
+                begin + byteSize,
+                std::memory_order_relaxed,
+                std::memory_order_relaxed));
+
+    *offset = begin;
+    return true;
+}
+
+HgiVkStagingRegion
+HgiVkStagingRing::_UploadDedicated(const void* data, size_t byteSize)
+{
+    /* MULTI-THREAD CALL*/
+
+    HgiBufferDesc stagingDesc;
+    stagingDesc.usage = HgiBufferUsageTransferSrc;
+    stagingDesc.byteSize = byteSize;
+    stagingDesc.data = data;
+
+    HgiVkBuffer* stagingBuffer = new HgiVkBuffer(_device, stagingDesc);
+
+    HgiVkStagingRegion region;
+    region.buffer = stagingBuffer->GetBuffer();
+    region.offset = 0;
+    region.size = byteSize;
+
+    // Schedule destruction of staging buffer 3 frames from now.
+    // (Deferred resource commands are recorded before then, during EndFrame)
+    HgiVkObject stagingObject;
+    stagingObject.buffer = stagingBuffer;
+    stagingObject.type = HgiVkObjectTypeBuffer;
+    _device->DestroyObject(stagingObject);
+
+    return region;
+}
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
@@ -0,0 +1,97 @@
+#ifndef PXR_IMAGING_HGIVK_STAGING_RING_H
+#define PXR_IMAGING_HGIVK_STAGING_RING_H
+
+#include <atomic>
+#include <string>
+
+#include "pxr/pxr.h"
+#include "pxr/imaging/hgiVk/api.h"
+#include "pxr/imaging/hgiVk/vulkan.h"
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+class HgiVkDevice;
+
+
+/// \struct HgiVkStagingRegion
+///
+/// A range of host visible memory that holds data to be copied to the gpu.
+/// The range is either part of a frame's staging ring, or an entire dedicated
+/// staging buffer.
+///
+struct HgiVkStagingRegion {
+    VkBuffer buffer = nullptr;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+};
+
+
+/// \class HgiVkStagingRing
+///
+/// Linear staging allocator of one frame.
+/// The ring owns one persistently mapped buffer that is sub-allocated with an
+/// atomic bump pointer, so many small uploads do not each create (and later
+/// destroy) their own staging buffer. All memory is reclaimed at once when the
+/// frame is re-used, after the gpu has completed the frame.
+/// Uploads that do not fit (HGIVK_STAGING_RING_SIZE) get a dedicated staging
+/// buffer that is destroyed via the frame's garbage collector.
+///
+class HgiVkStagingRing final
+{
+public:
+    HGIVK_API
+    HgiVkStagingRing(HgiVkDevice* device);
+
+    HGIVK_API
+    ~HgiVkStagingRing();
+
+    /// Makes the entire ring available again.
+    /// Must only be called once the gpu has completed the frame that last
+    /// used the ring.
+    HGIVK_API
+    void Reset();
+
+    /// Copies `byteSize` bytes of `data` into staging memory and returns the
+    /// region that holds it. The region offset is a multiple of `alignment`.
+    /// The region is valid until the frame is re-used.
+    /// Thread safety: Lock-free for uploads that fit in the ring.
+    HGIVK_API
+    HgiVkStagingRegion Upload(
+        const void* data,
+        size_t byteSize,
+        uint32_t alignment);
+
+    /// Set debug name the vulkan objects held by this ring will have.
+    HGIVK_API
+    void SetDebugName(std::string const& name);
+
+private:
+    HgiVkStagingRing() = delete;
+    HgiVkStagingRing & operator=(const HgiVkStagingRing&) = delete;
+    HgiVkStagingRing(const HgiVkStagingRing&) = delete;
+
+    // Reserves `byteSize` bytes in the ring. Returns false if the ring is full.
+    bool _Allocate(
+        VkDeviceSize byteSize,
+        VkDeviceSize alignment,
+        VkDeviceSize* offset);
+
+    // Creates a dedicated staging buffer for uploads that do not fit.
+    HgiVkStagingRegion _UploadDedicated(const void* data, size_t byteSize);
+
+private:
+    HgiVkDevice* _device;
+
+    VkDeviceSize _capacity;
+    VkBuffer _vkBuffer;
+    VmaAllocation _vmaAllocation;
+    char* _dataMapped;
+
+    // Offset of the first free byte in the ring.
+    std::atomic<VkDeviceSize> _head;
+};
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+#endif
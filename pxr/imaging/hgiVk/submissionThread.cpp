@@ -0,0 +1,381 @@
+#include "pxr/base/tf/diagnostic.h"
+#include "pxr/base/tf/stopwatch.h"
+
+#include "pxr/imaging/hgiVk/submissionThread.h"
+
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+
+// Appends `count` elements to `storage` and returns a pointer to the first
+// appended element. The storage must have been reserved up front, so that
+// pointers returned earlier remain valid.
+template <typename T>
+static const T*
+_Append(std::vector<T>* storage, const T* data, uint32_t count)
+{
+    if (!data || count == 0) return nullptr;
+    TF_VERIFY(storage->size() + count <= storage->capacity());
+    storage->insert(storage->end(), data, data + count);
+    return storage->data() + storage->size() - count;
+}
+
+static void
+_CopySubmitInfos(
+    std::vector<VkSubmitInfo> const& submitInfos,
+    HgiVkSubmission* submission)
+{
+    // Reserve all storage first. The copied infos point into it.
+    size_t numCommandBuffers = 0;
+    size_t numSemaphores = 0;
+    size_t numWaitStages = 0;
+    size_t numValues = 0;
+    size_t numTimelineInfos = 0;
+
+    for (VkSubmitInfo const& info : submitInfos) {
+        numCommandBuffers += info.commandBufferCount;
+        numSemaphores += info.waitSemaphoreCount + info.signalSemaphoreCount;
+        numWaitStages += info.waitSemaphoreCount;
+
+        const VkBaseInStructure* ext = (const VkBaseInStructure*) info.pNext;
+        for (; ext; ext = ext->pNext) {
+            if (ext->sType ==
+                VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR) {
+                const VkTimelineSemaphoreSubmitInfoKHR* t =
+                    (const VkTimelineSemaphoreSubmitInfoKHR*) ext;
+                numValues += t->waitSemaphoreValueCount +
+                             t->signalSemaphoreValueCount;
+                numTimelineInfos++;
+            }
+        }
+    }
+
+    submission->submitInfos.reserve(submitInfos.size());
+    submission->commandBuffers.reserve(numCommandBuffers);
+    submission->semaphores.reserve(numSemaphores);
+    submission->waitStages.reserve(numWaitStages);
+    submission->semaphoreValues.reserve(numValues);
+    submission->timelineInfos.reserve(numTimelineInfos);
+
+    for (VkSubmitInfo const& info : submitInfos) {
+        VkSubmitInfo copy = info;
+        copy.pNext = nullptr;
+
+        copy.pCommandBuffers = _Append(
+            &submission->commandBuffers,
+            info.pCommandBuffers,
+            info.commandBufferCount);
+
+        copy.pWaitSemaphores = _Append(
+            &submission->semaphores,
+            info.pWaitSemaphores,
+            info.waitSemaphoreCount);
+
+        copy.pWaitDstStageMask = _Append(
+            &submission->waitStages,
+            info.pWaitDstStageMask,
+            info.waitSemaphoreCount);
+
+        copy.pSignalSemaphores = _Append(
+            &submission->semaphores,
+            info.pSignalSemaphores,
+            info.signalSemaphoreCount);
+
+        const VkBaseInStructure* ext = (const VkBaseInStructure*) info.pNext;
+        for (; ext; ext = ext->pNext) {
+            if (ext->sType !=
+                VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR) {
+                TF_CODING_ERROR("Unsupported pNext in VkSubmitInfo");
+                continue;
+            }
+
+            VkTimelineSemaphoreSubmitInfoKHR t =
+                *((const VkTimelineSemaphoreSubmitInfoKHR*) ext);
+            t.pNext = nullptr;
+
+            t.pWaitSemaphoreValues = _Append(
+                &submission->semaphoreValues,
+                t.pWaitSemaphoreValues,
+                t.waitSemaphoreValueCount);
+
+            t.pSignalSemaphoreValues = _Append(
+                &submission->semaphoreValues,
+                t.pSignalSemaphoreValues,
+                t.signalSemaphoreValueCount);
+
+            submission->timelineInfos.push_back(t);
+            copy.pNext = &submission->timelineInfos.back();
+        }
+
+        submission->submitInfos.push_back(copy);
+    }
+}
+
+static void
+_CopyPresentInfo(
+    VkPresentInfoKHR const& presentInfo,
+    HgiVkSubmission* submission)
+{
+    if (presentInfo.pNext) {
+        TF_CODING_ERROR("Unsupported pNext in VkPresentInfoKHR");
+    }
+
+    submission->semaphores.reserve(presentInfo.waitSemaphoreCount);
+    submission->swapchains.reserve(presentInfo.swapchainCount);
+    submission->imageIndices.reserve(presentInfo.swapchainCount);
+
+    VkPresentInfoKHR copy = presentInfo;
+    copy.pNext = nullptr;
+    copy.pResults = nullptr; // Results are checked by the thread.
+
+    copy.pWaitSemaphores = _Append(
+        &submission->semaphores,
+        presentInfo.pWaitSemaphores,
+        presentInfo.waitSemaphoreCount);
+
+    copy.pSwapchains = _Append(
+        &submission->swapchains,
+        presentInfo.pSwapchains,
+        presentInfo.swapchainCount);
+
+    copy.pImageIndices = _Append(
+        &submission->imageIndices,
+        presentInfo.pImageIndices,
+        presentInfo.swapchainCount);
+
+    submission->isPresent = true;
+    submission->presentInfo = copy;
+}
+
+static float
+_QueueSubmit(
+    VkQueue queue,
+    std::mutex* queueLock,
+    uint32_t submitCount,
+    const VkSubmitInfo* submitInfos,
+    VkFence fence)
+{
+    // The vkQueue must be externally synchronized.
+    std::lock_guard<std::mutex> lock(*queueLock);
+
+    TfStopwatch watch;
+    watch.Start();
+
+    // Commit provided command buffers to queue.
+    // Record and submission order does not guarantee execution order.
+    // Vulkan docs: "Execution Model" and "Implicit Synchronization Guarantees".
+    TF_VERIFY(
+        vkQueueSubmit(
+            queue,
+            submitCount,
+            submitInfos,
+            fence) == VK_SUCCESS
+    );
+
+    watch.Stop();
+    return (float) watch.GetNanoseconds();
+}
+
+static float
+_QueuePresent(
+    VkQueue queue,
+    std::mutex* queueLock,
+    VkPresentInfoKHR const& presentInfo)
+{
+    std::lock_guard<std::mutex> lock(*queueLock);
+
+    TfStopwatch watch;
+    watch.Start();
+
+    VkResult res = vkQueuePresentKHR(queue, &presentInfo);
+
+    watch.Stop();
+
+    // If swapchain is out of date here it is caught by the next acquire.
+    TF_VERIFY(res == VK_SUCCESS ||
+              res == VK_ERROR_OUT_OF_DATE_KHR ||
+              res == VK_SUBOPTIMAL_KHR);
+
+    return (float) watch.GetNanoseconds();
+}
+
+static HgiVkSubmitFuture
+_MakeReadyFuture(float nanoSeconds)
+{
+    std::promise<float> promise;
+    promise.set_value(nanoSeconds);
+    return promise.get_future().share();
+}
+
+HgiVkSubmissionThread::HgiVkSubmissionThread()
+    : _head(nullptr)
+    , _stop(false)
+{
+    _thread = std::thread(&HgiVkSubmissionThread::_Run, this);
+}
+
+HgiVkSubmissionThread::~HgiVkSubmissionThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(_wakeLock);
+        _stop = true;
+    }
+    _wakeCondition.notify_one();
+    _thread.join();
+}
+
+HgiVkSubmitFuture
+HgiVkSubmissionThread::Submit(
+    VkQueue queue,
+    std::mutex* queueLock,
+    std::vector<VkSubmitInfo> const& submitInfos,
+    VkFence fence)
+{
+    /* MULTI-THREAD CALL*/
+
+    HgiVkSubmission* submission = new HgiVkSubmission();
+    submission->queue = queue;
+    submission->queueLock = queueLock;
+    submission->fence = fence;
+    _CopySubmitInfos(submitInfos, submission);
+
+    return _Push(submission);
+}
+
+HgiVkSubmitFuture
+HgiVkSubmissionThread::Present(
+    VkQueue queue,
+    std::mutex* queueLock,
+    VkPresentInfoKHR const& presentInfo)
+{
+    /* MULTI-THREAD CALL*/
+
+    HgiVkSubmission* submission = new HgiVkSubmission();
+    submission->queue = queue;
+    submission->queueLock = queueLock;
+    _CopyPresentInfo(presentInfo, submission);
+
+    return _Push(submission);
+}
+
+void
+HgiVkSubmissionThread::Flush()
+{
+    /* MULTI-THREAD CALL*/
+
+    // An empty submission (without queue) is only a marker. Submissions are
+    // executed in order, so once it is done all earlier ones are too.
+    _Push(new HgiVkSubmission()).wait();
+}
+
+HgiVkSubmitFuture
+HgiVkSubmissionThread::SubmitImmediate(
+    VkQueue queue,
+    std::mutex* queueLock,
+    std::vector<VkSubmitInfo> const& submitInfos,
+    VkFence fence)
+{
+    /* MULTI-THREAD CALL*/
+
+    return _MakeReadyFuture(
+        _QueueSubmit(
+            queue,
+            queueLock,
+            (uint32_t) submitInfos.size(),
+            submitInfos.data(),
+            fence));
+}
+
+HgiVkSubmitFuture
+HgiVkSubmissionThread::PresentImmediate(
+    VkQueue queue,
+    std::mutex* queueLock,
+    VkPresentInfoKHR const& presentInfo)
+{
+    /* MULTI-THREAD CALL*/
+
+    return _MakeReadyFuture(_QueuePresent(queue, queueLock, presentInfo));
+}
+
+HgiVkSubmitFuture
+HgiVkSubmissionThread::_Push(HgiVkSubmission* submission)
+{
+    /* MULTI-THREAD CALL*/
+
+    HgiVkSubmitFuture future = submission->promise.get_future().share();
+
+    submission->next = _head.load(std::memory_order_relaxed);
+    while (!_head.compare_exchange_weak(
+            submission->next,
+            submission,
+            std::memory_order_release,
+            std::memory_order_relaxed)) {
+        // submission->next was updated with the current head, try again.
+    }
+
+    // Briefly take the lock before notifying. The thread checks for work while
+    // holding the lock, so it either sees the new submission or is already
+    // waiting and receives the notification.
+    {
+        std::lock_guard<std::mutex> lock(_wakeLock);
+    }
+    _wakeCondition.notify_one();
+
+    return future;
+}
+
+void
+HgiVkSubmissionThread::_Run()
+{
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_wakeLock);
+            _wakeCondition.wait(lock, [this] {
+                return _stop || _head.load(std::memory_order_acquire);
+            });
+
+            // Drain the queue before stopping.
+            if (_stop && !_head.load(std::memory_order_acquire)) {
+                return;
+            }
+        }
+
+        HgiVkSubmission* node =
+            _head.exchange(nullptr, std::memory_order_acquire);
+
+        // The list is newest-first, reverse it to submit in queued order.
+        HgiVkSubmission* ordered = nullptr;
+        while (node) {
+            HgiVkSubmission* next = node->next;
+            node->next = ordered;
+            ordered = node;
+            node = next;
+        }
+
+        while (ordered) {
+            HgiVkSubmission* next = ordered->next;
+
+            float nanoSeconds = 0.0f;
+            if (ordered->queue && ordered->isPresent) {
+                nanoSeconds = _QueuePresent(
+                    ordered->queue,
+                    ordered->queueLock,
+                    ordered->presentInfo);
+            } else if (ordered->queue) {
+                nanoSeconds = _QueueSubmit(
+                    ordered->queue,
+                    ordered->queueLock,
+                    (uint32_t) ordered->submitInfos.size(),
+                    ordered->submitInfos.data(),
+                    ordered->fence);
+            }
+
+            ordered->promise.set_value(nanoSeconds);
+            delete ordered;
+            ordered = next;
+        }
+    }
+}
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
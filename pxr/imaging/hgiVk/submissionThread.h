@@ -0,0 +1,145 @@
+#ifndef PXR_IMAGING_HGIVK_SUBMISSION_THREAD_H
+#define PXR_IMAGING_HGIVK_SUBMISSION_THREAD_H
+
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "pxr/pxr.h"
+#include "pxr/imaging/hgiVk/api.h"
+#include "pxr/imaging/hgiVk/vulkan.h"
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+
+/// Handle to a queue submission (or presentation).
+/// The future becomes ready once the vulkan call has returned. Its value is
+/// the cpu time, in nanoseconds, the vulkan call took.
+/// Note that a ready future only means the work was handed to the queue, not
+/// that the gpu has finished it.
+typedef std::shared_future<float> HgiVkSubmitFuture;
+
+
+/// \struct HgiVkSubmission
+///
+/// A queue submission (or presentation) that is executed by the submission
+/// thread. All arrays the vulkan infos point to are owned by the submission,
+/// so the caller may release its own data as soon as it was queued.
+///
+struct HgiVkSubmission {
+    VkQueue queue = nullptr;
+    std::mutex* queueLock = nullptr;
+    VkFence fence = nullptr;
+
+    // Submit infos, or a present info when isPresent is true.
+    bool isPresent = false;
+    std::vector<VkSubmitInfo> submitInfos;
+    VkPresentInfoKHR presentInfo = {VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
+
+    // Storage the infos above point into.
+    std::vector<VkCommandBuffer> commandBuffers;
+    std::vector<VkSemaphore> semaphores;
+    std::vector<VkPipelineStageFlags> waitStages;
+    std::vector<uint64_t> semaphoreValues;
+    std::vector<VkTimelineSemaphoreSubmitInfoKHR> timelineInfos;
+    std::vector<VkSwapchainKHR> swapchains;
+    std::vector<uint32_t> imageIndices;
+
+    std::promise<float> promise;
+
+    // Intrusive link used by HgiVkSubmissionThread.
+    HgiVkSubmission* next = nullptr;
+};
+
+
+/// \class HgiVkSubmissionThread
+///
+/// Thread that owns the submission to the vulkan queues of a device.
+/// On some drivers vkQueueSubmit takes milliseconds for large frames. By
+/// moving it to this thread the render thread only pays for copying the
+/// submit infos into a lock-free queue. Submissions are executed in the order
+/// they were queued, across all queues, so binary semaphores are still
+/// signaled before they are waited on.
+///
+class HgiVkSubmissionThread final
+{
+public:
+    HGIVK_API
+    HgiVkSubmissionThread();
+
+    /// Executes all queued submissions and then stops the thread.
+    HGIVK_API
+    ~HgiVkSubmissionThread();
+
+    /// Queues a copy of the submit infos for submission to `queue`.
+    /// `queueLock` is held while submitting, since the queue may also be used
+    /// outside of this thread. `fence` is optional and can be nullptr.
+    /// Thread safety: Lock-free, may be called from any thread.
+    HGIVK_API
+    HgiVkSubmitFuture Submit(
+        VkQueue queue,
+        std::mutex* queueLock,
+        std::vector<VkSubmitInfo> const& submitInfos,
+        VkFence fence);
+
+    /// Queues a copy of the present info for presentation on `queue`.
+    /// Thread safety: Lock-free, may be called from any thread.
+    HGIVK_API
+    HgiVkSubmitFuture Present(
+        VkQueue queue,
+        std::mutex* queueLock,
+        VkPresentInfoKHR const& presentInfo);
+
+    /// Blocks until all submissions that were queued before this call have
+    /// been handed to their queue.
+    HGIVK_API
+    void Flush();
+
+    /// Submits on the calling thread and returns a ready future.
+    /// Used by the device when the submission thread is disabled.
+    HGIVK_API
+    static HgiVkSubmitFuture SubmitImmediate(
+        VkQueue queue,
+        std::mutex* queueLock,
+        std::vector<VkSubmitInfo> const& submitInfos,
+        VkFence fence);
+
+    /// Presents on the calling thread and returns a ready future.
+    /// Used by the device when the submission thread is disabled.
+    HGIVK_API
+    static HgiVkSubmitFuture PresentImmediate(
+        VkQueue queue,
+        std::mutex* queueLock,
+        VkPresentInfoKHR const& presentInfo);
+
+private:
+    HgiVkSubmissionThread & operator=(const HgiVkSubmissionThread&) = delete;
+    HgiVkSubmissionThread(const HgiVkSubmissionThread&) = delete;
+
+    // Adds the submission to the queue and wakes up the thread.
+    HgiVkSubmitFuture _Push(HgiVkSubmission* submission);
+
+    // Thread main loop.
+    void _Run();
+
+private:
+    // Newest submission first. Producers push with a CAS on the head, the
+    // thread takes the entire list with one exchange.
+    std::atomic<HgiVkSubmission*> _head;
+
+    // The lock and condition are only used to put the thread to sleep when
+    // there is no work. They are not held while submitting.
+    std::mutex _wakeLock;
+    std::condition_variable _wakeCondition;
+    bool _stop;
+
+    std::thread _thread;
+};
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+#endif
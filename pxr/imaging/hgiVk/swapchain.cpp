@@ -81,9 +81,8 @@ _DestroyVulkanSwapchain(
     VkSemaphore vkReleaseSemaphore,
     VkImageViewVector& vkImageViews)
 {
-    TF_VERIFY(
-        vkDeviceWaitIdle(device->GetVulkanDevice()) == VK_SUCCESS
-    );
+    // Also waits for presentations still queued on the submission thread.
+    device->WaitForIdle();
 
     for (uint32_t i = 0; i < vkImageViews.size(); i++) {
         vkDestroyImageView(
@@ -210,13 +209,9 @@ HgiVkSwapchain::PresentSwapchain()
     submitInfo.signalSemaphoreCount = 1;
     submitInfo.pSignalSemaphores = &_vkReleaseSemaphore;
 
-    TF_VERIFY(
-        vkQueueSubmit(
-            _device->GetVulkanDeviceQueue(),
-            1,
-            &submitInfo,
-            VK_NULL_HANDLE) == VK_SUCCESS
-    );
+    // Submit via the device so the submission is ordered after the frame's
+    // command buffers (See HGIVK_SUBMISSION_THREAD).
+    _device->SubmitToQueue({submitInfo}, VK_NULL_HANDLE);
 
     uint32_t imageIndex = _nextImageIndex;
 
@@ -227,14 +222,8 @@ HgiVkSwapchain::PresentSwapchain()
     vkPresentInfo.pSwapchains = &_vkSwapchain;
     vkPresentInfo.pImageIndices = &imageIndex;
 
-    VkResult res = vkQueuePresentKHR(
-        _device->GetVulkanDeviceQueue(),
-        &vkPresentInfo);
-
     // If swapchain is out of date here we will catch it next BeginSwapchain.
-    TF_VERIFY(res == VK_SUCCESS ||
-              res == VK_ERROR_OUT_OF_DATE_KHR ||
-              res == VK_SUBOPTIMAL_KHR);
+    _presentFuture = _device->PresentToQueue(vkPresentInfo);
 }
 
 uint32_t
@@ -549,6 +538,12 @@ HgiVkSwapchain::_ResizeSwapchainIfNecessary()
 VkResult
 HgiVkSwapchain::_AcquireNextImage()
 {
+    // The acquire semaphore may only be signaled again once the previous
+    // submission that waits on it has been handed to the queue.
+    if (_presentFuture.valid()) {
+        _presentFuture.wait();
+    }
+
     return vkAcquireNextImageKHR(
         _device->GetVulkanDevice(),
         _vkSwapchain,
@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "pxr/imaging/hgiVk/api.h"
+#include "pxr/imaging/hgiVk/submissionThread.h"
 #include "pxr/imaging/hgiVk/surface.h"
 #include "pxr/imaging/hgiVk/vulkan.h"
 
@@ -96,6 +97,9 @@ private:
     VkSemaphore _vkAcquireSemaphore;
     VkSemaphore _vkReleaseSemaphore;
     VkImageViewVector _vkImageViews;
+
+    // Presentation of the previous image (See HGIVK_SUBMISSION_THREAD).
+    HgiVkSubmitFuture _presentFuture;
 };
 
 typedef HgiVkSwapchain* HgiVkSwapchainHandle;
@@ -1,12 +1,33 @@
+#include <algorithm>
+
+#include "pxr/imaging/hgiVk/bindlessTextures.h"
 #include "pxr/imaging/hgiVk/device.h"
 #include "pxr/imaging/hgiVk/diagnostic.h"
 #include "pxr/imaging/hgiVk/commandBuffer.h"
 #include "pxr/imaging/hgiVk/conversions.h"
-#include "pxr/imaging/hgiVk/renderPass.h"
+#include "pxr/imaging/hgiVk/mipGenerator.h"
+#include "pxr/imaging/hgiVk/samplerCache.h"
 #include "pxr/imaging/hgiVk/texture.h"
 
 PXR_NAMESPACE_OPEN_SCOPE
 
+// Accesses that must be made available by the next barrier.
+static const VkAccessFlags _writeAccess =
+    VK_ACCESS_SHADER_WRITE_BIT |
+    VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+    VK_ACCESS_TRANSFER_WRITE_BIT |
+    VK_ACCESS_HOST_WRITE_BIT |
+    VK_ACCESS_MEMORY_WRITE_BIT;
+
+static bool
+_IsSameState(HgiVkImageState const& a, HgiVkImageState const& b)
+{
+    return a.layout == b.layout &&
+           a.access == b.access &&
+           a.stages == b.stages;
+}
+
 static bool
 _CheckFormatSupport(
     VkPhysicalDevice pDevice,
@@ -25,20 +46,17 @@ HgiVkTexture::HgiVkTexture(
     : HgiTexture(desc)
     , _device(device)
     , _descriptor(desc)
+    , _mipGeneration(_MipGenerationNone)
     , _vkImage(nullptr)
     , _vmaImageAllocation(nullptr)
+    , _bindlessIndex(HgiVkBindlessTextures::InvalidIndex)
+    , _isConcurrent(false)
+    , _tracksState(true)
 {
-    TF_VERIFY(device && cb);
-
-    VkPhysicalDeviceProperties vkDeviceProps =
-        device->GetVulkanPhysicalDeviceProperties();
-
-    VkPhysicalDeviceFeatures vkDeviceFeatures =
-        device->GetVulkanPhysicalDeviceFeatures();
+    TF_VERIFY(device);
 
     GfVec3i const& dimensions = desc.dimensions;
     bool isDepthBuffer = desc.usage & HgiTextureUsageBitsDepthTarget;
-    bool supportAnisotropy = vkDeviceFeatures.samplerAnisotropy;
 
     //
     // Gather image create info
@@ -65,10 +83,27 @@ HgiVkTexture::HgiVkTexture(
         (uint32_t) dimensions[2]};
 
     imageCreateInfo.usage = HgiVkConversions::GetTextureUsage(desc.usage);
+
+    // Textures that shaders access may be read or written by compute shaders
+    // on the async compute queue of another queue family. Like storage
+    // buffers (see HgiVkBuffer) we share them between all queue families
+    // instead of transferring ownership back and forth each frame.
+    std::vector<uint32_t> queueFamilies = device->GetVulkanQueueFamilyIndices();
+    bool shaderAccess = desc.usage &
+        (HgiTextureUsageBitsShaderRead | HgiTextureUsageBitsShaderWrite);
+    if (shaderAccess &&
+        device->GetVulkanComputeQueueFamilyIndex() !=
+            device->GetVulkanDeviceQueueFamilyIndex()) {
+        imageCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        imageCreateInfo.queueFamilyIndexCount = (uint32_t)queueFamilies.size();
+        imageCreateInfo.pQueueFamilyIndices = queueFamilies.data();
+    }
+    _isConcurrent =
+        imageCreateInfo.sharingMode == VK_SHARING_MODE_CONCURRENT;
+
     VkFormatFeatureFlags formatValidationFlags =
         HgiVkConversions::GetFormatFeature(desc.usage);
 
-
     if (!_CheckFormatSupport(
             device->GetVulkanPhysicalDevice(),
             imageCreateInfo.format,
@@ -76,6 +111,43 @@ HgiVkTexture::HgiVkTexture(
         TF_CODING_ERROR("Image format not supported on device");
     };
 
+    // Mips are preferably generated with a linear filtered blit. Formats that
+    // cannot be blitted are downsampled by a compute shader instead.
+    // Depth textures can not be filtered by either.
+    if (desc.generateMips && desc.mipLevels > 1) {
+        if (!isDepthBuffer && _CheckFormatSupport(
+                device->GetVulkanPhysicalDevice(),
+                imageCreateInfo.format,
+                VK_FORMAT_FEATURE_BLIT_SRC_BIT |
+                VK_FORMAT_FEATURE_BLIT_DST_BIT |
+                VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)) {
+            _mipGeneration = _MipGenerationBlit;
+            imageCreateInfo.usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                     VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        } else if (!isDepthBuffer &&
+                   imageCreateInfo.imageType == VK_IMAGE_TYPE_2D &&
+                   device->GetMipGenerator()->IsFormatSupported(desc.format) &&
+                   _CheckFormatSupport(
+                        device->GetVulkanPhysicalDevice(),
+                        imageCreateInfo.format,
+                        VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |
+                        VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT)) {
+            _mipGeneration = _MipGenerationCompute;
+            imageCreateInfo.usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                                     VK_IMAGE_USAGE_SAMPLED_BIT |
+                                     VK_IMAGE_USAGE_STORAGE_BIT;
+        }
+
+        // The pixel data only holds the first mip. Without a way to generate
+        // the others they would stay undefined, so the image gets one mip.
+        if (_mipGeneration == _MipGenerationNone) {
+            TF_CODING_ERROR("Cannot generate mips for texture %s, format %d",
+                desc.debugName.c_str(), desc.format);
+            _descriptor.mipLevels = 1;
+            imageCreateInfo.mipLevels = 1;
+        }
+    }
+
     //
     // Create image with memory allocated and bound.
     //
@@ -83,6 +155,14 @@ HgiVkTexture::HgiVkTexture(
     // Equivalent to: vkCreateImage, vkAllocateMemory, vkBindImageMemory
     VmaAllocationCreateInfo allocInfo = {};
     allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+    // Transient attachments are never loaded or stored, so tiled gpus can
+    // keep them in tile memory and never allocate their memory.
+    if ((desc.usage & HgiTextureUsageBitsTransient) &&
+        device->GetDeviceSupportLazilyAllocatedMemory()) {
+        allocInfo.usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+    }
+
     TF_VERIFY(
         vmaCreateImage(
             device->GetVulkanMemoryAllocator(),
@@ -104,49 +184,17 @@ HgiVkTexture::HgiVkTexture(
     }
 
     //
-    // Create a texture sampler
+    // Acquire the default sampler
     //
 
     // In Vulkan textures are accessed by samplers.
     // This separates all the sampling information from the texture data.
-    // This means you could have multiple sampler objects for the same texture
-    // with different settings
-    // Note: Similar to the samplers available with OpenGL 3.3+
-    // XXX Hgi currently provides no sampler information so we guess.
-
-    VkSamplerCreateInfo sampler = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
-    sampler.magFilter = VK_FILTER_LINEAR;
-    sampler.minFilter = VK_FILTER_LINEAR;
-    sampler.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    sampler.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    sampler.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    sampler.compareOp = VK_COMPARE_OP_NEVER;
-    sampler.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
-    sampler.mipLodBias = 0.0f;
-    sampler.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-    sampler.minLod = 0.0f;
-    sampler.maxLod = (float) desc.mipLevels;
-    sampler.maxAnisotropy = supportAnisotropy ?
-                            vkDeviceProps.limits.maxSamplerAnisotropy : 1.0f;
-    sampler.anisotropyEnable = supportAnisotropy ? VK_TRUE : VK_FALSE;
-
-    TF_VERIFY(
-        vkCreateSampler(
-            device->GetVulkanDevice(),
-            &sampler,
-            HgiVkAllocator(),
-            &_vkDescriptor.sampler) == VK_SUCCESS
-    );
-
-    // Debug label
-    if (!_descriptor.debugName.empty()) {
-        std::string debugLabel = "Sampler " + _descriptor.debugName;
-        HgiVkSetDebugName(
-            _device,
-            (uint64_t)_vkDescriptor.sampler,
-            VK_DEBUG_REPORT_OBJECT_TYPE_SAMPLER_EXT,
-            debugLabel.c_str());
-    }
+    // Textures that are bound without a sampler (see HgiTextureBindDesc)
+    // use the default sampler state, which all textures share via the
+    // device's sampler cache.
+    HgiSamplerDesc samplerDesc;
+    _vkDescriptor.sampler = device->GetSamplerCache()->AcquireSampler(
+        samplerDesc);
 
     //
     // Create image view
@@ -179,11 +227,12 @@ HgiVkTexture::HgiVkTexture(
     view.subresourceRange.baseArrayLayer = 0;
     view.subresourceRange.layerCount = desc.layerCount;
 
-    if (imageCreateInfo.tiling != VK_IMAGE_TILING_OPTIMAL && desc.mipLevels>1) {
+    if (imageCreateInfo.tiling != VK_IMAGE_TILING_OPTIMAL &&
+        _descriptor.mipLevels > 1) {
         TF_WARN("linear tiled images usually do not support mips");
     }
 
-    view.subresourceRange.levelCount = desc.mipLevels;
+    view.subresourceRange.levelCount = _descriptor.mipLevels;
 
     view.image = _vkImage;
 
@@ -209,33 +258,48 @@ HgiVkTexture::HgiVkTexture(
     // Transition image
     //
 
-    _vkDescriptor.imageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-
 // todo Storage images should use VK_IMAGE_LAYOUT_GENERAL
 
-    VkImageLayout newLayout = isDepthBuffer ?
-        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL :
-        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-    if (imageCreateInfo.usage & VK_IMAGE_USAGE_SAMPLED_BIT) {
-        newLayout = isDepthBuffer ?
-            VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL :
-            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    }
+    // The layout never changes. The current layout is tracked per subresource.
+    _vkDescriptor.imageLayout = _GetDefaultImageLayout();
 
-    // XXX Optimization potential: Most textures are not read in the
-    // vertex stage, so we could use VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT.
-    // However keep in mind the depth buffer can also be used in
-    // VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT.
-    // For now we are conservative and use VERTEX_SHADER.
+    //
+    // Register in the global texture array (bindless textures)
+    //
 
-    // Transition image to SHADER_READ as our default state
-    TransitionImageBarrier(
-        cb,
-        this,
-        newLayout, // transition tex to this layout
-        HgiVkRenderPass::GetDefaultDstAccessMask(), // shader read access
-        VK_PIPELINE_STAGE_TRANSFER_BIT,             // producer stage
-        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT);       // consumer stage
+    // Shaders sample the texture in its default layout, so the slot is
+    // written once. Depth textures are not sampled through the array, since
+    // their view has both the depth and stencil aspect.
+    HgiVkBindlessTextures* bindless = device->GetBindlessTextures();
+    if (bindless && !isDepthBuffer &&
+        (desc.usage & HgiTextureUsageBitsShaderRead)) {
+        _bindlessIndex = bindless->RegisterTexture(
+            _vkDescriptor.imageView,
+            _vkDescriptor.sampler,
+            _vkDescriptor.imageLayout);
+    }
+
+    if (cb) {
+        // The image starts out UNDEFINED and without prior accesses.
+        cb->TrackTexture(
+            this,
+            GetDefaultStates(),
+            HgiVkImageStateVector(
+                _descriptor.mipLevels * _descriptor.layerCount));
+
+        // Transition image from UNDEFINED to our default state
+        HgiVkImageState defaultState = _GetDefaultState();
+        TransitionImageBarrier(
+            cb,
+            defaultState.layout,  // transition tex to this layout
+            defaultState.access,  // type of access
+            defaultState.stages); // consumer stage
+    } else {
+        // Deferred recording: The transition (and pixel upload) is recorded
+        // later via RecordDeferredInitialization, but those commands are
+        // submitted before any draw commands of this frame. So command
+        // buffers can start from the default state right away.
+    }
 
     // Don't hold onto pixel data ptr locally. HgiTextureDesc states that:
     // "The application may alter or free this memory as soon as the constructor
@@ -250,9 +314,13 @@ HgiVkTexture::HgiVkTexture(
     : HgiTexture(desc)
     , _device(device)
     , _descriptor(desc)
+    , _mipGeneration(_MipGenerationNone)
     , _vkDescriptor(vkDesc)
     , _vkImage(nullptr)
     , _vmaImageAllocation(nullptr)
+    , _bindlessIndex(HgiVkBindlessTextures::InvalidIndex)
+    , _isConcurrent(false)
+    , _tracksState(false)
 {
     // This constructor directly initialized the vulkan resources (_vkImage).
     // This is useful for images that have their lifetime externally managed.
@@ -270,15 +338,16 @@ HgiVkTexture::~HgiVkTexture()
         return;
     }
 
+    if (_bindlessIndex != HgiVkBindlessTextures::InvalidIndex) {
+        _device->GetBindlessTextures()->UnregisterTexture(_bindlessIndex);
+    }
+
     vkDestroyImageView(
         _device->GetVulkanDevice(),
         _vkDescriptor.imageView,
         HgiVkAllocator());
 
-    vkDestroySampler(
-        _device->GetVulkanDevice(),
-        _vkDescriptor.sampler,
-        HgiVkAllocator());
+    _device->GetSamplerCache()->ReleaseSampler(_vkDescriptor.sampler);
 
     vmaDestroyImage(
         _device->GetVulkanMemoryAllocator(),
@@ -304,6 +373,32 @@ HgiVkTexture::GetImageLayout() const
     return _vkDescriptor.imageLayout;
 }
 
+HgiVkImageState
+HgiVkTexture::GetSubresourceState(
+    HgiVkCommandBuffer* cb,
+    uint32_t mipLevel,
+    uint32_t layer)
+{
+    if (!_tracksState) return HgiVkImageState();
+
+    HgiVkTrackedTexture const* tracked = cb->FindTrackedTexture(this);
+    if (!tracked) return _GetDefaultState();
+
+    size_t index = layer * _descriptor.mipLevels + mipLevel;
+    if (!TF_VERIFY(index < tracked->states.size())) return HgiVkImageState();
+    return tracked->states[index];
+}
+
+HgiVkImageStateVector
+HgiVkTexture::GetDefaultStates() const
+{
+    if (!_tracksState) return HgiVkImageStateVector();
+
+    return HgiVkImageStateVector(
+        _descriptor.mipLevels * _descriptor.layerCount,
+        _GetDefaultState());
+}
+
 VkSampler
 HgiVkTexture::GetSampler() const
 {
@@ -316,10 +411,365 @@ HgiVkTexture::GetDescriptor() const
     return _descriptor;
 }
 
+uint32_t
+HgiVkTexture::GetBindlessIndex() const
+{
+    return _bindlessIndex;
+}
+
 void
 HgiVkTexture::CopyTextureFrom(
     HgiVkCommandBuffer* cb,
-    HgiVkBuffer const& src)
+    HgiVkStagingRegion const& src)
+{
+    //
+    // Image memory barriers for the texture image
+    //
+
+    // All mips are overwritten, so the current contents can be discarded.
+    InvalidateContents(cb);
+
+    // Transition image so we can copy into it
+    TransitionImageBarrier(
+        cb,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, // Transition tex to this layout
+        VK_ACCESS_TRANSFER_WRITE_BIT,         // Write access to image
+        VK_PIPELINE_STAGE_TRANSFER_BIT);      // consumer stage
+
+    // Copy pixels (all mip levels) from staging buffer to gpu image
+    _RecordCopyFromBuffer(cb, src);
+
+    if (_mipGeneration != _MipGenerationNone) {
+        // Generating the mips ends in the default state.
+        _RecordGenerateMips(cb, &_GetStates(cb));
+        return;
+    }
+
+    // Return to the default state when copy is finished
+    RestoreDefaultState(cb);
+}
+
+void
+HgiVkTexture::RecordDeferredInitialization(
+    HgiVkCommandBuffer* cb,
+    HgiVkStagingRegion const* src)
+{
+    HgiVkImageState defaultState = _GetDefaultState();
+
+    if (!src) {
+        // Same transition as the constructor records in the immediate path.
+        RecordImageBarrier(
+            cb,
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            defaultState.layout,
+            0,
+            defaultState.access,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            defaultState.stages);
+        return;
+    }
+
+    // Contents are undefined before the copy, so we can skip the default
+    // layout and go straight to TRANSFER_DST.
+    RecordImageBarrier(
+        cb,
+        VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        0,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+    _RecordCopyFromBuffer(cb, *src);
+
+    if (_mipGeneration != _MipGenerationNone) {
+        _RecordGenerateMips(cb, nullptr);
+        return;
+    }
+
+    RecordImageBarrier(
+        cb,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        defaultState.layout,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        defaultState.access,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        defaultState.stages);
+}
+
+void
+HgiVkTexture::CopyTextureFromTransferQueue(
+    HgiVkCommandBuffer* transferCB,
+    HgiVkCommandBuffer* cb,
+    HgiVkStagingRegion const& src)
+{
+    // Contents are undefined before the copy. The transfer queue does not
+    // need to acquire ownership to discard the contents.
+    RecordImageBarrier(
+        transferCB,
+        VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        0,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+    _RecordCopyFromBuffer(transferCB, src);
+
+    // Vulkan docs: "Queue Family Ownership Transfer".
+    // The release and acquire barriers must match (including the layout
+    // transition), except for the access masks that are ignored on the
+    // 'other' side.
+    // CONCURRENT textures need no ownership transfer, the barriers below are
+    // then only layout transitions, execution and memory dependencies.
+    bool isDepthBuffer = _descriptor.usage & HgiTextureUsageBitsDepthTarget;
+    HgiVkImageState defaultState = _GetDefaultState();
+
+    // The mips are generated on the graphics queue, since the transfer queue
+    // cannot blit or dispatch. The image stays in TRANSFER_DST until then.
+    bool generateMips = _mipGeneration != _MipGenerationNone;
+    if (generateMips) {
+        defaultState.layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        defaultState.access = VK_ACCESS_TRANSFER_READ_BIT |
+                              VK_ACCESS_TRANSFER_WRITE_BIT;
+        defaultState.stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    }
+
+    VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = defaultState.layout;
+    barrier.srcQueueFamilyIndex = _isConcurrent ? VK_QUEUE_FAMILY_IGNORED :
+        _device->GetVulkanTransferQueueFamilyIndex();
+    barrier.dstQueueFamilyIndex = _isConcurrent ? VK_QUEUE_FAMILY_IGNORED :
+        _device->GetVulkanDeviceQueueFamilyIndex();
+    barrier.image = _vkImage;
+    barrier.subresourceRange.aspectMask = isDepthBuffer ?
+        VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT :
+        VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = _descriptor.mipLevels;
+    barrier.subresourceRange.layerCount = _descriptor.layerCount;
+
+    // Release (transfer queue)
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = 0;
+
+    transferCB->AddBarrier(
+        VK_PIPELINE_STAGE_TRANSFER_BIT,       // producer stage
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, // consumer stage (other queue)
+        barrier);
+
+    // Acquire (graphics queue). The semaphore wait covers the transfer stage.
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = defaultState.access;
+
+    cb->AddBarrier(
+        VK_PIPELINE_STAGE_TRANSFER_BIT, // producer stage (semaphore wait)
+        defaultState.stages,            // consumer stage
+        barrier);
+
+    if (generateMips) {
+        // Ends in the default state, where command buffers start from.
+        _RecordGenerateMips(cb, nullptr);
+    }
+}
+
+void
+HgiVkTexture::TransitionImageBarrier(
+    HgiVkCommandBuffer* cb,
+    VkImageLayout newLayout,
+    VkAccessFlags accessRequest,
+    VkPipelineStageFlags consumerStage,
+    uint32_t baseMipLevel,
+    uint32_t mipLevelCount,
+    uint32_t baseLayer,
+    uint32_t layerCount)
+{
+    if (!_tracksState) return;
+
+    if (mipLevelCount == VK_REMAINING_MIP_LEVELS) {
+        mipLevelCount = _descriptor.mipLevels - baseMipLevel;
+    }
+    if (layerCount == VK_REMAINING_ARRAY_LAYERS) {
+        layerCount = _descriptor.layerCount - baseLayer;
+    }
+
+    if (!TF_VERIFY(baseMipLevel + mipLevelCount <= _descriptor.mipLevels &&
+                   baseLayer + layerCount <= _descriptor.layerCount,
+                   "Invalid subresource range")) {
+        return;
+    }
+
+    HgiVkImageState newState;
+    newState.layout = newLayout;
+    newState.access = accessRequest;
+    newState.stages = consumerStage;
+
+    // The first transition of the entire texture in `cb` can be left to the
+    // command buffer manager, which records it between the command buffers
+    // (see HgiVkCommandBufferManager). The texture then starts out in
+    // `newState` in `cb`.
+    bool entireTexture = mipLevelCount == _descriptor.mipLevels &&
+                         layerCount == _descriptor.layerCount;
+
+    if (entireTexture && cb->CanDeferFirstTransition(this)) {
+        HgiVkTrackedTexture* tracked = cb->FindTrackedTexture(this);
+        if (!tracked) {
+            tracked = &cb->TrackTexture(
+                this, GetDefaultStates(), GetDefaultStates());
+            tracked->firstUsePending = true;
+        }
+        if (tracked->firstUsePending) {
+            std::fill(
+                tracked->initial.begin(), tracked->initial.end(), newState);
+            tracked->states = tracked->initial;
+            tracked->firstUsePending = false;
+            return;
+        }
+    }
+
+    _Transition(
+        cb,
+        newState,
+        baseMipLevel,
+        mipLevelCount,
+        baseLayer,
+        layerCount,
+        /*skipDone*/ false);
+}
+
+void
+HgiVkTexture::RestoreDefaultState(HgiVkCommandBuffer* cb)
+{
+    if (!_tracksState) return;
+
+    _Transition(
+        cb,
+        _GetDefaultState(),
+        0,
+        _descriptor.mipLevels,
+        0,
+        _descriptor.layerCount,
+        /*skipDone*/ true);
+}
+
+void
+HgiVkTexture::InvalidateContents(HgiVkCommandBuffer* cb)
+{
+    if (!_tracksState) return;
+
+    // Before its first use in `cb` the contents are discarded between the
+    // command buffers, if the first transition can be deferred.
+    HgiVkTrackedTexture* tracked = cb->FindTrackedTexture(this);
+    if (!tracked && cb->CanDeferFirstTransition(this)) {
+        tracked = &cb->TrackTexture(
+            this, GetDefaultStates(), GetDefaultStates());
+        tracked->firstUsePending = true;
+    }
+
+    if (tracked && tracked->firstUsePending) {
+        tracked->discard = true;
+    }
+
+    // The accesses are kept, the next barrier must still wait for them.
+    HgiVkImageStateVector& states = tracked && tracked->firstUsePending ?
+        tracked->states : _GetStates(cb);
+    for (HgiVkImageState& state : states) {
+        state.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    }
+}
+
+void
+HgiVkTexture::RecordStateHandOver(
+    HgiVkCommandBuffer* cb,
+    HgiVkImageStateVector const& oldStates,
+    HgiVkImageStateVector const& newStates,
+    bool discard)
+{
+    if (!_tracksState) return;
+
+    uint32_t const mips = _descriptor.mipLevels;
+    if (!TF_VERIFY(oldStates.size() == newStates.size() &&
+                   oldStates.size() == mips * _descriptor.layerCount)) {
+        return;
+    }
+
+    for (uint32_t l=0; l<_descriptor.layerCount; l++) {
+        for (uint32_t m=0; m<mips; m++) {
+            HgiVkImageState const& o = oldStates[l * mips + m];
+            HgiVkImageState const& n = newStates[l * mips + m];
+
+            // Reads after reads in the same layout need no barrier, as long
+            // as the new state still includes all readers. A later write only
+            // waits for the stages in the new state.
+            bool hazard = (o.access & _writeAccess) ||
+                          (n.access & _writeAccess);
+            if (!discard && o.layout == n.layout && !hazard &&
+                !(o.stages & ~n.stages)) {
+                continue;
+            }
+
+            _RecordImageBarrier(
+                cb,
+                discard ? VK_IMAGE_LAYOUT_UNDEFINED : o.layout,
+                n.layout,
+                o.access & _writeAccess, // Only writes must be flushed
+                n.access,
+                o.stages ? o.stages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                n.stages,
+                m,
+                1,
+                l,
+                1);
+        }
+    }
+}
+
+void
+HgiVkTexture::RecordImageBarrier(
+    HgiVkCommandBuffer* cb,
+    VkImageLayout oldLayout,
+    VkImageLayout newLayout,
+    VkAccessFlags srcAccess,
+    VkAccessFlags dstAccess,
+    VkPipelineStageFlags producerStage,
+    VkPipelineStageFlags consumerStage)
+{
+    _RecordImageBarrier(
+        cb,
+        oldLayout,
+        newLayout,
+        srcAccess,
+        dstAccess,
+        producerStage,
+        consumerStage,
+        0,
+        _descriptor.mipLevels,
+        0,
+        _descriptor.layerCount);
+}
+
+VkImageLayout
+HgiVkTexture::_GetDefaultImageLayout() const
+{
+    bool isDepthBuffer = _descriptor.usage & HgiTextureUsageBitsDepthTarget;
+    VkImageUsageFlags usage =
+        HgiVkConversions::GetTextureUsage(_descriptor.usage);
+
+    if (usage & VK_IMAGE_USAGE_SAMPLED_BIT) {
+        return isDepthBuffer ?
+            VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL :
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    }
+
+    return isDepthBuffer ?
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL :
+        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+}
+
+void
+HgiVkTexture::_RecordCopyFromBuffer(
+    HgiVkCommandBuffer* cb,
+    HgiVkStagingRegion const& src)
 {
     // Setup buffer copy regions for each mip level
     std::vector<VkBufferImageCopy> bufferCopyRegions;
@@ -333,8 +783,12 @@ HgiVkTexture::CopyTextureFrom(
     // See dimension reduction rule in ARB_texture_non_power_of_two.
     // Default numMips is: 1 + floor(log2(max(w, h, d)));
 
-    uint32_t offset = 0;
-    for (uint32_t i = 0; i < _descriptor.mipLevels; i++) {
+    // Generated mips are not part of the pixel data.
+    uint32_t mipLevels = _mipGeneration != _MipGenerationNone ?
+        1 : _descriptor.mipLevels;
+
+    VkDeviceSize offset = src.offset;
+    for (uint32_t i = 0; i < mipLevels; i++) {
         float div = powf(2, i);
         float mipWidth = std::max(1.0f, std::floor(width / div));
         float mipHeight = std::max(1.0f, std::floor(height / div));
@@ -352,49 +806,292 @@ HgiVkTexture::CopyTextureFrom(
         bufferCopyRegions.push_back(bufferCopyRegion);
 
         // Determine byte-offset in total pixel buffer for this mip
-        offset += (mipWidth * mipHeight * mipDepth * bpp);
+        offset += (VkDeviceSize) (mipWidth * mipHeight * mipDepth * bpp);
     }
 
-    //
-    // Image memory barriers for the texture image
-    //
-
-    // Transition image so we can copy into it
-    TransitionImageBarrier(
-        cb,
-        this,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, // Transition tex to this layout
-        VK_ACCESS_TRANSFER_WRITE_BIT,         // Write access to image
-        VK_PIPELINE_STAGE_HOST_BIT,           // producer stage
-        VK_PIPELINE_STAGE_TRANSFER_BIT);      // consumer stage
-
     // Copy pixels (all mip levels) from staging buffer to gpu image
     vkCmdCopyBufferToImage(
         cb->GetCommandBufferForRecoding(),
-        src.GetBuffer(),
+        src.buffer,
         _vkImage,
         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
         static_cast<uint32_t>(bufferCopyRegions.size()),
         bufferCopyRegions.data());
+}
 
-    // Transition image to SHADER_READ when copy is finished
-    TransitionImageBarrier(
-        cb,
-        this,
-        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,   // transition tex to this
-        HgiVkRenderPass::GetDefaultDstAccessMask(), // Shader read access
-        VK_PIPELINE_STAGE_TRANSFER_BIT,             // producer stage
-        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT);       // consumer stage
+void
+HgiVkTexture::_RecordGenerateMips(
+    HgiVkCommandBuffer* cb,
+    HgiVkImageStateVector* states)
+{
+    uint32_t mipLevels = _descriptor.mipLevels;
+    uint32_t layerCount = _descriptor.layerCount;
+    GfVec3i const& dimensions = _descriptor.dimensions;
+
+    // Mip 0 was just written by the copy, the other mips were only
+    // transitioned to TRANSFER_DST.
+    HgiVkImageState copied;
+    copied.layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    copied.access = VK_ACCESS_TRANSFER_WRITE_BIT;
+    copied.stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+    HgiVkImageStateVector untracked;
+    if (!states) {
+        untracked.assign(mipLevels * layerCount, copied);
+        states = &untracked;
+    }
+
+    for (uint32_t l=0; l<layerCount; l++) {
+        for (uint32_t m=1; m<mipLevels; m++) {
+            (*states)[l * mipLevels + m].access = 0;
+        }
+    }
+
+    // All layers of a mip are processed together, so they are in the same
+    // state.
+    auto transition = [&](
+        HgiVkImageState const& newState,
+        uint32_t baseMipLevel,
+        uint32_t mipLevelCount)
+    {
+        HgiVkImageState oldState = (*states)[baseMipLevel];
+        _TransitionRange(
+            cb,
+            *states,
+            oldState,
+            newState,
+            baseMipLevel,
+            mipLevelCount,
+            0,
+            layerCount);
+    };
+
+    HgiVkImageState readState;
+    HgiVkImageState writeState;
+
+    if (_mipGeneration == _MipGenerationBlit) {
+        readState.layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        readState.access = VK_ACCESS_TRANSFER_READ_BIT;
+        readState.stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        writeState = copied;
+    } else {
+        readState.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        readState.access = VK_ACCESS_SHADER_READ_BIT;
+        readState.stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        writeState.layout = VK_IMAGE_LAYOUT_GENERAL;
+        writeState.access = VK_ACCESS_SHADER_WRITE_BIT;
+        writeState.stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    }
+
+    HgiVkMipGenerator* mipGenerator = _device->GetMipGenerator();
+
+    // Each mip is downsampled from the previous mip, which must be complete.
+    for (uint32_t i=1; i<mipLevels; i++) {
+        transition(readState, i-1, 1);
+
+        if (_mipGeneration == _MipGenerationBlit) {
+            // Mips that were only transitioned to TRANSFER_DST need no
+            // barrier before the blit writes them.
+            VkImageBlit blit = {};
+            blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blit.srcSubresource.mipLevel = i-1;
+            blit.srcSubresource.layerCount = layerCount;
+            blit.srcOffsets[1].x = std::max(1, dimensions[0] >> (i-1));
+            blit.srcOffsets[1].y = std::max(1, dimensions[1] >> (i-1));
+            blit.srcOffsets[1].z = std::max(1, dimensions[2] >> (i-1));
+            blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blit.dstSubresource.mipLevel = i;
+            blit.dstSubresource.layerCount = layerCount;
+            blit.dstOffsets[1].x = std::max(1, dimensions[0] >> i);
+            blit.dstOffsets[1].y = std::max(1, dimensions[1] >> i);
+            blit.dstOffsets[1].z = std::max(1, dimensions[2] >> i);
+
+            vkCmdBlitImage(
+                cb->GetCommandBufferForRecoding(),
+                _vkImage,
+                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                _vkImage,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                1,
+                &blit,
+                VK_FILTER_LINEAR);
+
+            for (uint32_t l=0; l<layerCount; l++) {
+                (*states)[l * mipLevels + i] = writeState;
+            }
+        } else {
+            transition(writeState, i, 1);
+            for (uint32_t l=0; l<layerCount; l++) {
+                mipGenerator->RecordDownsample(cb, this, i-1, l);
+            }
+        }
+    }
+
+    // All mips but the last one were read, the last one was written.
+    HgiVkImageState defaultState = _GetDefaultState();
+    transition(defaultState, 0, mipLevels-1);
+    transition(defaultState, mipLevels-1, 1);
+}
+
+HgiVkImageState
+HgiVkTexture::_GetDefaultState() const
+{
+    bool isDepthBuffer = _descriptor.usage & HgiTextureUsageBitsDepthTarget;
+    VkImageUsageFlags usage =
+        HgiVkConversions::GetTextureUsage(_descriptor.usage);
+
+    HgiVkImageState state;
+    state.layout = _GetDefaultImageLayout();
+
+    if (usage & VK_IMAGE_USAGE_SAMPLED_BIT) {
+        // We don't know which shader stages will sample the texture.
+        state.access = VK_ACCESS_SHADER_READ_BIT;
+        state.stages = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                       VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    } else if (isDepthBuffer) {
+        state.access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        state.stages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                       VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    } else {
+        state.access = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+                       VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        state.stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    }
+
+    return state;
+}
+
+HgiVkImageStateVector&
+HgiVkTexture::_GetStates(HgiVkCommandBuffer* cb)
+{
+    // Other command buffers may be recording with the same texture, so the
+    // state lives in the command buffer, not in the texture.
+    if (HgiVkTrackedTexture* tracked = cb->FindTrackedTexture(this)) {
+        tracked->firstUsePending = false;
+        return tracked->states;
+    }
+
+    // Without a deferred first transition the texture starts out in the
+    // default state in `cb`.
+    return cb->TrackTexture(this, GetDefaultStates(), GetDefaultStates())
+        .states;
 }
 
 void
-HgiVkTexture::TransitionImageBarrier(
+HgiVkTexture::_Transition(
+    HgiVkCommandBuffer* cb,
+    HgiVkImageState const& newState,
+    uint32_t baseMipLevel,
+    uint32_t mipLevelCount,
+    uint32_t baseLayer,
+    uint32_t layerCount,
+    bool skipDone)
+{
+    if (mipLevelCount == 0 || layerCount == 0) return;
+
+    HgiVkImageStateVector& states = _GetStates(cb);
+    uint32_t const mips = _descriptor.mipLevels;
+
+    // Usually the entire range is in the same state and needs one barrier.
+    HgiVkImageState first = states[baseLayer * mips + baseMipLevel];
+    bool sameState = true;
+
+    for (uint32_t l=baseLayer; l<baseLayer+layerCount && sameState; l++) {
+        for (uint32_t m=baseMipLevel; m<baseMipLevel+mipLevelCount; m++) {
+            if (!_IsSameState(states[l * mips + m], first)) {
+                sameState = false;
+                break;
+            }
+        }
+    }
+
+    if (sameState) {
+        if (skipDone && _IsSameState(first, newState)) return;
+        _TransitionRange(
+            cb,
+            states,
+            first,
+            newState,
+            baseMipLevel,
+            mipLevelCount,
+            baseLayer,
+            layerCount);
+        return;
+    }
+
+    // Otherwise transition each subresource from its own state, e.g. after
+    // the mips of a texture were written one by one.
+    for (uint32_t l=baseLayer; l<baseLayer+layerCount; l++) {
+        for (uint32_t m=baseMipLevel; m<baseMipLevel+mipLevelCount; m++) {
+            HgiVkImageState oldState = states[l * mips + m];
+            if (skipDone && _IsSameState(oldState, newState)) continue;
+            _TransitionRange(cb, states, oldState, newState, m, 1, l, 1);
+        }
+    }
+}
+
+void
+HgiVkTexture::_TransitionRange(
     HgiVkCommandBuffer* cb,
-    HgiVkTexture* tex,
+    HgiVkImageStateVector& states,
+    HgiVkImageState const& oldState,
+    HgiVkImageState const& newState,
+    uint32_t baseMipLevel,
+    uint32_t mipLevelCount,
+    uint32_t baseLayer,
+    uint32_t layerCount)
+{
+    bool layoutChange = oldState.layout != newState.layout;
+    bool hazard = (oldState.access & _writeAccess) ||
+                  (newState.access & _writeAccess);
+
+    // Read after read in the same layout (or the first use of the texture):
+    // No barrier, but remember all readers so that a later write waits for
+    // each of them.
+    HgiVkImageState state = newState;
+    if (!layoutChange && (!hazard || oldState.stages == 0)) {
+        if (!hazard) {
+            state.access |= oldState.access;
+            state.stages |= oldState.stages;
+        }
+    } else {
+        _RecordImageBarrier(
+            cb,
+            oldState.layout,
+            newState.layout,
+            oldState.access & _writeAccess, // Only writes must be flushed
+            newState.access,
+            oldState.stages ? oldState.stages :
+                              VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            newState.stages,
+            baseMipLevel,
+            mipLevelCount,
+            baseLayer,
+            layerCount);
+    }
+
+    for (uint32_t l=baseLayer; l<baseLayer+layerCount; l++) {
+        for (uint32_t m=baseMipLevel; m<baseMipLevel+mipLevelCount; m++) {
+            states[l * _descriptor.mipLevels + m] = state;
+        }
+    }
+}
+
+void
+HgiVkTexture::_RecordImageBarrier(
+    HgiVkCommandBuffer* cb,
+    VkImageLayout oldLayout,
     VkImageLayout newLayout,
-    VkAccessFlags accesRequest,
+    VkAccessFlags srcAccess,
+    VkAccessFlags dstAccess,
     VkPipelineStageFlags producerStage,
-    VkPipelineStageFlags consumerStage)
+    VkPipelineStageFlags consumerStage,
+    uint32_t baseMipLevel,
+    uint32_t mipLevelCount,
+    uint32_t baseLayer,
+    uint32_t layerCount)
 {
     bool isDepthBuffer = _descriptor.usage & HgiTextureUsageBitsDepthTarget;
 
@@ -407,16 +1104,16 @@ HgiVkTexture::TransitionImageBarrier(
     // will be the earliest consumer stage. This helps schedule work and avoid
     // wait-bubbles.
 
-    // XXX srcAccessMask=0:
+    // srcAccess=0:
     // Only invalidation barrier, no flush barrier. For read-only resources.
     // Meaning: There are no pending writes. Multiple passes can go back to back
     // which all read the resource.
 
     VkImageMemoryBarrier barrier[1] = {};
     barrier[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier[0].srcAccessMask = 0;            // what producer does
-    barrier[0].dstAccessMask = accesRequest; // what consumer does
-    barrier[0].oldLayout = _vkDescriptor.imageLayout;
+    barrier[0].srcAccessMask = srcAccess; // what producer does
+    barrier[0].dstAccessMask = dstAccess; // what consumer does
+    barrier[0].oldLayout = oldLayout;
     barrier[0].newLayout = newLayout;
     barrier[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
@@ -424,20 +1121,17 @@ HgiVkTexture::TransitionImageBarrier(
     barrier[0].subresourceRange.aspectMask = isDepthBuffer ?
         VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT :
         VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier[0].subresourceRange.levelCount = _descriptor.mipLevels;
-    barrier[0].subresourceRange.layerCount = _descriptor.layerCount;
+    barrier[0].subresourceRange.baseMipLevel = baseMipLevel;
+    barrier[0].subresourceRange.levelCount = mipLevelCount;
+    barrier[0].subresourceRange.baseArrayLayer = baseLayer;
+    barrier[0].subresourceRange.layerCount = layerCount;
 
     // Insert a memory dependency at the proper pipeline stages that will
-    // execute the image layout transition.
-
-    vkCmdPipelineBarrier(
-        cb->GetCommandBufferForRecoding(),
-        producerStage,
-        consumerStage,
-        0, 0, NULL, 0, NULL, 1,
-        barrier);
+    // execute the image layout transition. The barrier is recorded (batched
+    // with other pending barriers) before the next command that uses the
+    // command buffer.
 
-    _vkDescriptor.imageLayout = newLayout;
+    cb->AddBarrier(producerStage, consumerStage, barrier[0]);
 }
 
 PXR_NAMESPACE_CLOSE_SCOPE
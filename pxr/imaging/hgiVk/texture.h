@@ -1,12 +1,14 @@
 #ifndef PXR_IMAGING_HGIVK_TEXTURE_H
 #define PXR_IMAGING_HGIVK_TEXTURE_H
 
+#include <vector>
 
 #include "pxr/pxr.h"
 #include "pxr/imaging/hgi/texture.h"
 
 #include "pxr/imaging/hgiVk/api.h"
 #include "pxr/imaging/hgiVk/buffer.h"
+#include "pxr/imaging/hgiVk/stagingRing.h"
 #include "pxr/imaging/hgiVk/vulkan.h"
 
 
@@ -16,13 +18,43 @@ class HgiVkDevice;
 class HgiVkCommandBuffer;
 
 
+/// \struct HgiVkImageState
+///
+/// State of one subresource (one mip level of one array layer) of an image,
+/// as left behind by the commands recorded so far.
+/// `access` and `stages` are the accesses of the subresource since its last
+/// barrier. They are the source scope of the next barrier.
+///
+struct HgiVkImageState {
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkAccessFlags access = 0;
+    VkPipelineStageFlags stages = 0;
+};
+
+typedef std::vector<HgiVkImageState> HgiVkImageStateVector;
+
+
 /// \class HgiVkTexture
 ///
 /// Represents a GPU texture resource.
 ///
+/// The state (layout, access, stages) of each subresource is tracked per
+/// command buffer, so commands only record the barriers they actually need
+/// and command buffers can be recorded in parallel.
+/// Between queue submissions a texture is always in its default state (see
+/// GetImageLayout). Within one graphics queue submission the command buffer
+/// manager hands the state of each texture over from one command buffer to
+/// the next (see RecordStateHandOver). Other command buffers return the
+/// texture to the default state before they end (see
+/// HgiVkCommandBuffer::TrackTexture).
+///
 class HgiVkTexture final : public HgiTexture {
 public:
     // Default constructor
+    // When `cb` is nullptr the initial layout transition is not recorded.
+    // The texture immediately reports the layout it will have once the
+    // caller has recorded RecordDeferredInitialization (deferred resource
+    // recording, see HgiVkCommandBufferManager::DeferResourceCommand).
     HGIVK_API
     HgiVkTexture(
         HgiVkDevice* device,
@@ -47,11 +79,28 @@ public:
     HGIVK_API
     VkImageView GetImageView() const;
 
-    /// Returns the image layout of the texture
+    /// Returns the default image layout of the texture.
+    /// This is the layout the texture is in between command buffers and the
+    /// layout in which shaders sample the texture.
     HGIVK_API
     VkImageLayout GetImageLayout() const;
 
-    /// Returns the sampler of the texture.
+    /// Returns the state of one subresource as left behind by the commands
+    /// recorded into `cb` so far.
+    HGIVK_API
+    HgiVkImageState GetSubresourceState(
+        HgiVkCommandBuffer* cb,
+        uint32_t mipLevel,
+        uint32_t layer);
+
+    /// Returns the default state for all subresources, indexed by
+    /// layer * mipLevels + mipLevel. Empty for swapchain images, their state
+    /// is not tracked.
+    HGIVK_API
+    HgiVkImageStateVector GetDefaultStates() const;
+
+    /// Returns the default sampler of the texture, used when the texture is
+    /// bound without a sampler. It is shared with all other textures.
     HGIVK_API
     VkSampler GetSampler() const;
 
@@ -59,22 +108,94 @@ public:
     HGIVK_API
     HgiTextureDesc const& GetDescriptor() const;
 
-    /// Records a copy command to copy the data from the provided source buffer
-    /// into this (destination) texture. This requires that the source buffer is
-    /// setup as a staging buffer (HgiBufferUsageTransferSrc) and that this
-    /// (destination) texture has usage: HgiTextureUsageTransferDst.
+    /// Returns the index of the texture in the global texture array, or
+    /// HgiVkBindlessTextures::InvalidIndex if it is not in the array.
+    /// Sampled color textures are in the array when bindless textures are
+    /// enabled (see HgiVkDevice::GetDeviceSupportBindlessTextures).
+    /// The index does not change during the lifetime of the texture.
+    HGIVK_API
+    uint32_t GetBindlessIndex() const;
+
+    /// Records a copy command to copy the data from the provided staging region
+    /// into this (destination) texture. This requires that this (destination)
+    /// texture has usage: HgiTextureUsageTransferDst.
+    /// The region offset must be a multiple of 4 and of the texel size.
     HGIVK_API
     void CopyTextureFrom(
         HgiVkCommandBuffer* cb,
-        HgiVkBuffer const& src);
+        HgiVkStagingRegion const& src);
+
+    /// Records the commands that were skipped when the texture was created
+    /// without a command buffer. Transitions the image from UNDEFINED to its
+    /// default layout and, if `src` is provided, copies the staging data into
+    /// the texture (see CopyTextureFrom).
+    /// The tracked state is not changed, it already is the default state.
+    HGIVK_API
+    void RecordDeferredInitialization(
+        HgiVkCommandBuffer* cb,
+        HgiVkStagingRegion const* src);
+
+    /// Same as RecordDeferredInitialization with a staging buffer, but the
+    /// upload is recorded in `transferCB`, which belongs to the device's
+    /// dedicated transfer queue. Queue family ownership of the image is
+    /// released in `transferCB` and acquired in `cb` (graphics queue).
+    /// The texture must have been created without a command buffer and the
+    /// graphics submission of `cb` must wait on a semaphore signaled by the
+    /// transfer submission of `transferCB`.
+    HGIVK_API
+    void CopyTextureFromTransferQueue(
+        HgiVkCommandBuffer* transferCB,
+        HgiVkCommandBuffer* cb,
+        HgiVkStagingRegion const& src);
 
-    /// Transition image from its current layout to newLayout
+    /// Prepares the subresources in the given range for `accessRequest` in
+    /// `consumerStage` with layout `newLayout`.
+    /// The producer stage and access are taken from the tracked state. A
+    /// barrier is only added if there is a layout transition or a hazard.
+    /// Reads after reads in the same layout need no barrier.
     HGIVK_API
     void TransitionImageBarrier(
         HgiVkCommandBuffer* cb,
-        HgiVkTexture* tex,
         VkImageLayout newLayout,
-        VkAccessFlags accesRequest,
+        VkAccessFlags accessRequest,
+        VkPipelineStageFlags consumerStage,
+        uint32_t baseMipLevel = 0,
+        uint32_t mipLevelCount = VK_REMAINING_MIP_LEVELS,
+        uint32_t baseLayer = 0,
+        uint32_t layerCount = VK_REMAINING_ARRAY_LAYERS);
+
+    /// Returns all subresources that are not in the default state to it.
+    HGIVK_API
+    void RestoreDefaultState(HgiVkCommandBuffer* cb);
+
+    /// Marks the contents of the texture as undefined, so the next transition
+    /// can discard them instead of preserving them (old layout UNDEFINED).
+    /// Used before the entire texture is overwritten or cleared by `cb`.
+    HGIVK_API
+    void InvalidateContents(HgiVkCommandBuffer* cb);
+
+    /// Records the barriers that take the subresources from `oldStates`, as
+    /// left behind by an earlier command buffer, to `newStates`, where a
+    /// later command buffer starts from. If `discard` is set the contents are
+    /// not preserved. Used by the command buffer manager between the command
+    /// buffers of one queue submission. The tracked state is not changed.
+    HGIVK_API
+    void RecordStateHandOver(
+        HgiVkCommandBuffer* cb,
+        HgiVkImageStateVector const& oldStates,
+        HgiVkImageStateVector const& newStates,
+        bool discard);
+
+    /// Records a barrier from oldLayout to newLayout without changing the
+    /// tracked state. Used by command buffers that are submitted outside of
+    /// the frame. Those see the texture in its default layout.
+    HGIVK_API
+    void RecordImageBarrier(
+        HgiVkCommandBuffer* cb,
+        VkImageLayout oldLayout,
+        VkImageLayout newLayout,
+        VkAccessFlags srcAccess,
+        VkAccessFlags dstAccess,
         VkPipelineStageFlags producerStage,
         VkPipelineStageFlags consumerStage);
 
@@ -83,14 +204,95 @@ private:
     HgiVkTexture & operator=(const HgiVkTexture&) = delete;
     HgiVkTexture(const HgiVkTexture&) = delete;
 
+    // Returns the layout a new texture is transitioned into after creation.
+    VkImageLayout _GetDefaultImageLayout() const;
+
+    // Returns the state the texture is in between command buffers.
+    HgiVkImageState _GetDefaultState() const;
+
+    // Returns the state of all subresources in `cb`, indexed by
+    // layer * mipLevels + mipLevel. Starts tracking the texture in `cb`
+    // with the default state on first use. A first transition that is still
+    // pending can no longer be deferred afterwards.
+    HgiVkImageStateVector& _GetStates(HgiVkCommandBuffer* cb);
+
+    // Transitions the subresources in the range to `newState`.
+    // If `skipDone` is set, subresources already in `newState` are skipped.
+    void _Transition(
+        HgiVkCommandBuffer* cb,
+        HgiVkImageState const& newState,
+        uint32_t baseMipLevel,
+        uint32_t mipLevelCount,
+        uint32_t baseLayer,
+        uint32_t layerCount,
+        bool skipDone);
+
+    // Transitions a range of subresources that are all in `oldState`.
+    void _TransitionRange(
+        HgiVkCommandBuffer* cb,
+        HgiVkImageStateVector& states,
+        HgiVkImageState const& oldState,
+        HgiVkImageState const& newState,
+        uint32_t baseMipLevel,
+        uint32_t mipLevelCount,
+        uint32_t baseLayer,
+        uint32_t layerCount);
+
+    // Records the copy of all mips from a staging buffer into the image.
+    // Only mip 0 is copied if the texture generates its mips.
+    // The image must be in TRANSFER_DST layout.
+    void _RecordCopyFromBuffer(
+        HgiVkCommandBuffer* cb,
+        HgiVkStagingRegion const& src);
+
+    // Records the generation of mips 1..n from mip 0, right after mip 0 was
+    // copied. All mips must be in TRANSFER_DST layout. Leaves all mips in the
+    // default state.
+    // The transitions update `states`, the tracked states of `cb`. If it is
+    // nullptr the state is not tracked, because the texture already reports
+    // its default state (deferred and transfer queue uploads).
+    void _RecordGenerateMips(
+        HgiVkCommandBuffer* cb,
+        HgiVkImageStateVector* states);
+
+    // Adds an image barrier for a range of subresources.
+    void _RecordImageBarrier(
+        HgiVkCommandBuffer* cb,
+        VkImageLayout oldLayout,
+        VkImageLayout newLayout,
+        VkAccessFlags srcAccess,
+        VkAccessFlags dstAccess,
+        VkPipelineStageFlags producerStage,
+        VkPipelineStageFlags consumerStage,
+        uint32_t baseMipLevel,
+        uint32_t mipLevelCount,
+        uint32_t baseLayer,
+        uint32_t layerCount);
+
 private:
+    // How the mips of a texture are generated (HgiTextureDesc::generateMips).
+    enum _MipGeneration {
+        _MipGenerationNone = 0,
+        _MipGenerationBlit,    // vkCmdBlitImage with linear filter
+        _MipGenerationCompute  // HgiVkMipGenerator
+    };
+
     HgiVkDevice* _device;
 
     HgiTextureDesc _descriptor;
+    _MipGeneration _mipGeneration;
 
     VkDescriptorImageInfo _vkDescriptor; // VkSampler,VkImageView,VkImageLayout
     VkImage _vkImage;
     VmaAllocation _vmaImageAllocation;
+    uint32_t _bindlessIndex;
+
+    // True if the texture is shared between queue families without ownership
+    // transfers (VK_SHARING_MODE_CONCURRENT).
+    bool _isConcurrent;
+
+    // False for swapchain images, their state is managed by the swapchain.
+    bool _tracksState;
 };
 
 
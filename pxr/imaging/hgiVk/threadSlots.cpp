@@ -0,0 +1,65 @@
+#include "pxr/imaging/hgiVk/threadSlots.h"
+
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+static std::atomic<bool> _slotInUse[HgiVkThreadSlots::MaxSlots];
+static std::atomic<uint32_t> _slotCount(0);
+
+// Holds the slot of a thread and releases it when the thread exits.
+struct _HgiVkThreadSlot {
+    ~_HgiVkThreadSlot() {
+        if (slot != _invalidSlot) {
+            _slotInUse[slot].store(false, std::memory_order_release);
+        }
+    }
+
+    static const uint32_t _invalidSlot = ~0u;
+    uint32_t slot = _invalidSlot;
+};
+
+thread_local _HgiVkThreadSlot _HgiVkThreadLocalSlot;
+
+
+static uint32_t
+_AcquireSlot()
+{
+    // Take the lowest free slot. This only happens once per thread, so a
+    // linear scan is fine.
+    for (uint32_t i=0; i<HgiVkThreadSlots::MaxSlots; i++) {
+        if (_slotInUse[i].load(std::memory_order_relaxed)) continue;
+        if (_slotInUse[i].exchange(true, std::memory_order_acquire)) continue;
+
+        // Grow the slot count if this slot is beyond it.
+        uint32_t count = _slotCount.load(std::memory_order_relaxed);
+        while (count < i+1 &&
+               !_slotCount.compare_exchange_weak(count, i+1)) {
+            // count was updated with the current value, try again.
+        }
+        return i;
+    }
+
+    TF_FATAL_ERROR("More than %u threads use HgiVk",
+                   HgiVkThreadSlots::MaxSlots);
+    return 0;
+}
+
+uint32_t
+HgiVkThreadSlots::GetSlot()
+{
+    /* MULTI-THREAD CALL*/
+
+    if (_HgiVkThreadLocalSlot.slot == _HgiVkThreadSlot::_invalidSlot) {
+        _HgiVkThreadLocalSlot.slot = _AcquireSlot();
+    }
+    return _HgiVkThreadLocalSlot.slot;
+}
+
+uint32_t
+HgiVkThreadSlots::GetSlotCount()
+{
+    return _slotCount.load(std::memory_order_acquire);
+}
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
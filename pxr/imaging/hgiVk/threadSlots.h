@@ -0,0 +1,130 @@
+#ifndef PXR_IMAGING_HGIVK_THREAD_SLOTS_H
+#define PXR_IMAGING_HGIVK_THREAD_SLOTS_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "pxr/pxr.h"
+#include "pxr/base/tf/diagnostic.h"
+#include "pxr/imaging/hgiVk/api.h"
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+
+/// \class HgiVkThreadSlots
+///
+/// Hands out a small, unique index ('slot') to each thread.
+///
+/// HgiVk records commands from any thread Hydra (or the embedding application)
+/// decides to use. Per-thread data, such as command pools, is stored at the
+/// thread's slot in a HgiVkThreadSlotArray. A thread keeps its slot for its
+/// entire lifetime, so the per-thread data is stable across frames. When the
+/// thread exits its slot is released and may be handed to a new thread.
+/// Slots are handed out lowest-first, so the slot range stays compact.
+///
+class HgiVkThreadSlots final
+{
+public:
+    /// Max number of threads that may hold a slot at the same time.
+    static const uint32_t MaxSlots = 16384;
+
+    /// Returns the slot of the calling thread.
+    /// The first call of a thread acquires a free slot (lock-free).
+    /// Thread safety: May be called from any thread.
+    HGIVK_API
+    static uint32_t GetSlot();
+
+    /// Returns one past the highest slot that was ever handed out.
+    HGIVK_API
+    static uint32_t GetSlotCount();
+
+private:
+    HgiVkThreadSlots() = delete;
+};
+
+
+/// \class HgiVkThreadSlotArray
+///
+/// Lock-free, growable array with one element per thread slot.
+/// Elements are default constructed the first time a slot is accessed and are
+/// never moved, so a reference to an element stays valid until the array is
+/// destroyed. Storage grows in chunks of slots.
+///
+template <class T>
+class HgiVkThreadSlotArray final
+{
+public:
+    static const uint32_t ChunkSize = 64;
+    static const uint32_t MaxChunks = HgiVkThreadSlots::MaxSlots / ChunkSize;
+
+    HgiVkThreadSlotArray() {
+        for (std::atomic<T*>& chunk : _chunks) {
+            chunk.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~HgiVkThreadSlotArray() {
+        for (std::atomic<T*>& chunk : _chunks) {
+            delete[] chunk.load(std::memory_order_relaxed);
+        }
+    }
+
+    /// Returns the element of the calling thread.
+    /// Thread safety: Lock-free. The returned element should only be used by
+    /// the calling thread, unless the caller guarantees otherwise.
+    T& Get() {
+        return Get(HgiVkThreadSlots::GetSlot());
+    }
+
+    /// Returns the element at `slot`, growing the array if needed.
+    /// Thread safety: Lock-free.
+    T& Get(uint32_t slot) {
+        const uint32_t chunkIndex = slot / ChunkSize;
+        if (chunkIndex >= MaxChunks) {
+            TF_FATAL_ERROR("Thread slot %u out of range", slot);
+        }
+
+        T* chunk = _chunks[chunkIndex].load(std::memory_order_acquire);
+        if (!chunk) {
+            // Another thread may be growing the same chunk. The loser of the
+            // race deletes its chunk and uses the winner's.
+            T* newChunk = new T[ChunkSize]();
+            if (_chunks[chunkIndex].compare_exchange_strong(
+                    chunk,
+                    newChunk,
+                    std::memory_order_acq_rel,
+                    std::memory_order_acquire)) {
+                chunk = newChunk;
+            } else {
+                delete[] newChunk;
+            }
+        }
+
+        return chunk[slot % ChunkSize];
+    }
+
+    /// Calls `fn(T&)` for each element of each allocated chunk.
+    /// Thread safety: Growing the array during ForEach is safe, but the caller
+    /// must ensure no thread modifies the elements while they are visited.
+    template <class Fn>
+    void ForEach(Fn const& fn) {
+        for (std::atomic<T*>& c : _chunks) {
+            T* chunk = c.load(std::memory_order_acquire);
+            if (!chunk) continue;
+            for (uint32_t i=0; i<ChunkSize; i++) {
+                fn(chunk[i]);
+            }
+        }
+    }
+
+private:
+    HgiVkThreadSlotArray & operator=(const HgiVkThreadSlotArray&) = delete;
+    HgiVkThreadSlotArray(const HgiVkThreadSlotArray&) = delete;
+
+    std::atomic<T*> _chunks[MaxChunks];
+};
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+#endif